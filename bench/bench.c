@@ -0,0 +1,195 @@
+#include "bench.h"
+#include "trading_engine/id_intern.h"
+#include "utils/logging.h"
+#include <cJSON/cJSON.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define BENCH_JSON_VERSION 1
+
+void bench_case_name(const BenchCase* bench_case, char* name, size_t size) {
+    if (bench_case->param_name) {
+        snprintf(name, size, "%s/%s:%ld", bench_case->name, bench_case->param_name,
+                 (long)bench_case->param);
+    } else {
+        snprintf(name, size, "%s", bench_case->name);
+    }
+}
+
+static int compare_doubles(const void* a, const void* b) {
+    double lhs = *(const double*)a;
+    double rhs = *(const double*)b;
+    return (lhs > rhs) - (lhs < rhs);
+}
+
+int bench_run_case(const BenchCase* bench_case, const BenchOptions* options, BenchResult* result) {
+    memset(result, 0, sizeof(*result));
+    bench_case_name(bench_case, result->name, sizeof(result->name));
+
+    double* samples = calloc((size_t)options->repetitions, sizeof(double));
+    if (!samples) {
+        return -1;
+    }
+
+    for (int rep = 0; rep < options->repetitions; rep++) {
+        // Every repetition replays the same seeded flow
+        BenchState state = { .seed = options->seed };
+        int status = bench_case->run(&state, bench_case->param);
+
+        // Cases release every order before returning, so the interned IDs
+        // can go too and each repetition starts from an empty table
+        id_intern_reset();
+
+        if (status != 0 || state.ops == 0) {
+            LOG_ERROR("Benchmark %s failed", result->name);
+            free(samples);
+            return -1;
+        }
+        samples[rep] = (double)state.elapsed_ns / (double)state.ops;
+        result->ops = state.ops;
+    }
+
+    qsort(samples, (size_t)options->repetitions, sizeof(double), compare_doubles);
+    result->repetitions = options->repetitions;
+    result->ns_per_op_min = samples[0];
+    result->ns_per_op_median = samples[options->repetitions / 2];
+    result->ns_per_op_max = samples[options->repetitions - 1];
+    result->ops_per_sec = result->ns_per_op_median > 0 ? 1e9 / result->ns_per_op_median : 0.0;
+
+    free(samples);
+    return 0;
+}
+
+int bench_write_json(const char* path, const BenchOptions* options,
+                     const BenchResult* results, int count) {
+    cJSON* root = cJSON_CreateObject();
+    if (!root) {
+        return -1;
+    }
+
+    cJSON_AddStringToObject(root, "suite", "quant_bench");
+    cJSON_AddNumberToObject(root, "version", BENCH_JSON_VERSION);
+    cJSON_AddStringToObject(root, "label", options->label ? options->label : "");
+    cJSON_AddNumberToObject(root, "timestamp", (double)time(NULL));
+    cJSON_AddNumberToObject(root, "seed", (double)options->seed);
+    cJSON_AddNumberToObject(root, "repetitions", options->repetitions);
+#ifdef BENCH_BUILD_TYPE
+    cJSON_AddStringToObject(root, "build_type", BENCH_BUILD_TYPE);
+#endif
+    cJSON_AddStringToObject(root, "compiler", __VERSION__);
+
+    cJSON* entries = cJSON_CreateArray();
+    for (int i = 0; i < count; i++) {
+        cJSON* entry = cJSON_CreateObject();
+        cJSON_AddStringToObject(entry, "name", results[i].name);
+        cJSON_AddNumberToObject(entry, "ops", (double)results[i].ops);
+        cJSON_AddNumberToObject(entry, "ns_per_op", results[i].ns_per_op_median);
+        cJSON_AddNumberToObject(entry, "ns_per_op_min", results[i].ns_per_op_min);
+        cJSON_AddNumberToObject(entry, "ns_per_op_max", results[i].ns_per_op_max);
+        cJSON_AddNumberToObject(entry, "ops_per_sec", results[i].ops_per_sec);
+        cJSON_AddItemToArray(entries, entry);
+    }
+    cJSON_AddItemToObject(root, "results", entries);
+
+    char* json = cJSON_Print(root);
+    cJSON_Delete(root);
+    if (!json) {
+        return -1;
+    }
+
+    FILE* file = fopen(path, "w");
+    if (!file) {
+        LOG_ERROR("Failed to open %s for writing", path);
+        free(json);
+        return -1;
+    }
+    int status = fputs(json, file) >= 0 && fputc('\n', file) != EOF ? 0 : -1;
+    if (fclose(file) != 0) {
+        status = -1;
+    }
+    free(json);
+    return status;
+}
+
+static char* read_file(const char* path) {
+    FILE* file = fopen(path, "rb");
+    if (!file) {
+        LOG_ERROR("Failed to open baseline %s", path);
+        return NULL;
+    }
+
+    char* data = NULL;
+    long size = -1;
+    if (fseek(file, 0, SEEK_END) == 0) {
+        size = ftell(file);
+    }
+    if (size >= 0 && fseek(file, 0, SEEK_SET) == 0) {
+        data = malloc((size_t)size + 1);
+        if (data && fread(data, 1, (size_t)size, file) == (size_t)size) {
+            data[size] = '\0';
+        } else {
+            free(data);
+            data = NULL;
+        }
+    }
+    fclose(file);
+    return data;
+}
+
+static const cJSON* find_baseline(const cJSON* entries, const char* name) {
+    const cJSON* entry;
+    cJSON_ArrayForEach(entry, entries) {
+        const cJSON* entry_name = cJSON_GetObjectItem(entry, "name");
+        if (entry_name && cJSON_IsString(entry_name) && strcmp(entry_name->valuestring, name) == 0) {
+            return entry;
+        }
+    }
+    return NULL;
+}
+
+int bench_compare(const char* baseline_path, const BenchResult* results, int count,
+                  double threshold_pct) {
+    char* data = read_file(baseline_path);
+    if (!data) {
+        return -1;
+    }
+
+    cJSON* root = cJSON_Parse(data);
+    free(data);
+    const cJSON* entries = root ? cJSON_GetObjectItem(root, "results") : NULL;
+    if (!entries || !cJSON_IsArray(entries)) {
+        LOG_ERROR("Baseline %s is not a quant_bench result file", baseline_path);
+        cJSON_Delete(root);
+        return -1;
+    }
+
+    const cJSON* label = cJSON_GetObjectItem(root, "label");
+    printf("\nCompared with %s%s%s%s\n", baseline_path,
+           label && cJSON_IsString(label) && label->valuestring[0] ? " (" : "",
+           label && cJSON_IsString(label) ? label->valuestring : "",
+           label && cJSON_IsString(label) && label->valuestring[0] ? ")" : "");
+    printf("%-40s %12s %12s %9s\n", "Benchmark", "Base ns/op", "ns/op", "Change");
+
+    int regressions = 0;
+    for (int i = 0; i < count; i++) {
+        const cJSON* baseline = find_baseline(entries, results[i].name);
+        const cJSON* base_ns = baseline ? cJSON_GetObjectItem(baseline, "ns_per_op") : NULL;
+        if (!base_ns || !cJSON_IsNumber(base_ns) || base_ns->valuedouble <= 0) {
+            printf("%-40s %12s %12.1f %9s\n", results[i].name, "-", results[i].ns_per_op_median, "new");
+            continue;
+        }
+
+        double change = (results[i].ns_per_op_median / base_ns->valuedouble - 1.0) * 100.0;
+        bool regressed = change > threshold_pct;
+        if (regressed) {
+            regressions++;
+        }
+        printf("%-40s %12.1f %12.1f %+8.1f%%%s\n", results[i].name, base_ns->valuedouble,
+               results[i].ns_per_op_median, change, regressed ? "  REGRESSION" : "");
+    }
+
+    cJSON_Delete(root);
+    return regressions;
+}
@@ -0,0 +1,82 @@
+#ifndef QUANT_TRADING_BENCH_H
+#define QUANT_TRADING_BENCH_H
+
+#include "utils/clock.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define BENCH_NAME_LENGTH 96
+
+// State of one repetition of a benchmark case. Cases do their setup, then
+// bracket the measured work with bench_timer_start/stop (possibly several
+// times) and report how many operations that work performed.
+typedef struct {
+    uint64_t seed;
+    uint64_t ops;
+    int64_t elapsed_ns;
+    int64_t started_ns;
+} BenchState;
+
+// Returns 0 on success, -1 if the case could not run
+typedef int (*BenchFunction)(BenchState* state, int64_t param);
+
+typedef struct {
+    const char* name;
+    const char* param_name;    // NULL for unparameterized cases
+    int64_t param;
+    BenchFunction run;
+} BenchCase;
+
+typedef struct {
+    char name[BENCH_NAME_LENGTH];  // "case" or "case/param:value"
+    uint64_t ops;                  // Per repetition
+    int repetitions;
+    double ns_per_op_min;
+    double ns_per_op_median;
+    double ns_per_op_max;
+    double ops_per_sec;            // From the median
+} BenchResult;
+
+typedef struct {
+    uint64_t seed;
+    int repetitions;
+    const char* label;         // Free text stored in the JSON, e.g. a commit hash
+} BenchOptions;
+
+static inline void bench_timer_start(BenchState* state) {
+    state->started_ns = clock_now_ns();
+}
+
+static inline void bench_timer_stop(BenchState* state) {
+    state->elapsed_ns += clock_now_ns() - state->started_ns;
+}
+
+// Keeps the compiler from discarding a result that is otherwise unused
+static inline void bench_do_not_optimize(const void* value) {
+    __asm__ volatile("" : : "g"(value) : "memory");
+}
+
+void bench_case_name(const BenchCase* bench_case, char* name, size_t size);
+
+// Runs every repetition of a case and summarizes them
+int bench_run_case(const BenchCase* bench_case, const BenchOptions* options, BenchResult* result);
+
+int bench_write_json(const char* path, const BenchOptions* options,
+                     const BenchResult* results, int count);
+
+// Prints each result against the same case in a JSON file written by an
+// earlier run. Returns the number of cases whose median got slower by more
+// than threshold_pct, or -1 if the baseline cannot be read.
+int bench_compare(const char* baseline_path, const BenchResult* results, int count,
+                  double threshold_pct);
+
+// Case tables, one per area
+extern const BenchCase ENGINE_BENCHES[];
+extern const size_t ENGINE_BENCH_COUNT;
+extern const BenchCase PROTOCOL_BENCHES[];
+extern const size_t PROTOCOL_BENCH_COUNT;
+extern const BenchCase LOADER_BENCHES[];
+extern const size_t LOADER_BENCH_COUNT;
+
+#endif // QUANT_TRADING_BENCH_H
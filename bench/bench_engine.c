@@ -0,0 +1,321 @@
+#include "bench.h"
+#include "order_flow.h"
+#include "trading_engine/avl_tree.h"
+#include "trading_engine/order_book.h"
+#include <stdlib.h>
+
+#define AVL_BATCH 10000
+#define AVL_PRICE_LEVELS 2000
+
+#define SWEEP_BOOK_LEVELS 100
+#define SWEEP_ORDERS_PER_LEVEL 8
+#define SWEEP_AGGRESSORS 2000
+
+#define CANCEL_MIX_OPS 20000
+#define CANCEL_MIX_LEVELS 200
+
+static const char* const BENCH_SYMBOL = "BENCH";
+
+// Tree nodes only hold the order pointer, so the AVL cases use zeroed
+// stand-ins instead of real orders
+typedef struct {
+    AVLTree* tree;
+    double* prices;
+    Order* orders;
+    size_t count;
+} AvlFixture;
+
+static int avl_fixture_create(AvlFixture* fixture, uint64_t seed, size_t count) {
+    fixture->tree = avl_create(false);
+    fixture->prices = malloc(count * sizeof(double));
+    fixture->orders = calloc(count, sizeof(Order));
+    fixture->count = count;
+    if (!fixture->tree || !fixture->prices || !fixture->orders) {
+        return -1;
+    }
+
+    BenchRng rng;
+    bench_rng_seed(&rng, seed);
+    for (size_t i = 0; i < count; i++) {
+        fixture->prices[i] = 100.0 + bench_rng_below(&rng, AVL_PRICE_LEVELS) * 0.01;
+    }
+    return 0;
+}
+
+static void avl_fixture_destroy(AvlFixture* fixture) {
+    avl_destroy(fixture->tree);
+    free(fixture->prices);
+    free(fixture->orders);
+}
+
+static void avl_fixture_insert(AvlFixture* fixture, size_t i) {
+    avl_insert(fixture->tree, fixture->prices[i], i + 1, &fixture->orders[i]);
+}
+
+static int bench_avl_insert(BenchState* state, int64_t depth) {
+    AvlFixture fixture;
+    if (avl_fixture_create(&fixture, state->seed, (size_t)depth + AVL_BATCH) != 0) {
+        avl_fixture_destroy(&fixture);
+        return -1;
+    }
+
+    for (size_t i = 0; i < (size_t)depth; i++) {
+        avl_fixture_insert(&fixture, i);
+    }
+
+    bench_timer_start(state);
+    for (size_t i = (size_t)depth; i < fixture.count; i++) {
+        avl_fixture_insert(&fixture, i);
+    }
+    bench_timer_stop(state);
+    state->ops = AVL_BATCH;
+
+    avl_fixture_destroy(&fixture);
+    return 0;
+}
+
+static int bench_avl_delete(BenchState* state, int64_t depth) {
+    AvlFixture fixture;
+    size_t* victims = malloc(((size_t)depth + AVL_BATCH) * sizeof(size_t));
+    if (!victims || avl_fixture_create(&fixture, state->seed, (size_t)depth + AVL_BATCH) != 0) {
+        free(victims);
+        avl_fixture_destroy(&fixture);
+        return -1;
+    }
+
+    // Delete a random AVL_BATCH of the nodes, leaving depth behind
+    BenchRng rng;
+    bench_rng_seed(&rng, state->seed ^ 0x5EEDULL);
+    for (size_t i = 0; i < fixture.count; i++) {
+        avl_fixture_insert(&fixture, i);
+        victims[i] = i;
+    }
+    for (size_t i = 0; i < AVL_BATCH; i++) {
+        size_t j = i + bench_rng_below(&rng, (uint32_t)(fixture.count - i));
+        size_t swap = victims[i];
+        victims[i] = victims[j];
+        victims[j] = swap;
+    }
+
+    bench_timer_start(state);
+    for (size_t i = 0; i < AVL_BATCH; i++) {
+        size_t victim = victims[i];
+        avl_delete_order(fixture.tree, fixture.prices[victim], victim + 1);
+    }
+    bench_timer_stop(state);
+    state->ops = AVL_BATCH;
+
+    free(victims);
+    avl_fixture_destroy(&fixture);
+    return 0;
+}
+
+static OrderBook* create_book(OrderBookBackend backend) {
+    OrderBookConfig config = {
+        .backend = backend,
+        .tick_size = 0.01,
+        .num_levels = 4096
+    };
+    return order_book_create_with_config(&config);
+}
+
+static Order* add_resting(OrderBook* book, OrderPool* pool, OrderFlow* flow,
+                          bool is_buy, int level, int* level_quantity) {
+    OrderFlowEvent event;
+    order_flow_next_passive_side(flow, is_buy, &event);
+    event.price = order_flow_level_price(flow, is_buy ? -level : level);
+
+    Order* order = order_flow_create_order(&event, BENCH_SYMBOL);
+    if (!order || order_pool_add(pool, order) != 0) {
+        order_destroy(order);
+        return NULL;
+    }
+    if (order_book_add_order(book, order) != 0) {
+        return NULL;
+    }
+    if (level_quantity) {
+        level_quantity[level] += event.quantity;
+    }
+    return order;
+}
+
+// Aggressors alternate sides and each clears exactly the best `levels`
+// levels on the other side, which are then refilled outside the timer
+static int run_match_sweep(BenchState* state, int64_t levels, OrderBookBackend backend) {
+    OrderFlowConfig flow_config = {
+        .mid_price = 100.0,
+        .tick_size = 0.01,
+        .levels = SWEEP_BOOK_LEVELS,
+        .max_quantity = 100
+    };
+    OrderFlow flow;
+    order_flow_init(&flow, &flow_config, state->seed);
+
+    OrderBook* book = create_book(backend);
+    OrderPool pool = {0};
+    int level_quantity[2][SWEEP_BOOK_LEVELS + 1] = {{0}};
+    int status = book ? 0 : -1;
+
+    for (int side = 0; side < 2 && status == 0; side++) {
+        for (int level = 1; level <= SWEEP_BOOK_LEVELS && status == 0; level++) {
+            for (int i = 0; i < SWEEP_ORDERS_PER_LEVEL; i++) {
+                if (!add_resting(book, &pool, &flow, side == 0, level, level_quantity[side])) {
+                    status = -1;
+                    break;
+                }
+            }
+        }
+    }
+
+    for (int i = 0; i < SWEEP_AGGRESSORS && status == 0; i++) {
+        bool is_buy = i % 2 == 0;
+        int resting_side = is_buy ? 1 : 0;
+
+        OrderFlowEvent event;
+        order_flow_next_passive_side(&flow, is_buy, &event);
+        event.price = order_flow_level_price(&flow, is_buy ? (int)levels : -(int)levels);
+        event.quantity = 0;
+        for (int level = 1; level <= levels; level++) {
+            event.quantity += level_quantity[resting_side][level];
+            level_quantity[resting_side][level] = 0;
+        }
+
+        Order* aggressor = order_flow_create_order(&event, BENCH_SYMBOL);
+        if (!aggressor || order_pool_add(&pool, aggressor) != 0) {
+            order_destroy(aggressor);
+            status = -1;
+            break;
+        }
+
+        bench_timer_start(state);
+        order_book_add_order(book, aggressor);
+        order_book_match_orders(book);
+        bench_timer_stop(state);
+        state->ops++;
+
+        for (int level = 1; level <= levels && status == 0; level++) {
+            for (int j = 0; j < SWEEP_ORDERS_PER_LEVEL; j++) {
+                if (!add_resting(book, &pool, &flow, !is_buy, level, level_quantity[resting_side])) {
+                    status = -1;
+                    break;
+                }
+            }
+        }
+    }
+
+    order_book_destroy(book);
+    order_pool_clear(&pool);
+    return status;
+}
+
+static int bench_match_sweep(BenchState* state, int64_t levels) {
+    return run_match_sweep(state, levels, ORDER_BOOK_BACKEND_AVL);
+}
+
+static int bench_match_sweep_dense(BenchState* state, int64_t levels) {
+    return run_match_sweep(state, levels, ORDER_BOOK_BACKEND_DENSE);
+}
+
+// 70% cancels of random live orders, 25% passive adds, 5% small crossing
+// orders that match against the top of the book
+static int run_cancel_mix(BenchState* state, int64_t depth, OrderBookBackend backend) {
+    OrderFlowConfig flow_config = {
+        .mid_price = 100.0,
+        .tick_size = 0.01,
+        .levels = CANCEL_MIX_LEVELS,
+        .max_quantity = 100
+    };
+    OrderFlow flow;
+    order_flow_init(&flow, &flow_config, state->seed);
+
+    OrderBook* book = create_book(backend);
+    OrderPool pool = {0};
+    Order** live = malloc(((size_t)depth + CANCEL_MIX_OPS) * sizeof(Order*));
+    size_t live_count = 0;
+    int status = book && live ? 0 : -1;
+
+    for (int64_t i = 0; i < depth && status == 0; i++) {
+        OrderFlowEvent event;
+        order_flow_next_passive(&flow, &event);
+        Order* order = order_flow_create_order(&event, BENCH_SYMBOL);
+        if (!order || order_pool_add(&pool, order) != 0 || order_book_add_order(book, order) != 0) {
+            status = -1;
+            break;
+        }
+        live[live_count++] = order;
+    }
+
+    for (int i = 0; i < CANCEL_MIX_OPS && status == 0; i++) {
+        uint32_t roll = bench_rng_below(&flow.rng, 100);
+
+        if (roll < 70 && live_count > 0) {
+            size_t index = bench_rng_below(&flow.rng, (uint32_t)live_count);
+            Order* order = live[index];
+            live[index] = live[--live_count];
+
+            bench_timer_start(state);
+            order_book_cancel_order(book, order_get_id(order), order->is_buy_order);
+            bench_timer_stop(state);
+            state->ops++;
+            continue;
+        }
+
+        OrderFlowEvent event;
+        order_flow_next_passive(&flow, &event);
+        bool crossing = roll >= 95;
+        if (crossing) {
+            event.price = order_flow_level_price(&flow, event.is_buy ? 1 : -1);
+        }
+
+        Order* order = order_flow_create_order(&event, BENCH_SYMBOL);
+        if (!order || order_pool_add(&pool, order) != 0) {
+            order_destroy(order);
+            status = -1;
+            break;
+        }
+
+        bench_timer_start(state);
+        order_book_add_order(book, order);
+        if (crossing) {
+            order_book_match_orders(book);
+        }
+        bench_timer_stop(state);
+        state->ops++;
+
+        live[live_count++] = order;
+    }
+
+    order_book_destroy(book);
+    order_pool_clear(&pool);
+    free(live);
+    return status;
+}
+
+static int bench_cancel_mix(BenchState* state, int64_t depth) {
+    return run_cancel_mix(state, depth, ORDER_BOOK_BACKEND_AVL);
+}
+
+static int bench_cancel_mix_dense(BenchState* state, int64_t depth) {
+    return run_cancel_mix(state, depth, ORDER_BOOK_BACKEND_DENSE);
+}
+
+const BenchCase ENGINE_BENCHES[] = {
+    {"avl_insert", "depth", 1000, bench_avl_insert},
+    {"avl_insert", "depth", 10000, bench_avl_insert},
+    {"avl_insert", "depth", 100000, bench_avl_insert},
+    {"avl_delete_order", "depth", 1000, bench_avl_delete},
+    {"avl_delete_order", "depth", 10000, bench_avl_delete},
+    {"avl_delete_order", "depth", 100000, bench_avl_delete},
+    {"match_sweep", "levels", 1, bench_match_sweep},
+    {"match_sweep", "levels", 5, bench_match_sweep},
+    {"match_sweep", "levels", 20, bench_match_sweep},
+    {"match_sweep_dense", "levels", 1, bench_match_sweep_dense},
+    {"match_sweep_dense", "levels", 5, bench_match_sweep_dense},
+    {"match_sweep_dense", "levels", 20, bench_match_sweep_dense},
+    {"cancel_mix", "depth", 1000, bench_cancel_mix},
+    {"cancel_mix", "depth", 10000, bench_cancel_mix},
+    {"cancel_mix_dense", "depth", 1000, bench_cancel_mix_dense},
+    {"cancel_mix_dense", "depth", 10000, bench_cancel_mix_dense},
+};
+
+const size_t ENGINE_BENCH_COUNT = sizeof(ENGINE_BENCHES) / sizeof(ENGINE_BENCHES[0]);
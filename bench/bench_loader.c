@@ -0,0 +1,103 @@
+#include "bench.h"
+#include "order_flow.h"
+#include "trading_engine/order_book.h"
+#include "utils/logging.h"
+#include "utils/order_loader.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#define SCALING_ORDERS 400000  // About 16 MB, enough for 16 one-megabyte chunks
+
+static int write_order_file(char* path, uint64_t seed, int64_t count) {
+    int fd = mkstemps(path, 4);
+    if (fd < 0) {
+        LOG_ERROR("Failed to create %s", path);
+        return -1;
+    }
+
+    FILE* file = fdopen(fd, "w");
+    if (!file) {
+        close(fd);
+        unlink(path);
+        return -1;
+    }
+
+    OrderFlowConfig flow_config = {
+        .mid_price = 100.0,
+        .tick_size = 0.01,
+        .levels = 500,
+        .max_quantity = 1000
+    };
+    OrderFlow flow;
+    order_flow_init(&flow, &flow_config, seed);
+
+    fprintf(file, "order_id,trader_id,symbol,side,price,quantity\n");
+    for (int64_t i = 0; i < count; i++) {
+        OrderFlowEvent event;
+        order_flow_next_passive(&flow, &event);
+        fprintf(file, "%s,%s,BENCH,%s,%.2f,%d\n", event.order_id, event.trader_id,
+                event.is_buy ? "BUY" : "SELL", event.price, event.quantity);
+    }
+
+    if (fclose(file) != 0) {
+        unlink(path);
+        return -1;
+    }
+    return 0;
+}
+
+static void collect_order(Order* order, void* user_data) {
+    order_pool_add((OrderPool*)user_data, order);
+}
+
+// Passive flow only, so nothing matches and every loaded order can be
+// recovered from the book for cleanup
+static int run_load(BenchState* state, int64_t count, int max_threads) {
+    const char* tmpdir = getenv("TMPDIR");
+    char path[256];
+    snprintf(path, sizeof(path), "%s/quant_bench_XXXXXX.csv", tmpdir ? tmpdir : "/tmp");
+    if (write_order_file(path, state->seed, count) != 0) {
+        return -1;
+    }
+
+    OrderBook* book = order_book_create(NULL);
+    if (!book) {
+        unlink(path);
+        return -1;
+    }
+
+    bench_timer_start(state);
+    int loaded = load_orders_from_file_threads(path, book, max_threads);
+    bench_timer_stop(state);
+    state->ops = loaded > 0 ? (uint64_t)loaded : 0;
+
+    OrderPool pool = {0};
+    order_book_traverse_buy_orders(book, collect_order, &pool);
+    order_book_traverse_sell_orders(book, collect_order, &pool);
+    order_book_destroy(book);
+    order_pool_clear(&pool);
+    unlink(path);
+
+    return loaded == count ? 0 : -1;
+}
+
+static int bench_load_orders_from_file(BenchState* state, int64_t count) {
+    return run_load(state, count, 0);
+}
+
+// Parser thread scaling; the loader still caps threads at the online CPUs
+static int bench_load_orders_threads(BenchState* state, int64_t threads) {
+    return run_load(state, SCALING_ORDERS, (int)threads);
+}
+
+const BenchCase LOADER_BENCHES[] = {
+    {"load_orders_from_file", "orders", 10000, bench_load_orders_from_file},
+    {"load_orders_from_file", "orders", 200000, bench_load_orders_from_file},
+    {"load_orders_threads", "threads", 1, bench_load_orders_threads},
+    {"load_orders_threads", "threads", 2, bench_load_orders_threads},
+    {"load_orders_threads", "threads", 4, bench_load_orders_threads},
+    {"load_orders_threads", "threads", 8, bench_load_orders_threads},
+};
+
+const size_t LOADER_BENCH_COUNT = sizeof(LOADER_BENCHES) / sizeof(LOADER_BENCHES[0]);
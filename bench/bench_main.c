@@ -0,0 +1,163 @@
+#include "bench.h"
+#include "utils/logging.h"
+#include <getopt.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define DEFAULT_SEED 42
+#define DEFAULT_REPETITIONS 5
+#define DEFAULT_THRESHOLD_PCT 10.0
+
+typedef struct {
+    const BenchCase* cases;
+    const size_t* count;
+} BenchSuite;
+
+static const BenchSuite SUITES[] = {
+    {ENGINE_BENCHES, &ENGINE_BENCH_COUNT},
+    {PROTOCOL_BENCHES, &PROTOCOL_BENCH_COUNT},
+    {LOADER_BENCHES, &LOADER_BENCH_COUNT},
+};
+
+#define SUITE_COUNT (sizeof(SUITES) / sizeof(SUITES[0]))
+
+static void print_usage(const char* program) {
+    fprintf(stderr,
+            "Usage: %s [options]\n"
+            "  --filter TEXT        Only run benchmarks whose name contains TEXT\n"
+            "  --repetitions N      Runs per benchmark, the median is reported (default %d)\n"
+            "  --seed N             Seed for the synthetic order flow (default %d)\n"
+            "  --output FILE        Write results as JSON to FILE\n"
+            "  --label TEXT         Label stored in the JSON, e.g. a commit hash\n"
+            "  --compare FILE       Compare with a JSON file from an earlier run\n"
+            "  --threshold PCT      Slowdown that counts as a regression (default %.0f)\n"
+            "  --list               List benchmarks and exit\n"
+            "  --help               Show this message\n",
+            program, DEFAULT_REPETITIONS, DEFAULT_SEED, DEFAULT_THRESHOLD_PCT);
+}
+
+int main(int argc, char* argv[]) {
+    BenchOptions options = {
+        .seed = DEFAULT_SEED,
+        .repetitions = DEFAULT_REPETITIONS,
+        .label = NULL
+    };
+    const char* filter = NULL;
+    const char* output_path = NULL;
+    const char* baseline_path = NULL;
+    double threshold_pct = DEFAULT_THRESHOLD_PCT;
+    bool list_only = false;
+
+    static const struct option long_options[] = {
+        {"filter", required_argument, NULL, 'f'},
+        {"repetitions", required_argument, NULL, 'r'},
+        {"seed", required_argument, NULL, 's'},
+        {"output", required_argument, NULL, 'o'},
+        {"label", required_argument, NULL, 'l'},
+        {"compare", required_argument, NULL, 'c'},
+        {"threshold", required_argument, NULL, 't'},
+        {"list", no_argument, NULL, 'L'},
+        {"help", no_argument, NULL, 'h'},
+        {NULL, 0, NULL, 0}
+    };
+
+    int opt;
+    while ((opt = getopt_long(argc, argv, "f:r:s:o:l:c:t:Lh", long_options, NULL)) != -1) {
+        switch (opt) {
+            case 'f':
+                filter = optarg;
+                break;
+            case 'r':
+                options.repetitions = atoi(optarg);
+                if (options.repetitions <= 0) {
+                    fprintf(stderr, "Invalid --repetitions argument: %s\n", optarg);
+                    return EXIT_FAILURE;
+                }
+                break;
+            case 's':
+                options.seed = strtoull(optarg, NULL, 10);
+                break;
+            case 'o':
+                output_path = optarg;
+                break;
+            case 'l':
+                options.label = optarg;
+                break;
+            case 'c':
+                baseline_path = optarg;
+                break;
+            case 't':
+                threshold_pct = strtod(optarg, NULL);
+                break;
+            case 'L':
+                list_only = true;
+                break;
+            case 'h':
+                print_usage(argv[0]);
+                return EXIT_SUCCESS;
+            default:
+                print_usage(argv[0]);
+                return EXIT_FAILURE;
+        }
+    }
+
+    // The engine logs every order and fill at info level
+    set_log_level(LOG_ERROR);
+
+    size_t total = 0;
+    for (size_t s = 0; s < SUITE_COUNT; s++) {
+        total += *SUITES[s].count;
+    }
+
+    BenchResult* results = calloc(total, sizeof(BenchResult));
+    if (!results) {
+        return EXIT_FAILURE;
+    }
+
+    if (!list_only) {
+        printf("%-40s %12s %12s %12s %14s\n", "Benchmark", "ns/op", "min", "max", "ops/s");
+    }
+
+    int count = 0;
+    int failures = 0;
+    for (size_t s = 0; s < SUITE_COUNT; s++) {
+        for (size_t i = 0; i < *SUITES[s].count; i++) {
+            const BenchCase* bench_case = &SUITES[s].cases[i];
+            char name[BENCH_NAME_LENGTH];
+            bench_case_name(bench_case, name, sizeof(name));
+            if (filter && !strstr(name, filter)) {
+                continue;
+            }
+            if (list_only) {
+                printf("%s\n", name);
+                continue;
+            }
+
+            BenchResult* result = &results[count];
+            if (bench_run_case(bench_case, &options, result) != 0) {
+                failures++;
+                continue;
+            }
+            printf("%-40s %12.1f %12.1f %12.1f %14.0f\n", result->name, result->ns_per_op_median,
+                   result->ns_per_op_min, result->ns_per_op_max, result->ops_per_sec);
+            fflush(stdout);
+            count++;
+        }
+    }
+
+    int status = failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+    if (!list_only && output_path && bench_write_json(output_path, &options, results, count) != 0) {
+        fprintf(stderr, "Failed to write %s\n", output_path);
+        status = EXIT_FAILURE;
+    }
+    if (!list_only && baseline_path) {
+        int regressions = bench_compare(baseline_path, results, count, threshold_pct);
+        if (regressions != 0) {
+            status = EXIT_FAILURE;
+        }
+    }
+
+    free(results);
+    return status;
+}
@@ -0,0 +1,118 @@
+#include "bench.h"
+#include "order_flow.h"
+#include "protocol/json_protocol.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define SERIALIZE_ITERATIONS 200
+#define PARSE_MESSAGES 5000
+
+static int bench_serialize_book_snapshot(BenchState* state, int64_t levels) {
+    BookSnapshot snapshot = {0};
+    strncpy(snapshot.symbol, "BENCH", sizeof(snapshot.symbol) - 1);
+    snapshot.num_bids = (int)levels;
+    snapshot.num_asks = (int)levels;
+    snapshot.bid_prices = malloc((size_t)levels * sizeof(double));
+    snapshot.bid_quantities = malloc((size_t)levels * sizeof(int));
+    snapshot.ask_prices = malloc((size_t)levels * sizeof(double));
+    snapshot.ask_quantities = malloc((size_t)levels * sizeof(int));
+
+    int status = -1;
+    if (snapshot.bid_prices && snapshot.bid_quantities &&
+        snapshot.ask_prices && snapshot.ask_quantities) {
+        BenchRng rng;
+        bench_rng_seed(&rng, state->seed);
+        for (int64_t i = 0; i < levels; i++) {
+            snapshot.bid_prices[i] = 100.0 - (double)(i + 1) * 0.01;
+            snapshot.ask_prices[i] = 100.0 + (double)(i + 1) * 0.01;
+            snapshot.bid_quantities[i] = 1 + (int)bench_rng_below(&rng, 1000);
+            snapshot.ask_quantities[i] = 1 + (int)bench_rng_below(&rng, 1000);
+        }
+
+        status = 0;
+        bench_timer_start(state);
+        for (int i = 0; i < SERIALIZE_ITERATIONS; i++) {
+            char* json = serialize_book_snapshot(&snapshot);
+            if (!json) {
+                status = -1;
+                break;
+            }
+            bench_do_not_optimize(json);
+            free(json);
+        }
+        bench_timer_stop(state);
+        state->ops = SERIALIZE_ITERATIONS;
+    }
+
+    free(snapshot.bid_prices);
+    free(snapshot.bid_quantities);
+    free(snapshot.ask_prices);
+    free(snapshot.ask_quantities);
+    return status;
+}
+
+static int bench_parse_order_message(BenchState* state, int64_t param) {
+    (void)param;
+    OrderFlowConfig flow_config = {
+        .mid_price = 100.0,
+        .tick_size = 0.01,
+        .levels = 100,
+        .max_quantity = 1000
+    };
+    OrderFlow flow;
+    order_flow_init(&flow, &flow_config, state->seed);
+
+    char** messages = calloc(PARSE_MESSAGES, sizeof(char*));
+    if (!messages) {
+        return -1;
+    }
+
+    int status = 0;
+    for (int i = 0; i < PARSE_MESSAGES; i++) {
+        OrderFlowEvent event;
+        order_flow_next_passive(&flow, &event);
+
+        OrderMessage order = {0};
+        strncpy(order.symbol, "BENCH", sizeof(order.symbol) - 1);
+        strncpy(order.order_id, event.order_id, sizeof(order.order_id) - 1);
+        strncpy(order.trader_id, event.trader_id, sizeof(order.trader_id) - 1);
+        order.price = event.price;
+        order.quantity = event.quantity;
+        order.is_buy = event.is_buy;
+
+        messages[i] = serialize_order_message(&order);
+        if (!messages[i]) {
+            status = -1;
+            break;
+        }
+    }
+
+    if (status == 0) {
+        bench_timer_start(state);
+        for (int i = 0; i < PARSE_MESSAGES; i++) {
+            OrderMessage parsed;
+            if (!parse_order_message(messages[i], &parsed)) {
+                status = -1;
+                break;
+            }
+            bench_do_not_optimize(&parsed);
+        }
+        bench_timer_stop(state);
+        state->ops = PARSE_MESSAGES;
+    }
+
+    for (int i = 0; i < PARSE_MESSAGES; i++) {
+        free(messages[i]);
+    }
+    free(messages);
+    return status;
+}
+
+const BenchCase PROTOCOL_BENCHES[] = {
+    {"serialize_book_snapshot", "levels", 10, bench_serialize_book_snapshot},
+    {"serialize_book_snapshot", "levels", 100, bench_serialize_book_snapshot},
+    {"serialize_book_snapshot", "levels", 1000, bench_serialize_book_snapshot},
+    {"parse_order_message", NULL, 0, bench_parse_order_message},
+};
+
+const size_t PROTOCOL_BENCH_COUNT = sizeof(PROTOCOL_BENCHES) / sizeof(PROTOCOL_BENCHES[0]);
@@ -0,0 +1,75 @@
+#include "order_flow.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+// splitmix64 spreads small seeds over the whole state
+void bench_rng_seed(BenchRng* rng, uint64_t seed) {
+    uint64_t z = seed + 0x9E3779B97F4A7C15ULL;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    rng->state = (z ^ (z >> 31)) | 1;
+}
+
+// xorshift64*
+uint64_t bench_rng_next(BenchRng* rng) {
+    rng->state ^= rng->state >> 12;
+    rng->state ^= rng->state << 25;
+    rng->state ^= rng->state >> 27;
+    return rng->state * 0x2545F4914F6CDD1DULL;
+}
+
+uint32_t bench_rng_below(BenchRng* rng, uint32_t bound) {
+    return bound ? (uint32_t)((bench_rng_next(rng) >> 32) * bound >> 32) : 0;
+}
+
+void order_flow_init(OrderFlow* flow, const OrderFlowConfig* config, uint64_t seed) {
+    flow->config = *config;
+    flow->next_id = 1;
+    bench_rng_seed(&flow->rng, seed);
+}
+
+double order_flow_level_price(const OrderFlow* flow, int ticks) {
+    return flow->config.mid_price + ticks * flow->config.tick_size;
+}
+
+void order_flow_next_passive_side(OrderFlow* flow, bool is_buy, OrderFlowEvent* event) {
+    int ticks = 1 + (int)bench_rng_below(&flow->rng, (uint32_t)flow->config.levels);
+
+    snprintf(event->order_id, sizeof(event->order_id), "B%lu", (unsigned long)flow->next_id++);
+    snprintf(event->trader_id, sizeof(event->trader_id), "T%u", bench_rng_below(&flow->rng, 64));
+    event->is_buy = is_buy;
+    event->price = order_flow_level_price(flow, is_buy ? -ticks : ticks);
+    event->quantity = 1 + (int)bench_rng_below(&flow->rng, (uint32_t)flow->config.max_quantity);
+}
+
+void order_flow_next_passive(OrderFlow* flow, OrderFlowEvent* event) {
+    order_flow_next_passive_side(flow, bench_rng_below(&flow->rng, 2) == 0, event);
+}
+
+Order* order_flow_create_order(const OrderFlowEvent* event, const char* symbol) {
+    return order_create(event->order_id, event->trader_id, symbol,
+                        event->price, event->quantity, event->is_buy);
+}
+
+int order_pool_add(OrderPool* pool, Order* order) {
+    if (pool->count == pool->capacity) {
+        size_t capacity = pool->capacity ? pool->capacity * 2 : 1024;
+        Order** grown = realloc(pool->orders, capacity * sizeof(Order*));
+        if (!grown) {
+            return -1;
+        }
+        pool->orders = grown;
+        pool->capacity = capacity;
+    }
+    pool->orders[pool->count++] = order;
+    return 0;
+}
+
+void order_pool_clear(OrderPool* pool) {
+    for (size_t i = 0; i < pool->count; i++) {
+        order_destroy(pool->orders[i]);
+    }
+    free(pool->orders);
+    pool->orders = NULL;
+    pool->count = pool->capacity = 0;
+}
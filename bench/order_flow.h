@@ -0,0 +1,59 @@
+#ifndef QUANT_TRADING_BENCH_ORDER_FLOW_H
+#define QUANT_TRADING_BENCH_ORDER_FLOW_H
+
+#include "trading_engine/order.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Seeded synthetic order flow, so every run of a benchmark sees the same orders
+
+typedef struct {
+    uint64_t state;
+} BenchRng;
+
+void bench_rng_seed(BenchRng* rng, uint64_t seed);
+uint64_t bench_rng_next(BenchRng* rng);
+// Uniform in [0, bound)
+uint32_t bench_rng_below(BenchRng* rng, uint32_t bound);
+
+typedef struct {
+    double mid_price;
+    double tick_size;
+    int levels;                // Passive orders rest 1..levels ticks away from mid
+    int max_quantity;
+} OrderFlowConfig;
+
+typedef struct {
+    char order_id[24];
+    char trader_id[16];
+    double price;
+    int quantity;
+    bool is_buy;
+} OrderFlowEvent;
+
+typedef struct {
+    BenchRng rng;
+    OrderFlowConfig config;
+    uint64_t next_id;
+} OrderFlow;
+
+void order_flow_init(OrderFlow* flow, const OrderFlowConfig* config, uint64_t seed);
+// Price of the level ticks away from mid, negative below it
+double order_flow_level_price(const OrderFlow* flow, int ticks);
+// Random side, resting on its own side of mid so it never crosses
+void order_flow_next_passive(OrderFlow* flow, OrderFlowEvent* event);
+void order_flow_next_passive_side(OrderFlow* flow, bool is_buy, OrderFlowEvent* event);
+Order* order_flow_create_order(const OrderFlowEvent* event, const char* symbol);
+
+// Owns orders created by a benchmark until it tears down
+typedef struct {
+    Order** orders;
+    size_t count;
+    size_t capacity;
+} OrderPool;
+
+int order_pool_add(OrderPool* pool, Order* order);
+void order_pool_clear(OrderPool* pool);
+
+#endif // QUANT_TRADING_BENCH_ORDER_FLOW_H
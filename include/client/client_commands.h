@@ -9,6 +9,7 @@ typedef enum {
     CMD_SELL,
     CMD_CANCEL,
     CMD_VIEW,
+    CMD_STATS,
     CMD_HELP,
     CMD_QUIT,
     CMD_INVALID
@@ -20,6 +21,9 @@ typedef struct {
     double price;
     int quantity;
     char order_id[32];
+    TimeInForce time_in_force;
+    bool is_market;
+    int display_quantity;      // Iceberg slice size, 0 shows everything
 } Command;
 
 Command parse_command(const char* input);
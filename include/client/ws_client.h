@@ -13,6 +13,7 @@ typedef struct {
     int server_port;
     int reconnect_interval_ms;
     int ping_interval_ms;
+    bool exit_on_disconnect;   // Exit the process once the connection is given up (interactive client)
 } WSClientConfig;
 
 void ws_client_force_shutdown(void);
@@ -24,6 +25,7 @@ void ws_client_disconnect(WSClient* client);
 void ws_client_destroy(WSClient* client);
 
 // Message operations
+// Safe from any thread: the message is queued and written by the service thread
 int ws_client_send(WSClient* client, const char* message, size_t len);
 bool ws_client_is_connected(const WSClient* client);
 
@@ -10,6 +10,7 @@ char* serialize_order_message(const OrderMessage* order);
 char* serialize_trade_message(const TradeMessage* trade);
 char* serialize_book_snapshot(const BookSnapshot* snapshot);
 char* serialize_server_status(const ServerStatus* status);
+char* serialize_batch_ack(const BatchAck* ack);
 
 // Message deserialization
 bool parse_order_message(const char* json, OrderMessage* order);
@@ -17,8 +18,15 @@ bool parse_trade_message(const char* json, TradeMessage* trade);
 bool parse_book_snapshot(const char* json, BookSnapshot* snapshot);
 bool parse_server_status(const char* json, ServerStatus* status);
 
+// Batches name one symbol and carry an "orders" array of 1 to
+// MAX_BATCH_ORDERS entries without a symbol of their own. Both return the
+// number of entries, or -1 if the batch or any entry is malformed.
+int parse_order_batch(const cJSON* root, OrderMessage* orders);
+int parse_cancel_batch(const cJSON* root, char* symbol, size_t symbol_size, CancelMessage* cancels);
+
 // Helper functions
 cJSON* create_base_message(int type);
+const char* time_in_force_name(TimeInForce time_in_force);
 bool parse_base_message(const char* json, int* type);
 
 // Error handling
@@ -11,7 +11,11 @@ typedef enum {
     MSG_CANCEL_ORDER = 2,
     MSG_REQUEST_BOOK = 3,
     MSG_SUBSCRIBE_SYMBOL = 4,
-    MSG_UNSUBSCRIBE_SYMBOL = 5
+    MSG_UNSUBSCRIBE_SYMBOL = 5,
+    MSG_REQUEST_STATUS = 6,
+    MSG_PLACE_ORDER_BATCH = 7,
+    MSG_CANCEL_ORDER_BATCH = 8,
+    MSG_MODIFY_ORDER = 9
 } ClientMessageType;
 
 // Server -> Client messages
@@ -22,19 +26,56 @@ typedef enum {
     MSG_TRADE_EXECUTED = 104,
     MSG_BOOK_SNAPSHOT = 105,
     MSG_SERVER_STATUS = 106,
-    MSG_ERROR = 107
+    MSG_ERROR = 107,
+    MSG_BATCH_ACK = 108,
+    MSG_ORDER_MODIFIED = 109
 } ServerMessageType;
 
+// Time in force, sent as "time_in_force": "GTC", "IOC" or "FOK". Only GTC
+// orders rest in the book.
+typedef enum {
+    TIME_IN_FORCE_GTC = 0,
+    TIME_IN_FORCE_IOC = 1,
+    TIME_IN_FORCE_FOK = 2
+} TimeInForce;
+
 // Message structure for order placement
 typedef struct {
     char symbol[16];
     char order_id[32];
     char trader_id[32];
-    double price;
+    double price;              // Ignored for market orders
     int quantity;
     bool is_buy;
+    TimeInForce time_in_force; // Optional, GTC by default
+    bool is_market;            // "order_type": "MARKET"; never rests, whatever its time in force
+    int display_quantity;      // Optional iceberg slice size for GTC limit orders, 0 shows everything
 } OrderMessage;
 
+// Orders or cancels in one batch message, all for the same symbol
+#define MAX_BATCH_ORDERS 64
+
+// One entry of a cancel batch
+typedef struct {
+    char order_id[32];
+    bool is_buy;
+} CancelMessage;
+
+// Outcome of one entry of a batch
+typedef struct {
+    char order_id[32];
+    bool accepted;
+    char reason[48];
+} BatchItemResult;
+
+// The single reply to a batch, with one result per entry in request order
+typedef struct {
+    int request_type;          // MSG_PLACE_ORDER_BATCH or MSG_CANCEL_ORDER_BATCH
+    char symbol[16];
+    int count;
+    BatchItemResult results[MAX_BATCH_ORDERS];
+} BatchAck;
+
 // Message structure for trade execution
 typedef struct {
     char symbol[16];
@@ -58,12 +99,48 @@ typedef struct {
     int* ask_quantities;
 } BookSnapshot;
 
+// Latency percentiles for one stage of order handling
+#define MAX_LATENCY_STAGES 8
+
+typedef struct {
+    char stage[16];
+    uint64_t count;
+    double mean_us;
+    double p50_us;
+    double p90_us;
+    double p99_us;
+    double p999_us;
+    double max_us;
+} LatencyStageStats;
+
+// Running total of one kind of server event
+#define MAX_STATUS_COUNTERS 16
+
+typedef struct {
+    char name[24];
+    uint64_t value;
+} StatusCounter;
+
+// Resting orders in one symbol's book
+#define MAX_STATUS_SYMBOLS 100
+
+typedef struct {
+    char symbol[16];
+    int active_orders;
+} SymbolStatus;
+
 // Message structure for server status
 typedef struct {
     bool is_ready;
     int num_connected_clients;
     int num_active_orders;
     int64_t timestamp;
+    int num_latency_stages;
+    LatencyStageStats latency[MAX_LATENCY_STAGES];
+    int num_counters;
+    StatusCounter counters[MAX_STATUS_COUNTERS];
+    int num_symbols;
+    SymbolStatus symbols[MAX_STATUS_SYMBOLS];
 } ServerStatus;
 
 #endif /* PROTOCOL_MESSAGE_TYPES_H */
@@ -0,0 +1,24 @@
+#ifndef SERVER_CHECKPOINTER_H
+#define SERVER_CHECKPOINTER_H
+
+#include "server/server_handlers.h"
+
+// Background thread that periodically saves a book checkpoint, bounding how
+// much journal a restart has to replay (see server_handlers_save_snapshot).
+
+typedef struct Checkpointer Checkpointer;
+
+typedef struct {
+    ServerHandlers* handlers;
+    const char* path;          // Checkpoint file
+    int interval_ms;
+    CpuList cpus;              // CPUs for the checkpoint thread; empty leaves it unpinned
+} CheckpointerConfig;
+
+Checkpointer* checkpointer_create(const CheckpointerConfig* config);
+void checkpointer_destroy(Checkpointer* checkpointer);
+
+int checkpointer_start(Checkpointer* checkpointer);
+int checkpointer_stop(Checkpointer* checkpointer);
+
+#endif /* SERVER_CHECKPOINTER_H */
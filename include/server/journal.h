@@ -0,0 +1,111 @@
+#ifndef SERVER_JOURNAL_H
+#define SERVER_JOURNAL_H
+
+#include "trading_engine/order.h"
+#include "utils/cpu_affinity.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Append-only write-ahead journal of order events. Producers append records
+// to an in-memory batch; a dedicated thread writes each batch to a
+// preallocated segment file and makes it durable with a single fdatasync
+// (group commit). Segments are named journal-<first LSN>.log.
+
+typedef struct Journal Journal;
+
+typedef enum {
+    JOURNAL_EVENT_ORDER = 1,   // Order accepted into a book
+    JOURNAL_EVENT_CANCEL = 2,  // Resting order canceled
+    JOURNAL_EVENT_FILL = 3,    // Match between a buy and a sell order
+    JOURNAL_EVENT_MODIFY = 4   // Resting order given a new price and open quantity
+} JournalEventType;
+
+#define JOURNAL_FLAG_BUY (1u << 0)
+#define JOURNAL_FLAG_IOC (1u << 1)      // Orders only: the order type, see order_can_rest
+#define JOURNAL_FLAG_FOK (1u << 2)
+#define JOURNAL_FLAG_MARKET (1u << 3)
+
+// Fixed-width on-disk record. crc32 covers every byte after itself, so a
+// torn or preallocated (zeroed) record is detected on read.
+typedef struct {
+    uint32_t crc32;
+    uint16_t type;             // JournalEventType
+    uint16_t flags;
+    uint64_t lsn;              // Log sequence number, strictly increasing from 1
+    int64_t timestamp_ns;      // Wall clock at append
+    char symbol[MAX_SYMBOL_LENGTH];
+    char order_id[MAX_ID_LENGTH];       // Buy order ID for fills
+    char counterpart_id[MAX_ID_LENGTH]; // Trader ID for orders, sell order ID for fills
+    double price;
+    uint64_t sequence;         // Priority sequence of the order (orders, and modifies that requeue)
+    int32_t quantity;          // Open quantity for modifies
+    int32_t display_quantity;  // Orders only: iceberg slice size, 0 if fully displayed
+} JournalRecord;
+
+#define JOURNAL_SEGMENT_MAGIC "QTJRNL\0\0"
+#define JOURNAL_VERSION 1
+
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t record_size;
+    uint64_t first_lsn;
+    uint8_t reserved[40];
+} JournalSegmentHeader;
+
+typedef struct {
+    const char* directory;
+    size_t segment_size;       // Bytes preallocated per segment file
+    int group_commit_us;       // Longest a batch waits for more events before it is flushed
+    int max_batch_events;      // A batch this large is flushed immediately
+    bool async_ack;            // Acks do not wait for durability
+    CpuList cpus;              // CPUs for the writer thread; empty leaves it unpinned
+} JournalConfig;
+
+// Constructor and destructor. Creation resumes numbering after the last
+// valid record already in the directory.
+Journal* journal_create(const JournalConfig* config);
+void journal_destroy(Journal* journal);
+
+// Writer thread control. Stopping flushes everything appended so far.
+int journal_start(Journal* journal);
+int journal_stop(Journal* journal);
+
+// Appends an event and returns its LSN (0 on error). Does not block on I/O.
+uint64_t journal_append(Journal* journal, JournalRecord* record);
+uint64_t journal_record_order(Journal* journal, const Order* order);
+// Sets an order's time in force, market flag and display quantity from an order record
+void journal_restore_order_type(const JournalRecord* record, Order* order);
+uint64_t journal_record_cancel(Journal* journal, const char* symbol, const char* order_id,
+                               bool is_buy_order);
+// sequence is the priority the order takes if the modify requeues it
+uint64_t journal_record_modify(Journal* journal, const char* symbol, const char* order_id,
+                               bool is_buy_order, double price, int quantity, uint64_t sequence);
+uint64_t journal_record_fill(Journal* journal, const char* symbol, const char* buy_order_id,
+                             const char* sell_order_id, double price, int quantity);
+
+// Blocks until lsn is durable. Returns immediately in async-ack mode and
+// returns -1 if the journal has failed and lsn can no longer be made durable.
+int journal_wait_durable(Journal* journal, uint64_t lsn);
+// Like journal_wait_durable, but also waits in async-ack mode
+int journal_flush(Journal* journal, uint64_t lsn);
+uint64_t journal_durable_lsn(Journal* journal);
+// LSN of the most recently appended event, durable or not
+uint64_t journal_last_lsn(Journal* journal);
+const char* journal_get_directory(const Journal* journal);
+
+// Deletes segments holding only events at or before lsn, once a checkpoint
+// covers them. The active segment is never deleted. Returns the number removed.
+int journal_truncate(Journal* journal, uint64_t lsn);
+
+// Sequential reader over the segments in a journal directory. Records are
+// returned in LSN order; reading stops at the first torn or corrupt record.
+typedef struct JournalReader JournalReader;
+
+JournalReader* journal_reader_open(const char* directory, uint64_t from_lsn);
+// Returns the next record, valid until the following call, or NULL at the end
+const JournalRecord* journal_reader_next(JournalReader* reader);
+void journal_reader_close(JournalReader* reader);
+
+#endif /* SERVER_JOURNAL_H */
@@ -0,0 +1,54 @@
+#ifndef SERVER_LATENCY_STATS_H
+#define SERVER_LATENCY_STATS_H
+
+#include "protocol/message_types.h"
+#include <stdint.h>
+
+// Where a request's time goes between the socket and its last response.
+// Stages are consecutive, so they add up to the total.
+typedef enum {
+    LATENCY_STAGE_RECEIVE,     // Socket receive until queued for a worker
+    LATENCY_STAGE_QUEUE,       // Waiting in the queue
+    LATENCY_STAGE_DECODE,      // JSON parsing and validation
+    LATENCY_STAGE_MATCH,       // Book work under the book lock
+    LATENCY_STAGE_JOURNAL,     // Waiting for the journal to make the event durable
+    LATENCY_STAGE_SERIALIZE,   // Building responses
+    LATENCY_STAGE_WRITE,       // Handing responses to the socket
+    LATENCY_STAGE_TOTAL,       // Receive until the request is finished
+    LATENCY_STAGE_COUNT
+} LatencyStage;
+
+_Static_assert(LATENCY_STAGE_COUNT <= MAX_LATENCY_STAGES, "Too many latency stages");
+
+typedef struct LatencyStats LatencyStats;
+
+// Timing of one request, kept on the handling thread's stack
+typedef struct {
+    int64_t received_ns;
+    int64_t last_ns;
+    int64_t stage_ns[LATENCY_STAGE_COUNT];
+    uint32_t stages_seen;      // Bit per stage
+} RequestTimer;
+
+LatencyStats* latency_stats_create(void);
+void latency_stats_destroy(LatencyStats* stats);
+
+const char* latency_stage_name(LatencyStage stage);
+
+void request_timer_start(RequestTimer* timer, int64_t received_ns);
+// Charges the time since the previous mark to stage. Stages may be marked
+// more than once per request; their times add up.
+void request_timer_mark(RequestTimer* timer, LatencyStage stage);
+void request_timer_mark_at(RequestTimer* timer, LatencyStage stage, int64_t now_ns);
+
+// Allocates the calling worker's histogram shards ahead of its first request
+void latency_stats_prepare_thread(LatencyStats* stats);
+
+// Records every stage the request passed through, plus its total
+void latency_stats_record(LatencyStats* stats, const RequestTimer* timer);
+
+// Fills one entry per stage and returns the number filled
+int latency_stats_summarize(const LatencyStats* stats, LatencyStageStats* out, int max_stages);
+void latency_stats_log(const LatencyStats* stats);
+
+#endif /* SERVER_LATENCY_STATS_H */
@@ -4,6 +4,7 @@
 #include "trading_engine/order_book.h"
 #include "protocol/message_types.h"
 #include "trading_engine/trade_broadcaster.h"
+#include "utils/cpu_affinity.h"
 #include <pthread.h>
 
 typedef struct MarketData MarketData;
@@ -13,6 +14,7 @@ typedef struct {
     int max_depth;
     int max_symbols;
     TradeBroadcaster* trade_broadcaster;
+    CpuList cpus;              // CPUs for the snapshot thread; empty leaves it unpinned
 } MarketDataConfig;
 
 MarketData* market_data_create(const MarketDataConfig* config);
@@ -2,6 +2,9 @@
 #define SERVER_HANDLERS_H
 
 #include "ws_server.h"
+#include "journal.h"
+#include "latency_stats.h"
+#include "server_metrics.h"
 #include "trading_engine/order.h"
 #include "trading_engine/order_book.h"
 #include "protocol/message_types.h"
@@ -16,6 +19,13 @@ typedef struct {
     int max_message_size;
     int message_queue_size;
     TradeBroadcaster* trade_broadcaster;
+    Journal* journal;          // Optional; when set, order events are journaled before they are acked
+    WSServer* ws_server;       // Optional; reports connected clients in status replies
+    ServerMetrics* metrics;    // Optional; counts orders, acks, trades, cancels, rejects and queue drops
+    CpuList worker_cpus;       // Worker i is pinned to worker_cpus[i % count]; empty leaves them unpinned
+    bool busy_poll;            // Idle workers spin on the queue instead of sleeping on its condvar
+    int busy_poll_idle_us;     // How long an idle worker spins before it sleeps; 0 never sleeps
+    RateLimit trader_limit;    // Messages accepted per trader_id across all connections
 } HandlerConfig;
 
 // Message handler function type
@@ -24,7 +34,15 @@ typedef int (*MessageHandler)(ServerHandlers* handlers, WSClient* client, const
 // Handler functions
 int handle_place_order(ServerHandlers* handlers, WSClient* client, const cJSON* root, char* response);
 int handle_cancel_order(ServerHandlers* handlers, WSClient* client, const cJSON* root, char* response);
+// Cancel-replace in one step: "quantity" is the new open quantity. Lowering
+// it at the same price keeps time priority; any other change requeues.
+int handle_modify_order(ServerHandlers* handlers, WSClient* client, const cJSON* root, char* response);
 int handle_book_request(ServerHandlers* handlers, WSClient* client, const cJSON* root, char* response);
+int handle_status_request(ServerHandlers* handlers, WSClient* client, const cJSON* root, char* response);
+// Batches apply every entry under a single hold of the book lock, wait once
+// for the journal and answer with one MSG_BATCH_ACK
+int handle_place_order_batch(ServerHandlers* handlers, WSClient* client, const cJSON* root, char* response);
+int handle_cancel_order_batch(ServerHandlers* handlers, WSClient* client, const cJSON* root, char* response);
 
 // Constructor/Destructor
 ServerHandlers* server_handlers_create(const HandlerConfig* config);
@@ -32,20 +50,41 @@ void server_handlers_destroy(ServerHandlers* handlers);
 
 // Message handling
 int server_handlers_process_message(ServerHandlers* handlers, WSClient* client, const char* message, size_t len);
+// Replies that the client is over its rate limit, without queueing anything
+void server_handlers_reject_throttled(ServerHandlers* handlers, WSClient* client);
 int server_handlers_broadcast_trade(ServerHandlers* handlers, const TradeMessage* trade);
 int server_handlers_broadcast_status(ServerHandlers* handlers, const ServerStatus* status);
 
 // Order book management 
-int server_handlers_add_order_book(ServerHandlers* handlers, const char* symbol);
+// config selects the book backend for the symbol; NULL uses the default AVL book
+int server_handlers_add_order_book(ServerHandlers* handlers, const char* symbol,
+                                   const OrderBookConfig* config);
 OrderBook* server_handlers_get_order_book(ServerHandlers* handlers, const char* symbol);
 int server_handlers_remove_order_book(ServerHandlers* handlers, const char* symbol);
 
+// Book persistence (see trading_engine/book_snapshot.h). Saving captures the
+// books under a brief write lock and, with a journal, tags the snapshot with
+// the last journaled LSN and then drops journal segments it covers. Recovery
+// loads the snapshot (if the file exists) and replays the journal after it;
+// it must run before the journal is started. Recovered symbols without a
+// registered book get a default AVL book.
+int server_handlers_save_snapshot(ServerHandlers* handlers, const char* path);
+int server_handlers_recover(ServerHandlers* handlers, const char* snapshot_path);
+
 // Thread pool control
 int server_handlers_start_workers(ServerHandlers* handlers);
 int server_handlers_stop_workers(ServerHandlers* handlers);
 
+// Logs per-stage request latency percentiles since startup
+void server_handlers_log_latency(ServerHandlers* handlers);
+
+// Fills status with counters, resting orders per symbol and latency.
+// Never takes a book lock, so it is cheap enough to poll.
+void server_handlers_get_status(ServerHandlers* handlers, ServerStatus* status);
+
 // Helper functions
 int send_error_response(WSClient* client, const char* error_msg, char* response);
-char* dequeue_message(ServerHandlers* handlers, WSClient** client);
+// timer may be NULL; otherwise it is started at the message's receive time
+char* dequeue_message(ServerHandlers* handlers, WSClient** client, RequestTimer* timer);
 
 #endif /* SERVER_HANDLERS_H */
@@ -0,0 +1,51 @@
+#ifndef SERVER_METRICS_H
+#define SERVER_METRICS_H
+
+#include "protocol/message_types.h"
+#include <stdint.h>
+
+// Run-time event counters. Every thread adds into its own cache-line sized
+// shard with relaxed atomics, so updating a counter never takes a lock or
+// bounces a line between cores; readers sum the shards on demand. A shard
+// is allocated by the thread that owns it, so it lives on that thread's
+// NUMA node.
+typedef enum {
+    METRIC_ORDERS_IN,          // Place requests received
+    METRIC_ACKS_OUT,           // Order, cancel and modify acks sent
+    METRIC_TRADES,             // Fills
+    METRIC_CANCELS,            // Orders canceled
+    METRIC_MODIFIES,           // Orders repriced or resized in place
+    METRIC_REJECTS,            // Error replies
+    METRIC_QUEUE_FULL_DROPS,   // Messages dropped because the worker queue was full
+    METRIC_BYTES_IN,
+    METRIC_BYTES_OUT,
+    METRIC_CONNECTIONS_REFUSED, // Connections turned away by admission control
+    METRIC_THROTTLED_CONNECTION, // Messages rejected by a connection's rate limit
+    METRIC_THROTTLED_TRADER,   // Messages rejected by a trader's rate limit
+    METRIC_COUNT
+} MetricCounter;
+
+_Static_assert(METRIC_COUNT <= MAX_STATUS_COUNTERS, "Too many metric counters");
+
+typedef struct ServerMetrics ServerMetrics;
+
+ServerMetrics* server_metrics_create(void);
+void server_metrics_destroy(ServerMetrics* metrics);
+
+const char* server_metric_name(MetricCounter counter);
+
+// NULL metrics are ignored, so callers need not check whether metrics are enabled
+void server_metrics_add(ServerMetrics* metrics, MetricCounter counter, uint64_t amount);
+// Allocates the calling thread's shard now rather than on its first update
+void server_metrics_prepare_thread(ServerMetrics* metrics);
+
+// Sums the shards. Concurrent updates may or may not be included.
+uint64_t server_metrics_read(const ServerMetrics* metrics, MetricCounter counter);
+// Fills one entry per counter and returns the number filled
+int server_metrics_summarize(const ServerMetrics* metrics, StatusCounter* out, int max_counters);
+
+// Renders a status in the Prometheus text exposition format. Returns a
+// malloc'd string the caller frees, or NULL.
+char* server_metrics_format_text(const ServerStatus* status);
+
+#endif /* SERVER_METRICS_H */
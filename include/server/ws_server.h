@@ -4,6 +4,9 @@
 #include <stdbool.h>
 #include <stdint.h>
 #include <stddef.h>
+#include "server_metrics.h"
+#include "utils/cpu_affinity.h"
+#include "utils/rate_limiter.h"
 
 typedef struct WSServer WSServer;
 typedef struct WSClient WSClient;
@@ -12,9 +15,20 @@ typedef struct WSClient WSClient;
 typedef struct {
     const char* host;
     int port;
-    int max_clients;
+    int max_clients;           // Connections beyond this are refused; sizes the client table
+    int max_clients_per_ip;    // 0 for no per-address limit
+    int shed_queued_messages;  // Refuse connections while this many sends await writing; 0 never sheds
+    RateLimit client_limit;    // Messages accepted per connection; over-limit messages go to the throttle callback
+    int max_message_size;      // Largest message after reassembly; bigger ones close the connection. 0 means 64KB
+    int max_in_flight;         // Reads from a connection pause while this many of its messages are unfinished; 0 never pauses
     int ping_interval_ms;
     int status_interval_ms;
+    ServerMetrics* metrics;    // Optional; counts bytes in and out
+    int metrics_port;          // When > 0, serves GET /metrics over plain HTTP on this port
+    int service_threads;       // lws service threads sharing the connections; 0 means one
+    CpuList service_cpus;      // CPUs for the service threads; with several threads each gets its own
+    bool busy_poll;            // Poll sockets without blocking, burning the service core
+    int busy_poll_idle_us;     // Busy polling blocks again after this long without traffic; 0 never blocks
 } WSServerConfig;
 
 // Client connection info
@@ -40,9 +54,22 @@ void ws_server_destroy(WSServer* server);
 // Broadcast message to all clients
 int ws_server_broadcast(WSServer* server, const char* message, size_t len);
 
-// Send message to specific client
+// Send message to specific client. Safe from any thread: the message is
+// queued on the client and written by the service thread that owns it.
+// Returns -1 if the client has disconnected or its queue is full.
 int ws_server_send(WSClient* client, const char* message, size_t len);
 
+// Marks a message passed to the message callback as finished, whether it
+// was handled or rejected. Required once per message when max_in_flight is
+// set; a paused connection resumes reading once half its budget is free.
+void ws_server_message_done(WSClient* client);
+
+// A client stays valid until its connection closes. A thread that holds on
+// to one past the callback it was passed to, such as a worker queue, takes
+// a reference and releases it when done.
+void ws_server_client_retain(WSClient* client);
+void ws_server_client_release(WSClient* client);
+
 // Get client info
 const WSClientInfo* ws_server_get_client_info(const WSClient* client);
 
@@ -52,11 +79,19 @@ int ws_server_get_client_count(const WSServer* server);
 // Callback types
 typedef void (*ClientConnectCallback)(WSClient* client, void* user_data);
 typedef void (*ClientDisconnectCallback)(WSClient* client, void* user_data);
+// message is a complete, reassembled text message. It is not NUL-terminated
+// and is only valid until the callback returns.
 typedef void (*MessageCallback)(WSClient* client, const char* message, size_t len, void* user_data);
+// A message over the connection's rate limit, dropped before the message callback
+typedef void (*ThrottleCallback)(WSClient* client, void* user_data);
+// Returns the /metrics page as a malloc'd string, or NULL. Runs on a service thread.
+typedef char* (*MetricsPageCallback)(void* user_data);
 
 // Set callbacks
 void ws_server_set_connect_callback(WSServer* server, ClientConnectCallback callback, void* user_data);
 void ws_server_set_disconnect_callback(WSServer* server, ClientDisconnectCallback callback, void* user_data);
 void ws_server_set_message_callback(WSServer* server, MessageCallback callback, void* user_data);
+void ws_server_set_metrics_callback(WSServer* server, MetricsPageCallback callback, void* user_data);
+void ws_server_set_throttle_callback(WSServer* server, ThrottleCallback callback, void* user_data);
 
 #endif /* SERVER_WS_SERVER_H */
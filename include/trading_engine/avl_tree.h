@@ -3,13 +3,22 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include <stddef.h>
 
 // Forward declaration for Order
 struct Order;
 
+#define AVL_NODE_CANCELED (1u << 0)
+#define AVL_NODE_ICEBERG  (1u << 1)   // The order has a hidden reserve
+
+// The key and a hot copy of the order's matching state share the node's
+// first 32 bytes, so the matcher decides crossing and skips canceled orders
+// without touching the Order; it is only dereferenced on a fill.
 typedef struct AVLNode {
     double price;
-    int64_t timestamp;
+    uint64_t sequence;
+    int32_t remaining_quantity;
+    uint32_t flags;
     struct Order* order;
     struct AVLNode* left;
     struct AVLNode* right;
@@ -24,21 +33,33 @@ typedef struct AVLTree {
 // Tree operations
 AVLTree* avl_create(bool is_buy_tree);
 void avl_destroy(AVLTree* tree);
-void avl_insert(AVLTree* tree, double price, int64_t timestamp, struct Order* order);
+void avl_insert(AVLTree* tree, double price, uint64_t sequence, struct Order* order);
+// Merges orders sorted by ascending price then ascending sequence into the
+// tree and rebuilds it balanced in one pass, O(existing + n). Returns the
+// number inserted, or -1 with the tree unchanged. On return orders[0,
+// inserted) were inserted, in input order, and the rest were rejected for
+// repeating the price and sequence of a node in the tree or earlier in the batch.
+int avl_insert_sorted(AVLTree* tree, struct Order** orders, size_t n);
 struct Order* avl_find_min(const AVLTree* tree);
 struct Order* avl_find_max(const AVLTree* tree);
-void avl_delete_order(AVLTree* tree, double price, int64_t timestamp);
-bool avl_contains(const AVLTree* tree, double price, int64_t timestamp);
+// Node of the best order: the maximum of a buy tree, the minimum of a sell tree
+AVLNode* avl_best_node(const AVLTree* tree);
+AVLNode* avl_find_node(const AVLTree* tree, double price, uint64_t sequence);
+void avl_delete_order(AVLTree* tree, double price, uint64_t sequence);
+bool avl_contains(const AVLTree* tree, double price, uint64_t sequence);
 bool avl_is_empty(const AVLTree* tree);
-int compare_nodes(double price1, int64_t timestamp1,
-                  double price2, int64_t timestamp2,
+int compare_nodes(double price1, uint64_t sequence1,
+                  double price2, uint64_t sequence2,
                   bool is_buy_tree);
 
 // Helper functions for traversal
 typedef void (*TraversalCallback)(struct Order* order, void* user_data);
 void avl_inorder_traverse(const AVLTree* tree, TraversalCallback callback, void* user_data);
+// Visits orders in matching priority (best price first), stopping as soon as visit returns false
+typedef bool (*AVLVisitor)(const AVLNode* node, void* user_data);
+void avl_visit_best_first(const AVLTree* tree, AVLVisitor visit, void* user_data);
 
 // Delete operation
-void avl_delete_order(AVLTree* tree, double price, int64_t timestamp);
+void avl_delete_order(AVLTree* tree, double price, uint64_t sequence);
 
 #endif /* AVL_TREE_H */
@@ -0,0 +1,86 @@
+#ifndef TRADING_ENGINE_BOOK_SNAPSHOT_H
+#define TRADING_ENGINE_BOOK_SNAPSHOT_H
+
+#include "order_book.h"
+#include "order.h"
+#include <stdint.h>
+#include <stddef.h>
+
+// Binary snapshot of resting orders, one section per symbol:
+//
+//   SnapshotHeader
+//   SnapshotSection, SnapshotRecord[order_count]   (repeated section_count times)
+//
+// Records are fixed width and are read in place from the mapped file. Each
+// section carries a CRC-32 of its records. Integers are host byte order.
+// Files of any other version are rejected.
+#define SNAPSHOT_MAGIC "QTBOOKS\0"
+#define SNAPSHOT_VERSION 1
+
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t section_count;
+    uint64_t next_sequence;    // Sequence counter when the snapshot was taken
+    int64_t created_at;        // Wall clock seconds
+    uint64_t journal_lsn;      // Last journal event reflected in the books, 0 without a journal
+    uint8_t reserved[24];
+} SnapshotHeader;
+
+typedef struct {
+    char symbol[MAX_SYMBOL_LENGTH];
+    uint64_t order_count;
+    uint32_t crc32;            // Over the section's records
+    uint32_t reserved;
+} SnapshotSection;
+
+#define SNAPSHOT_RECORD_BUY (1u << 0)
+
+typedef struct {
+    char order_id[MAX_ID_LENGTH];
+    char trader_id[MAX_ID_LENGTH];
+    double price;
+    uint64_t sequence;
+    int32_t quantity;
+    int32_t remaining_quantity;     // Displayed part of the open quantity
+    uint32_t flags;
+    int32_t display_quantity;
+    int32_t hidden_quantity;
+    uint32_t reserved;
+} SnapshotRecord;
+
+// A book to be written together with its symbol
+typedef struct {
+    const char* symbol;
+    const OrderBook* book;
+} SnapshotBook;
+
+// Returns the book that restored orders for symbol should go into, or NULL to skip the section
+typedef OrderBook* (*SnapshotBookResolver)(const char* symbol, void* user_data);
+
+// In-memory copy of the live resting orders of a set of books. Capturing is
+// the only step that reads the books, so callers can exclude writers just
+// for the capture and do the file I/O afterwards.
+typedef struct SnapshotImage SnapshotImage;
+
+SnapshotImage* order_book_capture_snapshot(const SnapshotBook* books, size_t count,
+                                           uint64_t journal_lsn);
+// The file is written beside path and renamed into place, so a crash never
+// leaves a torn snapshot
+int snapshot_image_write(const SnapshotImage* image, const char* path);
+void snapshot_image_destroy(SnapshotImage* image);
+
+// Captures and writes in one step
+int order_book_save_snapshot(const char* path, const SnapshotBook* books, size_t count,
+                             uint64_t journal_lsn);
+
+// Restores a snapshot, keeping each order's original sequence so time priority
+// survives the restart. Returns the number of orders restored, or -1 if the
+// file is missing, truncated or fails its checksum (in which case no book is touched).
+// Restored orders are adopted by their book (see order_book_adopt_order),
+// which frees them as they leave it or when it is destroyed.
+// journal_lsn, if not NULL, receives the LSN the snapshot was taken at.
+int order_book_load_snapshot(const char* path, SnapshotBookResolver resolver, void* user_data,
+                             uint64_t* journal_lsn);
+
+#endif /* TRADING_ENGINE_BOOK_SNAPSHOT_H */
@@ -0,0 +1,42 @@
+#ifndef TRADING_ENGINE_ID_INTERN_H
+#define TRADING_ENGINE_ID_INTERN_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// Client-supplied order and trader IDs are interned once on ingress and
+// carried through the engine as 64-bit handles. Handles are reference
+// counted: each id_intern() takes a reference that its owner drops with
+// id_intern_release(). An ID with no references left is removed and its
+// handle reused, so the table holds only the IDs still in use.
+typedef uint64_t IdHandle;
+
+#define ID_HANDLE_INVALID 0
+
+// Returns the handle for id with a new reference, adding it to the table if
+// needed (ID_HANDLE_INVALID on error)
+IdHandle id_intern(const char* id);
+
+// Interns n IDs under a single acquisition of the table lock, for callers
+// that would otherwise contend on it per ID. Returns 0, or -1 with no
+// references taken.
+int id_intern_many(const char* const* ids, size_t n, IdHandle* handles);
+
+// Drops a reference taken by id_intern(). Releasing ID_HANDLE_INVALID is a no-op.
+void id_intern_release(IdHandle handle);
+
+// Returns the handle for id without taking a reference (ID_HANDLE_INVALID if
+// not interned). Only meaningful while someone else holds a reference.
+IdHandle id_intern_find(const char* id);
+
+// Returns the interned string for a handle the caller holds a reference to
+// (NULL for invalid handles). Lock-free.
+const char* id_intern_str(IdHandle handle);
+
+// Number of IDs currently interned
+size_t id_intern_count(void);
+
+// Releases every interned ID. Only safe once no engine structure holds a handle.
+void id_intern_reset(void);
+
+#endif /* TRADING_ENGINE_ID_INTERN_H */
@@ -4,20 +4,51 @@
 #include <time.h>
 #include <stdbool.h>
 #include <stdint.h>
+#include <stddef.h>
+#include "id_intern.h"
 
 #define MAX_ID_LENGTH 64
 #define MAX_SYMBOL_LENGTH 16
 
+// How long an order may rest. Orders that may not rest never enter a book;
+// they trade against it in a single pass and whatever is left is dropped.
+typedef enum {
+    ORDER_TIF_GTC = 0,         // Rests until filled or canceled
+    ORDER_TIF_IOC = 1,         // Fills what it can at once
+    ORDER_TIF_FOK = 2          // Fills in full at once or not at all
+} OrderTimeInForce;
+
+// Fields read by the matcher come first so they share the first cache line.
+// Both backends also keep a hot copy of the matching state beside their keys
+// (OrderSlot in price_ladder.h, AVLNode in avl_tree.h) and leave the Order
+// alone until a fill. Order and trader IDs are interned handles;
+// order_get_id() maps back to the string.
+//
+// An iceberg order shows display_quantity at a time: remaining_quantity is
+// the displayed slice and hidden_quantity the reserve behind it. When a
+// slice is used up the next one is shown and the order goes to the back of
+// its price level. Orders with display_quantity 0 show everything.
+//
+// Time priority comes from sequence, which is unique and strictly increasing
+// across the process. timestamp is CLOCK_MONOTONIC_RAW nanoseconds at creation
+// and is only used for latency accounting.
 typedef struct Order {
-    char order_id[MAX_ID_LENGTH];
-    char trader_id[MAX_ID_LENGTH];
-    char symbol[MAX_SYMBOL_LENGTH];
     double price;
+    uint64_t sequence;
     int quantity;
     int remaining_quantity;
     bool is_buy_order;
-    int64_t timestamp;
     bool is_canceled;
+    uint8_t time_in_force;     // OrderTimeInForce
+    bool is_market;            // Takes any price; price is ignored and the order never rests
+    bool owned_by_book;        // Freed by its book once it leaves, see order_book_adopt_order
+    int display_quantity;      // Iceberg slice size, 0 for a fully displayed order
+    int hidden_quantity;       // Iceberg reserve not yet displayed
+    uint32_t ladder_ticket;    // Dense backend: where the order's slot sits in its level
+    IdHandle order_handle;
+    IdHandle trader_handle;
+    int64_t timestamp;
+    char symbol[MAX_SYMBOL_LENGTH];
 } Order;
 
 // Constructor and destructor
@@ -27,6 +58,15 @@ Order* order_create(const char* order_id,
                    double price,
                    int quantity,
                    bool is_buy_order);
+// Creates an order from IDs the caller has already interned, taking over its
+// reference to each handle (released again on failure). Does not log, for
+// bulk loaders that intern a batch of IDs at once.
+Order* order_create_interned(IdHandle order_handle,
+                             IdHandle trader_handle,
+                             const char* symbol,
+                             double price,
+                             int quantity,
+                             bool is_buy_order);
 void order_destroy(Order* order);
 
 // Getters
@@ -36,15 +76,37 @@ const char* order_get_symbol(const Order* order);
 double order_get_price(const Order* order);
 int order_get_quantity(const Order* order);
 int order_get_remaining_quantity(const Order* order);
+// Displayed and hidden quantity together
+int order_get_open_quantity(const Order* order);
 bool order_is_buy_order(const Order* order);
 int64_t order_get_timestamp(const Order* order);
+uint64_t order_get_sequence(const Order* order);
 bool order_is_canceled(const Order* order);
+// False for IOC, FOK and market orders
+bool order_can_rest(const Order* order);
 
 // Setters
 void order_set_price(Order* order, double new_price);
 int order_set_quantity(Order* order, int new_quantity);
 int order_reduce_quantity(Order* order, int amount);
 void order_cancel(Order* order);
+// Makes a resting order an iceberg showing display_quantity at a time; 0
+// displays everything. Call before the order enters a book.
+int order_set_display_quantity(Order* order, int display_quantity);
+// Shows the next slice once the displayed one is used up. Returns false if
+// there is nothing left to show.
+bool order_replenish(Order* order);
+
+// Next priority sequence number (the first one issued is 1)
+uint64_t order_next_sequence(void);
+// Reserves n consecutive sequence numbers and returns the first
+uint64_t order_reserve_sequences(size_t n);
+// Ensures the next sequence issued is at least next (used after restoring orders)
+void order_advance_sequence(uint64_t next);
+// Makes next the next sequence issued, even if it is lower. Journal replay
+// uses it so the iceberg slices replenished while matching an event get the
+// sequences the original run gave them.
+void order_restart_sequence(uint64_t next);
 
 // Comparison functions
 bool order_equals(const Order* order1, const Order* order2);
@@ -2,26 +2,86 @@
 #define ORDER_BOOK_H
 
 #include "avl_tree.h"
+#include "order_index.h"
+#include "price_ladder.h"
 #include "trade_broadcaster.h"
 #include <stdbool.h>
 
+// Storage used for resting orders
+typedef enum {
+    ORDER_BOOK_BACKEND_AVL,    // Pointer-linked AVL trees, any price
+    ORDER_BOOK_BACKEND_DENSE   // Flat array of tick levels, for instruments trading in a narrow band
+} OrderBookBackend;
+
+typedef struct {
+    OrderBookBackend backend;
+    double tick_size;          // Dense backend only
+    int num_levels;            // Dense backend only: initial width of the price window in ticks
+    TradeBroadcaster* trade_broadcaster;
+} OrderBookConfig;
+
+// Invoked for every fill, after both orders have been reduced
+typedef void (*OrderBookTradeCallback)(const struct Order* buy_order, const struct Order* sell_order,
+                                       double price, int quantity, void* user_data);
+
 typedef struct OrderBook {
+    OrderBookBackend backend;
     AVLTree* buy_orders;
     AVLTree* sell_orders;
+    PriceLadder* buy_levels;
+    PriceLadder* sell_levels;
+    OrderIndex* orders_by_id;  // Live (uncanceled) resting orders by ID handle
+    size_t adopted_orders;     // Orders in the book that it frees, see order_book_adopt_order
     TradeBroadcaster* trade_broadcaster;
+    OrderBookTradeCallback on_trade;
+    void* trade_callback_data;
 } OrderBook;
 
 // Constructor and destructor
 OrderBook* order_book_create(TradeBroadcaster* broadcaster);
+OrderBook* order_book_create_with_config(const OrderBookConfig* config);
 void order_book_destroy(OrderBook* book);
+void order_book_set_trade_callback(OrderBook* book, OrderBookTradeCallback callback, void* user_data);
 
-// Order operations
+// Order operations. Only orders that can rest (see order_can_rest) are added.
+// An iceberg trades one displayed slice at a time; when a slice is used up
+// the book shows the next one behind the orders already at its price.
 int order_book_add_order(OrderBook* book, struct Order* order);
+// Adds a batch in one sorted pass and returns the number of orders added, or -1.
+// On return orders[0, added) are in the book and the remaining non-NULL entries
+// were rejected (duplicate live ID, off-tick price) and still belong to the caller.
+int order_book_add_orders_bulk(OrderBook* book, struct Order** orders, size_t n);
+// Hands ownership of an order added with order_book_add_order to the book,
+// which then frees it when it leaves the book (filled, or canceled and
+// dropped by the matcher) or with the book. An order that has already left,
+// such as one filled by the match after its add, is freed at once. Books
+// that never adopt leave all orders with the caller; a book that does must
+// not be left holding caller-owned orders that are freed before it is.
+void order_book_adopt_order(OrderBook* book, struct Order* order);
 void order_book_match_orders(OrderBook* book);
+// Trades an IOC, FOK or market order against the opposite side in a single
+// pass; the order never enters the book and the caller keeps ownership. A
+// FOK order first checks, without changing anything, that its whole
+// quantity is available within its limit. Whatever is left unfilled is
+// canceled. Icebergs are refused since they only make sense resting.
+// Returns the quantity filled, or -1 if the order was refused.
+int order_book_execute_order(OrderBook* book, struct Order* order);
+// True if order_book_execute_order would take the order rather than refuse
+// it. A killed FOK order is taken, with nothing filled.
+bool order_book_can_execute(const OrderBook* book, const struct Order* order);
 int order_book_cancel_order(OrderBook* book, const char* order_id, bool is_buy_order);
+// Cancel-replace of a live resting order, applied to the order in place.
+// new_quantity is the new open quantity, hidden reserve included. Lowering
+// it at the same price keeps the order's place in the queue; a new price or
+// a larger quantity requeues it behind the orders resting at its price with
+// sequence as its new priority. Nothing changes on failure. Does not match; callers match
+// afterwards since a new price may cross.
+int order_book_modify_order(OrderBook* book, const char* order_id, bool is_buy_order,
+                            double new_price, int new_quantity, uint64_t sequence);
 
-// Query operations
+// Query operations. Only displayed quantity is counted.
 int order_book_get_quantity_at_price(const OrderBook* book, double price, bool is_buy_order);
+// True unless the order is resting uncanceled on the given side
 bool order_book_is_order_canceled(const OrderBook* book, const char* order_id, bool is_buy_order);
 
 // Traversal callbacks
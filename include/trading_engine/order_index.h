@@ -0,0 +1,31 @@
+#ifndef TRADING_ENGINE_ORDER_INDEX_H
+#define TRADING_ENGINE_ORDER_INDEX_H
+
+#include "id_intern.h"
+#include <stddef.h>
+
+// Forward declaration for Order
+struct Order;
+
+typedef struct OrderIndexEntry {
+    IdHandle handle;
+    struct Order* order;
+} OrderIndexEntry;
+
+// Open-addressing map from order ID handle to resting order
+typedef struct OrderIndex {
+    OrderIndexEntry* entries;
+    size_t capacity;
+    size_t count;
+} OrderIndex;
+
+OrderIndex* order_index_create(size_t initial_capacity);
+void order_index_destroy(OrderIndex* index);
+
+// Returns -1 if the handle is already present
+int order_index_insert(OrderIndex* index, IdHandle handle, struct Order* order);
+struct Order* order_index_find(const OrderIndex* index, IdHandle handle);
+void order_index_remove(OrderIndex* index, IdHandle handle);
+size_t order_index_count(const OrderIndex* index);
+
+#endif /* TRADING_ENGINE_ORDER_INDEX_H */
@@ -0,0 +1,80 @@
+#ifndef TRADING_ENGINE_PRICE_LADDER_H
+#define TRADING_ENGINE_PRICE_LADDER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Forward declaration for Order
+struct Order;
+
+#define ORDER_SLOT_BUY      (1u << 0)
+#define ORDER_SLOT_CANCELED (1u << 1)
+#define ORDER_SLOT_ICEBERG  (1u << 2)   // The order has a hidden reserve
+
+// Hot per-order record kept contiguously in its level queue. The matcher
+// works from these and only dereferences the Order on a fill.
+typedef struct OrderSlot {
+    int64_t price_tick;
+    uint64_t sequence;
+    int32_t remaining_quantity;
+    uint32_t flags;
+    struct Order* order;
+} OrderSlot;
+
+// FIFO queue of resting orders at a single tick. Each order records the
+// ticket of its slot; a slot at index i has ticket i + shift, and shift
+// grows as compaction moves the queue down, so tickets stay valid.
+typedef struct PriceLevel {
+    OrderSlot* slots;
+    int head;
+    int tail;
+    int capacity;
+    uint32_t shift;
+} PriceLevel;
+
+// Dense array of price levels indexed by (price_tick - base_tick).
+// A bitmap of non-empty levels lets the best level be found with bit scans.
+// summary has a bit per non-zero bitmap word and top a bit per non-zero
+// summary word, so the search never walks the whole bitmap.
+typedef struct PriceLadder {
+    PriceLevel* levels;
+    uint64_t* bitmap;
+    uint64_t* summary;
+    uint64_t* top;
+    int num_levels;          // Always a multiple of 64
+    int64_t base_tick;
+    double tick_size;
+    bool is_buy_ladder;      // True for buy orders (best = highest), False for sell orders (best = lowest)
+    int order_count;
+} PriceLadder;
+
+// Ladder operations
+PriceLadder* price_ladder_create(bool is_buy_ladder, double tick_size, int num_levels);
+void price_ladder_destroy(PriceLadder* ladder);
+int price_ladder_insert(PriceLadder* ladder, struct Order* order);
+OrderSlot* price_ladder_best_slot(const PriceLadder* ladder);
+struct Order* price_ladder_best(const PriceLadder* ladder);
+void price_ladder_pop_best(PriceLadder* ladder);
+// Moves the best slot to the back of its level with the order's current
+// sequence and remaining quantity, in amortized O(1)
+int price_ladder_requeue_best(PriceLadder* ladder);
+// Finds the order's slot through its ticket, in O(1)
+OrderSlot* price_ladder_find(const PriceLadder* ladder, const struct Order* order);
+// Leaves a canceled slot that no longer refers to its order, so the order
+// can queue elsewhere; the slot is dropped once it reaches the front
+void price_ladder_discard(OrderSlot* slot);
+bool price_ladder_is_empty(const PriceLadder* ladder);
+int price_ladder_quantity_at(const PriceLadder* ladder, int64_t tick);
+// Live quantity, hidden reserves included, at ticks no worse than limit_tick
+// (any tick without a limit), summed best level first and stopping once
+// wanted is reached
+int price_ladder_available(const PriceLadder* ladder, bool has_limit, int64_t limit_tick, int wanted);
+
+// Tick conversion
+bool price_ladder_to_tick(const PriceLadder* ladder, double price, int64_t* tick);
+
+// Traversal in ascending price order, FIFO within a level
+typedef void (*LadderCallback)(struct Order* order, void* user_data);
+void price_ladder_traverse(const PriceLadder* ladder, LadderCallback callback, void* user_data);
+
+#endif /* TRADING_ENGINE_PRICE_LADDER_H */
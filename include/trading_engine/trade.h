@@ -2,6 +2,7 @@
 #define TRADE_H
 
 #include <stddef.h>
+#include "id_intern.h"
 
 #define MAX_ORDER_ID_LENGTH 64
 
@@ -9,8 +10,8 @@
 struct Trader;
 
 typedef struct Trade {
-    char buy_order_id[MAX_ORDER_ID_LENGTH];
-    char sell_order_id[MAX_ORDER_ID_LENGTH];
+    IdHandle buy_order;
+    IdHandle sell_order;
     double trade_price;
     int trade_quantity;
 } Trade;
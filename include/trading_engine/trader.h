@@ -1,6 +1,8 @@
 #ifndef TRADER_H
 #define TRADER_H
 
+#include "id_intern.h"
+
 #define MAX_TRADER_ID_LENGTH 64
 #define MAX_TRADER_NAME_LENGTH 128
 
@@ -9,7 +11,7 @@ struct Order;
 struct OrderBook;
 
 typedef struct Trader {
-    char trader_id[MAX_TRADER_ID_LENGTH];
+    IdHandle trader_handle;
     char name[MAX_TRADER_NAME_LENGTH];
     double balance;
 } Trader;
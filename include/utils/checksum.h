@@ -0,0 +1,11 @@
+#ifndef QUANT_TRADING_CHECKSUM_H
+#define QUANT_TRADING_CHECKSUM_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// CRC-32 (IEEE 802.3, reflected, as used by zlib). Pass 0 to start and
+// feed the previous result back in to checksum data in pieces.
+uint32_t crc32_update(uint32_t crc, const void* data, size_t len);
+
+#endif // QUANT_TRADING_CHECKSUM_H
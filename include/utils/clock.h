@@ -0,0 +1,15 @@
+#ifndef QUANT_TRADING_CLOCK_H
+#define QUANT_TRADING_CLOCK_H
+
+#include <stdint.h>
+#include <time.h>
+
+// Nanoseconds from a raw monotonic clock, for latency accounting only.
+// Not related to wall time and not adjusted by NTP.
+static inline int64_t clock_now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC_RAW, &ts);
+    return (int64_t)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+#endif // QUANT_TRADING_CLOCK_H
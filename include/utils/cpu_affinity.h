@@ -0,0 +1,39 @@
+#ifndef QUANT_TRADING_CPU_AFFINITY_H
+#define QUANT_TRADING_CPU_AFFINITY_H
+
+#include <pthread.h>
+
+// Thread placement. A thread created with a CPU list in its attributes
+// starts on those CPUs, so everything it touches first (its stack, shards
+// it allocates) lands on that CPU's NUMA node under the kernel's default
+// first-touch policy. An empty list leaves placement to the scheduler.
+
+#define MAX_CPU_LIST 64
+
+typedef struct {
+    int count;
+    int cpus[MAX_CPU_LIST];
+} CpuList;
+
+// Parses a list such as "2,4-7". Returns -1 on malformed input.
+int cpu_list_parse(const char* spec, CpuList* list);
+
+// pthread_create for a thread restricted to cpus. With slot >= 0 the
+// thread is pinned to the single CPU cpus[slot % count] instead, which is
+// how a pool spreads its threads one per core. If the kernel rejects the
+// placement (offline CPU, outside the process cpuset) the thread is
+// started unpinned with a warning.
+int cpu_thread_create(pthread_t* thread, const CpuList* cpus, int slot,
+                      void* (*start_routine)(void*), void* arg);
+
+// Hint to the core that the caller is spin-waiting, so a busy-poll loop
+// yields pipeline resources to its hyperthread sibling
+static inline void cpu_relax(void) {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__)
+    __asm__ __volatile__("yield");
+#endif
+}
+
+#endif // QUANT_TRADING_CPU_AFFINITY_H
@@ -0,0 +1,40 @@
+#ifndef QUANT_TRADING_LATENCY_HISTOGRAM_H
+#define QUANT_TRADING_LATENCY_HISTOGRAM_H
+
+#include <stdint.h>
+
+// HDR-style log-linear histogram of nanosecond latencies. Each power of two
+// is split into 32 linear sub-buckets, so any recorded value is reported
+// within about 3%. Values from 0 up to 2^40 ns (about 18 minutes) are
+// tracked; larger ones land in the top bucket.
+//
+// Recording is lock-free: every thread writes its own shard with relaxed
+// atomics, and readers merge the shards when summarizing.
+
+typedef struct LatencyHistogram LatencyHistogram;
+
+typedef struct {
+    uint64_t count;
+    int64_t min_ns;
+    int64_t max_ns;
+    double mean_ns;
+    int64_t p50_ns;
+    int64_t p90_ns;
+    int64_t p99_ns;
+    int64_t p999_ns;
+} LatencySummary;
+
+LatencyHistogram* latency_histogram_create(void);
+void latency_histogram_destroy(LatencyHistogram* histogram);
+
+void latency_histogram_record(LatencyHistogram* histogram, int64_t value_ns);
+// Allocates the calling thread's shard now rather than on its first record.
+// A pinned thread calling this places the shard on its own NUMA node.
+void latency_histogram_prepare_thread(LatencyHistogram* histogram);
+
+// Merges all shards. Concurrent recording may or may not be included.
+void latency_histogram_summarize(const LatencyHistogram* histogram, LatencySummary* summary);
+// Value at or below which the given fraction (0..1) of samples fall
+int64_t latency_histogram_percentile(const LatencyHistogram* histogram, double fraction);
+
+#endif // QUANT_TRADING_LATENCY_HISTOGRAM_H
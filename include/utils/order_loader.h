@@ -7,5 +7,8 @@
 // Function to load orders from a CSV file
 // Returns number of orders successfully loaded, or -1 on error
 int load_orders_from_file(const char* filename, OrderBook* book);
+// As load_orders_from_file, parsing on at most max_threads threads (0 picks
+// a count from the file size and the online CPUs)
+int load_orders_from_file_threads(const char* filename, OrderBook* book, int max_threads);
 
 #endif /* UTILS_ORDER_LOADER_H */
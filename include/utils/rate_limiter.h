@@ -0,0 +1,43 @@
+#ifndef QUANT_TRADING_RATE_LIMITER_H
+#define QUANT_TRADING_RATE_LIMITER_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Token-bucket throttling. A bucket holds up to burst tokens and refills at
+// rate tokens per second; each message takes one. A rate of 0 or less
+// disables the limit.
+
+#define RATE_LIMITER_MAX_KEY 64    // Fits any trader ID (MAX_ID_LENGTH)
+
+typedef struct {
+    double rate;               // Sustained messages per second
+    int burst;                 // Messages allowed back to back; at least 1
+} RateLimit;
+
+typedef struct {
+    double tokens;
+    int64_t last_ns;
+} TokenBucket;
+
+// Starts the bucket full
+void token_bucket_init(TokenBucket* bucket, const RateLimit* limit, int64_t now_ns);
+// Takes a token if one is available. Not thread-safe; the owner serializes calls.
+bool token_bucket_take(TokenBucket* bucket, const RateLimit* limit, int64_t now_ns);
+
+// Buckets keyed by a short string such as a trader id, shared by all
+// threads. Keys hash to one of several independently locked stripes, so
+// threads throttling different keys rarely contend. The table is sized up
+// front for capacity keys. A new key that finds its stripe full takes the
+// place of keys whose buckets have refilled, which behave exactly like new
+// ones, or failing that of the least recently used key.
+typedef struct RateLimiter RateLimiter;
+
+RateLimiter* rate_limiter_create(const RateLimit* limit, int capacity);
+void rate_limiter_destroy(RateLimiter* limiter);
+
+// Keys longer than RATE_LIMITER_MAX_KEY - 1 bytes are truncated
+bool rate_limiter_allow(RateLimiter* limiter, const char* key, size_t key_len, int64_t now_ns);
+
+#endif // QUANT_TRADING_RATE_LIMITER_H
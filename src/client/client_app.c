@@ -31,6 +31,16 @@ static void handle_signal(int signum) {
     }
 }
 
+static double json_number(const cJSON* object, const char* key) {
+    const cJSON* item = cJSON_GetObjectItem(object, key);
+    return item && cJSON_IsNumber(item) ? item->valuedouble : 0.0;
+}
+
+static const char* json_string(const cJSON* object, const char* key) {
+    const cJSON* item = cJSON_GetObjectItem(object, key);
+    return item && cJSON_IsString(item) ? item->valuestring : "";
+}
+
 static void handle_command(const Command* cmd, void* user_data) {
     if (cmd->type == CMD_QUIT) {
         LOG_INFO("Initiating client shutdown...");
@@ -117,6 +127,15 @@ static void handle_message(WSClient* ws_client, const char* message, size_t len,
             printf("  Side:     %s\n", type_item->valuestring);
             printf("  Price:    $%.2f\n", price_item->valuedouble);
             printf("  Quantity: %d\n", quantity_item->valueint);
+            if (json_number(order_id_item, "Display Quantity") > 0) {
+                printf("  Display:  %.0f (iceberg)\n", json_number(order_id_item, "Display Quantity"));
+            }
+            const char* time_in_force = json_string(order_id_item, "Time In Force");
+            if (strcmp(time_in_force, "IOC") == 0 || strcmp(time_in_force, "FOK") == 0 ||
+                strcmp(json_string(order_id_item, "Order Type"), "MARKET") == 0) {
+                printf("  Filled:   %.0f (%s, remainder canceled)\n",
+                       json_number(order_id_item, "Filled"), time_in_force);
+            }
             printf("===============================\n");
             printf("\ntrading> ");
             fflush(stdout);
@@ -211,6 +230,82 @@ static void handle_message(WSClient* ws_client, const char* message, size_t len,
         case MSG_SERVER_STATUS: {
             const char* status = cJSON_GetObjectItem(root, "status")->valuestring;
             printf("\nServer Status: %s\n", status);
+
+            cJSON* clients = cJSON_GetObjectItem(root, "connected_clients");
+            cJSON* orders = cJSON_GetObjectItem(root, "active_orders");
+            if (clients && orders) {
+                printf("  Clients: %d  Active orders: %d\n", clients->valueint, orders->valueint);
+            }
+
+            cJSON* counters = cJSON_GetObjectItem(root, "counters");
+            if (counters && cJSON_IsObject(counters)) {
+                cJSON* counter;
+                cJSON_ArrayForEach(counter, counters) {
+                    if (cJSON_IsNumber(counter)) {
+                        printf("  %-18s %.0f\n", counter->string, counter->valuedouble);
+                    }
+                }
+            }
+
+            cJSON* latency = cJSON_GetObjectItem(root, "latency");
+            if (latency && cJSON_IsArray(latency) && cJSON_GetArraySize(latency) > 0) {
+                printf("\n%-10s %10s %9s %9s %9s %9s %9s %9s\n", "Stage (us)", "Count",
+                       "Mean", "p50", "p90", "p99", "p99.9", "Max");
+                printf("------------------------------------------------------------------------------\n");
+                cJSON* stage;
+                cJSON_ArrayForEach(stage, latency) {
+                    cJSON* name = cJSON_GetObjectItem(stage, "stage");
+                    if (!name || !cJSON_IsString(name)) continue;
+                    printf("%-10s %10.0f %9.1f %9.1f %9.1f %9.1f %9.1f %9.1f\n",
+                           name->valuestring,
+                           json_number(stage, "count"),
+                           json_number(stage, "mean_us"),
+                           json_number(stage, "p50_us"),
+                           json_number(stage, "p90_us"),
+                           json_number(stage, "p99_us"),
+                           json_number(stage, "p999_us"),
+                           json_number(stage, "max_us"));
+                }
+            }
+            printf("\ntrading> ");
+            fflush(stdout);
+            break;
+        }
+
+        case MSG_ORDER_MODIFIED: {
+            cJSON* details = cJSON_GetObjectItem(root, "Modification Details");
+            if (!details || !cJSON_IsObject(details)) {
+                LOG_ERROR("Invalid order modified message format");
+                break;
+            }
+
+            printf("\n=== Order Modified ===\n");
+            printf("  Order ID: %s\n", json_string(details, "Order ID"));
+            printf("  Symbol:   %s\n", json_string(details, "Symbol"));
+            printf("  Price:    $%.2f\n", json_number(details, "Price"));
+            printf("  Quantity: %.0f\n", json_number(details, "Quantity"));
+            printf("======================\n");
+            printf("\ntrading> ");
+            fflush(stdout);
+            break;
+        }
+
+        case MSG_BATCH_ACK: {
+            printf("\n=== Batch Processed ===\n");
+            printf("  Symbol:   %s\n", json_string(root, "symbol"));
+            printf("  Accepted: %.0f  Rejected: %.0f\n",
+                   json_number(root, "accepted"), json_number(root, "rejected"));
+
+            cJSON* results = cJSON_GetObjectItem(root, "results");
+            cJSON* result;
+            cJSON_ArrayForEach(result, results) {
+                const char* reason = json_string(result, "reason");
+                printf("  %-20s %s%s%s\n",
+                       json_string(result, "order_id"),
+                       json_string(result, "status"),
+                       reason[0] ? ": " : "", reason);
+            }
+            printf("=======================\n");
             printf("\ntrading> ");
             fflush(stdout);
             break;
@@ -237,7 +332,8 @@ int main(int argc, char* argv[]) {
         .server_host = "localhost",
         .server_port = 8080,
         .reconnect_interval_ms = 5000,
-        .ping_interval_ms = 30000
+        .ping_interval_ms = 30000,
+        .exit_on_disconnect = true
     };
 
     OrderEntryConfig order_config = {
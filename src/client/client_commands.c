@@ -38,6 +38,9 @@ Command parse_command(const char* input) {
         cmd.type = CMD_CANCEL;
     } else if (strcasecmp(token, "VIEW") == 0) {
         cmd.type = CMD_VIEW;
+    } else if (strcasecmp(token, "STATS") == 0) {
+        cmd.type = CMD_STATS;
+        return cmd;
     } else if (strcasecmp(token, "HELP") == 0) {
         cmd.type = CMD_HELP;
         return cmd;
@@ -76,8 +79,9 @@ Command parse_command(const char* input) {
         cmd.type = CMD_INVALID;
         return cmd;
     }
-    cmd.price = atof(token);
-    if (!validate_price(cmd.price)) {
+    cmd.is_market = strcasecmp(token, "MKT") == 0;
+    cmd.price = cmd.is_market ? 0.0 : atof(token);
+    if (!cmd.is_market && !validate_price(cmd.price)) {
         LOG_ERROR("Invalid price: %f", cmd.price);
         cmd.type = CMD_INVALID;
         return cmd;
@@ -97,6 +101,32 @@ Command parse_command(const char* input) {
         return cmd;
     }
 
+    // Optional time in force and iceberg display size, in either order
+    while ((token = strtok(NULL, " \t\n")) != NULL) {
+        if (strcasecmp(token, "IOC") == 0) {
+            cmd.time_in_force = TIME_IN_FORCE_IOC;
+        } else if (strcasecmp(token, "FOK") == 0) {
+            cmd.time_in_force = TIME_IN_FORCE_FOK;
+        } else if (strcasecmp(token, "SHOW") == 0) {
+            token = strtok(NULL, " \t\n");
+            cmd.display_quantity = token ? atoi(token) : 0;
+            if (cmd.display_quantity <= 0 || cmd.display_quantity > cmd.quantity) {
+                LOG_ERROR("Invalid display quantity: %s", token ? token : "(missing)");
+                cmd.type = CMD_INVALID;
+                return cmd;
+            }
+        } else if (strcasecmp(token, "GTC") != 0) {
+            LOG_ERROR("Invalid time in force: %s", token);
+            cmd.type = CMD_INVALID;
+            return cmd;
+        }
+    }
+    if (cmd.display_quantity > 0 && (cmd.is_market || cmd.time_in_force != TIME_IN_FORCE_GTC)) {
+        LOG_ERROR("Only GTC limit orders can hide quantity");
+        cmd.type = CMD_INVALID;
+        return cmd;
+    }
+
     // Generate order ID
     generate_order_id(cmd.order_id, sizeof(cmd.order_id));
     LOG_INFO("Command parsed: type=%d, symbol=%s, price=%.2f, qty=%d, order_id=%s",
@@ -122,6 +152,17 @@ char* format_command_as_json(const Command* cmd, const char* trader_id) {
             cJSON_AddNumberToObject(root, "price", cmd->price);
             cJSON_AddNumberToObject(root, "quantity", cmd->quantity);
             cJSON_AddBoolToObject(root, "is_buy", cmd->type == CMD_BUY);
+            if (cmd->time_in_force == TIME_IN_FORCE_IOC) {
+                cJSON_AddStringToObject(root, "time_in_force", "IOC");
+            } else if (cmd->time_in_force == TIME_IN_FORCE_FOK) {
+                cJSON_AddStringToObject(root, "time_in_force", "FOK");
+            }
+            if (cmd->is_market) {
+                cJSON_AddStringToObject(root, "order_type", "MARKET");
+            }
+            if (cmd->display_quantity > 0) {
+                cJSON_AddNumberToObject(root, "display_quantity", cmd->display_quantity);
+            }
             break;
         }
         case CMD_VIEW: {
@@ -129,6 +170,10 @@ char* format_command_as_json(const Command* cmd, const char* trader_id) {
             cJSON_AddStringToObject(root, "symbol", cmd->symbol);
             break;
         }
+        case CMD_STATS: {
+            cJSON_AddNumberToObject(root, "type", MSG_REQUEST_STATUS);
+            break;
+        }
         default:
             cJSON_Delete(root);
             return NULL;
@@ -145,10 +190,11 @@ char* format_command_as_json(const Command* cmd, const char* trader_id) {
 
 void print_command_help(void) {
     printf("\nAvailable commands:\n");
-    printf("  BUY <symbol> <price> <quantity>\n");
-    printf("  SELL <symbol> <price> <quantity>\n");
+    printf("  BUY <symbol> <price|MKT> <quantity> [GTC|IOC|FOK] [SHOW <display quantity>]\n");
+    printf("  SELL <symbol> <price|MKT> <quantity> [GTC|IOC|FOK] [SHOW <display quantity>]\n");
     printf("  CANCEL <order_id>\n");
     printf("  VIEW <symbol>\n");
+    printf("  STATS\n");
     printf("  HELP\n");
     printf("  QUIT\n\n");
 }
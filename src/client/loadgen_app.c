@@ -0,0 +1,617 @@
+#include "client/ws_client.h"
+#include "protocol/message_types.h"
+#include "protocol/protocol_constants.h"
+#include "utils/clock.h"
+#include "utils/latency_histogram.h"
+#include "utils/logging.h"
+#include <cJSON/cJSON.h>
+#include <getopt.h>
+#include <inttypes.h>
+#include <signal.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#define MAX_CONNECTIONS 256
+#define RESTING_CAPACITY 4096      // Cancelable orders remembered per connection
+#define CANCEL_SLOTS 4096          // Outstanding cancel send times per connection
+#define CONNECT_TIMEOUT_MS 5000
+#define LIMIT_LEVELS 50            // Limit orders rest 1..50 ticks from mid
+#define SPIN_THRESHOLD_NS 50000    // Closer than this to the next send, spin instead of sleeping
+
+// Order IDs are "<kind><connection>.<sequence>.<send ns>" in hex, so the
+// send time comes back in every ack and trade that names the order
+#define ORDER_KIND_LIMIT 'L'
+#define ORDER_KIND_CROSS 'X'
+
+typedef struct {
+    char order_id[MAX_ORDER_ID_LENGTH];
+    bool is_buy;
+} RestingOrder;
+
+typedef struct {
+    uint64_t sequence;
+    int64_t sent_ns;
+} PendingCancel;
+
+typedef struct LoadGenerator LoadGenerator;
+
+typedef struct {
+    int index;
+    WSClient* client;
+    LoadGenerator* generator;
+    atomic_bool connected;
+
+    // Sender thread only
+    RestingOrder resting[RESTING_CAPACITY];
+    size_t resting_head;
+    size_t resting_count;
+    uint64_t next_sequence;
+
+    // Written by the sender, read by the service thread
+    _Atomic uint64_t cancel_sequence[CANCEL_SLOTS];
+    _Atomic int64_t cancel_sent_ns[CANCEL_SLOTS];
+} LoadConnection;
+
+typedef struct {
+    const char* host;
+    int port;
+    int connections;
+    double rate;               // Orders per second across all connections
+    double duration_s;
+    double drain_s;
+    int limit_pct;
+    int cancel_pct;
+    int cross_pct;
+    const char* symbol;
+    double mid_price;
+    double tick_size;
+    uint64_t seed;
+} LoadConfig;
+
+struct LoadGenerator {
+    LoadConfig config;
+    LoadConnection* connections;
+    LatencyHistogram* ack_latency;
+    LatencyHistogram* cancel_latency;
+    LatencyHistogram* trade_latency;
+    uint64_t rng;
+
+    uint64_t sent_limit;
+    uint64_t sent_cancel;
+    uint64_t sent_cross;
+    uint64_t send_failures;
+    _Atomic uint64_t acks;
+    _Atomic uint64_t cancel_acks;
+    _Atomic uint64_t errors;
+    _Atomic uint64_t trades;
+};
+
+static volatile sig_atomic_t running = 1;
+
+static void handle_signal(int signum) {
+    (void)signum;
+    running = 0;
+}
+
+static void print_usage(const char* program) {
+    fprintf(stderr,
+            "Usage: %s [options]\n"
+            "  --host HOST            Server host (default 127.0.0.1)\n"
+            "  --port PORT            Server port (default 8080)\n"
+            "  --connections N        Concurrent websocket connections (default 4, max %d)\n"
+            "  --rate N               Orders per second across all connections (default 1000)\n"
+            "  --duration SEC         Length of the run (default 10)\n"
+            "  --drain SEC            Time to wait for replies after the last send (default 2)\n"
+            "  --mix L:C:X            Percent of limit, cancel and crossing orders (default 70:20:10)\n"
+            "  --symbol SYMBOL        Symbol to trade (default AAPL)\n"
+            "  --mid PRICE            Price orders are placed around (default 100)\n"
+            "  --seed N               Seed for sides, prices and quantities (default 1)\n"
+            "  --help                 Show this message\n",
+            program, MAX_CONNECTIONS);
+}
+
+static uint64_t next_random(LoadGenerator* generator) {
+    generator->rng ^= generator->rng >> 12;
+    generator->rng ^= generator->rng << 25;
+    generator->rng ^= generator->rng >> 27;
+    return generator->rng * 0x2545F4914F6CDD1DULL;
+}
+
+static uint32_t random_below(LoadGenerator* generator, uint32_t bound) {
+    return (uint32_t)((next_random(generator) >> 32) * bound >> 32);
+}
+
+static bool parse_order_id(const char* order_id, char* kind, int* connection,
+                           uint64_t* sequence, int64_t* sent_ns) {
+    unsigned int index;
+    uint64_t seq;
+    uint64_t sent;
+    char prefix;
+    if (!order_id || sscanf(order_id, "%c%x.%" SCNx64 ".%" SCNx64, &prefix, &index, &seq, &sent) != 4 ||
+        (prefix != ORDER_KIND_LIMIT && prefix != ORDER_KIND_CROSS)) {
+        return false;
+    }
+    *kind = prefix;
+    *connection = (int)index;
+    *sequence = seq;
+    *sent_ns = (int64_t)sent;
+    return true;
+}
+
+static void handle_order_accepted(LoadConnection* connection, const cJSON* root, int64_t now) {
+    const cJSON* details = cJSON_GetObjectItem(root, "Trade Details");
+    const cJSON* order_id = details ? cJSON_GetObjectItem(details, "Order ID") : NULL;
+
+    char kind;
+    int index;
+    uint64_t sequence;
+    int64_t sent_ns;
+    if (order_id && cJSON_IsString(order_id) &&
+        parse_order_id(order_id->valuestring, &kind, &index, &sequence, &sent_ns) &&
+        index == connection->index) {
+        latency_histogram_record(connection->generator->ack_latency, now - sent_ns);
+        atomic_fetch_add(&connection->generator->acks, 1);
+    }
+}
+
+static void handle_order_canceled(LoadConnection* connection, const cJSON* root, int64_t now) {
+    const cJSON* details = cJSON_GetObjectItem(root, "Cancellation Details");
+    const cJSON* order_id = details ? cJSON_GetObjectItem(details, "Order ID") : NULL;
+
+    char kind;
+    int index;
+    uint64_t sequence;
+    int64_t placed_ns;
+    if (!order_id || !cJSON_IsString(order_id) ||
+        !parse_order_id(order_id->valuestring, &kind, &index, &sequence, &placed_ns) ||
+        index != connection->index) {
+        return;
+    }
+
+    size_t slot = sequence % CANCEL_SLOTS;
+    if (atomic_load(&connection->cancel_sequence[slot]) == sequence) {
+        int64_t sent_ns = atomic_load(&connection->cancel_sent_ns[slot]);
+        latency_histogram_record(connection->generator->cancel_latency, now - sent_ns);
+    }
+    atomic_fetch_add(&connection->generator->cancel_acks, 1);
+}
+
+// Every connection sees every trade; only the one that sent the order that
+// triggered the fill (the later of the two) records it
+static void handle_trade(LoadConnection* connection, const cJSON* root, int64_t now) {
+    const cJSON* buy_id = cJSON_GetObjectItem(root, "buy_order_id");
+    const cJSON* sell_id = cJSON_GetObjectItem(root, "sell_order_id");
+    if (!buy_id || !sell_id || !cJSON_IsString(buy_id) || !cJSON_IsString(sell_id)) {
+        return;
+    }
+
+    char kind;
+    int buy_index = -1;
+    int sell_index = -1;
+    uint64_t sequence;
+    int64_t buy_sent = 0;
+    int64_t sell_sent = 0;
+    bool have_buy = parse_order_id(buy_id->valuestring, &kind, &buy_index, &sequence, &buy_sent);
+    bool have_sell = parse_order_id(sell_id->valuestring, &kind, &sell_index, &sequence, &sell_sent);
+    if (!have_buy && !have_sell) {
+        return;
+    }
+
+    bool buy_is_later = have_buy && (!have_sell || buy_sent >= sell_sent);
+    int owner = buy_is_later ? buy_index : sell_index;
+    int64_t sent_ns = buy_is_later ? buy_sent : sell_sent;
+    if (owner == connection->index) {
+        latency_histogram_record(connection->generator->trade_latency, now - sent_ns);
+        atomic_fetch_add(&connection->generator->trades, 1);
+    }
+}
+
+static void handle_message(WSClient* client, const char* message, size_t len, void* user_data) {
+    (void)client;
+    (void)len;  // Messages arrive NUL-terminated
+    LoadConnection* connection = (LoadConnection*)user_data;
+    int64_t now = clock_now_ns();
+
+    cJSON* root = cJSON_Parse(message);
+    const cJSON* type = root ? cJSON_GetObjectItem(root, "type") : NULL;
+    if (!type || !cJSON_IsNumber(type)) {
+        cJSON_Delete(root);
+        return;
+    }
+
+    switch (type->valueint) {
+        case MSG_ORDER_ACCEPTED:
+            handle_order_accepted(connection, root, now);
+            break;
+        case MSG_ORDER_CANCELED:
+            handle_order_canceled(connection, root, now);
+            break;
+        case MSG_TRADE_EXECUTED:
+            handle_trade(connection, root, now);
+            break;
+        case MSG_ERROR:
+            atomic_fetch_add(&connection->generator->errors, 1);
+            break;
+        default:
+            break;
+    }
+    cJSON_Delete(root);
+}
+
+static void handle_connect(WSClient* client, void* user_data) {
+    (void)client;
+    atomic_store(&((LoadConnection*)user_data)->connected, true);
+}
+
+static void handle_disconnect(WSClient* client, void* user_data) {
+    (void)client;
+    LoadConnection* connection = (LoadConnection*)user_data;
+    if (atomic_exchange(&connection->connected, false) && running) {
+        LOG_WARN("Connection %d closed during the run", connection->index);
+    }
+}
+
+static int send_json(LoadConnection* connection, cJSON* root) {
+    char* json = cJSON_PrintUnformatted(root);
+    cJSON_Delete(root);
+    if (!json) {
+        return -1;
+    }
+    int status = ws_client_send(connection->client, json, strlen(json));
+    free(json);
+    return status;
+}
+
+static int send_order(LoadGenerator* generator, LoadConnection* connection, bool crossing) {
+    const LoadConfig* config = &generator->config;
+    bool is_buy = random_below(generator, 2) == 0;
+    int ticks = crossing ? LIMIT_LEVELS : 1 + (int)random_below(generator, LIMIT_LEVELS);
+    // Passive orders rest on their own side of mid; crossing ones reach through the other side
+    int offset = (is_buy != crossing) ? -ticks : ticks;
+    double price = config->mid_price + offset * config->tick_size;
+    int quantity = 1 + (int)random_below(generator, crossing ? 10 : 100);
+
+    char order_id[MAX_ORDER_ID_LENGTH];
+    snprintf(order_id, sizeof(order_id), "%c%x.%" PRIx64 ".%" PRIx64,
+             crossing ? ORDER_KIND_CROSS : ORDER_KIND_LIMIT, (unsigned int)connection->index,
+             connection->next_sequence++, (uint64_t)clock_now_ns());
+
+    char trader_id[MAX_TRADER_ID_LENGTH];
+    snprintf(trader_id, sizeof(trader_id), "LOADGEN%d", connection->index);
+
+    cJSON* root = cJSON_CreateObject();
+    if (!root) {
+        return -1;
+    }
+    cJSON_AddNumberToObject(root, "type", MSG_PLACE_ORDER);
+    cJSON_AddStringToObject(root, "order_id", order_id);
+    cJSON_AddStringToObject(root, "trader_id", trader_id);
+    cJSON_AddStringToObject(root, "symbol", config->symbol);
+    cJSON_AddNumberToObject(root, "price", price);
+    cJSON_AddNumberToObject(root, "quantity", quantity);
+    cJSON_AddBoolToObject(root, "is_buy", is_buy);
+    if (send_json(connection, root) != 0) {
+        return -1;
+    }
+
+    if (!crossing) {
+        // Remember it for a later cancel, forgetting the oldest when full
+        size_t slot = (connection->resting_head + connection->resting_count) % RESTING_CAPACITY;
+        if (connection->resting_count == RESTING_CAPACITY) {
+            connection->resting_head = (connection->resting_head + 1) % RESTING_CAPACITY;
+        } else {
+            connection->resting_count++;
+        }
+        snprintf(connection->resting[slot].order_id, sizeof(connection->resting[slot].order_id),
+                 "%s", order_id);
+        connection->resting[slot].is_buy = is_buy;
+    }
+    return 0;
+}
+
+// Cancels the oldest remembered limit order; it may have been filled already
+static int send_cancel(LoadGenerator* generator, LoadConnection* connection) {
+    if (connection->resting_count == 0) {
+        return send_order(generator, connection, false);
+    }
+
+    RestingOrder* order = &connection->resting[connection->resting_head];
+    connection->resting_head = (connection->resting_head + 1) % RESTING_CAPACITY;
+    connection->resting_count--;
+
+    char kind;
+    int index;
+    uint64_t sequence;
+    int64_t placed_ns;
+    if (parse_order_id(order->order_id, &kind, &index, &sequence, &placed_ns)) {
+        size_t slot = sequence % CANCEL_SLOTS;
+        atomic_store(&connection->cancel_sent_ns[slot], clock_now_ns());
+        atomic_store(&connection->cancel_sequence[slot], sequence);
+    }
+
+    cJSON* root = cJSON_CreateObject();
+    if (!root) {
+        return -1;
+    }
+    cJSON_AddNumberToObject(root, "type", MSG_CANCEL_ORDER);
+    cJSON_AddStringToObject(root, "order_id", order->order_id);
+    cJSON_AddStringToObject(root, "symbol", generator->config.symbol);
+    cJSON_AddBoolToObject(root, "is_buy", order->is_buy);
+    return send_json(connection, root);
+}
+
+static void wait_until(int64_t deadline_ns) {
+    int64_t remaining = deadline_ns - clock_now_ns();
+    if (remaining > SPIN_THRESHOLD_NS) {
+        struct timespec pause = {
+            .tv_sec = (remaining - SPIN_THRESHOLD_NS) / 1000000000LL,
+            .tv_nsec = (remaining - SPIN_THRESHOLD_NS) % 1000000000LL
+        };
+        nanosleep(&pause, NULL);
+    }
+    while (clock_now_ns() < deadline_ns) {
+    }
+}
+
+// Open loop: send times are fixed by the rate, not by when replies arrive,
+// so a slow server shows up as latency instead of as a lower send rate
+static void run_load(LoadGenerator* generator) {
+    const LoadConfig* config = &generator->config;
+    double interval_ns = 1e9 / config->rate;
+    int64_t start = clock_now_ns();
+    int64_t end = start + (int64_t)(config->duration_s * 1e9);
+
+    for (uint64_t i = 0; running; i++) {
+        int64_t due = start + (int64_t)(i * interval_ns);
+        if (due >= end) {
+            break;
+        }
+        wait_until(due);
+
+        LoadConnection* connection = &generator->connections[i % (uint64_t)config->connections];
+        if (!atomic_load(&connection->connected)) {
+            generator->send_failures++;
+            continue;
+        }
+
+        int roll = (int)random_below(generator, 100);
+        int status;
+        if (roll < config->limit_pct) {
+            status = send_order(generator, connection, false);
+            generator->sent_limit++;
+        } else if (roll < config->limit_pct + config->cancel_pct) {
+            status = send_cancel(generator, connection);
+            generator->sent_cancel++;
+        } else {
+            status = send_order(generator, connection, true);
+            generator->sent_cross++;
+        }
+        if (status != 0) {
+            generator->send_failures++;
+        }
+    }
+}
+
+static void print_latency(const char* name, const LatencyHistogram* histogram) {
+    LatencySummary summary;
+    latency_histogram_summarize(histogram, &summary);
+    if (summary.count == 0) {
+        printf("  %-8s %10s\n", name, "-");
+        return;
+    }
+    printf("  %-8s %10" PRIu64 " %9.1f %9.1f %9.1f %9.1f %9.1f %9.1f\n", name, summary.count,
+           summary.mean_ns / 1e3, summary.p50_ns / 1e3, summary.p90_ns / 1e3,
+           summary.p99_ns / 1e3, summary.p999_ns / 1e3, summary.max_ns / 1e3);
+}
+
+static void print_report(const LoadGenerator* generator, double elapsed_s) {
+    const LoadConfig* config = &generator->config;
+    uint64_t sent = generator->sent_limit + generator->sent_cancel + generator->sent_cross;
+    uint64_t acks = atomic_load(&generator->acks);
+    uint64_t cancel_acks = atomic_load(&generator->cancel_acks);
+
+    printf("\n=== Load Test: %d connections, %.0f orders/s target, %.1f s ===\n",
+           config->connections, config->rate, config->duration_s);
+    printf("  Sent:       %" PRIu64 " (%" PRIu64 " limit, %" PRIu64 " cancel, %" PRIu64 " crossing), "
+           "%" PRIu64 " failed\n",
+           sent, generator->sent_limit, generator->sent_cancel, generator->sent_cross,
+           generator->send_failures);
+    printf("  Send rate:  %.0f msg/s\n", elapsed_s > 0 ? sent / elapsed_s : 0.0);
+    printf("  Replies:    %" PRIu64 " acks, %" PRIu64 " cancel acks, %" PRIu64 " errors, %" PRIu64 " trades\n",
+           acks, cancel_acks, atomic_load(&generator->errors), atomic_load(&generator->trades));
+    printf("  Throughput: %.0f acks/s\n", elapsed_s > 0 ? (acks + cancel_acks) / elapsed_s : 0.0);
+
+    printf("\n  %-8s %10s %9s %9s %9s %9s %9s %9s\n", "(us)", "Count", "Mean", "p50", "p90",
+           "p99", "p99.9", "Max");
+    print_latency("ack", generator->ack_latency);
+    print_latency("cancel", generator->cancel_latency);
+    print_latency("trade", generator->trade_latency);
+}
+
+static int parse_mix(const char* arg, LoadConfig* config) {
+    if (sscanf(arg, "%d:%d:%d", &config->limit_pct, &config->cancel_pct, &config->cross_pct) != 3 ||
+        config->limit_pct < 0 || config->cancel_pct < 0 || config->cross_pct < 0 ||
+        config->limit_pct + config->cancel_pct + config->cross_pct != 100) {
+        return -1;
+    }
+    return 0;
+}
+
+static bool is_valid_symbol(const char* symbol) {
+    for (int i = 0; i < SYMBOL_COUNT; i++) {
+        if (strcmp(VALID_SYMBOLS[i], symbol) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool wait_for_connections(LoadGenerator* generator) {
+    int64_t deadline = clock_now_ns() + (int64_t)CONNECT_TIMEOUT_MS * 1000000;
+    while (running && clock_now_ns() < deadline) {
+        int connected = 0;
+        for (int i = 0; i < generator->config.connections; i++) {
+            connected += atomic_load(&generator->connections[i].connected) ? 1 : 0;
+        }
+        if (connected == generator->config.connections) {
+            return true;
+        }
+        usleep(10000);
+    }
+    return false;
+}
+
+int main(int argc, char* argv[]) {
+    LoadConfig config = {
+        .host = "127.0.0.1",
+        .port = 8080,
+        .connections = 4,
+        .rate = 1000.0,
+        .duration_s = 10.0,
+        .drain_s = 2.0,
+        .limit_pct = 70,
+        .cancel_pct = 20,
+        .cross_pct = 10,
+        .symbol = "AAPL",
+        .mid_price = 100.0,
+        .tick_size = 0.01,
+        .seed = 1
+    };
+
+    static const struct option options[] = {
+        {"host", required_argument, NULL, 'H'},
+        {"port", required_argument, NULL, 'p'},
+        {"connections", required_argument, NULL, 'c'},
+        {"rate", required_argument, NULL, 'r'},
+        {"duration", required_argument, NULL, 'd'},
+        {"drain", required_argument, NULL, 'D'},
+        {"mix", required_argument, NULL, 'm'},
+        {"symbol", required_argument, NULL, 's'},
+        {"mid", required_argument, NULL, 'M'},
+        {"seed", required_argument, NULL, 'S'},
+        {"help", no_argument, NULL, 'h'},
+        {NULL, 0, NULL, 0}
+    };
+
+    int opt;
+    while ((opt = getopt_long(argc, argv, "H:p:c:r:d:D:m:s:M:S:h", options, NULL)) != -1) {
+        switch (opt) {
+            case 'H': config.host = optarg; break;
+            case 'p': config.port = atoi(optarg); break;
+            case 'c': config.connections = atoi(optarg); break;
+            case 'r': config.rate = strtod(optarg, NULL); break;
+            case 'd': config.duration_s = strtod(optarg, NULL); break;
+            case 'D': config.drain_s = strtod(optarg, NULL); break;
+            case 'm':
+                if (parse_mix(optarg, &config) != 0) {
+                    fprintf(stderr, "Invalid --mix argument: %s (percentages must add up to 100)\n", optarg);
+                    return EXIT_FAILURE;
+                }
+                break;
+            case 's': config.symbol = optarg; break;
+            case 'M': config.mid_price = strtod(optarg, NULL); break;
+            case 'S': config.seed = strtoull(optarg, NULL, 10); break;
+            case 'h':
+                print_usage(argv[0]);
+                return EXIT_SUCCESS;
+            default:
+                print_usage(argv[0]);
+                return EXIT_FAILURE;
+        }
+    }
+
+    if (config.connections <= 0 || config.connections > MAX_CONNECTIONS || config.rate <= 0 ||
+        config.duration_s <= 0 || config.drain_s < 0 ||
+        config.mid_price <= LIMIT_LEVELS * config.tick_size) {
+        print_usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    if (!is_valid_symbol(config.symbol)) {
+        fprintf(stderr, "Unknown symbol: %s\n", config.symbol);
+        return EXIT_FAILURE;
+    }
+
+    set_log_level(LOG_WARNING);
+    signal(SIGINT, handle_signal);
+    signal(SIGTERM, handle_signal);
+
+    LoadGenerator* generator = calloc(1, sizeof(LoadGenerator));
+    if (!generator) {
+        return EXIT_FAILURE;
+    }
+    generator->config = config;
+    generator->rng = config.seed * 0x9E3779B97F4A7C15ULL + 1;
+    generator->connections = calloc((size_t)config.connections, sizeof(LoadConnection));
+    generator->ack_latency = latency_histogram_create();
+    generator->cancel_latency = latency_histogram_create();
+    generator->trade_latency = latency_histogram_create();
+
+    int status = EXIT_FAILURE;
+    if (!generator->connections || !generator->ack_latency || !generator->cancel_latency ||
+        !generator->trade_latency) {
+        goto cleanup;
+    }
+
+    WSClientConfig client_config = {
+        .server_host = config.host,
+        .server_port = config.port,
+        .reconnect_interval_ms = 1000,
+        .ping_interval_ms = 30000,
+        .exit_on_disconnect = false
+    };
+
+    for (int i = 0; i < config.connections; i++) {
+        LoadConnection* connection = &generator->connections[i];
+        connection->index = i;
+        connection->generator = generator;
+        connection->client = ws_client_create(&client_config);
+        if (!connection->client) {
+            goto cleanup;
+        }
+        ws_client_set_connect_callback(connection->client, handle_connect, connection);
+        ws_client_set_disconnect_callback(connection->client, handle_disconnect, connection);
+        ws_client_set_message_callback(connection->client, handle_message, connection);
+        if (ws_client_connect(connection->client) != 0) {
+            goto cleanup;
+        }
+    }
+
+    if (!wait_for_connections(generator)) {
+        LOG_ERROR("Not all %d connections to %s:%d were established", config.connections,
+                  config.host, config.port);
+        goto cleanup;
+    }
+
+    int64_t start = clock_now_ns();
+    run_load(generator);
+    double elapsed_s = (clock_now_ns() - start) / 1e9;
+
+    // Let replies for the last orders arrive; they count toward latency, not throughput
+    int64_t drain_end = clock_now_ns() + (int64_t)(config.drain_s * 1e9);
+    while (running && clock_now_ns() < drain_end) {
+        usleep(10000);
+    }
+
+    print_report(generator, elapsed_s);
+    status = atomic_load(&generator->acks) > 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+
+cleanup:
+    running = 0;
+    for (int i = 0; generator->connections && i < config.connections; i++) {
+        if (generator->connections[i].client) {
+            ws_client_disconnect(generator->connections[i].client);
+            ws_client_destroy(generator->connections[i].client);
+        }
+    }
+    latency_histogram_destroy(generator->ack_latency);
+    latency_histogram_destroy(generator->cancel_latency);
+    latency_histogram_destroy(generator->trade_latency);
+    free(generator->connections);
+    free(generator);
+    return status;
+}
@@ -6,12 +6,21 @@
 #include <stdlib.h>
 #include <pthread.h>
 
+// A queued outbound message, with LWS_PRE bytes of headroom before data
+typedef struct OutboundMessage {
+    struct OutboundMessage* next;
+    size_t len;
+    unsigned char data[];
+} OutboundMessage;
+
 struct WSClient {
     struct lws_context* context;
     struct lws* connection;
     pthread_t service_thread;
     bool running;
     bool connected;
+    bool connecting;           // A connection attempt is in flight
+    bool exit_on_disconnect;
     
     const char* host;
     int port;
@@ -24,6 +33,8 @@ struct WSClient {
     void* user_data;
     
     pthread_mutex_t lock;
+    OutboundMessage* outbound_head;
+    OutboundMessage* outbound_tail;
 
     CommandHandlerCallback command_callback;
     void* command_handler_data;
@@ -41,15 +52,74 @@ void ws_client_set_command_callback(WSClient* client, CommandCallback callback,
     client->command_handler_data = user_data;
 }
 
+static OutboundMessage* pop_outbound(WSClient* client) {
+    pthread_mutex_lock(&client->lock);
+    OutboundMessage* message = client->outbound_head;
+    if (message) {
+        client->outbound_head = message->next;
+        if (!client->outbound_head) {
+            client->outbound_tail = NULL;
+        }
+    }
+    pthread_mutex_unlock(&client->lock);
+    return message;
+}
+
+static bool has_outbound(WSClient* client) {
+    pthread_mutex_lock(&client->lock);
+    bool pending = client->outbound_head != NULL;
+    pthread_mutex_unlock(&client->lock);
+    return pending;
+}
+
+static void clear_outbound(WSClient* client) {
+    OutboundMessage* message;
+    while ((message = pop_outbound(client)) != NULL) {
+        free(message);
+    }
+}
+
 static int callback_trading(struct lws* wsi, enum lws_callback_reasons reason,
                           void* user, void* in, size_t len) {
     WSClient* client = (WSClient*)user;
     
     switch (reason) {
+        // Raised on the service thread by lws_cancel_service() in ws_client_send()
+        case LWS_CALLBACK_EVENT_WAIT_CANCELLED: {
+            WSClient* owner = (WSClient*)lws_context_user(lws_get_context(wsi));
+            if (owner && owner->connected && owner->connection && has_outbound(owner)) {
+                lws_callback_on_writable(owner->connection);
+            }
+            break;
+        }
+
+        case LWS_CALLBACK_CLIENT_WRITEABLE: {
+            OutboundMessage* message = pop_outbound(client);
+            if (!message) {
+                break;
+            }
+            int written = lws_write(wsi, message->data + LWS_PRE, message->len, LWS_WRITE_TEXT);
+            free(message);
+            if (written < 0) {
+                LOG_ERROR("Failed to send WebSocket message");
+                return -1;
+            }
+            if (has_outbound(client)) {
+                lws_callback_on_writable(wsi);
+            }
+            break;
+        }
+
         case LWS_CALLBACK_CLIENT_ESTABLISHED:
             pthread_mutex_lock(&client->lock);
             client->connected = true;
+            client->connecting = false;
             pthread_mutex_unlock(&client->lock);
+
+            // Flush anything queued while connecting
+            if (has_outbound(client)) {
+                lws_callback_on_writable(wsi);
+            }
             
             if (client->connect_cb) {
                 client->connect_cb(client, client->user_data);
@@ -60,6 +130,7 @@ static int callback_trading(struct lws* wsi, enum lws_callback_reasons reason,
         case LWS_CALLBACK_CLIENT_CLOSED:
             pthread_mutex_lock(&client->lock);
             client->connected = false;
+            client->connecting = false;
             pthread_mutex_unlock(&client->lock);
             
             if (client->disconnect_cb) {
@@ -75,8 +146,9 @@ static int callback_trading(struct lws* wsi, enum lws_callback_reasons reason,
                 msg[len] = '\0';
             }
 
+            // Hand out the NUL-terminated copy so callbacks can parse it in place
             if (client->message_cb) {
-                client->message_cb(client, (const char*)in, len, client->user_data);
+                client->message_cb(client, msg ? msg : (const char*)in, len, client->user_data);
             }
             free(msg);
             break;
@@ -87,6 +159,7 @@ static int callback_trading(struct lws* wsi, enum lws_callback_reasons reason,
             LOG_ERROR("WebSocket connection error");
             pthread_mutex_lock(&client->lock);
             client->connected = false;
+            client->connecting = false;
             pthread_mutex_unlock(&client->lock);
             break;
             
@@ -127,7 +200,7 @@ static void* service_thread(void* arg) {
     while (client->running) {
         lws_service(client->context, 50);
         
-        if (!client->connected && client->running) {
+        if (!client->connected && !client->connecting && client->running) {
             if (retry_count < max_retries) {
                 LOG_INFO("Connection lost, attempting reconnect (%d/%d)...",
                         retry_count + 1, max_retries);
@@ -143,7 +216,11 @@ static void* service_thread(void* arg) {
                     .userdata = client
                 };
                 
+                client->connecting = true;
                 client->connection = lws_client_connect_via_info(&info);
+                if (!client->connection) {
+                    client->connecting = false;
+                }
                 retry_count++;
             } else {
                 LOG_ERROR("Max reconnection attempts reached, shutting down");
@@ -159,7 +236,9 @@ static void* service_thread(void* arg) {
                     client->command_callback(&cmd, client->command_handler_data);
                 }
                 
-                ws_client_force_shutdown();
+                if (client->exit_on_disconnect) {
+                    ws_client_force_shutdown();
+                }
                 break;
             }
         }
@@ -178,6 +257,7 @@ WSClient* ws_client_create(const WSClientConfig* config) {
     client->port = config->server_port;
     client->reconnect_interval_ms = config->reconnect_interval_ms;
     client->ping_interval_ms = config->ping_interval_ms;
+    client->exit_on_disconnect = config->exit_on_disconnect;
     
     pthread_mutex_init(&client->lock, NULL);
     
@@ -186,7 +266,8 @@ WSClient* ws_client_create(const WSClientConfig* config) {
         .protocols = protocols,
         .gid = -1,
         .uid = -1,
-        .options = LWS_SERVER_OPTION_DO_SSL_GLOBAL_INIT
+        .options = LWS_SERVER_OPTION_DO_SSL_GLOBAL_INIT,
+        .user = client
     };
     
     client->context = lws_create_context(&info);
@@ -212,6 +293,7 @@ void ws_client_destroy(WSClient* client) {
         lws_context_destroy(client->context);
     }
     
+    clear_outbound(client);
     pthread_mutex_destroy(&client->lock);
     free((void*)client->host);
     free(client);
@@ -222,6 +304,7 @@ int ws_client_connect(WSClient* client) {
     if (!client) return -1;
     
     client->running = true;
+    client->connecting = true;
     if (pthread_create(&client->service_thread, NULL, service_thread, client) != 0) {
         LOG_ERROR("Failed to create service thread");
         client->running = false;
@@ -240,6 +323,7 @@ int ws_client_connect(WSClient* client) {
     client->connection = lws_client_connect_via_info(&info);
     if (!client->connection) {
         LOG_ERROR("Failed to connect to WebSocket server");
+        client->connecting = false;
         client->running = false;
         pthread_join(client->service_thread, NULL);
         return -1;
@@ -258,7 +342,9 @@ void ws_client_disconnect(WSClient* client) {
     pthread_join(client->service_thread, NULL);
     
     LOG_INFO("WebSocket client disconnected");
-    ws_client_force_shutdown();
+    if (client->exit_on_disconnect) {
+        ws_client_force_shutdown();
+    }
 }
 
 int ws_client_send(WSClient* client, const char* message, size_t len) {
@@ -267,19 +353,24 @@ int ws_client_send(WSClient* client, const char* message, size_t len) {
         return -1;
     }
     
-    unsigned char* buf = malloc(LWS_PRE + len);
-    if (!buf) return -1;
+    OutboundMessage* queued = malloc(sizeof(OutboundMessage) + LWS_PRE + len);
+    if (!queued) return -1;
     
-    memcpy(buf + LWS_PRE, message, len);
+    queued->next = NULL;
+    queued->len = len;
+    memcpy(queued->data + LWS_PRE, message, len);
     
-    int result = lws_write(client->connection, buf + LWS_PRE, len, LWS_WRITE_TEXT);
-    free(buf);
-    
-    if (result < 0) {
-        LOG_ERROR("Failed to send WebSocket message");
-        return -1;
+    pthread_mutex_lock(&client->lock);
+    if (client->outbound_tail) {
+        client->outbound_tail->next = queued;
+    } else {
+        client->outbound_head = queued;
     }
+    client->outbound_tail = queued;
+    pthread_mutex_unlock(&client->lock);
     
+    // lws is not thread-safe; wake the service thread to do the write
+    lws_cancel_service(client->context);
     return 0;
 }
 
@@ -6,6 +6,63 @@
 
 static char last_error[256];
 
+static const char* const time_in_force_names[] = {
+    [TIME_IN_FORCE_GTC] = "GTC",
+    [TIME_IN_FORCE_IOC] = "IOC",
+    [TIME_IN_FORCE_FOK] = "FOK"
+};
+
+const char* time_in_force_name(TimeInForce time_in_force) {
+    return (unsigned)time_in_force <= TIME_IN_FORCE_FOK ? time_in_force_names[time_in_force] : "GTC";
+}
+
+// Reads the optional "time_in_force", "order_type" and "display_quantity"
+// fields of an order
+static bool parse_order_type(const cJSON* object, OrderMessage* order) {
+    order->time_in_force = TIME_IN_FORCE_GTC;
+    order->is_market = false;
+    order->display_quantity = 0;
+
+    const cJSON* time_in_force = cJSON_GetObjectItem(object, "time_in_force");
+    if (time_in_force) {
+        if (!cJSON_IsString(time_in_force)) {
+            return false;
+        }
+        bool known = false;
+        for (int i = TIME_IN_FORCE_GTC; i <= TIME_IN_FORCE_FOK; i++) {
+            if (strcmp(time_in_force->valuestring, time_in_force_names[i]) == 0) {
+                order->time_in_force = (TimeInForce)i;
+                known = true;
+            }
+        }
+        if (!known) {
+            return false;
+        }
+    }
+
+    const cJSON* order_type = cJSON_GetObjectItem(object, "order_type");
+    if (order_type) {
+        if (!cJSON_IsString(order_type)) {
+            return false;
+        }
+        order->is_market = strcmp(order_type->valuestring, "MARKET") == 0;
+        if (!order->is_market && strcmp(order_type->valuestring, "LIMIT") != 0) {
+            return false;
+        }
+    }
+
+    // Only an order that rests has anything to hide
+    const cJSON* display_quantity = cJSON_GetObjectItem(object, "display_quantity");
+    if (display_quantity) {
+        if (!cJSON_IsNumber(display_quantity) || display_quantity->valueint <= 0 ||
+            order->is_market || order->time_in_force != TIME_IN_FORCE_GTC) {
+            return false;
+        }
+        order->display_quantity = display_quantity->valueint;
+    }
+    return true;
+}
+
 bool parse_base_message(const char* json, int* type) {
     if (!json || !type) {
         LOG_ERROR("Invalid parameters for base message parsing");
@@ -68,6 +125,15 @@ char* serialize_order_message(const OrderMessage* order) {
     cJSON_AddNumberToObject(root, "price", order->price);
     cJSON_AddNumberToObject(root, "quantity", order->quantity);
     cJSON_AddBoolToObject(root, "is_buy", order->is_buy);
+    if (order->time_in_force != TIME_IN_FORCE_GTC) {
+        cJSON_AddStringToObject(root, "time_in_force", time_in_force_name(order->time_in_force));
+    }
+    if (order->is_market) {
+        cJSON_AddStringToObject(root, "order_type", "MARKET");
+    }
+    if (order->display_quantity > 0) {
+        cJSON_AddNumberToObject(root, "display_quantity", order->display_quantity);
+    }
 
     char* json_str = cJSON_Print(root);
     cJSON_Delete(root);
@@ -145,6 +211,95 @@ char* serialize_book_snapshot(const BookSnapshot* snapshot) {
     return json_str;
 }
 
+char* serialize_server_status(const ServerStatus* status) {
+    if (!status) {
+        LOG_ERROR("Attempt to serialize null server status");
+        return NULL;
+    }
+
+    cJSON* root = cJSON_CreateObject();
+    cJSON_AddNumberToObject(root, "type", MSG_SERVER_STATUS);
+    cJSON_AddStringToObject(root, "status", status->is_ready ? "ready" : "starting");
+    cJSON_AddNumberToObject(root, "connected_clients", status->num_connected_clients);
+    cJSON_AddNumberToObject(root, "active_orders", status->num_active_orders);
+    cJSON_AddNumberToObject(root, "timestamp", (double)status->timestamp);
+
+    cJSON* latency = cJSON_CreateArray();
+    for (int i = 0; i < status->num_latency_stages && i < MAX_LATENCY_STAGES; i++) {
+        const LatencyStageStats* stage = &status->latency[i];
+        cJSON* entry = cJSON_CreateObject();
+        cJSON_AddStringToObject(entry, "stage", stage->stage);
+        cJSON_AddNumberToObject(entry, "count", (double)stage->count);
+        cJSON_AddNumberToObject(entry, "mean_us", stage->mean_us);
+        cJSON_AddNumberToObject(entry, "p50_us", stage->p50_us);
+        cJSON_AddNumberToObject(entry, "p90_us", stage->p90_us);
+        cJSON_AddNumberToObject(entry, "p99_us", stage->p99_us);
+        cJSON_AddNumberToObject(entry, "p999_us", stage->p999_us);
+        cJSON_AddNumberToObject(entry, "max_us", stage->max_us);
+        cJSON_AddItemToArray(latency, entry);
+    }
+    cJSON_AddItemToObject(root, "latency", latency);
+
+    cJSON* counters = cJSON_CreateObject();
+    for (int i = 0; i < status->num_counters && i < MAX_STATUS_COUNTERS; i++) {
+        cJSON_AddNumberToObject(counters, status->counters[i].name, (double)status->counters[i].value);
+    }
+    cJSON_AddItemToObject(root, "counters", counters);
+
+    cJSON* symbols = cJSON_CreateObject();
+    for (int i = 0; i < status->num_symbols && i < MAX_STATUS_SYMBOLS; i++) {
+        cJSON_AddNumberToObject(symbols, status->symbols[i].symbol, status->symbols[i].active_orders);
+    }
+    cJSON_AddItemToObject(root, "active_orders_by_symbol", symbols);
+
+    char* json_str = cJSON_Print(root);
+    cJSON_Delete(root);
+
+    if (json_str) {
+        LOG_DEBUG("Serialized server status: %s", json_str);
+    }
+
+    return json_str;
+}
+
+char* serialize_batch_ack(const BatchAck* ack) {
+    if (!ack) {
+        LOG_ERROR("Attempt to serialize null batch ack");
+        return NULL;
+    }
+
+    int accepted = 0;
+    cJSON* results = cJSON_CreateArray();
+    for (int i = 0; i < ack->count && i < MAX_BATCH_ORDERS; i++) {
+        const BatchItemResult* result = &ack->results[i];
+        cJSON* entry = cJSON_CreateObject();
+        cJSON_AddStringToObject(entry, "order_id", result->order_id);
+        cJSON_AddStringToObject(entry, "status", result->accepted ? "accepted" : "rejected");
+        if (!result->accepted) {
+            cJSON_AddStringToObject(entry, "reason", result->reason);
+        }
+        cJSON_AddItemToArray(results, entry);
+        accepted += result->accepted;
+    }
+
+    cJSON* root = cJSON_CreateObject();
+    cJSON_AddNumberToObject(root, "type", MSG_BATCH_ACK);
+    cJSON_AddNumberToObject(root, "request_type", ack->request_type);
+    cJSON_AddStringToObject(root, "symbol", ack->symbol);
+    cJSON_AddNumberToObject(root, "accepted", accepted);
+    cJSON_AddNumberToObject(root, "rejected", ack->count - accepted);
+    cJSON_AddItemToObject(root, "results", results);
+
+    char* json_str = cJSON_Print(root);
+    cJSON_Delete(root);
+
+    if (json_str) {
+        LOG_DEBUG("Serialized batch ack: %s", json_str);
+    }
+
+    return json_str;
+}
+
 bool parse_order_message(const char* json, OrderMessage* order) {
     if (!json || !order) {
         LOG_ERROR("Invalid parameters for order parsing");
@@ -164,7 +319,14 @@ bool parse_order_message(const char* json, OrderMessage* order) {
     cJSON* quantity = cJSON_GetObjectItem(root, "quantity");
     cJSON* is_buy = cJSON_GetObjectItem(root, "is_buy");
 
-    if (!order_id || !trader_id || !symbol || !price || !quantity || !is_buy) {
+    if (!parse_order_type(root, order)) {
+        LOG_ERROR("Invalid order type, time in force or display quantity in order JSON");
+        cJSON_Delete(root);
+        return false;
+    }
+
+    // Market orders need no price
+    if (!order_id || !trader_id || !symbol || (!price && !order->is_market) || !quantity || !is_buy) {
         LOG_ERROR("Missing required fields in order JSON");
         cJSON_Delete(root);
         return false;
@@ -173,7 +335,7 @@ bool parse_order_message(const char* json, OrderMessage* order) {
     strncpy(order->order_id, order_id->valuestring, sizeof(order->order_id) - 1);
     strncpy(order->trader_id, trader_id->valuestring, sizeof(order->trader_id) - 1);
     strncpy(order->symbol, symbol->valuestring, sizeof(order->symbol) - 1);
-    order->price = price->valuedouble;
+    order->price = price && !order->is_market ? price->valuedouble : 0.0;
     order->quantity = quantity->valueint;
     order->is_buy = cJSON_IsTrue(is_buy);
 
@@ -292,6 +454,103 @@ bool parse_book_snapshot(const char* json, BookSnapshot* snapshot) {
     return true;
 }
 
+// Copies a string field, rejecting one that is missing or would not fit
+static bool copy_string_field(const cJSON* object, const char* name, char* out, size_t size) {
+    const cJSON* field = cJSON_GetObjectItem(object, name);
+    if (!field || !cJSON_IsString(field) || strlen(field->valuestring) >= size) {
+        return false;
+    }
+    strcpy(out, field->valuestring);
+    return true;
+}
+
+// The shared "orders" array of a batch, or NULL if it is missing, empty or too long
+static const cJSON* batch_entries(const cJSON* root, char* symbol, size_t symbol_size) {
+    if (!root || !copy_string_field(root, "symbol", symbol, symbol_size)) {
+        LOG_ERROR("Batch is missing its symbol");
+        return NULL;
+    }
+
+    const cJSON* entries = cJSON_GetObjectItem(root, "orders");
+    int count = entries && cJSON_IsArray(entries) ? cJSON_GetArraySize(entries) : 0;
+    if (count < 1 || count > MAX_BATCH_ORDERS) {
+        LOG_ERROR("Batch must carry 1 to %d orders", MAX_BATCH_ORDERS);
+        return NULL;
+    }
+    return entries;
+}
+
+int parse_order_batch(const cJSON* root, OrderMessage* orders) {
+    if (!orders) {
+        LOG_ERROR("Invalid parameters for order batch parsing");
+        return -1;
+    }
+
+    char symbol[sizeof(orders->symbol)];
+    const cJSON* entries = batch_entries(root, symbol, sizeof(symbol));
+    if (!entries) {
+        return -1;
+    }
+
+    int count = cJSON_GetArraySize(entries);
+    for (int i = 0; i < count; i++) {
+        const cJSON* entry = cJSON_GetArrayItem(entries, i);
+        const cJSON* price = cJSON_GetObjectItem(entry, "price");
+        const cJSON* quantity = cJSON_GetObjectItem(entry, "quantity");
+        const cJSON* is_buy = cJSON_GetObjectItem(entry, "is_buy");
+        OrderMessage* order = &orders[i];
+
+        memset(order, 0, sizeof(*order));
+        if (!copy_string_field(entry, "order_id", order->order_id, sizeof(order->order_id)) ||
+            !copy_string_field(entry, "trader_id", order->trader_id, sizeof(order->trader_id)) ||
+            !parse_order_type(entry, order) ||
+            (!order->is_market && !cJSON_IsNumber(price)) ||
+            !quantity || !cJSON_IsNumber(quantity) || !is_buy) {
+            LOG_ERROR("Missing required fields in batch order %d", i);
+            return -1;
+        }
+
+        strcpy(order->symbol, symbol);
+        order->price = order->is_market ? 0.0 : price->valuedouble;
+        order->quantity = quantity->valueint;
+        order->is_buy = cJSON_IsTrue(is_buy);
+    }
+
+    LOG_DEBUG("Successfully parsed batch of %d orders", count);
+    return count;
+}
+
+int parse_cancel_batch(const cJSON* root, char* symbol, size_t symbol_size, CancelMessage* cancels) {
+    if (!symbol || !cancels) {
+        LOG_ERROR("Invalid parameters for cancel batch parsing");
+        return -1;
+    }
+
+    const cJSON* entries = batch_entries(root, symbol, symbol_size);
+    if (!entries) {
+        return -1;
+    }
+
+    int count = cJSON_GetArraySize(entries);
+    for (int i = 0; i < count; i++) {
+        const cJSON* entry = cJSON_GetArrayItem(entries, i);
+        const cJSON* is_buy = cJSON_GetObjectItem(entry, "is_buy");
+        CancelMessage* cancel = &cancels[i];
+
+        memset(cancel, 0, sizeof(*cancel));
+        if (!copy_string_field(entry, "order_id", cancel->order_id, sizeof(cancel->order_id)) ||
+            !is_buy) {
+            LOG_ERROR("Missing required fields in batch cancel %d", i);
+            return -1;
+        }
+        // As for single cancels, numeric 0/1 is accepted as well as a bool
+        cancel->is_buy = cJSON_IsNumber(is_buy) ? is_buy->valueint != 0 : cJSON_IsTrue(is_buy);
+    }
+
+    LOG_DEBUG("Successfully parsed batch of %d cancels", count);
+    return count;
+}
+
 const char* get_last_protocol_error(void) {
     return last_error;
 }
@@ -89,7 +89,7 @@ bool validate_order_message(const OrderMessage* order, char* error_msg, size_t e
         return false;
     }
 
-    if (!validate_price(order->price)) {
+    if (!order->is_market && !validate_price(order->price)) {
         snprintf(error_msg, error_size, "Invalid price: %.2f", order->price);
         return false;
     }
@@ -99,6 +99,11 @@ bool validate_order_message(const OrderMessage* order, char* error_msg, size_t e
         return false;
     }
 
+    if (order->display_quantity < 0 || order->display_quantity > order->quantity) {
+        snprintf(error_msg, error_size, "Invalid display quantity: %d", order->display_quantity);
+        return false;
+    }
+
     LOG_DEBUG("Order message validated successfully: %s", order->order_id);
     return true;
 }
@@ -0,0 +1,121 @@
+#include "server/checkpointer.h"
+#include "utils/clock.h"
+#include "utils/logging.h"
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+struct Checkpointer {
+    ServerHandlers* handlers;
+    char* path;
+    int interval_ms;
+    CpuList cpus;
+
+    pthread_t thread;
+    pthread_mutex_t lock;
+    pthread_cond_t stop_cond;
+    bool running;
+};
+
+static void* checkpoint_thread(void* arg) {
+    Checkpointer* checkpointer = (Checkpointer*)arg;
+
+    pthread_mutex_lock(&checkpointer->lock);
+    while (checkpointer->running) {
+        struct timespec deadline;
+        clock_gettime(CLOCK_REALTIME, &deadline);
+        deadline.tv_sec += checkpointer->interval_ms / 1000;
+        deadline.tv_nsec += (long)(checkpointer->interval_ms % 1000) * 1000000;
+        deadline.tv_sec += deadline.tv_nsec / 1000000000L;
+        deadline.tv_nsec %= 1000000000L;
+
+        // Sleep until the next checkpoint is due, waking early on stop
+        while (checkpointer->running &&
+               pthread_cond_timedwait(&checkpointer->stop_cond, &checkpointer->lock, &deadline) == 0) {
+        }
+        if (!checkpointer->running) {
+            break;
+        }
+        pthread_mutex_unlock(&checkpointer->lock);
+
+        int64_t start = clock_now_ns();
+        if (server_handlers_save_snapshot(checkpointer->handlers, checkpointer->path) == 0) {
+            LOG_INFO("Checkpoint written to %s in %.1f ms", checkpointer->path,
+                     (clock_now_ns() - start) / 1e6);
+        } else {
+            LOG_ERROR("Checkpoint to %s failed", checkpointer->path);
+        }
+
+        pthread_mutex_lock(&checkpointer->lock);
+    }
+    pthread_mutex_unlock(&checkpointer->lock);
+    return NULL;
+}
+
+Checkpointer* checkpointer_create(const CheckpointerConfig* config) {
+    if (!config || !config->handlers || !config->path || config->interval_ms <= 0) {
+        LOG_ERROR("Invalid checkpointer configuration");
+        return NULL;
+    }
+
+    Checkpointer* checkpointer = calloc(1, sizeof(Checkpointer));
+    if (!checkpointer) {
+        LOG_ERROR("Failed to allocate checkpointer");
+        return NULL;
+    }
+
+    checkpointer->path = strdup(config->path);
+    if (!checkpointer->path) {
+        free(checkpointer);
+        return NULL;
+    }
+    checkpointer->handlers = config->handlers;
+    checkpointer->interval_ms = config->interval_ms;
+    checkpointer->cpus = config->cpus;
+
+    pthread_mutex_init(&checkpointer->lock, NULL);
+    pthread_cond_init(&checkpointer->stop_cond, NULL);
+    return checkpointer;
+}
+
+void checkpointer_destroy(Checkpointer* checkpointer) {
+    if (!checkpointer) {
+        return;
+    }
+
+    if (checkpointer->running) {
+        checkpointer_stop(checkpointer);
+    }
+
+    pthread_mutex_destroy(&checkpointer->lock);
+    pthread_cond_destroy(&checkpointer->stop_cond);
+    free(checkpointer->path);
+    free(checkpointer);
+}
+
+int checkpointer_start(Checkpointer* checkpointer) {
+    if (!checkpointer || checkpointer->running) return -1;
+
+    checkpointer->running = true;
+    if (cpu_thread_create(&checkpointer->thread, &checkpointer->cpus, -1,
+                          checkpoint_thread, checkpointer) != 0) {
+        checkpointer->running = false;
+        return -1;
+    }
+
+    LOG_INFO("Checkpointing to %s every %d ms", checkpointer->path, checkpointer->interval_ms);
+    return 0;
+}
+
+int checkpointer_stop(Checkpointer* checkpointer) {
+    if (!checkpointer || !checkpointer->running) return -1;
+
+    pthread_mutex_lock(&checkpointer->lock);
+    checkpointer->running = false;
+    pthread_cond_broadcast(&checkpointer->stop_cond);
+    pthread_mutex_unlock(&checkpointer->lock);
+
+    pthread_join(checkpointer->thread, NULL);
+    return 0;
+}
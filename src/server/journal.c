@@ -0,0 +1,782 @@
+#define _GNU_SOURCE
+#include "server/journal.h"
+#include "utils/checksum.h"
+#include "utils/logging.h"
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <inttypes.h>
+#include <limits.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#define DEFAULT_SEGMENT_SIZE (64 * 1024 * 1024)
+#define DEFAULT_GROUP_COMMIT_US 200
+#define DEFAULT_MAX_BATCH_EVENTS 1024
+#define SEGMENT_NAME_FORMAT "journal-%020" PRIu64 ".log"
+
+_Static_assert(sizeof(JournalRecord) == 192, "JournalRecord layout changed");
+_Static_assert(sizeof(JournalSegmentHeader) == 64, "JournalSegmentHeader layout changed");
+
+struct Journal {
+    char directory[PATH_MAX];
+    size_t segment_size;
+    int group_commit_us;
+    int max_batch_events;
+    bool async_ack;
+    CpuList cpus;
+
+    pthread_t writer_thread;
+    bool running;
+    bool failed;
+
+    pthread_mutex_t lock;
+    pthread_cond_t pending_cond;
+    pthread_cond_t durable_cond;
+
+    // Producers fill pending while the writer thread flushes writing
+    JournalRecord* pending;
+    size_t pending_count;
+    size_t pending_capacity;
+    JournalRecord* writing;
+    size_t writing_capacity;
+
+    uint64_t next_lsn;
+    uint64_t durable_lsn;
+
+    // Owned by the writer thread
+    int segment_fd;
+    size_t segment_offset;
+};
+
+static uint32_t record_crc(const JournalRecord* record) {
+    return crc32_update(0, (const char*)record + sizeof(record->crc32),
+                        sizeof(JournalRecord) - sizeof(record->crc32));
+}
+
+static int64_t wall_clock_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return (int64_t)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+static int segment_path(char* path, size_t size, const char* directory, uint64_t first_lsn) {
+    int len = snprintf(path, size, "%s/" SEGMENT_NAME_FORMAT, directory, first_lsn);
+    if (len < 0 || (size_t)len >= size) {
+        LOG_ERROR("Journal segment path too long in %s", directory);
+        return -1;
+    }
+    return 0;
+}
+
+static int sync_directory(const char* directory) {
+    int fd = open(directory, O_RDONLY | O_DIRECTORY);
+    if (fd < 0) {
+        return -1;
+    }
+    int result = fsync(fd);
+    close(fd);
+    return result;
+}
+
+// Returns the last valid LSN in a segment, or first_lsn - 1 if it holds no records
+static uint64_t scan_segment(const char* path, uint64_t first_lsn) {
+    uint64_t last_lsn = first_lsn - 1;
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return last_lsn;
+    }
+
+    JournalRecord records[256];
+    off_t offset = sizeof(JournalSegmentHeader);
+    bool done = false;
+    while (!done) {
+        ssize_t bytes = pread(fd, records, sizeof(records), offset);
+        if (bytes < (ssize_t)sizeof(JournalRecord)) {
+            break;
+        }
+        size_t count = (size_t)bytes / sizeof(JournalRecord);
+        for (size_t i = 0; i < count; i++) {
+            if (records[i].lsn != last_lsn + 1 || records[i].crc32 != record_crc(&records[i])) {
+                done = true;
+                break;
+            }
+            last_lsn = records[i].lsn;
+        }
+        offset += (off_t)(count * sizeof(JournalRecord));
+    }
+
+    close(fd);
+    return last_lsn;
+}
+
+static int compare_lsn(const void* a, const void* b) {
+    uint64_t lhs = *(const uint64_t*)a;
+    uint64_t rhs = *(const uint64_t*)b;
+    return (lhs > rhs) - (lhs < rhs);
+}
+
+// Returns the first LSNs of the segments in a directory in ascending order,
+// or -1 if the directory cannot be read
+static int list_segments(const char* directory, uint64_t** segments, size_t* count) {
+    *segments = NULL;
+    *count = 0;
+
+    DIR* dir = opendir(directory);
+    if (!dir) {
+        return -1;
+    }
+
+    size_t capacity = 0;
+    struct dirent* entry;
+    while ((entry = readdir(dir)) != NULL) {
+        uint64_t first_lsn;
+        if (sscanf(entry->d_name, "journal-%" SCNu64 ".log", &first_lsn) != 1 || first_lsn == 0) {
+            continue;
+        }
+        if (*count == capacity) {
+            capacity = capacity ? capacity * 2 : 16;
+            uint64_t* grown = realloc(*segments, capacity * sizeof(uint64_t));
+            if (!grown) {
+                free(*segments);
+                *segments = NULL;
+                *count = 0;
+                closedir(dir);
+                return -1;
+            }
+            *segments = grown;
+        }
+        (*segments)[(*count)++] = first_lsn;
+    }
+    closedir(dir);
+
+    qsort(*segments, *count, sizeof(uint64_t), compare_lsn);
+    return 0;
+}
+
+// Finds where numbering should resume from the newest segment in the directory
+static uint64_t find_next_lsn(const char* directory) {
+    uint64_t* segments;
+    size_t count;
+    if (list_segments(directory, &segments, &count) != 0 || count == 0) {
+        free(segments);
+        return 1;
+    }
+
+    uint64_t newest = segments[count - 1];
+    free(segments);
+
+    char path[PATH_MAX];
+    if (segment_path(path, sizeof(path), directory, newest) != 0) {
+        return 1;
+    }
+    return scan_segment(path, newest) + 1;
+}
+
+static int open_segment(Journal* journal, uint64_t first_lsn) {
+    char path[PATH_MAX];
+    if (segment_path(path, sizeof(path), journal->directory, first_lsn) != 0) {
+        return -1;
+    }
+
+    int fd = open(path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        LOG_ERROR("Failed to create journal segment %s: %s", path, strerror(errno));
+        return -1;
+    }
+
+    // Preallocating means later appends never change the file size, so
+    // fdatasync only has to flush data blocks rather than inode metadata
+    if (fallocate(fd, 0, 0, (off_t)journal->segment_size) != 0) {
+        int err = posix_fallocate(fd, 0, (off_t)journal->segment_size);
+        if (err != 0) {
+            LOG_ERROR("Failed to preallocate journal segment %s: %s", path, strerror(err));
+            close(fd);
+            return -1;
+        }
+    }
+
+    JournalSegmentHeader header = {0};
+    memcpy(header.magic, JOURNAL_SEGMENT_MAGIC, sizeof(header.magic));
+    header.version = JOURNAL_VERSION;
+    header.record_size = sizeof(JournalRecord);
+    header.first_lsn = first_lsn;
+    if (pwrite(fd, &header, sizeof(header), 0) != (ssize_t)sizeof(header) ||
+        fdatasync(fd) != 0 || sync_directory(journal->directory) != 0) {
+        LOG_ERROR("Failed to initialize journal segment %s: %s", path, strerror(errno));
+        close(fd);
+        return -1;
+    }
+
+    if (journal->segment_fd >= 0) {
+        close(journal->segment_fd);
+    }
+    journal->segment_fd = fd;
+    journal->segment_offset = sizeof(header);
+    LOG_INFO("Opened journal segment %s", path);
+    return 0;
+}
+
+static int write_records(Journal* journal, const JournalRecord* records, size_t count) {
+    const char* data = (const char*)records;
+    size_t bytes = count * sizeof(JournalRecord);
+    while (bytes > 0) {
+        ssize_t written = pwrite(journal->segment_fd, data, bytes, (off_t)journal->segment_offset);
+        if (written < 0) {
+            if (errno == EINTR) continue;
+            return -1;
+        }
+        data += written;
+        bytes -= (size_t)written;
+        journal->segment_offset += (size_t)written;
+    }
+    return 0;
+}
+
+// Writes a batch, rolling to new segments as they fill, then makes it durable
+static int flush_batch(Journal* journal, const JournalRecord* records, size_t count) {
+    size_t done = 0;
+    while (done < count) {
+        size_t room = (journal->segment_size - journal->segment_offset) / sizeof(JournalRecord);
+        if (room == 0 || journal->segment_fd < 0) {
+            if (journal->segment_fd >= 0 && fdatasync(journal->segment_fd) != 0) {
+                return -1;
+            }
+            if (open_segment(journal, records[done].lsn) != 0) {
+                return -1;
+            }
+            continue;
+        }
+
+        size_t run = count - done < room ? count - done : room;
+        if (write_records(journal, records + done, run) != 0) {
+            return -1;
+        }
+        done += run;
+    }
+
+    return fdatasync(journal->segment_fd);
+}
+
+static void* writer_thread(void* arg) {
+    Journal* journal = (Journal*)arg;
+
+    pthread_mutex_lock(&journal->lock);
+    while (journal->running || journal->pending_count > 0) {
+        while (journal->pending_count == 0 && journal->running) {
+            pthread_cond_wait(&journal->pending_cond, &journal->lock);
+        }
+        if (journal->pending_count == 0) {
+            break;
+        }
+
+        // Group commit window: let concurrent producers join this batch
+        if (journal->running && journal->pending_count < (size_t)journal->max_batch_events) {
+            struct timespec deadline;
+            clock_gettime(CLOCK_REALTIME, &deadline);
+            deadline.tv_nsec += (long)journal->group_commit_us * 1000;
+            deadline.tv_sec += deadline.tv_nsec / 1000000000L;
+            deadline.tv_nsec %= 1000000000L;
+            while (journal->running &&
+                   journal->pending_count < (size_t)journal->max_batch_events &&
+                   pthread_cond_timedwait(&journal->pending_cond, &journal->lock, &deadline) == 0) {
+            }
+        }
+
+        JournalRecord* batch = journal->pending;
+        size_t batch_capacity = journal->pending_capacity;
+        size_t count = journal->pending_count;
+        journal->pending = journal->writing;
+        journal->pending_capacity = journal->writing_capacity;
+        journal->pending_count = 0;
+        journal->writing = batch;
+        journal->writing_capacity = batch_capacity;
+        bool failed = journal->failed;
+        pthread_mutex_unlock(&journal->lock);
+
+        int result = failed ? -1 : flush_batch(journal, batch, count);
+
+        pthread_mutex_lock(&journal->lock);
+        if (result == 0) {
+            journal->durable_lsn = batch[count - 1].lsn;
+        } else if (!journal->failed) {
+            LOG_ERROR("Journal write failed, events from LSN %lu are not durable: %s",
+                      batch[0].lsn, strerror(errno));
+            journal->failed = true;
+        }
+        pthread_cond_broadcast(&journal->durable_cond);
+    }
+    pthread_mutex_unlock(&journal->lock);
+    return NULL;
+}
+
+Journal* journal_create(const JournalConfig* config) {
+    if (!config || !config->directory) {
+        LOG_ERROR("Invalid journal configuration");
+        return NULL;
+    }
+
+    Journal* journal = calloc(1, sizeof(Journal));
+    if (!journal) {
+        LOG_ERROR("Failed to allocate journal");
+        return NULL;
+    }
+
+    if (snprintf(journal->directory, sizeof(journal->directory), "%s", config->directory) >=
+        (int)sizeof(journal->directory)) {
+        LOG_ERROR("Journal directory path too long");
+        free(journal);
+        return NULL;
+    }
+
+    journal->segment_size = config->segment_size ? config->segment_size : DEFAULT_SEGMENT_SIZE;
+    journal->group_commit_us = config->group_commit_us > 0 ? config->group_commit_us
+                                                           : DEFAULT_GROUP_COMMIT_US;
+    journal->max_batch_events = config->max_batch_events > 0 ? config->max_batch_events
+                                                             : DEFAULT_MAX_BATCH_EVENTS;
+    journal->async_ack = config->async_ack;
+    journal->cpus = config->cpus;
+    journal->segment_fd = -1;
+
+    if (journal->segment_size < sizeof(JournalSegmentHeader) + sizeof(JournalRecord)) {
+        LOG_ERROR("Journal segment size %zu is too small", journal->segment_size);
+        free(journal);
+        return NULL;
+    }
+
+    journal->pending_capacity = journal->writing_capacity = (size_t)journal->max_batch_events;
+    journal->pending = malloc(journal->pending_capacity * sizeof(JournalRecord));
+    journal->writing = malloc(journal->writing_capacity * sizeof(JournalRecord));
+    if (!journal->pending || !journal->writing) {
+        LOG_ERROR("Failed to allocate journal buffers");
+        free(journal->pending);
+        free(journal->writing);
+        free(journal);
+        return NULL;
+    }
+
+    journal->next_lsn = find_next_lsn(journal->directory);
+    journal->durable_lsn = journal->next_lsn - 1;
+
+    pthread_mutex_init(&journal->lock, NULL);
+    pthread_cond_init(&journal->pending_cond, NULL);
+    pthread_cond_init(&journal->durable_cond, NULL);
+
+    LOG_INFO("Journal in %s resumes at LSN %lu (%s acks)", journal->directory,
+             journal->next_lsn, journal->async_ack ? "async" : "durable");
+    return journal;
+}
+
+void journal_destroy(Journal* journal) {
+    if (!journal) {
+        return;
+    }
+
+    if (journal->running) {
+        journal_stop(journal);
+    }
+
+    if (journal->segment_fd >= 0) {
+        close(journal->segment_fd);
+    }
+    pthread_mutex_destroy(&journal->lock);
+    pthread_cond_destroy(&journal->pending_cond);
+    pthread_cond_destroy(&journal->durable_cond);
+    free(journal->pending);
+    free(journal->writing);
+    free(journal);
+}
+
+int journal_start(Journal* journal) {
+    if (!journal || journal->running) {
+        return -1;
+    }
+
+    // Always begin a fresh segment rather than appending after a possibly torn tail
+    if (open_segment(journal, journal->next_lsn) != 0) {
+        return -1;
+    }
+
+    journal->running = true;
+    if (cpu_thread_create(&journal->writer_thread, &journal->cpus, -1, writer_thread, journal) != 0) {
+        LOG_ERROR("Failed to start journal writer thread");
+        journal->running = false;
+        return -1;
+    }
+    return 0;
+}
+
+int journal_stop(Journal* journal) {
+    if (!journal || !journal->running) {
+        return -1;
+    }
+
+    pthread_mutex_lock(&journal->lock);
+    journal->running = false;
+    pthread_cond_broadcast(&journal->pending_cond);
+    pthread_mutex_unlock(&journal->lock);
+
+    pthread_join(journal->writer_thread, NULL);
+    LOG_INFO("Journal stopped at durable LSN %lu", journal->durable_lsn);
+    return 0;
+}
+
+uint64_t journal_append(Journal* journal, JournalRecord* record) {
+    if (!journal || !record) {
+        return 0;
+    }
+
+    pthread_mutex_lock(&journal->lock);
+    if (journal->failed || !journal->running) {
+        pthread_mutex_unlock(&journal->lock);
+        return 0;
+    }
+
+    if (journal->pending_count == journal->pending_capacity) {
+        size_t capacity = journal->pending_capacity * 2;
+        JournalRecord* grown = realloc(journal->pending, capacity * sizeof(JournalRecord));
+        if (!grown) {
+            pthread_mutex_unlock(&journal->lock);
+            LOG_ERROR("Failed to grow journal batch");
+            return 0;
+        }
+        journal->pending = grown;
+        journal->pending_capacity = capacity;
+    }
+
+    record->lsn = journal->next_lsn++;
+    record->crc32 = record_crc(record);
+    journal->pending[journal->pending_count++] = *record;
+
+    // Wake the writer when a batch starts or fills up
+    if (journal->pending_count == 1 ||
+        journal->pending_count == (size_t)journal->max_batch_events) {
+        pthread_cond_signal(&journal->pending_cond);
+    }
+
+    uint64_t lsn = record->lsn;
+    pthread_mutex_unlock(&journal->lock);
+    return lsn;
+}
+
+uint64_t journal_record_order(Journal* journal, const Order* order) {
+    if (!order) {
+        return 0;
+    }
+
+    JournalRecord record = {0};
+    record.type = JOURNAL_EVENT_ORDER;
+    record.flags = order->is_buy_order ? JOURNAL_FLAG_BUY : 0;
+    if (order->time_in_force == ORDER_TIF_IOC) {
+        record.flags |= JOURNAL_FLAG_IOC;
+    } else if (order->time_in_force == ORDER_TIF_FOK) {
+        record.flags |= JOURNAL_FLAG_FOK;
+    }
+    if (order->is_market) {
+        record.flags |= JOURNAL_FLAG_MARKET;
+    }
+    record.timestamp_ns = wall_clock_ns();
+    snprintf(record.symbol, sizeof(record.symbol), "%s", order->symbol);
+    snprintf(record.order_id, sizeof(record.order_id), "%s", order_get_id(order));
+    snprintf(record.counterpart_id, sizeof(record.counterpart_id), "%s", order_get_trader_id(order));
+    record.price = order->price;
+    record.sequence = order->sequence;
+    record.quantity = order->quantity;
+    record.display_quantity = order->display_quantity;
+    return journal_append(journal, &record);
+}
+
+void journal_restore_order_type(const JournalRecord* record, Order* order) {
+    if (!record || !order) {
+        return;
+    }
+    order->time_in_force = (record->flags & JOURNAL_FLAG_FOK) ? ORDER_TIF_FOK
+                         : (record->flags & JOURNAL_FLAG_IOC) ? ORDER_TIF_IOC
+                         : ORDER_TIF_GTC;
+    order->is_market = (record->flags & JOURNAL_FLAG_MARKET) != 0;
+    order_set_display_quantity(order, record->display_quantity);
+}
+
+uint64_t journal_record_cancel(Journal* journal, const char* symbol, const char* order_id,
+                               bool is_buy_order) {
+    if (!symbol || !order_id) {
+        return 0;
+    }
+
+    JournalRecord record = {0};
+    record.type = JOURNAL_EVENT_CANCEL;
+    record.flags = is_buy_order ? JOURNAL_FLAG_BUY : 0;
+    record.timestamp_ns = wall_clock_ns();
+    snprintf(record.symbol, sizeof(record.symbol), "%s", symbol);
+    snprintf(record.order_id, sizeof(record.order_id), "%s", order_id);
+    return journal_append(journal, &record);
+}
+
+uint64_t journal_record_modify(Journal* journal, const char* symbol, const char* order_id,
+                               bool is_buy_order, double price, int quantity, uint64_t sequence) {
+    if (!symbol || !order_id) {
+        return 0;
+    }
+
+    JournalRecord record = {0};
+    record.type = JOURNAL_EVENT_MODIFY;
+    record.flags = is_buy_order ? JOURNAL_FLAG_BUY : 0;
+    record.timestamp_ns = wall_clock_ns();
+    snprintf(record.symbol, sizeof(record.symbol), "%s", symbol);
+    snprintf(record.order_id, sizeof(record.order_id), "%s", order_id);
+    record.price = price;
+    record.sequence = sequence;
+    record.quantity = quantity;
+    return journal_append(journal, &record);
+}
+
+uint64_t journal_record_fill(Journal* journal, const char* symbol, const char* buy_order_id,
+                             const char* sell_order_id, double price, int quantity) {
+    if (!symbol || !buy_order_id || !sell_order_id) {
+        return 0;
+    }
+
+    JournalRecord record = {0};
+    record.type = JOURNAL_EVENT_FILL;
+    record.timestamp_ns = wall_clock_ns();
+    snprintf(record.symbol, sizeof(record.symbol), "%s", symbol);
+    snprintf(record.order_id, sizeof(record.order_id), "%s", buy_order_id);
+    snprintf(record.counterpart_id, sizeof(record.counterpart_id), "%s", sell_order_id);
+    record.price = price;
+    record.quantity = quantity;
+    return journal_append(journal, &record);
+}
+
+int journal_flush(Journal* journal, uint64_t lsn) {
+    if (!journal) {
+        return -1;
+    }
+
+    // Anything already appended is written eventually, since stopping drains the batch
+    pthread_mutex_lock(&journal->lock);
+    while (journal->durable_lsn < lsn && lsn < journal->next_lsn && !journal->failed) {
+        pthread_cond_wait(&journal->durable_cond, &journal->lock);
+    }
+    int result = journal->durable_lsn >= lsn ? 0 : -1;
+    pthread_mutex_unlock(&journal->lock);
+    return result;
+}
+
+int journal_wait_durable(Journal* journal, uint64_t lsn) {
+    if (!journal || lsn == 0) {
+        return -1;
+    }
+    if (journal->async_ack) {
+        return 0;
+    }
+    return journal_flush(journal, lsn);
+}
+
+uint64_t journal_durable_lsn(Journal* journal) {
+    if (!journal) {
+        return 0;
+    }
+    pthread_mutex_lock(&journal->lock);
+    uint64_t lsn = journal->durable_lsn;
+    pthread_mutex_unlock(&journal->lock);
+    return lsn;
+}
+
+uint64_t journal_last_lsn(Journal* journal) {
+    if (!journal) {
+        return 0;
+    }
+    pthread_mutex_lock(&journal->lock);
+    uint64_t lsn = journal->next_lsn - 1;
+    pthread_mutex_unlock(&journal->lock);
+    return lsn;
+}
+
+const char* journal_get_directory(const Journal* journal) {
+    return journal ? journal->directory : NULL;
+}
+
+int journal_truncate(Journal* journal, uint64_t lsn) {
+    if (!journal) {
+        return -1;
+    }
+
+    uint64_t* segments;
+    size_t count;
+    if (list_segments(journal->directory, &segments, &count) != 0) {
+        LOG_ERROR("Failed to list journal directory %s", journal->directory);
+        return -1;
+    }
+
+    // A segment ends where the next one begins, so the newest is always kept
+    int removed = 0;
+    for (size_t i = 0; i + 1 < count && segments[i + 1] - 1 <= lsn; i++) {
+        char path[PATH_MAX];
+        if (segment_path(path, sizeof(path), journal->directory, segments[i]) != 0) {
+            break;
+        }
+        if (unlink(path) != 0) {
+            LOG_WARN("Failed to remove journal segment %s: %s", path, strerror(errno));
+            break;
+        }
+        removed++;
+    }
+    free(segments);
+
+    if (removed > 0) {
+        sync_directory(journal->directory);
+        LOG_INFO("Removed %d journal segments covered by LSN %lu", removed, lsn);
+    }
+    return removed;
+}
+
+struct JournalReader {
+    char directory[PATH_MAX];
+    uint64_t* segments;
+    size_t segment_count;
+    size_t next_segment;
+    uint64_t next_lsn;         // LSN the next record must carry
+
+    const char* data;          // Current mapped segment
+    size_t size;
+    size_t offset;
+};
+
+static void unmap_segment(JournalReader* reader) {
+    if (reader->data) {
+        munmap((void*)reader->data, reader->size);
+        reader->data = NULL;
+    }
+}
+
+static int map_segment(JournalReader* reader, uint64_t first_lsn) {
+    char path[PATH_MAX];
+    if (segment_path(path, sizeof(path), reader->directory, first_lsn) != 0) {
+        return -1;
+    }
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        LOG_ERROR("Failed to open journal segment %s: %s", path, strerror(errno));
+        return -1;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(JournalSegmentHeader)) {
+        LOG_ERROR("Journal segment %s is too small", path);
+        close(fd);
+        return -1;
+    }
+
+    const char* data = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) {
+        LOG_ERROR("Failed to map journal segment %s: %s", path, strerror(errno));
+        return -1;
+    }
+    madvise((void*)data, (size_t)st.st_size, MADV_SEQUENTIAL);
+
+    const JournalSegmentHeader* header = (const JournalSegmentHeader*)data;
+    if (memcmp(header->magic, JOURNAL_SEGMENT_MAGIC, sizeof(header->magic)) != 0 ||
+        header->version != JOURNAL_VERSION || header->record_size != sizeof(JournalRecord) ||
+        header->first_lsn != first_lsn) {
+        LOG_ERROR("Journal segment %s has an unknown format", path);
+        munmap((void*)data, (size_t)st.st_size);
+        return -1;
+    }
+
+    reader->data = data;
+    reader->size = (size_t)st.st_size;
+    reader->offset = sizeof(JournalSegmentHeader);
+    return 0;
+}
+
+JournalReader* journal_reader_open(const char* directory, uint64_t from_lsn) {
+    if (!directory) {
+        LOG_ERROR("Invalid journal directory");
+        return NULL;
+    }
+
+    JournalReader* reader = calloc(1, sizeof(JournalReader));
+    if (!reader) {
+        LOG_ERROR("Failed to allocate journal reader");
+        return NULL;
+    }
+
+    snprintf(reader->directory, sizeof(reader->directory), "%s", directory);
+    if (list_segments(directory, &reader->segments, &reader->segment_count) != 0) {
+        LOG_ERROR("Failed to list journal directory %s: %s", directory, strerror(errno));
+        free(reader);
+        return NULL;
+    }
+
+    // Start from the last segment that begins at or before from_lsn
+    reader->next_lsn = from_lsn ? from_lsn : 1;
+    while (reader->next_segment + 1 < reader->segment_count &&
+           reader->segments[reader->next_segment + 1] <= reader->next_lsn) {
+        reader->next_segment++;
+    }
+    if (reader->segment_count > 0 && reader->segments[reader->next_segment] > reader->next_lsn) {
+        LOG_WARN("Journal %s starts at LSN %lu, after requested LSN %lu", directory,
+                 reader->segments[reader->next_segment], reader->next_lsn);
+        reader->next_lsn = reader->segments[reader->next_segment];
+    }
+    return reader;
+}
+
+const JournalRecord* journal_reader_next(JournalReader* reader) {
+    if (!reader) {
+        return NULL;
+    }
+
+    for (;;) {
+        if (!reader->data) {
+            if (reader->next_segment >= reader->segment_count) {
+                return NULL;
+            }
+            uint64_t first_lsn = reader->segments[reader->next_segment++];
+            if (first_lsn > reader->next_lsn) {
+                LOG_ERROR("Journal is missing LSNs %lu to %lu", reader->next_lsn, first_lsn - 1);
+                reader->next_segment = reader->segment_count;
+                return NULL;
+            }
+            if (map_segment(reader, first_lsn) != 0) {
+                reader->next_segment = reader->segment_count;
+                return NULL;
+            }
+        }
+
+        while (reader->size - reader->offset >= sizeof(JournalRecord)) {
+            const JournalRecord* record = (const JournalRecord*)(reader->data + reader->offset);
+            if (record->crc32 != record_crc(record) || record->lsn == 0) {
+                break;  // Unwritten or torn tail of this segment
+            }
+            reader->offset += sizeof(JournalRecord);
+            if (record->lsn < reader->next_lsn) {
+                continue;  // Before the requested start
+            }
+            if (record->lsn != reader->next_lsn) {
+                break;
+            }
+            reader->next_lsn++;
+            return record;
+        }
+
+        unmap_segment(reader);
+    }
+}
+
+void journal_reader_close(JournalReader* reader) {
+    if (!reader) {
+        return;
+    }
+    unmap_segment(reader);
+    free(reader->segments);
+    free(reader);
+}
@@ -0,0 +1,131 @@
+#include "server/latency_stats.h"
+#include "utils/clock.h"
+#include "utils/latency_histogram.h"
+#include "utils/logging.h"
+#include <stdlib.h>
+#include <string.h>
+
+struct LatencyStats {
+    LatencyHistogram* stages[LATENCY_STAGE_COUNT];
+};
+
+static const char* const stage_names[LATENCY_STAGE_COUNT] = {
+    [LATENCY_STAGE_RECEIVE] = "receive",
+    [LATENCY_STAGE_QUEUE] = "queue",
+    [LATENCY_STAGE_DECODE] = "decode",
+    [LATENCY_STAGE_MATCH] = "match",
+    [LATENCY_STAGE_JOURNAL] = "journal",
+    [LATENCY_STAGE_SERIALIZE] = "serialize",
+    [LATENCY_STAGE_WRITE] = "write",
+    [LATENCY_STAGE_TOTAL] = "total"
+};
+
+LatencyStats* latency_stats_create(void) {
+    LatencyStats* stats = calloc(1, sizeof(LatencyStats));
+    if (!stats) {
+        LOG_ERROR("Failed to allocate latency stats");
+        return NULL;
+    }
+
+    for (int i = 0; i < LATENCY_STAGE_COUNT; i++) {
+        stats->stages[i] = latency_histogram_create();
+        if (!stats->stages[i]) {
+            latency_stats_destroy(stats);
+            return NULL;
+        }
+    }
+    return stats;
+}
+
+void latency_stats_destroy(LatencyStats* stats) {
+    if (!stats) {
+        return;
+    }
+    for (int i = 0; i < LATENCY_STAGE_COUNT; i++) {
+        latency_histogram_destroy(stats->stages[i]);
+    }
+    free(stats);
+}
+
+const char* latency_stage_name(LatencyStage stage) {
+    return stage < LATENCY_STAGE_COUNT ? stage_names[stage] : "unknown";
+}
+
+void request_timer_start(RequestTimer* timer, int64_t received_ns) {
+    memset(timer, 0, sizeof(*timer));
+    timer->received_ns = received_ns;
+    timer->last_ns = received_ns;
+}
+
+void request_timer_mark_at(RequestTimer* timer, LatencyStage stage, int64_t now_ns) {
+    if (!timer || stage >= LATENCY_STAGE_TOTAL) {
+        return;
+    }
+    timer->stage_ns[stage] += now_ns - timer->last_ns;
+    timer->stages_seen |= 1u << stage;
+    timer->last_ns = now_ns;
+}
+
+void request_timer_mark(RequestTimer* timer, LatencyStage stage) {
+    request_timer_mark_at(timer, stage, clock_now_ns());
+}
+
+void latency_stats_prepare_thread(LatencyStats* stats) {
+    if (!stats) {
+        return;
+    }
+    for (int i = 0; i < LATENCY_STAGE_COUNT; i++) {
+        latency_histogram_prepare_thread(stats->stages[i]);
+    }
+}
+
+void latency_stats_record(LatencyStats* stats, const RequestTimer* timer) {
+    if (!stats || !timer) {
+        return;
+    }
+
+    for (int i = 0; i < LATENCY_STAGE_TOTAL; i++) {
+        if (timer->stages_seen & (1u << i)) {
+            latency_histogram_record(stats->stages[i], timer->stage_ns[i]);
+        }
+    }
+    latency_histogram_record(stats->stages[LATENCY_STAGE_TOTAL], clock_now_ns() - timer->received_ns);
+}
+
+int latency_stats_summarize(const LatencyStats* stats, LatencyStageStats* out, int max_stages) {
+    if (!stats || !out) {
+        return 0;
+    }
+
+    int count = max_stages < LATENCY_STAGE_COUNT ? max_stages : LATENCY_STAGE_COUNT;
+    for (int i = 0; i < count; i++) {
+        LatencySummary summary;
+        latency_histogram_summarize(stats->stages[i], &summary);
+
+        LatencyStageStats* entry = &out[i];
+        memset(entry, 0, sizeof(*entry));
+        strncpy(entry->stage, stage_names[i], sizeof(entry->stage) - 1);
+        entry->count = summary.count;
+        entry->mean_us = summary.mean_ns / 1e3;
+        entry->p50_us = summary.p50_ns / 1e3;
+        entry->p90_us = summary.p90_ns / 1e3;
+        entry->p99_us = summary.p99_ns / 1e3;
+        entry->p999_us = summary.p999_ns / 1e3;
+        entry->max_us = summary.max_ns / 1e3;
+    }
+    return count;
+}
+
+void latency_stats_log(const LatencyStats* stats) {
+    LatencyStageStats entries[LATENCY_STAGE_COUNT];
+    int count = latency_stats_summarize(stats, entries, LATENCY_STAGE_COUNT);
+
+    for (int i = 0; i < count; i++) {
+        if (entries[i].count == 0) {
+            continue;
+        }
+        LOG_INFO("Latency %-9s n=%lu mean=%.1fus p50=%.1fus p90=%.1fus p99=%.1fus p99.9=%.1fus max=%.1fus",
+                 entries[i].stage, entries[i].count, entries[i].mean_us, entries[i].p50_us,
+                 entries[i].p90_us, entries[i].p99_us, entries[i].p999_us, entries[i].max_us);
+    }
+}
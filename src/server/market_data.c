@@ -19,6 +19,7 @@ struct MarketData {
     
     int snapshot_interval_ms;
     int max_depth;
+    CpuList cpus;
 };
 
 static void* snapshot_thread(void* arg) {
@@ -74,6 +75,7 @@ MarketData* market_data_create(const MarketDataConfig* config) {
     market->snapshot_interval_ms = config->snapshot_interval_ms;
     market->max_depth = config->max_depth;
     market->trade_broadcaster = config->trade_broadcaster;
+    market->cpus = config->cpus;
     pthread_mutex_init((pthread_mutex_t*)&market->lock, NULL);
     
     return market;
@@ -98,7 +100,7 @@ int market_data_start_snapshot_timer(MarketData* market) {
     if (!market || market->running) return -1;
     
     market->running = true;
-    if (pthread_create(&market->snapshot_thread, NULL, snapshot_thread, market) != 0) {
+    if (cpu_thread_create(&market->snapshot_thread, &market->cpus, -1, snapshot_thread, market) != 0) {
         market->running = false;
         return -1;
     }
@@ -0,0 +1,340 @@
+#include "server/journal.h"
+#include "trading_engine/order.h"
+#include "trading_engine/order_book.h"
+#include "trading_engine/id_intern.h"
+#include "utils/clock.h"
+#include "utils/logging.h"
+#include <getopt.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define MAX_REPLAY_SYMBOLS 256
+#define INITIAL_CAPACITY 1024
+
+// A fill produced by the engine during replay, waiting for its recorded twin
+typedef struct {
+    IdHandle buy_order;
+    IdHandle sell_order;
+    double price;
+    int quantity;
+} ReplayFill;
+
+typedef struct {
+    char symbol[MAX_SYMBOL_LENGTH];
+    OrderBook* book;
+    ReplayFill* fills;
+    size_t fill_head;
+    size_t fill_count;
+    size_t fill_capacity;
+    bool failed;
+} ReplayBook;
+
+typedef struct {
+    ReplayBook books[MAX_REPLAY_SYMBOLS];
+    int book_count;
+    Order** orders;            // Every order created, freed at exit
+    size_t order_count;
+    size_t order_capacity;
+    uint64_t max_sequence;     // Highest sequence replayed or drawn by matching
+
+    uint64_t events;
+    uint64_t placed;
+    uint64_t canceled;
+    uint64_t modified;
+    uint64_t fills_verified;
+    uint64_t mismatches;
+} Replay;
+
+static void print_usage(const char* program) {
+    fprintf(stderr,
+            "Usage: %s [options] JOURNAL_DIR\n"
+            "  --from LSN   Start at LSN instead of the beginning of the journal\n"
+            "  --verbose    Log every engine event\n"
+            "  --help       Show this message\n",
+            program);
+}
+
+static void record_fill(const Order* buy_order, const Order* sell_order,
+                        double price, int quantity, void* user_data) {
+    ReplayBook* entry = (ReplayBook*)user_data;
+
+    if (entry->fill_head == entry->fill_count) {
+        entry->fill_head = entry->fill_count = 0;
+    }
+    if (entry->fill_count == entry->fill_capacity) {
+        size_t capacity = entry->fill_capacity ? entry->fill_capacity * 2 : INITIAL_CAPACITY;
+        ReplayFill* grown = realloc(entry->fills, capacity * sizeof(ReplayFill));
+        if (!grown) {
+            LOG_ERROR("Failed to grow replay fill queue for %s", entry->symbol);
+            entry->failed = true;
+            return;
+        }
+        entry->fills = grown;
+        entry->fill_capacity = capacity;
+    }
+
+    ReplayFill* fill = &entry->fills[entry->fill_count++];
+    fill->buy_order = buy_order->order_handle;
+    fill->sell_order = sell_order->order_handle;
+    fill->price = price;
+    fill->quantity = quantity;
+}
+
+static ReplayBook* find_book(Replay* replay, const char* symbol, bool create) {
+    for (int i = 0; i < replay->book_count; i++) {
+        if (strcmp(replay->books[i].symbol, symbol) == 0) {
+            return &replay->books[i];
+        }
+    }
+
+    if (!create || replay->book_count >= MAX_REPLAY_SYMBOLS) {
+        return NULL;
+    }
+
+    ReplayBook* entry = &replay->books[replay->book_count];
+    memset(entry, 0, sizeof(*entry));
+    entry->book = order_book_create(NULL);
+    if (!entry->book) {
+        return NULL;
+    }
+    strncpy(entry->symbol, symbol, MAX_SYMBOL_LENGTH - 1);
+    order_book_set_trade_callback(entry->book, record_fill, entry);
+    replay->book_count++;
+    return entry;
+}
+
+static int track_order(Replay* replay, Order* order) {
+    if (replay->order_count == replay->order_capacity) {
+        size_t capacity = replay->order_capacity ? replay->order_capacity * 2 : INITIAL_CAPACITY;
+        Order** grown = realloc(replay->orders, capacity * sizeof(Order*));
+        if (!grown) {
+            return -1;
+        }
+        replay->orders = grown;
+        replay->order_capacity = capacity;
+    }
+    replay->orders[replay->order_count++] = order;
+    return 0;
+}
+
+static void report_mismatch(Replay* replay, const JournalRecord* record, const char* reason) {
+    replay->mismatches++;
+    LOG_ERROR("LSN %lu (%s %s): %s", record->lsn, record->symbol, record->order_id, reason);
+}
+
+// Replenishing icebergs while matching draws sequences. Restarting the
+// counter past everything replayed so far reissues the ones the recorded
+// run drew, relative to the other orders in the book.
+static void begin_event(Replay* replay, uint64_t sequence) {
+    if (sequence > replay->max_sequence) {
+        replay->max_sequence = sequence;
+    }
+    order_restart_sequence(replay->max_sequence + 1);
+}
+
+static void end_event(Replay* replay) {
+    replay->max_sequence = order_reserve_sequences(0) - 1;
+}
+
+static void replay_order(Replay* replay, const JournalRecord* record) {
+    ReplayBook* entry = find_book(replay, record->symbol, true);
+    if (!entry) {
+        report_mismatch(replay, record, "no book for symbol");
+        return;
+    }
+
+    Order* order = order_create(record->order_id, record->counterpart_id, record->symbol,
+                                record->price, record->quantity,
+                                (record->flags & JOURNAL_FLAG_BUY) != 0);
+    if (!order || track_order(replay, order) != 0) {
+        order_destroy(order);
+        report_mismatch(replay, record, "failed to create order");
+        return;
+    }
+    // Keep the recorded time priority
+    order->sequence = record->sequence;
+    journal_restore_order_type(record, order);
+
+    begin_event(replay, record->sequence);
+    if (!order_can_rest(order)) {
+        if (order_book_execute_order(entry->book, order) < 0) {
+            report_mismatch(replay, record, "order refused by book");
+        } else {
+            replay->placed++;
+        }
+    } else if (order_book_add_order(entry->book, order) != 0) {
+        report_mismatch(replay, record, "order rejected by book");
+    } else {
+        order_book_match_orders(entry->book);
+        replay->placed++;
+    }
+    end_event(replay);
+}
+
+static void replay_cancel(Replay* replay, const JournalRecord* record) {
+    ReplayBook* entry = find_book(replay, record->symbol, false);
+    if (!entry ||
+        order_book_cancel_order(entry->book, record->order_id,
+                                (record->flags & JOURNAL_FLAG_BUY) != 0) != 0) {
+        report_mismatch(replay, record, "cancel did not find a live order");
+        return;
+    }
+    replay->canceled++;
+}
+
+static void replay_modify(Replay* replay, const JournalRecord* record) {
+    ReplayBook* entry = find_book(replay, record->symbol, false);
+    if (!entry ||
+        order_book_modify_order(entry->book, record->order_id,
+                                (record->flags & JOURNAL_FLAG_BUY) != 0,
+                                record->price, record->quantity, record->sequence) != 0) {
+        report_mismatch(replay, record, "modify did not find a live order");
+        return;
+    }
+    begin_event(replay, record->sequence);
+    order_book_match_orders(entry->book);
+    end_event(replay);
+    replay->modified++;
+}
+
+// Recorded fills must match what the engine just produced, field for field
+static void verify_fill(Replay* replay, const JournalRecord* record) {
+    ReplayBook* entry = find_book(replay, record->symbol, false);
+    if (!entry || entry->fill_head == entry->fill_count) {
+        report_mismatch(replay, record, "recorded fill was not produced");
+        return;
+    }
+
+    const ReplayFill* fill = &entry->fills[entry->fill_head++];
+    if (fill->buy_order != id_intern_find(record->order_id) ||
+        fill->sell_order != id_intern_find(record->counterpart_id) ||
+        memcmp(&fill->price, &record->price, sizeof(double)) != 0 ||
+        fill->quantity != record->quantity) {
+        char reason[256];
+        snprintf(reason, sizeof(reason),
+                 "fill differs: replay %s/%s %d @ %.17g, recorded %s/%s %d @ %.17g",
+                 id_intern_str(fill->buy_order), id_intern_str(fill->sell_order),
+                 fill->quantity, fill->price, record->order_id, record->counterpart_id,
+                 record->quantity, record->price);
+        report_mismatch(replay, record, reason);
+        return;
+    }
+    replay->fills_verified++;
+}
+
+int main(int argc, char* argv[]) {
+    uint64_t from_lsn = 1;
+    bool verbose = false;
+
+    static const struct option options[] = {
+        {"from", required_argument, NULL, 'f'},
+        {"verbose", no_argument, NULL, 'v'},
+        {"help", no_argument, NULL, 'h'},
+        {NULL, 0, NULL, 0}
+    };
+
+    int opt;
+    while ((opt = getopt_long(argc, argv, "f:vh", options, NULL)) != -1) {
+        switch (opt) {
+            case 'f':
+                from_lsn = strtoull(optarg, NULL, 10);
+                break;
+            case 'v':
+                verbose = true;
+                break;
+            case 'h':
+                print_usage(argv[0]);
+                return EXIT_SUCCESS;
+            default:
+                print_usage(argv[0]);
+                return EXIT_FAILURE;
+        }
+    }
+
+    if (optind != argc - 1) {
+        print_usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    // The engine logs every match at info level, which would dominate the timing
+    set_log_level(verbose ? LOG_DEBUG : LOG_WARNING);
+
+    JournalReader* reader = journal_reader_open(argv[optind], from_lsn);
+    if (!reader) {
+        return EXIT_FAILURE;
+    }
+
+    Replay* replay = calloc(1, sizeof(Replay));
+    if (!replay) {
+        journal_reader_close(reader);
+        return EXIT_FAILURE;
+    }
+
+    uint64_t first_lsn = 0;
+    uint64_t last_lsn = 0;
+    int64_t start = clock_now_ns();
+
+    const JournalRecord* record;
+    while ((record = journal_reader_next(reader)) != NULL) {
+        if (!first_lsn) {
+            first_lsn = record->lsn;
+        }
+        last_lsn = record->lsn;
+        replay->events++;
+
+        switch (record->type) {
+            case JOURNAL_EVENT_ORDER:
+                replay_order(replay, record);
+                break;
+            case JOURNAL_EVENT_CANCEL:
+                replay_cancel(replay, record);
+                break;
+            case JOURNAL_EVENT_MODIFY:
+                replay_modify(replay, record);
+                break;
+            case JOURNAL_EVENT_FILL:
+                verify_fill(replay, record);
+                break;
+            default:
+                report_mismatch(replay, record, "unknown event type");
+                break;
+        }
+    }
+
+    int64_t elapsed_ns = clock_now_ns() - start;
+    journal_reader_close(reader);
+
+    // Fills produced after the last recorded one were lost with a torn journal tail
+    uint64_t unrecorded = 0;
+    for (int i = 0; i < replay->book_count; i++) {
+        ReplayBook* entry = &replay->books[i];
+        unrecorded += entry->fill_count - entry->fill_head;
+        if (entry->failed) {
+            replay->mismatches++;
+        }
+    }
+
+    double seconds = elapsed_ns / 1e9;
+    printf("Replayed LSN %lu-%lu: %lu events in %.3f s (%.0f events/s)\n",
+           first_lsn, last_lsn, replay->events, seconds,
+           seconds > 0 ? replay->events / seconds : 0.0);
+    printf("  orders:    %lu\n", replay->placed);
+    printf("  cancels:   %lu\n", replay->canceled);
+    printf("  modifies:  %lu\n", replay->modified);
+    printf("  fills:     %lu verified, %lu not in journal\n", replay->fills_verified, unrecorded);
+    printf("  mismatches: %lu\n", replay->mismatches);
+
+    for (int i = 0; i < replay->book_count; i++) {
+        order_book_destroy(replay->books[i].book);
+        free(replay->books[i].fills);
+    }
+    for (size_t i = 0; i < replay->order_count; i++) {
+        order_destroy(replay->orders[i]);
+    }
+    free(replay->orders);
+
+    int status = replay->mismatches == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+    free(replay);
+    return status;
+}
@@ -2,12 +2,34 @@
 #include "server/server_handlers.h"
 #include "server/session_manager.h"
 #include "server/market_data.h"
+#include "server/journal.h"
+#include "server/checkpointer.h"
+#include "trading_engine/trade_broadcaster.h"
+#include "protocol/protocol_constants.h"
+#include "utils/cpu_affinity.h"
 #include "utils/logging.h"
+#include <getopt.h>
 #include <signal.h>
+#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <unistd.h>
 
+#define DEFAULT_DENSE_LEVELS 4096
+#define DEFAULT_CHECKPOINT_INTERVAL_S 60
+#define DEFAULT_STATS_INTERVAL_S 60
+#define DEFAULT_BUSY_POLL_IDLE_US 1000
+#define DEFAULT_MAX_CLIENTS 1024
+#define DEFAULT_RATE_BURST 100
+#define DEFAULT_MAX_IN_FLIGHT 16
+#define MIN_MESSAGE_QUEUE_SIZE 1000
+#define DEFAULT_MAX_MESSAGE_SIZE (64 * 1024)
+
+typedef struct {
+    char symbol[16];
+    OrderBookConfig config;
+} BookSelection;
+
 static volatile bool running = true;
 
 static void handle_signal(int signum) {
@@ -15,14 +37,267 @@ static void handle_signal(int signum) {
     running = false;
 }
 
+static void print_usage(const char* program) {
+    fprintf(stderr,
+            "Usage: %s [options]\n"
+            "  --dense SYMBOL:TICK[:LEVELS]  Use the dense price-level book for SYMBOL\n"
+            "  --snapshot FILE               Restore books from FILE at start, checkpoint them to it\n"
+            "  --checkpoint-interval SEC     Seconds between checkpoints, 0 for shutdown only (default %d)\n"
+            "  --journal DIR                 Write order events to a write-ahead journal in DIR\n"
+            "  --async-ack                   Ack orders without waiting for the journal to sync\n"
+            "  --stats-interval SEC          Seconds between latency logs, 0 to disable (default %d)\n"
+            "  --metrics-port PORT           Serve counters and latency at http://host:PORT/metrics\n"
+            "  --max-clients N               Refuse connections beyond N (default %d)\n"
+            "  --max-clients-per-ip N        Refuse connections beyond N from one address, 0 for no limit\n"
+            "  --shed-queued N               Refuse connections while N sends wait to be written, 0 to disable\n"
+            "  --max-message-size BYTES      Largest message a client may send (default %d)\n"
+            "  --max-in-flight N             Stop reading a connection while N of its messages are queued, 0 never (default %d)\n"
+            "  --client-rate N               Messages per second accepted from one connection, 0 for no limit\n"
+            "  --client-burst N              Messages a connection may send back to back (default %d)\n"
+            "  --trader-rate N               Messages per second accepted for one trader_id, 0 for no limit\n"
+            "  --trader-burst N              Messages a trader may send back to back (default %d)\n"
+            "  --service-threads N           Websocket service threads sharing the connections (default 1)\n"
+            "  --service-cpus LIST           CPUs for the websocket service threads, e.g. 2\n"
+            "  --worker-cpus LIST            One handler worker pinned to each CPU, e.g. 3-6\n"
+            "  --background-cpus LIST        CPUs shared by market data, journal and checkpoint threads\n"
+            "  --busy-poll                   Spin the service thread and idle workers instead of sleeping\n"
+            "  --busy-poll-idle-us US        Idle time before busy polling sleeps, 0 to never sleep (default %d)\n"
+            "  --help                        Show this message\n",
+            program, DEFAULT_CHECKPOINT_INTERVAL_S, DEFAULT_STATS_INTERVAL_S, DEFAULT_MAX_CLIENTS,
+            DEFAULT_MAX_MESSAGE_SIZE, DEFAULT_MAX_IN_FLIGHT, DEFAULT_RATE_BURST, DEFAULT_RATE_BURST, DEFAULT_BUSY_POLL_IDLE_US);
+}
+
+// Parses SYMBOL:TICK[:LEVELS] into a dense book selection
+static int parse_dense_selection(const char* arg, BookSelection* selection) {
+    char buf[64];
+    strncpy(buf, arg, sizeof(buf) - 1);
+    buf[sizeof(buf) - 1] = '\0';
+
+    char* symbol = strtok(buf, ":");
+    char* tick = strtok(NULL, ":");
+    char* levels = strtok(NULL, ":");
+    if (!symbol || !tick || strlen(symbol) >= sizeof(selection->symbol)) {
+        return -1;
+    }
+
+    memset(selection, 0, sizeof(*selection));
+    strncpy(selection->symbol, symbol, sizeof(selection->symbol) - 1);
+    selection->config.backend = ORDER_BOOK_BACKEND_DENSE;
+    selection->config.tick_size = strtod(tick, NULL);
+    selection->config.num_levels = levels ? atoi(levels) : DEFAULT_DENSE_LEVELS;
+    return selection->config.tick_size > 0.0 && selection->config.num_levels > 0 ? 0 : -1;
+}
+
+static const OrderBookConfig* find_book_selection(const BookSelection* selections, int count,
+                                                  const char* symbol) {
+    for (int i = 0; i < count; i++) {
+        if (strcmp(selections[i].symbol, symbol) == 0) {
+            return &selections[i].config;
+        }
+    }
+    return NULL;
+}
+
 static void message_handler_wrapper(WSClient* client, const char* message, size_t len, void* user_data) {
     ServerHandlers* handlers = (ServerHandlers*)user_data;
     server_handlers_process_message(handlers, client, message, len);
 }
 
+static void throttle_handler(WSClient* client, void* user_data) {
+    server_handlers_reject_throttled((ServerHandlers*)user_data, client);
+}
+
+static char* metrics_page(void* user_data) {
+    ServerStatus status;
+    server_handlers_get_status((ServerHandlers*)user_data, &status);
+    return server_metrics_format_text(&status);
+}
+
 int main(int argc, char* argv[]) {
     // Initialize logging
     set_log_level(LOG_INFO);
+
+    BookSelection selections[SYMBOL_COUNT];
+    int selection_count = 0;
+    const char* snapshot_path = NULL;
+    const char* journal_dir = NULL;
+    bool async_ack = false;
+    int checkpoint_interval_s = DEFAULT_CHECKPOINT_INTERVAL_S;
+    int stats_interval_s = DEFAULT_STATS_INTERVAL_S;
+    int metrics_port = 0;
+    int max_clients = DEFAULT_MAX_CLIENTS;
+    int max_clients_per_ip = 0;
+    int shed_queued = 0;
+    int max_in_flight = DEFAULT_MAX_IN_FLIGHT;
+    int max_message_size = DEFAULT_MAX_MESSAGE_SIZE;
+    RateLimit client_limit = {.rate = 0, .burst = DEFAULT_RATE_BURST};
+    RateLimit trader_limit = {.rate = 0, .burst = DEFAULT_RATE_BURST};
+    int service_threads = 1;
+    CpuList service_cpus = {0};
+    CpuList worker_cpus = {0};
+    CpuList background_cpus = {0};
+    bool busy_poll = false;
+    int busy_poll_idle_us = DEFAULT_BUSY_POLL_IDLE_US;
+
+    static const struct option options[] = {
+        {"dense", required_argument, NULL, 'd'},
+        {"snapshot", required_argument, NULL, 's'},
+        {"journal", required_argument, NULL, 'j'},
+        {"async-ack", no_argument, NULL, 'a'},
+        {"checkpoint-interval", required_argument, NULL, 'c'},
+        {"stats-interval", required_argument, NULL, 'l'},
+        {"metrics-port", required_argument, NULL, 'm'},
+        {"max-clients", required_argument, NULL, 'C'},
+        {"max-clients-per-ip", required_argument, NULL, 'i'},
+        {"shed-queued", required_argument, NULL, 'q'},
+        {"max-message-size", required_argument, NULL, 'M'},
+        {"max-in-flight", required_argument, NULL, 'f'},
+        {"client-rate", required_argument, NULL, 'r'},
+        {"client-burst", required_argument, NULL, 'b'},
+        {"trader-rate", required_argument, NULL, 't'},
+        {"trader-burst", required_argument, NULL, 'u'},
+        {"service-threads", required_argument, NULL, 'T'},
+        {"service-cpus", required_argument, NULL, 'S'},
+        {"worker-cpus", required_argument, NULL, 'W'},
+        {"background-cpus", required_argument, NULL, 'B'},
+        {"busy-poll", no_argument, NULL, 'P'},
+        {"busy-poll-idle-us", required_argument, NULL, 'I'},
+        {"help", no_argument, NULL, 'h'},
+        {NULL, 0, NULL, 0}
+    };
+
+    int opt;
+    while ((opt = getopt_long(argc, argv, "d:s:j:ac:l:m:C:i:q:M:f:r:b:t:u:T:S:W:B:PI:h", options, NULL)) != -1) {
+        switch (opt) {
+            case 'd':
+                if (selection_count >= SYMBOL_COUNT ||
+                    parse_dense_selection(optarg, &selections[selection_count]) != 0) {
+                    fprintf(stderr, "Invalid --dense argument: %s\n", optarg);
+                    return EXIT_FAILURE;
+                }
+                selection_count++;
+                break;
+            case 's':
+                snapshot_path = optarg;
+                break;
+            case 'j':
+                journal_dir = optarg;
+                break;
+            case 'a':
+                async_ack = true;
+                break;
+            case 'c':
+                checkpoint_interval_s = atoi(optarg);
+                if (checkpoint_interval_s < 0) {
+                    fprintf(stderr, "Invalid --checkpoint-interval argument: %s\n", optarg);
+                    return EXIT_FAILURE;
+                }
+                break;
+            case 'l':
+                stats_interval_s = atoi(optarg);
+                if (stats_interval_s < 0) {
+                    fprintf(stderr, "Invalid --stats-interval argument: %s\n", optarg);
+                    return EXIT_FAILURE;
+                }
+                break;
+            case 'm':
+                metrics_port = atoi(optarg);
+                if (metrics_port <= 0 || metrics_port > 65535) {
+                    fprintf(stderr, "Invalid --metrics-port argument: %s\n", optarg);
+                    return EXIT_FAILURE;
+                }
+                break;
+            case 'C':
+                max_clients = atoi(optarg);
+                if (max_clients <= 0) {
+                    fprintf(stderr, "Invalid --max-clients argument: %s\n", optarg);
+                    return EXIT_FAILURE;
+                }
+                break;
+            case 'i':
+                max_clients_per_ip = atoi(optarg);
+                if (max_clients_per_ip < 0) {
+                    fprintf(stderr, "Invalid --max-clients-per-ip argument: %s\n", optarg);
+                    return EXIT_FAILURE;
+                }
+                break;
+            case 'q':
+                shed_queued = atoi(optarg);
+                if (shed_queued < 0) {
+                    fprintf(stderr, "Invalid --shed-queued argument: %s\n", optarg);
+                    return EXIT_FAILURE;
+                }
+                break;
+            case 'M':
+                max_message_size = atoi(optarg);
+                if (max_message_size <= 0) {
+                    fprintf(stderr, "Invalid --max-message-size argument: %s\n", optarg);
+                    return EXIT_FAILURE;
+                }
+                break;
+            case 'f':
+                max_in_flight = atoi(optarg);
+                if (max_in_flight < 0) {
+                    fprintf(stderr, "Invalid --max-in-flight argument: %s\n", optarg);
+                    return EXIT_FAILURE;
+                }
+                break;
+            case 'r':
+            case 't': {
+                RateLimit* limit = opt == 'r' ? &client_limit : &trader_limit;
+                limit->rate = atof(optarg);
+                if (limit->rate < 0) {
+                    fprintf(stderr, "Invalid rate: %s\n", optarg);
+                    return EXIT_FAILURE;
+                }
+                break;
+            }
+            case 'b':
+            case 'u': {
+                RateLimit* limit = opt == 'b' ? &client_limit : &trader_limit;
+                limit->burst = atoi(optarg);
+                if (limit->burst <= 0) {
+                    fprintf(stderr, "Invalid burst: %s\n", optarg);
+                    return EXIT_FAILURE;
+                }
+                break;
+            }
+            case 'T':
+                service_threads = atoi(optarg);
+                if (service_threads <= 0) {
+                    fprintf(stderr, "Invalid --service-threads argument: %s\n", optarg);
+                    return EXIT_FAILURE;
+                }
+                break;
+            case 'S':
+            case 'W':
+            case 'B': {
+                CpuList* list = opt == 'S' ? &service_cpus : opt == 'W' ? &worker_cpus : &background_cpus;
+                if (cpu_list_parse(optarg, list) != 0) {
+                    fprintf(stderr, "Invalid CPU list: %s\n", optarg);
+                    return EXIT_FAILURE;
+                }
+                break;
+            }
+            case 'P':
+                busy_poll = true;
+                break;
+            case 'I':
+                busy_poll_idle_us = atoi(optarg);
+                if (busy_poll_idle_us < 0) {
+                    fprintf(stderr, "Invalid --busy-poll-idle-us argument: %s\n", optarg);
+                    return EXIT_FAILURE;
+                }
+                break;
+            case 'h':
+                print_usage(argv[0]);
+                return EXIT_SUCCESS;
+            default:
+                print_usage(argv[0]);
+                return EXIT_FAILURE;
+        }
+    }
+
     LOG_INFO("Starting trading server...");
 
     // Set up signal handlers
@@ -33,19 +308,40 @@ int main(int argc, char* argv[]) {
     WSServerConfig ws_config = {
         .host = "0.0.0.0",
         .port = 8080,
-        .max_clients = 100,
+        .max_clients = max_clients,
+        .max_clients_per_ip = max_clients_per_ip,
+        .shed_queued_messages = shed_queued,
+        .client_limit = client_limit,
+        .max_message_size = max_message_size,
+        .max_in_flight = max_in_flight,
         .ping_interval_ms = 30000,
-        .status_interval_ms = 60000
+        .status_interval_ms = 60000,
+        .metrics_port = metrics_port,
+        .service_threads = service_threads,
+        .service_cpus = service_cpus,
+        .busy_poll = busy_poll,
+        .busy_poll_idle_us = busy_poll_idle_us
     };
 
+    // With flow control the queue holds every connection's full budget, so
+    // overload pauses reads instead of dropping messages
+    int message_queue_size = MIN_MESSAGE_QUEUE_SIZE;
+    if (max_in_flight > 0 && max_clients * max_in_flight + 1 > message_queue_size) {
+        message_queue_size = max_clients * max_in_flight + 1;
+    }
+
     HandlerConfig handler_config = {
-        .thread_pool_size = 4,
-        .max_message_size = 4096,
-        .message_queue_size = 1000
+        .thread_pool_size = worker_cpus.count > 0 ? worker_cpus.count : 4,
+        .max_message_size = max_message_size,
+        .message_queue_size = message_queue_size,
+        .worker_cpus = worker_cpus,
+        .busy_poll = busy_poll,
+        .busy_poll_idle_us = busy_poll_idle_us,
+        .trader_limit = trader_limit
     };
 
     SessionConfig session_config = {
-        .max_sessions = 100,
+        .max_sessions = max_clients,
         .session_timeout_ms = 30000,
         .cleanup_interval_ms = 60000
     };
@@ -53,30 +349,130 @@ int main(int argc, char* argv[]) {
     MarketDataConfig market_config = {
         .snapshot_interval_ms = 1000,
         .max_depth = 10,
-        .max_symbols = 100
+        .max_symbols = 100,
+        .cpus = background_cpus
+    };
+
+    JournalConfig journal_config = {
+        .directory = journal_dir,
+        .segment_size = 64 * 1024 * 1024,
+        .group_commit_us = 200,
+        .max_batch_events = 1024,
+        .async_ack = async_ack,
+        .cpus = background_cpus
     };
 
     // Create server components
+    Journal* journal = NULL;
+    if (journal_dir) {
+        journal = journal_create(&journal_config);
+        if (!journal) {
+            LOG_ERROR("Failed to open journal in %s", journal_dir);
+            return EXIT_FAILURE;
+        }
+        handler_config.journal = journal;
+    }
+
+    ServerMetrics* metrics = server_metrics_create();
+    if (!metrics) {
+        journal_destroy(journal);
+        return EXIT_FAILURE;
+    }
+    ws_config.metrics = metrics;
+    handler_config.metrics = metrics;
+
     WSServer* server = ws_server_create(&ws_config);
     if (!server) {
         LOG_ERROR("Failed to create WebSocket server");
+        journal_destroy(journal);
+        server_metrics_destroy(metrics);
+        return EXIT_FAILURE;
+    }
+    handler_config.ws_server = server;
+
+    TradeBroadcaster* broadcaster = trade_broadcaster_create(server);
+    if (!broadcaster) {
+        ws_server_destroy(server);
+        journal_destroy(journal);
+        server_metrics_destroy(metrics);
         return EXIT_FAILURE;
     }
+    handler_config.trade_broadcaster = broadcaster;
 
     ServerHandlers* handlers = server_handlers_create(&handler_config);
     if (!handlers) {
         LOG_ERROR("Failed to create server handlers");
         ws_server_destroy(server);
+        trade_broadcaster_destroy(broadcaster);
+        journal_destroy(journal);
+        server_metrics_destroy(metrics);
         return EXIT_FAILURE;
     }
 
     ws_server_set_message_callback(server, message_handler_wrapper, handlers);
+    ws_server_set_metrics_callback(server, metrics_page, handlers);
+    ws_server_set_throttle_callback(server, throttle_handler, handlers);
+
+    // Register books up front so each symbol gets its selected backend
+    for (int i = 0; i < SYMBOL_COUNT; i++) {
+        const OrderBookConfig* book_config =
+            find_book_selection(selections, selection_count, VALID_SYMBOLS[i]);
+        if (server_handlers_add_order_book(handlers, VALID_SYMBOLS[i], book_config) != 0) {
+            LOG_WARN("Failed to register order book for %s", VALID_SYMBOLS[i]);
+        }
+    }
+
+    // Rebuild the books from the last checkpoint plus the journal after it,
+    // before the journal starts taking new events
+    if ((snapshot_path || journal) && server_handlers_recover(handlers, snapshot_path) != 0) {
+        LOG_ERROR("Failed to recover order books");
+        server_handlers_destroy(handlers);
+        ws_server_destroy(server);
+        trade_broadcaster_destroy(broadcaster);
+        journal_destroy(journal);
+        server_metrics_destroy(metrics);
+        return EXIT_FAILURE;
+    }
+
+    if (journal && journal_start(journal) != 0) {
+        LOG_ERROR("Failed to start journal in %s", journal_dir);
+        server_handlers_destroy(handlers);
+        ws_server_destroy(server);
+        trade_broadcaster_destroy(broadcaster);
+        journal_destroy(journal);
+        server_metrics_destroy(metrics);
+        return EXIT_FAILURE;
+    }
+
+    Checkpointer* checkpointer = NULL;
+    if (snapshot_path && checkpoint_interval_s > 0) {
+        CheckpointerConfig checkpoint_config = {
+            .handlers = handlers,
+            .path = snapshot_path,
+            .interval_ms = checkpoint_interval_s * 1000,
+            .cpus = background_cpus
+        };
+        checkpointer = checkpointer_create(&checkpoint_config);
+        if (!checkpointer) {
+            LOG_ERROR("Failed to create checkpointer");
+            server_handlers_destroy(handlers);
+            ws_server_destroy(server);
+            trade_broadcaster_destroy(broadcaster);
+            journal_destroy(journal);
+            server_metrics_destroy(metrics);
+            return EXIT_FAILURE;
+        }
+    }
 
     SessionManager* sessions = session_manager_create(&session_config);
     if (!sessions) {
         LOG_ERROR("Failed to create session manager");
+        checkpointer_destroy(checkpointer);
         server_handlers_destroy(handlers);
         ws_server_destroy(server);
+        trade_broadcaster_destroy(broadcaster);
+        journal_destroy(journal);
+        server_metrics_destroy(metrics);
         return EXIT_FAILURE;
     }
 
@@ -84,8 +480,12 @@ int main(int argc, char* argv[]) {
     if (!market) {
         LOG_ERROR("Failed to create market data manager");
         session_manager_destroy(sessions);
+        checkpointer_destroy(checkpointer);
         server_handlers_destroy(handlers);
         ws_server_destroy(server);
+        trade_broadcaster_destroy(broadcaster);
+        journal_destroy(journal);
+        server_metrics_destroy(metrics);
         return EXIT_FAILURE;
     }
 
@@ -94,34 +494,59 @@ int main(int argc, char* argv[]) {
         LOG_ERROR("Failed to start WebSocket server");
         market_data_destroy(market);
         session_manager_destroy(sessions);
+        checkpointer_destroy(checkpointer);
         server_handlers_destroy(handlers);
         ws_server_destroy(server);
+        trade_broadcaster_destroy(broadcaster);
+        journal_destroy(journal);
+        server_metrics_destroy(metrics);
         return EXIT_FAILURE;
     }
 
     // Start worker threads
     server_handlers_start_workers(handlers);
     market_data_start_snapshot_timer(market);
+    if (checkpointer) {
+        checkpointer_start(checkpointer);
+    }
 
     LOG_INFO("Trading server started successfully");
 
     // Main loop
+    int seconds_since_stats = 0;
     while (running) {
         session_manager_cleanup_sessions(sessions);
         session_manager_ping_clients(sessions);
         sleep(1);
+
+        if (stats_interval_s > 0 && ++seconds_since_stats >= stats_interval_s) {
+            server_handlers_log_latency(handlers);
+            seconds_since_stats = 0;
+        }
     }
 
     // Cleanup
     LOG_INFO("Shutting down trading server...");
+    server_handlers_log_latency(handlers);
     market_data_stop_snapshot_timer(market);
+    checkpointer_destroy(checkpointer);
     server_handlers_stop_workers(handlers);
     ws_server_stop(server);
+    if (journal) {
+        journal_stop(journal);
+    }
+
+    if (snapshot_path && server_handlers_save_snapshot(handlers, snapshot_path) != 0) {
+        LOG_ERROR("Failed to save snapshot %s", snapshot_path);
+    }
 
     market_data_destroy(market);
     session_manager_destroy(sessions);
     server_handlers_destroy(handlers);
     ws_server_destroy(server);
+    trade_broadcaster_destroy(broadcaster);
+    journal_destroy(journal);
+    server_metrics_destroy(metrics);
 
     LOG_INFO("Trading server shutdown complete");
     return EXIT_SUCCESS;
@@ -2,35 +2,71 @@
 #include "protocol/json_protocol.h"
 #include "protocol/message_types.h"
 #include "trading_engine/trade_broadcaster.h"
+#include "trading_engine/book_snapshot.h"
+#include "server/latency_stats.h"
+#include "utils/clock.h"
+#include "utils/cpu_affinity.h"
 #include "utils/logging.h"
+#include "utils/rate_limiter.h"
 #include <stdlib.h>
 #include <string.h>
 #include <time.h>
 #include <pthread.h>
+#include <stdatomic.h>
+#include <unistd.h>
 
 #define MAX_SYMBOLS 100
+#define MAX_TRACKED_TRADERS 4096   // Busy traders the limiter holds at once; idle ones are dropped
+
+_Static_assert(MAX_SYMBOLS <= MAX_STATUS_SYMBOLS, "Status cannot report every symbol");
+_Static_assert(RATE_LIMITER_MAX_KEY >= MAX_ID_LENGTH, "Trader IDs would be truncated in the rate limiter");
+_Static_assert((int)TIME_IN_FORCE_GTC == ORDER_TIF_GTC && (int)TIME_IN_FORCE_IOC == ORDER_TIF_IOC &&
+               (int)TIME_IN_FORCE_FOK == ORDER_TIF_FOK, "Protocol and engine time in force differ");
+
+// Resting orders in one book, republished under the book lock after every
+// change so status readers never need that lock. Padded so books handled by
+// different workers do not share a cache line.
+typedef struct {
+    atomic_int count;
+    char padding[64 - sizeof(atomic_int)];
+} ActiveOrderGauge;
 
 struct ServerHandlers {
     pthread_t* worker_threads;
     int thread_count;
-    bool running;
+    atomic_bool running;       // Cleared under queue_lock so no waiting worker misses it
     
     // Message queue
     char** message_queue;
     WSClient** client_queue;
+    int64_t* receive_times;    // When each queued message came off the socket
+    int64_t* enqueue_times;
     int queue_size;
     int queue_head;
     int queue_tail;
     pthread_mutex_t queue_lock;
     pthread_cond_t queue_cond;
+    atomic_int queue_depth;    // Mirrors tail - head so spinning workers can poll without the lock
+    bool busy_poll;
+    int64_t busy_poll_idle_ns;
     
-    // Order books
+    // Order books. books_lock guards the registry; each book's mutex
+    // serializes changes to that book so its journal order matches the
+    // order in which they were applied.
     OrderBook* books[MAX_SYMBOLS];
     char symbols[MAX_SYMBOLS][16];
+    pthread_mutex_t book_locks[MAX_SYMBOLS];
     int book_count;
     pthread_rwlock_t books_lock;
+    ActiveOrderGauge active_orders[MAX_SYMBOLS];
 
     TradeBroadcaster* trade_broadcaster;
+    Journal* journal;
+    WSServer* ws_server;
+    LatencyStats* latency;
+    ServerMetrics* metrics;
+    CpuList worker_cpus;
+    RateLimiter* traders;      // NULL when trader_limit is off
 };
 
 // Message handler lookup table
@@ -40,9 +76,48 @@ static const struct {
 } message_handlers[] = {
     {MSG_PLACE_ORDER, handle_place_order},
     {MSG_CANCEL_ORDER, handle_cancel_order},
-    {MSG_REQUEST_BOOK, handle_book_request}
+    {MSG_REQUEST_BOOK, handle_book_request},
+    {MSG_REQUEST_STATUS, handle_status_request},
+    {MSG_PLACE_ORDER_BATCH, handle_place_order_batch},
+    {MSG_CANCEL_ORDER_BATCH, handle_cancel_order_batch},
+    {MSG_MODIFY_ORDER, handle_modify_order}
 };
 
+// Timer of the request the calling worker is handling, NULL outside a request
+static __thread RequestTimer* current_timer;
+
+typedef struct PendingTrade {
+    char symbol[MAX_SYMBOL_LENGTH];
+    char buy_order_id[MAX_ID_LENGTH];
+    char sell_order_id[MAX_ID_LENGTH];
+    double price;
+    int quantity;
+    time_t timestamp;
+} PendingTrade;
+
+// Trades made by the request a worker is handling. They are broadcast only
+// once the event that caused them is durable, so market data never shows a
+// fill that recovery would not reproduce.
+typedef struct PendingTrades {
+    PendingTrade* trades;
+    int count;
+    int capacity;
+} PendingTrades;
+
+// Trades held for the calling worker's request, NULL outside a request
+static __thread PendingTrades* current_trades;
+
+// Read without any lock by workers spinning for messages and by the fill callback
+static bool is_running(const ServerHandlers* handlers) {
+    return atomic_load_explicit(&handlers->running, memory_order_acquire);
+}
+
+static void mark_stage(LatencyStage stage) {
+    if (current_timer) {
+        request_timer_mark(current_timer, stage);
+    }
+}
+
 static void collect_orders(Order* order, void* user_data) {
     BookSnapshot* snap = (BookSnapshot*)user_data;
     if (order->is_canceled || order->remaining_quantity <= 0) {
@@ -64,22 +139,202 @@ static void collect_orders(Order* order, void* user_data) {
     }
 }
 
+// Books lock must be held
+static int find_book_index(const ServerHandlers* handlers, const char* symbol) {
+    for (int i = 0; i < handlers->book_count; i++) {
+        if (strcmp(handlers->symbols[i], symbol) == 0) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+static void hold_trade(PendingTrades* pending, const struct Order* buy_order,
+                       const struct Order* sell_order, double price, int quantity) {
+    if (pending->count == pending->capacity) {
+        int capacity = pending->capacity ? pending->capacity * 2 : 16;
+        PendingTrade* trades = realloc(pending->trades, capacity * sizeof(PendingTrade));
+        if (!trades) {
+            LOG_ERROR("Failed to hold trade %s/%s for broadcast",
+                      order_get_id(buy_order), order_get_id(sell_order));
+            return;
+        }
+        pending->trades = trades;
+        pending->capacity = capacity;
+    }
+
+    PendingTrade* trade = &pending->trades[pending->count++];
+    snprintf(trade->symbol, sizeof(trade->symbol), "%s", buy_order->symbol);
+    snprintf(trade->buy_order_id, sizeof(trade->buy_order_id), "%s", order_get_id(buy_order));
+    snprintf(trade->sell_order_id, sizeof(trade->sell_order_id), "%s", order_get_id(sell_order));
+    trade->price = price;
+    trade->quantity = quantity;
+    trade->timestamp = time(NULL);
+}
+
+// Broadcasts the trades held for the current request, or drops them if the
+// event that made them could not be journaled
+static void release_trades(ServerHandlers* handlers, bool durable) {
+    PendingTrades* pending = current_trades;
+    if (!pending) {
+        return;
+    }
+    if (!durable && pending->count > 0) {
+        LOG_WARN("Dropping %d trade broadcasts whose order was not journaled", pending->count);
+    }
+    for (int i = 0; durable && handlers->trade_broadcaster && i < pending->count; i++) {
+        const PendingTrade* trade = &pending->trades[i];
+        trade_broadcaster_send_trade(handlers->trade_broadcaster, trade->symbol,
+                                     trade->buy_order_id, trade->sell_order_id,
+                                     trade->price, trade->quantity, trade->timestamp);
+    }
+    pending->count = 0;
+}
+
+static void record_fill(const struct Order* buy_order, const struct Order* sell_order,
+                        double price, int quantity, void* user_data) {
+    ServerHandlers* handlers = (ServerHandlers*)user_data;
+    if (handlers->journal) {
+        journal_record_fill(handlers->journal, buy_order->symbol, order_get_id(buy_order),
+                            order_get_id(sell_order), price, quantity);
+    }
+    // Replayed fills were broadcast by the run that made them
+    if (current_trades) {
+        hold_trade(current_trades, buy_order, sell_order, price, quantity);
+    }
+    // Fills reproduced by recovery were counted by the run that made them
+    if (is_running(handlers)) {
+        server_metrics_add(handlers->metrics, METRIC_TRADES, 1);
+    }
+}
+
+// Book lock must be held
+static void publish_active_orders(ServerHandlers* handlers, int index) {
+    atomic_store_explicit(&handlers->active_orders[index].count,
+                          (int)order_index_count(handlers->books[index]->orders_by_id),
+                          memory_order_relaxed);
+}
+
+// Books lock must be held for writing
+static void publish_all_active_orders(ServerHandlers* handlers) {
+    for (int i = 0; i < handlers->book_count; i++) {
+        publish_active_orders(handlers, i);
+    }
+}
+
+// Books lock must be held for writing
+static int register_book(ServerHandlers* handlers, const char* symbol, OrderBook* book) {
+    if (handlers->book_count >= MAX_SYMBOLS) {
+        return -1;
+    }
+
+    order_book_set_trade_callback(book, record_fill, handlers);
+
+    int index = handlers->book_count;
+    strncpy(handlers->symbols[index], symbol, 15);
+    handlers->symbols[index][15] = '\0';
+    handlers->books[index] = book;
+    handlers->book_count++;
+    return index;
+}
+
+// Looks up a book and returns it with the books read lock and the book's own
+// lock held, creating a default book first if create is set. Returns -1 with
+// nothing held if there is no such book.
+static int lock_book(ServerHandlers* handlers, const char* symbol, bool create) {
+    pthread_rwlock_rdlock(&handlers->books_lock);
+    int index = find_book_index(handlers, symbol);
+
+    if (index < 0 && create) {
+        pthread_rwlock_unlock(&handlers->books_lock);
+        pthread_rwlock_wrlock(&handlers->books_lock);
+        index = find_book_index(handlers, symbol);
+        if (index < 0) {
+            OrderBook* book = order_book_create(NULL);
+            if (book) {
+                index = register_book(handlers, symbol, book);
+                if (index < 0) {
+                    order_book_destroy(book);
+                } else {
+                    LOG_INFO("Created new order book for symbol %s", symbol);
+                }
+            }
+        }
+        // Books are never removed while workers run, so the index stays valid
+        pthread_rwlock_unlock(&handlers->books_lock);
+        pthread_rwlock_rdlock(&handlers->books_lock);
+    }
+
+    if (index < 0) {
+        pthread_rwlock_unlock(&handlers->books_lock);
+        return -1;
+    }
+
+    pthread_mutex_lock(&handlers->book_locks[index]);
+    return index;
+}
+
+static void unlock_book(ServerHandlers* handlers, int index) {
+    pthread_mutex_unlock(&handlers->book_locks[index]);
+    pthread_rwlock_unlock(&handlers->books_lock);
+}
+
+// Waits until the journal holds lsn. Without a journal every event is acked at once.
+static bool wait_durable(ServerHandlers* handlers, uint64_t lsn) {
+    if (!handlers->journal) {
+        return true;
+    }
+    return lsn != 0 && journal_wait_durable(handlers->journal, lsn) == 0;
+}
+
+// Spins until the queue looks non-empty, returning false if the idle
+// budget runs out first. A message that arrives meanwhile is seen within a
+// cache-line transfer rather than a futex wake-up.
+static bool spin_for_message(ServerHandlers* handlers) {
+    int64_t deadline = handlers->busy_poll_idle_ns > 0 ? clock_now_ns() + handlers->busy_poll_idle_ns : 0;
+    unsigned spins = 0;
+    while (atomic_load_explicit(&handlers->queue_depth, memory_order_acquire) == 0 &&
+           is_running(handlers)) {
+        cpu_relax();
+        // Reading the clock every iteration would cost more than the pause
+        if (deadline != 0 && (++spins & 0xFF) == 0 && clock_now_ns() >= deadline) {
+            return false;
+        }
+    }
+    return true;
+}
+
 // Helper Functions
-char* dequeue_message(ServerHandlers* handlers, WSClient** client) {
+char* dequeue_message(ServerHandlers* handlers, WSClient** client, RequestTimer* timer) {
     pthread_mutex_lock(&handlers->queue_lock);
     
-    while (handlers->queue_head == handlers->queue_tail && handlers->running) {
+    while (handlers->queue_head == handlers->queue_tail && is_running(handlers)) {
+        if (handlers->busy_poll) {
+            // Spin without the lock; a worker that loses the race for a message spins again
+            pthread_mutex_unlock(&handlers->queue_lock);
+            bool found = spin_for_message(handlers);
+            pthread_mutex_lock(&handlers->queue_lock);
+            if (found) {
+                continue;
+            }
+        }
         pthread_cond_wait(&handlers->queue_cond, &handlers->queue_lock);
     }
     
-    if (!handlers->running) {
+    if (!is_running(handlers)) {
         pthread_mutex_unlock(&handlers->queue_lock);
         return NULL;
     }
     
     char* message = handlers->message_queue[handlers->queue_head];
     *client = handlers->client_queue[handlers->queue_head];
+    if (timer) {
+        request_timer_start(timer, handlers->receive_times[handlers->queue_head]);
+        request_timer_mark_at(timer, LATENCY_STAGE_RECEIVE, handlers->enqueue_times[handlers->queue_head]);
+        request_timer_mark(timer, LATENCY_STAGE_QUEUE);
+    }
     handlers->queue_head = (handlers->queue_head + 1) % handlers->queue_size;
+    atomic_fetch_sub_explicit(&handlers->queue_depth, 1, memory_order_relaxed);
     
     pthread_mutex_unlock(&handlers->queue_lock);
     return message;
@@ -92,121 +347,184 @@ int send_error_response(WSClient* client, const char* error_msg, char* response)
     return ws_server_send(client, response, strlen(response));
 }
 
+static int reject(ServerHandlers* handlers, WSClient* client, const char* error_msg, char* response) {
+    server_metrics_add(handlers->metrics, METRIC_REJECTS, 1);
+    return send_error_response(client, error_msg, response);
+}
+
+static struct Order* create_order(const OrderMessage* message) {
+    struct Order* order = order_create(message->order_id, message->trader_id, message->symbol,
+                                       message->price, message->quantity, message->is_buy);
+    if (order) {
+        order->time_in_force = (uint8_t)message->time_in_force;
+        order->is_market = message->is_market;
+        order_set_display_quantity(order, message->display_quantity);
+    }
+    return order;
+}
+
+// Book lock must be held. A resting order is added, matched and handed to
+// the book, which frees it once it leaves; any other order trades in one
+// pass and is freed, never entering the book. Either way only an order the
+// book accepts is journaled, and before it trades so its fills follow it in
+// the log. Returns the quantity filled, or -1 (with the order freed) if the
+// book refused it.
+static int apply_order(ServerHandlers* handlers, OrderBook* book, struct Order* order,
+                       uint64_t* lsn) {
+    *lsn = 0;
+    if (!order_can_rest(order)) {
+        if (!order_book_can_execute(book, order)) {
+            order_destroy(order);
+            return -1;
+        }
+        if (handlers->journal) {
+            *lsn = journal_record_order(handlers->journal, order);
+        }
+        int filled = order_book_execute_order(book, order);
+        order_destroy(order);
+        return filled;
+    }
+
+    if (order_book_add_order(book, order) != 0) {
+        // Duplicate live order ID or unusable price for this book
+        order_destroy(order);
+        return -1;
+    }
+    if (handlers->journal) {
+        *lsn = journal_record_order(handlers->journal, order);
+    }
+    order_book_match_orders(book);
+    int filled = order->quantity - order_get_open_quantity(order);
+    order_book_adopt_order(book, order);
+    return filled;
+}
+
 // Message Handlers
 int handle_place_order(ServerHandlers* handlers, WSClient* client, const cJSON* root, char* response) {
+    server_metrics_add(handlers->metrics, METRIC_ORDERS_IN, 1);
+
     OrderMessage order;
-    if (!parse_order_message(cJSON_Print(root), &order)) {
-        return send_error_response(client, "Invalid order format", response);
+    char* json = cJSON_Print(root);
+    bool parsed = json && parse_order_message(json, &order);
+    free(json);
+    if (!parsed) {
+        return reject(handlers, client, "Invalid order format", response);
     }
+    mark_stage(LATENCY_STAGE_DECODE);
 
     LOG_INFO("Processing order: %s %s %.2f x %d",
              order.order_id, order.symbol, order.price, order.quantity);
 
-    pthread_rwlock_rdlock(&handlers->books_lock);
-    bool order_placed = false;
+    int index = lock_book(handlers, order.symbol, true);
+    if (index < 0) {
+        return reject(handlers, client, "Failed to place order", response);
+    }
+    OrderBook* book = handlers->books[index];
 
-    // Find or create order book
-    OrderBook* book = NULL;
-    for (int i = 0; i < handlers->book_count; i++) {
-        if (strcmp(handlers->symbols[i], order.symbol) == 0) {
-            book = handlers->books[i];
-            break;
-        }
+    struct Order* new_order = create_order(&order);
+    uint64_t lsn = 0;
+    int filled = new_order ? apply_order(handlers, book, new_order, &lsn) : -1;
+    if (filled < 0) {
+        unlock_book(handlers, index);
+        return reject(handlers, client, "Failed to place order", response);
     }
+    publish_active_orders(handlers, index);
 
-    if (!book) {
-        book = order_book_create(handlers->trade_broadcaster);
-        if (book) {
-            handlers->books[handlers->book_count] = book;
-            strncpy(handlers->symbols[handlers->book_count], order.symbol,
-                    sizeof(handlers->symbols[0]) - 1);
-            handlers->book_count++;
-            LOG_INFO("Created new order book for symbol %s", order.symbol);
-        }
-    }
-
-    if (book) {
-        struct Order* new_order = order_create(
-            order.order_id, order.trader_id, order.symbol,
-            order.price, order.quantity, order.is_buy
-        );
-
-        if (new_order) {
-            order_book_add_order(book, new_order);
-            order_placed = true;
-
-            // Get current timestamp
-            time_t now;
-            time(&now);
-            char timestamp[64];
-            strftime(timestamp, sizeof(timestamp), "%Y-%m-%d %H:%M:%S", localtime(&now));
-
-            // Send formatted confirmation
-            snprintf(response, 1024,
-                "{\n"
-                "    \"type\": %d,\n"
-                "    \"Trade Details\": {\n"
-                "        \"Type\":          \"%s\",\n"
-                "        \"Order ID\":      \"%s\",\n"
-                "        \"Trader ID\":     \"%s\",\n"
-                "        \"Symbol\":        \"%s\",\n"
-                "        \"Price\":         %.2f,\n"
-                "        \"Quantity\":      %d\n"
-                "    },\n"
-                "    \"Timestamp\":     \"%s\",\n"
-                "    \"status\":        \"success\"\n"
-                "}",
-                MSG_ORDER_ACCEPTED,
-                order.is_buy ? "Buy" : "Sell",
-                order.order_id,
-                order.trader_id,
-                order.symbol,
-                order.price,
-                order.quantity,
-                timestamp);
-
-            ws_server_send(client, response, strlen(response));
-            LOG_INFO("Order placed and confirmed: %s", response);
-
-            LOG_INFO("Attempting to match orders for %s", order.symbol);
-            order_book_match_orders(book);
+    // Capture the updated book while it is still locked
+    BookSnapshot snapshot = {0};
+    strncpy(snapshot.symbol, order.symbol, sizeof(snapshot.symbol) - 1);
+    snapshot.max_orders = 200;
+    snapshot.bid_prices = malloc(snapshot.max_orders * sizeof(double));
+    snapshot.bid_quantities = malloc(snapshot.max_orders * sizeof(int));
+    snapshot.ask_prices = malloc(snapshot.max_orders * sizeof(double));
+    snapshot.ask_quantities = malloc(snapshot.max_orders * sizeof(int));
 
-            // Send updated book snapshot
-            BookSnapshot snapshot = {0};
-            strncpy(snapshot.symbol, order.symbol, sizeof(snapshot.symbol) - 1);
-            snapshot.max_orders = 200;
-            snapshot.bid_prices = malloc(snapshot.max_orders * sizeof(double));
-            snapshot.bid_quantities = malloc(snapshot.max_orders * sizeof(int));
-            snapshot.ask_prices = malloc(snapshot.max_orders * sizeof(double));
-            snapshot.ask_quantities = malloc(snapshot.max_orders * sizeof(int));
-
-            if (snapshot.bid_prices && snapshot.bid_quantities && 
-                snapshot.ask_prices && snapshot.ask_quantities) {
-                
-                snapshot.num_bids = snapshot.num_asks = 0;
-                avl_inorder_traverse(book->buy_orders, collect_orders, &snapshot);
-                avl_inorder_traverse(book->sell_orders, collect_orders, &snapshot);
-
-                char* book_json = serialize_book_snapshot(&snapshot);
-                if (book_json) {
-                    ws_server_send(client, book_json, strlen(book_json));
-                    free(book_json);
-                }
-            }
+    bool have_snapshot = snapshot.bid_prices && snapshot.bid_quantities &&
+                         snapshot.ask_prices && snapshot.ask_quantities;
+    if (have_snapshot) {
+        snapshot.num_bids = snapshot.num_asks = 0;
+        order_book_traverse_buy_orders(book, collect_orders, &snapshot);
+        order_book_traverse_sell_orders(book, collect_orders, &snapshot);
+    }
 
+    unlock_book(handlers, index);
+    mark_stage(LATENCY_STAGE_MATCH);
+
+    // Only acknowledge once the order survives a crash
+    if (handlers->journal) {
+        bool durable = wait_durable(handlers, lsn);
+        mark_stage(LATENCY_STAGE_JOURNAL);
+        if (!durable) {
             free(snapshot.bid_prices);
             free(snapshot.bid_quantities);
             free(snapshot.ask_prices);
             free(snapshot.ask_quantities);
+            release_trades(handlers, false);
+            return reject(handlers, client, "Order could not be journaled", response);
         }
     }
+    release_trades(handlers, true);
 
-    pthread_rwlock_unlock(&handlers->books_lock);
-    
-    if (!order_placed) {
-        return send_error_response(client, "Failed to place order", response);
+    // Get current timestamp
+    time_t now;
+    time(&now);
+    char timestamp[64];
+    strftime(timestamp, sizeof(timestamp), "%Y-%m-%d %H:%M:%S", localtime(&now));
+
+    // Send formatted confirmation
+    snprintf(response, 1024,
+        "{\n"
+        "    \"type\": %d,\n"
+        "    \"Trade Details\": {\n"
+        "        \"Type\":          \"%s\",\n"
+        "        \"Order ID\":      \"%s\",\n"
+        "        \"Trader ID\":     \"%s\",\n"
+        "        \"Symbol\":        \"%s\",\n"
+        "        \"Price\":         %.2f,\n"
+        "        \"Quantity\":      %d,\n"
+        "        \"Order Type\":    \"%s\",\n"
+        "        \"Time In Force\": \"%s\",\n"
+        "        \"Display Quantity\": %d,\n"
+        "        \"Filled\":        %d\n"
+        "    },\n"
+        "    \"Timestamp\":     \"%s\",\n"
+        "    \"status\":        \"success\"\n"
+        "}",
+        MSG_ORDER_ACCEPTED,
+        order.is_buy ? "Buy" : "Sell",
+        order.order_id,
+        order.trader_id,
+        order.symbol,
+        order.price,
+        order.quantity,
+        order.is_market ? "MARKET" : "LIMIT",
+        time_in_force_name(order.time_in_force),
+        order.display_quantity,
+        filled,
+        timestamp);
+    mark_stage(LATENCY_STAGE_SERIALIZE);
+
+    if (ws_server_send(client, response, strlen(response)) == 0) {
+        server_metrics_add(handlers->metrics, METRIC_ACKS_OUT, 1);
+    }
+    mark_stage(LATENCY_STAGE_WRITE);
+    LOG_INFO("Order placed and confirmed: %s", response);
+
+    // Send updated book snapshot
+    if (have_snapshot) {
+        char* book_json = serialize_book_snapshot(&snapshot);
+        mark_stage(LATENCY_STAGE_SERIALIZE);
+        if (book_json) {
+            ws_server_send(client, book_json, strlen(book_json));
+            mark_stage(LATENCY_STAGE_WRITE);
+            free(book_json);
+        }
     }
 
+    free(snapshot.bid_prices);
+    free(snapshot.bid_quantities);
+    free(snapshot.ask_prices);
+    free(snapshot.ask_quantities);
     return 0;
 }
 
@@ -215,38 +533,45 @@ int handle_cancel_order(ServerHandlers* handlers, WSClient* client, const cJSON*
     const cJSON* symbol = cJSON_GetObjectItem(root, "symbol");
     
     if (!order_id || !order_id->valuestring || !symbol || !symbol->valuestring) {
-        return send_error_response(client, "Missing order_id or symbol", response);
+        return reject(handlers, client, "Missing order_id or symbol", response);
     }
 
-    pthread_rwlock_rdlock(&handlers->books_lock);
-    OrderBook* book = NULL;
-    
-    // Find order book
-    for (int i = 0; i < handlers->book_count; i++) {
-        if (strcmp(handlers->symbols[i], symbol->valuestring) == 0) {
-            book = handlers->books[i];
-            break;
-        }
-    }
-    
-    if (!book) {
-        pthread_rwlock_unlock(&handlers->books_lock);
-        return send_error_response(client, "Order book not found", response);
+    const cJSON* is_buy_item = cJSON_GetObjectItem(root, "is_buy");
+    if (!is_buy_item) {
+        return reject(handlers, client, "Missing is_buy flag", response);
     }
+    // JSON booleans carry no valueint; numeric 0/1 is accepted as well
+    bool is_buy = cJSON_IsTrue(is_buy_item) ||
+                  (cJSON_IsNumber(is_buy_item) && is_buy_item->valueint != 0);
+    mark_stage(LATENCY_STAGE_DECODE);
 
-    const cJSON* is_buy = cJSON_GetObjectItem(root, "is_buy");
-    if (!is_buy) {
-        pthread_rwlock_unlock(&handlers->books_lock);
-        return send_error_response(client, "Missing is_buy flag", response);
+    int index = lock_book(handlers, symbol->valuestring, false);
+    if (index < 0) {
+        return reject(handlers, client, "Order book not found", response);
     }
 
     // Cancel the order
-    if (order_book_cancel_order(book, order_id->valuestring, is_buy->valueint) != 0) {
-        pthread_rwlock_unlock(&handlers->books_lock);
-        return send_error_response(client, "Order not found or already canceled", response);
+    if (order_book_cancel_order(handlers->books[index], order_id->valuestring, is_buy) != 0) {
+        unlock_book(handlers, index);
+        return reject(handlers, client, "Order not found or already canceled", response);
     }
+    publish_active_orders(handlers, index);
+    server_metrics_add(handlers->metrics, METRIC_CANCELS, 1);
 
-    pthread_rwlock_unlock(&handlers->books_lock);
+    uint64_t lsn = handlers->journal
+        ? journal_record_cancel(handlers->journal, symbol->valuestring, order_id->valuestring,
+                                is_buy)
+        : 0;
+    unlock_book(handlers, index);
+    mark_stage(LATENCY_STAGE_MATCH);
+
+    if (handlers->journal) {
+        bool durable = wait_durable(handlers, lsn);
+        mark_stage(LATENCY_STAGE_JOURNAL);
+        if (!durable) {
+            return reject(handlers, client, "Cancel could not be journaled", response);
+        }
+    }
 
     // Get current timestamp
     time_t now;
@@ -269,34 +594,256 @@ int handle_cancel_order(ServerHandlers* handlers, WSClient* client, const cJSON*
         order_id->valuestring,
         symbol->valuestring,
         timestamp);
+    mark_stage(LATENCY_STAGE_SERIALIZE);
 
-    ws_server_send(client, response, strlen(response));
+    if (ws_server_send(client, response, strlen(response)) == 0) {
+        server_metrics_add(handlers->metrics, METRIC_ACKS_OUT, 1);
+    }
+    mark_stage(LATENCY_STAGE_WRITE);
     LOG_INFO("Order canceled: %s", response);
     
     return 0;
 }
 
-int handle_book_request(ServerHandlers* handlers, WSClient* client, const cJSON* root, char* response) {
+int handle_modify_order(ServerHandlers* handlers, WSClient* client, const cJSON* root, char* response) {
+    const cJSON* order_id = cJSON_GetObjectItem(root, "order_id");
     const cJSON* symbol = cJSON_GetObjectItem(root, "symbol");
-    if (!symbol || !symbol->valuestring) {
-        return send_error_response(client, "Missing symbol", response);
+    const cJSON* price = cJSON_GetObjectItem(root, "price");
+    const cJSON* quantity = cJSON_GetObjectItem(root, "quantity");
+    const cJSON* is_buy_item = cJSON_GetObjectItem(root, "is_buy");
+
+    if (!order_id || !order_id->valuestring || !symbol || !symbol->valuestring ||
+        !cJSON_IsNumber(price) || !cJSON_IsNumber(quantity) || !is_buy_item) {
+        return reject(handlers, client, "Invalid modify format", response);
     }
+    bool is_buy = cJSON_IsTrue(is_buy_item) ||
+                  (cJSON_IsNumber(is_buy_item) && is_buy_item->valueint != 0);
+    mark_stage(LATENCY_STAGE_DECODE);
 
-    pthread_rwlock_rdlock(&handlers->books_lock);
-    OrderBook* book = NULL;
+    int index = lock_book(handlers, symbol->valuestring, false);
+    if (index < 0) {
+        return reject(handlers, client, "Order book not found", response);
+    }
+    OrderBook* book = handlers->books[index];
 
-    // Find order book
-    for (int i = 0; i < handlers->book_count; i++) {
-        if (strcmp(handlers->symbols[i], symbol->valuestring) == 0) {
-            book = handlers->books[i];
-            break;
+    // Drawn up front so the journal records the priority a requeue was given
+    uint64_t sequence = order_next_sequence();
+    if (order_book_modify_order(book, order_id->valuestring, is_buy, price->valuedouble,
+                                quantity->valueint, sequence) != 0) {
+        unlock_book(handlers, index);
+        return reject(handlers, client, "Order not found or invalid modify", response);
+    }
+    server_metrics_add(handlers->metrics, METRIC_MODIFIES, 1);
+
+    // Journal the modify before matching so fills at the new price follow it
+    uint64_t lsn = handlers->journal
+        ? journal_record_modify(handlers->journal, symbol->valuestring, order_id->valuestring,
+                                is_buy, price->valuedouble, quantity->valueint, sequence)
+        : 0;
+    order_book_match_orders(book);
+    publish_active_orders(handlers, index);
+    unlock_book(handlers, index);
+    mark_stage(LATENCY_STAGE_MATCH);
+
+    if (handlers->journal) {
+        bool durable = wait_durable(handlers, lsn);
+        mark_stage(LATENCY_STAGE_JOURNAL);
+        if (!durable) {
+            release_trades(handlers, false);
+            return reject(handlers, client, "Modify could not be journaled", response);
         }
     }
+    release_trades(handlers, true);
 
-    if (!book) {
-        pthread_rwlock_unlock(&handlers->books_lock);
-        return send_error_response(client, "Order book not found", response);
+    time_t now;
+    time(&now);
+    char timestamp[64];
+    strftime(timestamp, sizeof(timestamp), "%Y-%m-%d %H:%M:%S", localtime(&now));
+
+    snprintf(response, 1024,
+        "{\n"
+        "    \"type\": %d,\n"
+        "    \"Modification Details\": {\n"
+        "        \"Order ID\":      \"%s\",\n"
+        "        \"Symbol\":        \"%s\",\n"
+        "        \"Price\":         %.2f,\n"
+        "        \"Quantity\":      %d\n"
+        "    },\n"
+        "    \"Timestamp\":     \"%s\",\n"
+        "    \"status\":        \"success\"\n"
+        "}",
+        MSG_ORDER_MODIFIED,
+        order_id->valuestring,
+        symbol->valuestring,
+        price->valuedouble,
+        quantity->valueint,
+        timestamp);
+    mark_stage(LATENCY_STAGE_SERIALIZE);
+
+    if (ws_server_send(client, response, strlen(response)) == 0) {
+        server_metrics_add(handlers->metrics, METRIC_ACKS_OUT, 1);
+    }
+    mark_stage(LATENCY_STAGE_WRITE);
+    LOG_INFO("Order modified: %s", response);
+
+    return 0;
+}
+
+static void set_batch_reason(BatchItemResult* result, const char* reason) {
+    result->accepted = false;
+    snprintf(result->reason, sizeof(result->reason), "%s", reason);
+}
+
+static void set_batch_result(BatchItemResult* result, const char* order_id, const char* reason) {
+    size_t length = strnlen(order_id, sizeof(result->order_id) - 1);
+    memcpy(result->order_id, order_id, length);
+    result->order_id[length] = '\0';
+    result->accepted = reason == NULL;
+    if (reason) {
+        set_batch_reason(result, reason);
     }
+}
+
+// Accepted entries are unconfirmed until lsn is durable; if it never is they
+// are reported as failed along with the rest. Returns whether lsn is durable.
+static bool confirm_batch(ServerHandlers* handlers, BatchAck* ack, const uint64_t* lsns,
+                          uint64_t last_lsn, const char* reason) {
+    if (!handlers->journal) {
+        return true;
+    }
+    bool durable = wait_durable(handlers, last_lsn);
+    mark_stage(LATENCY_STAGE_JOURNAL);
+    for (int i = 0; i < ack->count; i++) {
+        if (ack->results[i].accepted && (!durable || lsns[i] == 0)) {
+            set_batch_reason(&ack->results[i], reason);
+        }
+    }
+    return durable;
+}
+
+static int send_batch_ack(ServerHandlers* handlers, WSClient* client, const BatchAck* ack,
+                          char* response) {
+    char* json = serialize_batch_ack(ack);
+    mark_stage(LATENCY_STAGE_SERIALIZE);
+    if (!json) {
+        return reject(handlers, client, "Failed to serialize batch ack", response);
+    }
+
+    int rejected = 0;
+    for (int i = 0; i < ack->count; i++) {
+        rejected += !ack->results[i].accepted;
+    }
+    server_metrics_add(handlers->metrics, METRIC_REJECTS, (uint64_t)rejected);
+
+    if (ws_server_send(client, json, strlen(json)) == 0) {
+        server_metrics_add(handlers->metrics, METRIC_ACKS_OUT, (uint64_t)(ack->count - rejected));
+    }
+    mark_stage(LATENCY_STAGE_WRITE);
+    free(json);
+    return 0;
+}
+
+int handle_place_order_batch(ServerHandlers* handlers, WSClient* client, const cJSON* root, char* response) {
+    OrderMessage orders[MAX_BATCH_ORDERS];
+    int count = parse_order_batch(root, orders);
+    if (count < 0) {
+        server_metrics_add(handlers->metrics, METRIC_ORDERS_IN, 1);
+        return reject(handlers, client, "Invalid order batch format", response);
+    }
+    server_metrics_add(handlers->metrics, METRIC_ORDERS_IN, (uint64_t)count);
+    mark_stage(LATENCY_STAGE_DECODE);
+
+    BatchAck ack = {.request_type = MSG_PLACE_ORDER_BATCH, .count = count};
+    strcpy(ack.symbol, orders[0].symbol);
+    uint64_t lsns[MAX_BATCH_ORDERS] = {0};
+    uint64_t last_lsn = 0;
+
+    int index = lock_book(handlers, ack.symbol, true);
+    if (index < 0) {
+        return reject(handlers, client, "Failed to place order", response);
+    }
+    OrderBook* book = handlers->books[index];
+
+    // Entries are applied in order, each matched before the next is added,
+    // so the outcome is the same as sending them one by one
+    for (int i = 0; i < count; i++) {
+        struct Order* new_order = create_order(&orders[i]);
+        if (!new_order || apply_order(handlers, book, new_order, &lsns[i]) < 0) {
+            set_batch_result(&ack.results[i], orders[i].order_id, "Failed to place order");
+            continue;
+        }
+        if (lsns[i] > last_lsn) {
+            last_lsn = lsns[i];
+        }
+        set_batch_result(&ack.results[i], orders[i].order_id, NULL);
+    }
+    publish_active_orders(handlers, index);
+    unlock_book(handlers, index);
+    mark_stage(LATENCY_STAGE_MATCH);
+
+    release_trades(handlers, confirm_batch(handlers, &ack, lsns, last_lsn,
+                                           "Order could not be journaled"));
+    LOG_INFO("Processed batch of %d orders for %s", count, ack.symbol);
+    return send_batch_ack(handlers, client, &ack, response);
+}
+
+int handle_cancel_order_batch(ServerHandlers* handlers, WSClient* client, const cJSON* root, char* response) {
+    BatchAck ack = {.request_type = MSG_CANCEL_ORDER_BATCH};
+    CancelMessage cancels[MAX_BATCH_ORDERS];
+    int count = parse_cancel_batch(root, ack.symbol, sizeof(ack.symbol), cancels);
+    if (count < 0) {
+        return reject(handlers, client, "Invalid cancel batch format", response);
+    }
+    ack.count = count;
+    mark_stage(LATENCY_STAGE_DECODE);
+
+    uint64_t lsns[MAX_BATCH_ORDERS] = {0};
+    uint64_t last_lsn = 0;
+    int canceled = 0;
+
+    int index = lock_book(handlers, ack.symbol, false);
+    if (index < 0) {
+        return reject(handlers, client, "Order book not found", response);
+    }
+
+    for (int i = 0; i < count; i++) {
+        const CancelMessage* cancel = &cancels[i];
+        if (order_book_cancel_order(handlers->books[index], cancel->order_id, cancel->is_buy) != 0) {
+            set_batch_result(&ack.results[i], cancel->order_id, "Order not found or already canceled");
+            continue;
+        }
+        if (handlers->journal) {
+            lsns[i] = journal_record_cancel(handlers->journal, ack.symbol, cancel->order_id,
+                                            cancel->is_buy);
+            if (lsns[i] > last_lsn) {
+                last_lsn = lsns[i];
+            }
+        }
+        set_batch_result(&ack.results[i], cancel->order_id, NULL);
+        canceled++;
+    }
+    publish_active_orders(handlers, index);
+    unlock_book(handlers, index);
+    server_metrics_add(handlers->metrics, METRIC_CANCELS, (uint64_t)canceled);
+    mark_stage(LATENCY_STAGE_MATCH);
+
+    confirm_batch(handlers, &ack, lsns, last_lsn, "Cancel could not be journaled");
+    LOG_INFO("Processed batch of %d cancels for %s", count, ack.symbol);
+    return send_batch_ack(handlers, client, &ack, response);
+}
+
+int handle_book_request(ServerHandlers* handlers, WSClient* client, const cJSON* root, char* response) {
+    const cJSON* symbol = cJSON_GetObjectItem(root, "symbol");
+    if (!symbol || !symbol->valuestring) {
+        return reject(handlers, client, "Missing symbol", response);
+    }
+    mark_stage(LATENCY_STAGE_DECODE);
+
+    int index = lock_book(handlers, symbol->valuestring, false);
+    if (index < 0) {
+        return reject(handlers, client, "Order book not found", response);
+    }
+    OrderBook* book = handlers->books[index];
 
     // Create book snapshot
     BookSnapshot snapshot = {0};
@@ -313,27 +860,30 @@ int handle_book_request(ServerHandlers* handlers, WSClient* client, const cJSON*
         free(snapshot.bid_quantities);
         free(snapshot.ask_prices);
         free(snapshot.ask_quantities);
-        pthread_rwlock_unlock(&handlers->books_lock);
-        return send_error_response(client, "Memory allocation failed", response);
+        unlock_book(handlers, index);
+        return reject(handlers, client, "Memory allocation failed", response);
     }
 
     snapshot.num_bids = snapshot.num_asks = 0;
-    avl_inorder_traverse(book->buy_orders, collect_orders, &snapshot);
-    avl_inorder_traverse(book->sell_orders, collect_orders, &snapshot);
+    order_book_traverse_buy_orders(book, collect_orders, &snapshot);
+    order_book_traverse_sell_orders(book, collect_orders, &snapshot);
 
-    pthread_rwlock_unlock(&handlers->books_lock);
+    unlock_book(handlers, index);
+    mark_stage(LATENCY_STAGE_MATCH);
 
     // Serialize and send snapshot
     char* book_json = serialize_book_snapshot(&snapshot);
+    mark_stage(LATENCY_STAGE_SERIALIZE);
     if (!book_json) {
         free(snapshot.bid_prices);
         free(snapshot.bid_quantities);
         free(snapshot.ask_prices);
         free(snapshot.ask_quantities);
-        return send_error_response(client, "Failed to serialize book snapshot", response);
+        return reject(handlers, client, "Failed to serialize book snapshot", response);
     }
 
     ws_server_send(client, book_json, strlen(book_json));
+    mark_stage(LATENCY_STAGE_WRITE);
     
     free(book_json);
     free(snapshot.bid_prices);
@@ -344,27 +894,85 @@ int handle_book_request(ServerHandlers* handlers, WSClient* client, const cJSON*
     return 0;
 }
 
+void server_handlers_get_status(ServerHandlers* handlers, ServerStatus* status) {
+    memset(status, 0, sizeof(*status));
+    if (!handlers) return;
+
+    status->is_ready = is_running(handlers);
+    status->num_connected_clients = ws_server_get_client_count(handlers->ws_server);
+    status->timestamp = (int64_t)time(NULL);
+
+    // The registry lock only excludes book creation; workers share it for reading
+    pthread_rwlock_rdlock(&handlers->books_lock);
+    for (int i = 0; i < handlers->book_count; i++) {
+        SymbolStatus* entry = &status->symbols[i];
+        strncpy(entry->symbol, handlers->symbols[i], sizeof(entry->symbol) - 1);
+        entry->active_orders = atomic_load_explicit(&handlers->active_orders[i].count,
+                                                    memory_order_relaxed);
+        status->num_active_orders += entry->active_orders;
+    }
+    status->num_symbols = handlers->book_count;
+    pthread_rwlock_unlock(&handlers->books_lock);
+
+    status->num_counters = server_metrics_summarize(handlers->metrics, status->counters,
+                                                    MAX_STATUS_COUNTERS);
+    status->num_latency_stages = latency_stats_summarize(handlers->latency, status->latency,
+                                                         MAX_LATENCY_STAGES);
+}
+
+int handle_status_request(ServerHandlers* handlers, WSClient* client, const cJSON* root, char* response) {
+    (void)root;
+    ServerStatus status;
+    server_handlers_get_status(handlers, &status);
+
+    char* status_json = serialize_server_status(&status);
+    mark_stage(LATENCY_STAGE_SERIALIZE);
+    if (!status_json) {
+        return reject(handlers, client, "Failed to serialize server status", response);
+    }
+
+    ws_server_send(client, status_json, strlen(status_json));
+    mark_stage(LATENCY_STAGE_WRITE);
+    free(status_json);
+    return 0;
+}
+
+// Ends a dequeued request: frees the client's in-flight slot, which may let
+// a paused connection read again, and drops the queue's client reference
+static void finish_request(WSClient* client) {
+    ws_server_message_done(client);
+    ws_server_client_release(client);
+}
+
 // Worker Thread
 static void* worker_thread(void* arg) {
     ServerHandlers* handlers = (ServerHandlers*)arg;
     char response[1024];
     WSClient* client;
+    RequestTimer timer;
+    PendingTrades trades = {0};
+
+    // First touch of this worker's shards happens here, on its own core
+    latency_stats_prepare_thread(handlers->latency);
+    server_metrics_prepare_thread(handlers->metrics);
 
-    while (handlers->running) {
-        char* message = dequeue_message(handlers, &client);
+    while (is_running(handlers)) {
+        char* message = dequeue_message(handlers, &client, &timer);
         if (!message) continue;
 
         int msg_type;
         if (!parse_base_message(message, &msg_type)) {
-            send_error_response(client, "Invalid message format", response);
+            reject(handlers, client, "Invalid message format", response);
             free(message);
+            finish_request(client);
             continue;
         }
 
         cJSON* root = cJSON_Parse(message);
         if (!root) {
-            send_error_response(client, "Invalid JSON", response);
+            reject(handlers, client, "Invalid JSON", response);
             free(message);
+            finish_request(client);
             continue;
         }
 
@@ -372,7 +980,13 @@ static void* worker_thread(void* arg) {
         bool handled = false;
         for (size_t i = 0; i < sizeof(message_handlers)/sizeof(message_handlers[0]); i++) {
             if (message_handlers[i].msg_type == msg_type) {
+                current_timer = &timer;
+                current_trades = &trades;
                 message_handlers[i].handler(handlers, client, root, response);
+                current_timer = NULL;
+                current_trades = NULL;
+                trades.count = 0;
+                latency_stats_record(handlers->latency, &timer);
                 handled = true;
                 break;
             }
@@ -380,12 +994,14 @@ static void* worker_thread(void* arg) {
 
         if (!handled) {
             LOG_WARN("Unhandled message type: %d", msg_type);
-            send_error_response(client, "Unsupported message type", response);
+            reject(handlers, client, "Unsupported message type", response);
         }
 
         cJSON_Delete(root);
         free(message);
+        finish_request(client);
     }
+    free(trades.trades);
     return NULL;
 }
 
@@ -395,18 +1011,36 @@ ServerHandlers* server_handlers_create(const HandlerConfig* config) {
 
     handlers->thread_count = config->thread_pool_size;
     handlers->queue_size = config->message_queue_size;
-    handlers->running = false;
+    atomic_init(&handlers->running, false);
     handlers->queue_head = handlers->queue_tail = 0;
     handlers->trade_broadcaster = config->trade_broadcaster;
+    handlers->journal = config->journal;
+    handlers->ws_server = config->ws_server;
+    handlers->metrics = config->metrics;
+    handlers->worker_cpus = config->worker_cpus;
+    handlers->busy_poll = config->busy_poll;
+    handlers->busy_poll_idle_ns = (int64_t)config->busy_poll_idle_us * 1000;
 
     handlers->worker_threads = calloc(config->thread_pool_size, sizeof(pthread_t));
     handlers->message_queue = calloc(config->message_queue_size, sizeof(char*));
     handlers->client_queue = calloc(config->message_queue_size, sizeof(WSClient*));
+    handlers->receive_times = calloc(config->message_queue_size, sizeof(int64_t));
+    handlers->enqueue_times = calloc(config->message_queue_size, sizeof(int64_t));
+    handlers->latency = latency_stats_create();
+    if (config->trader_limit.rate > 0) {
+        handlers->traders = rate_limiter_create(&config->trader_limit, MAX_TRACKED_TRADERS);
+    }
 
-    if (!handlers->worker_threads || !handlers->message_queue || !handlers->client_queue) {
+    if (!handlers->worker_threads || !handlers->message_queue || !handlers->client_queue ||
+        !handlers->receive_times || !handlers->enqueue_times || !handlers->latency ||
+        (config->trader_limit.rate > 0 && !handlers->traders)) {
         free(handlers->worker_threads);
         free(handlers->message_queue);
         free(handlers->client_queue);
+        free(handlers->receive_times);
+        free(handlers->enqueue_times);
+        latency_stats_destroy(handlers->latency);
+        rate_limiter_destroy(handlers->traders);
         free(handlers);
         return NULL;
     }
@@ -414,6 +1048,9 @@ ServerHandlers* server_handlers_create(const HandlerConfig* config) {
     pthread_mutex_init(&handlers->queue_lock, NULL);
     pthread_cond_init(&handlers->queue_cond, NULL);
     pthread_rwlock_init(&handlers->books_lock, NULL);
+    for (int i = 0; i < MAX_SYMBOLS; i++) {
+        pthread_mutex_init(&handlers->book_locks[i], NULL);
+    }
 
     return handlers;
 }
@@ -421,34 +1058,45 @@ ServerHandlers* server_handlers_create(const HandlerConfig* config) {
 void server_handlers_destroy(ServerHandlers* handlers) {
     if (!handlers) return;
     
-    if (handlers->running) {
+    if (is_running(handlers)) {
         server_handlers_stop_workers(handlers);
     }
     
     pthread_mutex_destroy(&handlers->queue_lock);
     pthread_cond_destroy(&handlers->queue_cond);
     pthread_rwlock_destroy(&handlers->books_lock);
+    for (int i = 0; i < MAX_SYMBOLS; i++) {
+        pthread_mutex_destroy(&handlers->book_locks[i]);
+    }
     
     for (int i = 0; i < handlers->book_count; i++) {
         order_book_destroy(handlers->books[i]);
     }
     
-    for (int i = 0; i < handlers->queue_size; i++) {
+    // Slots outside head..tail hold messages the workers already freed
+    for (int i = handlers->queue_head; i != handlers->queue_tail; i = (i + 1) % handlers->queue_size) {
         free(handlers->message_queue[i]);
+        finish_request(handlers->client_queue[i]);
     }
     
     free(handlers->message_queue);
+    free(handlers->client_queue);
+    free(handlers->receive_times);
+    free(handlers->enqueue_times);
     free(handlers->worker_threads);
+    latency_stats_destroy(handlers->latency);
+    rate_limiter_destroy(handlers->traders);
     free(handlers);
 }
 
 int server_handlers_start_workers(ServerHandlers* handlers) {
-    if (!handlers || handlers->running) return -1;
+    if (!handlers || is_running(handlers)) return -1;
     
-    handlers->running = true;
+    atomic_store_explicit(&handlers->running, true, memory_order_release);
     for (int i = 0; i < handlers->thread_count; i++) {
-        if (pthread_create(&handlers->worker_threads[i], NULL, worker_thread, handlers) != 0) {
-            handlers->running = false;
+        if (cpu_thread_create(&handlers->worker_threads[i], &handlers->worker_cpus, i,
+                              worker_thread, handlers) != 0) {
+            atomic_store_explicit(&handlers->running, false, memory_order_release);
             return -1;
         }
     }
@@ -457,10 +1105,12 @@ int server_handlers_start_workers(ServerHandlers* handlers) {
 }
 
 int server_handlers_stop_workers(ServerHandlers* handlers) {
-    if (!handlers || !handlers->running) return -1;
+    if (!handlers || !is_running(handlers)) return -1;
     
-    handlers->running = false;
+    pthread_mutex_lock(&handlers->queue_lock);
+    atomic_store_explicit(&handlers->running, false, memory_order_release);
     pthread_cond_broadcast(&handlers->queue_cond);
+    pthread_mutex_unlock(&handlers->queue_lock);
     
     for (int i = 0; i < handlers->thread_count; i++) {
         pthread_join(handlers->worker_threads[i], NULL);
@@ -469,28 +1119,90 @@ int server_handlers_stop_workers(ServerHandlers* handlers) {
     return 0;
 }
 
+// Finds the trader_id string value in a raw message without parsing it.
+// Only the first occurrence is considered, which is the top-level field in
+// every message the protocol defines.
+static bool find_trader_id(const char* message, size_t len, const char** id, size_t* id_len) {
+    static const char field[] = "\"trader_id\"";
+    const size_t field_len = sizeof(field) - 1;
+    for (size_t i = 0; i + field_len <= len; i++) {
+        if (message[i] != '"' || memcmp(message + i, field, field_len) != 0) {
+            continue;
+        }
+        size_t p = i + field_len;
+        while (p < len && (message[p] == ' ' || message[p] == ':')) {
+            p++;
+        }
+        if (p >= len || message[p] != '"') {
+            return false;
+        }
+        size_t start = ++p;
+        while (p < len && message[p] != '"') {
+            p++;
+        }
+        if (p >= len) {
+            return false;
+        }
+        *id = message + start;
+        *id_len = p - start;
+        return true;
+    }
+    return false;
+}
+
+void server_handlers_reject_throttled(ServerHandlers* handlers, WSClient* client) {
+    char response[1024];
+    reject(handlers, client, "Rate limit exceeded", response);
+}
+
 int server_handlers_process_message(ServerHandlers* handlers, WSClient* client, 
                                   const char* message, size_t len) {
     if (!handlers || !message) return -1;
+    int64_t received = clock_now_ns();
     
     LOG_DEBUG("Processing message: %.*s", (int)len, message);
 
+    // Checked on the receiving thread so a flooding trader never takes a
+    // queue slot from anyone else
+    const char* trader_id;
+    size_t trader_len;
+    if (handlers->traders && find_trader_id(message, len, &trader_id, &trader_len) &&
+        !rate_limiter_allow(handlers->traders, trader_id, trader_len, received)) {
+        server_metrics_add(handlers->metrics, METRIC_THROTTLED_TRADER, 1);
+        server_handlers_reject_throttled(handlers, client);
+        ws_server_message_done(client);
+        return -1;
+    }
+
+    // The only copy of the message, made outside the lock; the worker
+    // parses and frees it
+    char* msg_copy = malloc(len + 1);
+    if (!msg_copy) {
+        ws_server_message_done(client);
+        return -1;
+    }
+    memcpy(msg_copy, message, len);
+    msg_copy[len] = '\0';
+
     pthread_mutex_lock(&handlers->queue_lock);
     
     if ((handlers->queue_tail + 1) % handlers->queue_size == handlers->queue_head) {
         pthread_mutex_unlock(&handlers->queue_lock);
+        free(msg_copy);
+        server_metrics_add(handlers->metrics, METRIC_QUEUE_FULL_DROPS, 1);
+        char response[1024];
+        reject(handlers, client, "Server busy", response);
+        ws_server_message_done(client);
         return -1; // Queue full
     }
     
-    char* msg_copy = strdup(message);
-    if (!msg_copy) {
-        pthread_mutex_unlock(&handlers->queue_lock);
-        return -1;
-    }
-    
     handlers->message_queue[handlers->queue_tail] = msg_copy;
-    handlers->client_queue[handlers->queue_tail] = client;  // Store client reference
+    ws_server_client_retain(client);  // Released by the worker once it has replied
+    handlers->client_queue[handlers->queue_tail] = client;
+    handlers->receive_times[handlers->queue_tail] = received;
+    handlers->enqueue_times[handlers->queue_tail] = clock_now_ns();
     handlers->queue_tail = (handlers->queue_tail + 1) % handlers->queue_size;
+    atomic_fetch_add_explicit(&handlers->queue_depth, 1, memory_order_release);
     
     pthread_cond_signal(&handlers->queue_cond);
     pthread_mutex_unlock(&handlers->queue_lock);
@@ -515,30 +1227,248 @@ OrderBook* server_handlers_get_order_book(ServerHandlers* handlers, const char*
     return book;
 }
 
-int server_handlers_add_order_book(ServerHandlers* handlers, const char* symbol) {
-    if (!handlers || !symbol || handlers->book_count >= MAX_SYMBOLS) return -1;
+int server_handlers_add_order_book(ServerHandlers* handlers, const char* symbol,
+                                   const OrderBookConfig* config) {
+    if (!handlers || !symbol) return -1;
     
     pthread_rwlock_wrlock(&handlers->books_lock);
     
     // Check if symbol already exists
-    for (int i = 0; i < handlers->book_count; i++) {
-        if (strcmp(handlers->symbols[i], symbol) == 0) {
-            pthread_rwlock_unlock(&handlers->books_lock);
-            return -1;
-        }
+    if (handlers->book_count >= MAX_SYMBOLS || find_book_index(handlers, symbol) >= 0) {
+        pthread_rwlock_unlock(&handlers->books_lock);
+        return -1;
     }
     
-    OrderBook* book = order_book_create(handlers->trade_broadcaster);
+    OrderBook* book = NULL;
+    if (config) {
+        OrderBookConfig book_config = *config;
+        book_config.trade_broadcaster = NULL;  // Trades are broadcast once durable
+        book = order_book_create_with_config(&book_config);
+    } else {
+        book = order_book_create(NULL);
+    }
     if (!book) {
         pthread_rwlock_unlock(&handlers->books_lock);
         return -1;
     }
     
-    strncpy(handlers->symbols[handlers->book_count], symbol, 15);
-    handlers->symbols[handlers->book_count][15] = '\0';
-    handlers->books[handlers->book_count] = book;
-    handlers->book_count++;
+    register_book(handlers, symbol, book);
     
+    LOG_INFO("Registered %s order book for symbol %s",
+             book->backend == ORDER_BOOK_BACKEND_DENSE ? "dense" : "AVL", symbol);
     pthread_rwlock_unlock(&handlers->books_lock);
     return 0;
 }
+
+int server_handlers_save_snapshot(ServerHandlers* handlers, const char* path) {
+    if (!handlers || !path) return -1;
+
+    // Writers are excluded only while the books are copied, so the image is
+    // a single consistent point that matches the journal exactly
+    pthread_rwlock_wrlock(&handlers->books_lock);
+
+    SnapshotBook entries[MAX_SYMBOLS];
+    for (int i = 0; i < handlers->book_count; i++) {
+        entries[i].symbol = handlers->symbols[i];
+        entries[i].book = handlers->books[i];
+    }
+    uint64_t lsn = journal_last_lsn(handlers->journal);
+    SnapshotImage* image = order_book_capture_snapshot(entries, (size_t)handlers->book_count, lsn);
+
+    pthread_rwlock_unlock(&handlers->books_lock);
+    if (!image) {
+        return -1;
+    }
+
+    // The checkpoint must never get ahead of the journal, or events numbered
+    // after a crash could collide with LSNs it claims to cover
+    if (handlers->journal && journal_flush(handlers->journal, lsn) != 0) {
+        LOG_ERROR("Journal could not be flushed to LSN %lu, skipping checkpoint", lsn);
+        snapshot_image_destroy(image);
+        return -1;
+    }
+
+    int result = snapshot_image_write(image, path);
+    snapshot_image_destroy(image);
+
+    if (result == 0 && handlers->journal) {
+        journal_truncate(handlers->journal, lsn);
+    }
+    return result;
+}
+
+// Runs with books_lock held for writing
+static OrderBook* resolve_recovered_book(const char* symbol, void* user_data) {
+    ServerHandlers* handlers = (ServerHandlers*)user_data;
+
+    int index = find_book_index(handlers, symbol);
+    if (index >= 0) {
+        return handlers->books[index];
+    }
+
+    if (handlers->book_count >= MAX_SYMBOLS) {
+        return NULL;
+    }
+
+    OrderBook* book = order_book_create(NULL);
+    if (!book) {
+        return NULL;
+    }
+
+    register_book(handlers, symbol, book);
+    LOG_INFO("Created order book for recovered symbol %s", symbol);
+    return book;
+}
+
+// Matching an event may replenish icebergs, which draws sequences. Starting
+// the counter just past everything replayed so far gives each slice the same
+// place in its queue as in the run that wrote the journal.
+static void begin_replayed_event(uint64_t sequence, uint64_t* max_sequence) {
+    if (sequence > *max_sequence) {
+        *max_sequence = sequence;
+    }
+    order_restart_sequence(*max_sequence + 1);
+}
+
+static void end_replayed_event(uint64_t* max_sequence) {
+    *max_sequence = order_reserve_sequences(0) - 1;  // Reserving zero just reads the counter
+}
+
+// Applies one journaled event. Fills are not applied; matching reproduces them.
+static int apply_journal_record(ServerHandlers* handlers, const JournalRecord* record,
+                                uint64_t* max_sequence) {
+    bool is_buy = (record->flags & JOURNAL_FLAG_BUY) != 0;
+
+    if (record->type == JOURNAL_EVENT_ORDER) {
+        OrderBook* book = resolve_recovered_book(record->symbol, handlers);
+        Order* order = book ? order_create(record->order_id, record->counterpart_id, record->symbol,
+                                           record->price, record->quantity, is_buy)
+                            : NULL;
+        if (!order) {
+            return -1;
+        }
+        order->sequence = record->sequence;
+        journal_restore_order_type(record, order);
+
+        int result = 0;
+        begin_replayed_event(record->sequence, max_sequence);
+        if (!order_can_rest(order)) {
+            result = order_book_execute_order(book, order) < 0 ? -1 : 0;
+            order_destroy(order);
+        } else if (order_book_add_order(book, order) != 0) {
+            order_destroy(order);
+            result = -1;
+        } else {
+            order_book_match_orders(book);
+            order_book_adopt_order(book, order);
+        }
+        end_replayed_event(max_sequence);
+        return result;
+    }
+
+    if (record->type == JOURNAL_EVENT_CANCEL) {
+        int index = find_book_index(handlers, record->symbol);
+        return index >= 0 &&
+               order_book_cancel_order(handlers->books[index], record->order_id, is_buy) == 0 ? 0 : -1;
+    }
+
+    if (record->type == JOURNAL_EVENT_MODIFY) {
+        int index = find_book_index(handlers, record->symbol);
+        if (index < 0 ||
+            order_book_modify_order(handlers->books[index], record->order_id, is_buy,
+                                    record->price, record->quantity, record->sequence) != 0) {
+            return -1;
+        }
+        begin_replayed_event(record->sequence, max_sequence);
+        order_book_match_orders(handlers->books[index]);
+        end_replayed_event(max_sequence);
+        return 0;
+    }
+
+    return 0;
+}
+
+int server_handlers_recover(ServerHandlers* handlers, const char* snapshot_path) {
+    if (!handlers) return -1;
+
+    pthread_rwlock_wrlock(&handlers->books_lock);
+
+    uint64_t snapshot_lsn = 0;
+    if (snapshot_path && access(snapshot_path, F_OK) == 0) {
+        int restored = order_book_load_snapshot(snapshot_path, resolve_recovered_book, handlers,
+                                                &snapshot_lsn);
+        if (restored < 0) {
+            pthread_rwlock_unlock(&handlers->books_lock);
+            return -1;
+        }
+        LOG_INFO("Restored %d orders from %s at journal LSN %lu", restored, snapshot_path, snapshot_lsn);
+    }
+
+    if (!handlers->journal) {
+        publish_all_active_orders(handlers);
+        pthread_rwlock_unlock(&handlers->books_lock);
+        return 0;
+    }
+
+    uint64_t last_lsn = journal_last_lsn(handlers->journal);
+    if (last_lsn < snapshot_lsn) {
+        LOG_ERROR("Checkpoint at LSN %lu is ahead of the journal, which ends at LSN %lu",
+                  snapshot_lsn, last_lsn);
+        pthread_rwlock_unlock(&handlers->books_lock);
+        return -1;
+    }
+
+    JournalReader* reader = journal_reader_open(journal_get_directory(handlers->journal),
+                                                snapshot_lsn + 1);
+    if (!reader) {
+        pthread_rwlock_unlock(&handlers->books_lock);
+        return -1;
+    }
+
+    // The journal is not started yet, so replayed fills are not journaled again
+    uint64_t applied = 0;
+    uint64_t max_sequence = 0;
+    uint64_t replayed_to = snapshot_lsn;
+    const JournalRecord* record;
+    while ((record = journal_reader_next(reader)) != NULL) {
+        if (record->lsn != replayed_to + 1) {
+            break;  // Segments after the checkpoint are missing
+        }
+        if (apply_journal_record(handlers, record, &max_sequence) != 0) {
+            LOG_WARN("Journal event at LSN %lu could not be applied", record->lsn);
+        }
+        replayed_to = record->lsn;
+        applied++;
+    }
+    journal_reader_close(reader);
+    publish_all_active_orders(handlers);
+    pthread_rwlock_unlock(&handlers->books_lock);
+
+    if (replayed_to != last_lsn) {
+        LOG_ERROR("Journal replay stopped at LSN %lu, expected LSN %lu", replayed_to, last_lsn);
+        return -1;
+    }
+    if (max_sequence > 0) {
+        order_advance_sequence(max_sequence + 1);
+    }
+
+    LOG_INFO("Replayed %lu journal events after LSN %lu", applied, snapshot_lsn);
+    return 0;
+}
+
+int server_handlers_broadcast_status(ServerHandlers* handlers, const ServerStatus* status) {
+    if (!handlers || !status || !handlers->ws_server) return -1;
+
+    char* status_json = serialize_server_status(status);
+    if (!status_json) {
+        return -1;
+    }
+    int result = ws_server_broadcast(handlers->ws_server, status_json, strlen(status_json));
+    free(status_json);
+    return result;
+}
+
+void server_handlers_log_latency(ServerHandlers* handlers) {
+    if (!handlers) return;
+    latency_stats_log(handlers->latency);
+}
@@ -0,0 +1,225 @@
+#include "server/server_metrics.h"
+#include "utils/logging.h"
+#include <stdarg.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define CACHE_LINE_SIZE 64
+#define MAX_SHARDS 64  // Threads beyond this share the last shard
+
+// One per thread, each on its own cache line
+typedef struct {
+    _Alignas(CACHE_LINE_SIZE) _Atomic uint64_t counters[METRIC_COUNT];
+} MetricsShard;
+
+struct ServerMetrics {
+    _Atomic(MetricsShard*) shards[MAX_SHARDS];
+};
+
+static const char* const metric_names[METRIC_COUNT] = {
+    [METRIC_ORDERS_IN] = "orders_in",
+    [METRIC_ACKS_OUT] = "acks_out",
+    [METRIC_TRADES] = "trades",
+    [METRIC_CANCELS] = "cancels",
+    [METRIC_MODIFIES] = "modifies",
+    [METRIC_REJECTS] = "rejects",
+    [METRIC_QUEUE_FULL_DROPS] = "queue_full_drops",
+    [METRIC_BYTES_IN] = "bytes_in",
+    [METRIC_BYTES_OUT] = "bytes_out",
+    [METRIC_CONNECTIONS_REFUSED] = "connections_refused",
+    [METRIC_THROTTLED_CONNECTION] = "throttled_connection",
+    [METRIC_THROTTLED_TRADER] = "throttled_trader"
+};
+
+static _Atomic unsigned next_thread_slot;
+static __thread int thread_slot = -1;
+
+static int current_slot(void) {
+    if (thread_slot < 0) {
+        unsigned slot = atomic_fetch_add_explicit(&next_thread_slot, 1, memory_order_relaxed);
+        thread_slot = slot < MAX_SHARDS ? (int)slot : MAX_SHARDS - 1;
+    }
+    return thread_slot;
+}
+
+ServerMetrics* server_metrics_create(void) {
+    ServerMetrics* metrics = calloc(1, sizeof(ServerMetrics));
+    if (!metrics) {
+        LOG_ERROR("Failed to allocate server metrics");
+    }
+    return metrics;
+}
+
+void server_metrics_destroy(ServerMetrics* metrics) {
+    if (!metrics) {
+        return;
+    }
+    for (int i = 0; i < MAX_SHARDS; i++) {
+        free(atomic_load(&metrics->shards[i]));
+    }
+    free(metrics);
+}
+
+static MetricsShard* get_shard(ServerMetrics* metrics) {
+    int slot = current_slot();
+    MetricsShard* shard = atomic_load_explicit(&metrics->shards[slot], memory_order_acquire);
+    if (shard) {
+        return shard;
+    }
+
+    MetricsShard* created = aligned_alloc(CACHE_LINE_SIZE, sizeof(MetricsShard));
+    if (!created) {
+        return NULL;
+    }
+    memset(created, 0, sizeof(*created));
+
+    // Only shared overflow slots can race here; the loser frees its copy
+    MetricsShard* expected = NULL;
+    if (!atomic_compare_exchange_strong_explicit(&metrics->shards[slot], &expected, created,
+                                                 memory_order_acq_rel, memory_order_acquire)) {
+        free(created);
+        return expected;
+    }
+    return created;
+}
+
+const char* server_metric_name(MetricCounter counter) {
+    return counter < METRIC_COUNT ? metric_names[counter] : "unknown";
+}
+
+void server_metrics_add(ServerMetrics* metrics, MetricCounter counter, uint64_t amount) {
+    if (!metrics || counter >= METRIC_COUNT) {
+        return;
+    }
+    MetricsShard* shard = get_shard(metrics);
+    if (!shard) {
+        return;
+    }
+    // Only the shared overflow shard ever sees more than one writer
+    atomic_fetch_add_explicit(&shard->counters[counter], amount, memory_order_relaxed);
+}
+
+void server_metrics_prepare_thread(ServerMetrics* metrics) {
+    if (metrics) {
+        get_shard(metrics);
+    }
+}
+
+uint64_t server_metrics_read(const ServerMetrics* metrics, MetricCounter counter) {
+    if (!metrics || counter >= METRIC_COUNT) {
+        return 0;
+    }
+
+    uint64_t total = 0;
+    for (int i = 0; i < MAX_SHARDS; i++) {
+        MetricsShard* shard = atomic_load_explicit(&((ServerMetrics*)metrics)->shards[i],
+                                                   memory_order_acquire);
+        if (shard) {
+            total += atomic_load_explicit(&shard->counters[counter], memory_order_relaxed);
+        }
+    }
+    return total;
+}
+
+int server_metrics_summarize(const ServerMetrics* metrics, StatusCounter* out, int max_counters) {
+    if (!metrics || !out) {
+        return 0;
+    }
+
+    int count = max_counters < METRIC_COUNT ? max_counters : METRIC_COUNT;
+    for (int i = 0; i < count; i++) {
+        memset(&out[i], 0, sizeof(out[i]));
+        strncpy(out[i].name, metric_names[i], sizeof(out[i].name) - 1);
+        out[i].value = server_metrics_read(metrics, (MetricCounter)i);
+    }
+    return count;
+}
+
+typedef struct {
+    char* data;
+    size_t size;
+    size_t used;
+} TextBuffer;
+
+static int append(TextBuffer* buffer, const char* fmt, ...) {
+    for (;;) {
+        va_list args;
+        va_start(args, fmt);
+        int written = vsnprintf(buffer->data + buffer->used, buffer->size - buffer->used, fmt, args);
+        va_end(args);
+        if (written < 0) {
+            return -1;
+        }
+        if ((size_t)written < buffer->size - buffer->used) {
+            buffer->used += (size_t)written;
+            return 0;
+        }
+
+        size_t size = buffer->size * 2;
+        while (size - buffer->used <= (size_t)written) {
+            size *= 2;
+        }
+        char* data = realloc(buffer->data, size);
+        if (!data) {
+            return -1;
+        }
+        buffer->data = data;
+        buffer->size = size;
+    }
+}
+
+char* server_metrics_format_text(const ServerStatus* status) {
+    if (!status) {
+        return NULL;
+    }
+
+    TextBuffer buffer = {.data = malloc(4096), .size = 4096, .used = 0};
+    if (!buffer.data) {
+        return NULL;
+    }
+    buffer.data[0] = '\0';
+
+    int result = 0;
+    for (int i = 0; i < status->num_counters && i < MAX_STATUS_COUNTERS && result == 0; i++) {
+        const StatusCounter* counter = &status->counters[i];
+        result = append(&buffer, "# TYPE quant_%s_total counter\nquant_%s_total %lu\n",
+                        counter->name, counter->name, counter->value);
+    }
+
+    if (result == 0) {
+        result = append(&buffer,
+                        "# TYPE quant_connected_clients gauge\nquant_connected_clients %d\n"
+                        "# TYPE quant_active_orders gauge\n",
+                        status->num_connected_clients);
+    }
+    for (int i = 0; i < status->num_symbols && i < MAX_STATUS_SYMBOLS && result == 0; i++) {
+        result = append(&buffer, "quant_active_orders{symbol=\"%s\"} %d\n",
+                        status->symbols[i].symbol, status->symbols[i].active_orders);
+    }
+
+    if (result == 0 && status->num_latency_stages > 0) {
+        result = append(&buffer, "# TYPE quant_latency_us summary\n");
+    }
+    for (int i = 0; i < status->num_latency_stages && i < MAX_LATENCY_STAGES && result == 0; i++) {
+        const LatencyStageStats* stage = &status->latency[i];
+        result = append(&buffer,
+                        "quant_latency_us{stage=\"%s\",quantile=\"0.5\"} %.1f\n"
+                        "quant_latency_us{stage=\"%s\",quantile=\"0.9\"} %.1f\n"
+                        "quant_latency_us{stage=\"%s\",quantile=\"0.99\"} %.1f\n"
+                        "quant_latency_us{stage=\"%s\",quantile=\"0.999\"} %.1f\n"
+                        "quant_latency_us_sum{stage=\"%s\"} %.1f\n"
+                        "quant_latency_us_count{stage=\"%s\"} %lu\n",
+                        stage->stage, stage->p50_us, stage->stage, stage->p90_us,
+                        stage->stage, stage->p99_us, stage->stage, stage->p999_us,
+                        stage->stage, stage->mean_us * (double)stage->count,
+                        stage->stage, stage->count);
+    }
+
+    if (result != 0) {
+        free(buffer.data);
+        return NULL;
+    }
+    return buffer.data;
+}
@@ -1,13 +1,50 @@
 #include "server/ws_server.h"
+#include "utils/clock.h"
 #include "utils/logging.h"
 #include <libwebsockets.h>
 #include <string.h>
 #include <stdlib.h>
 #include <pthread.h>
+#include <stdatomic.h>
+#include <arpa/inet.h>
+#include <sys/socket.h>
+
+#define CLIENT_OUTBOX_SIZE 256  // Messages queued per client before sends fail
+#define DEFAULT_MAX_CLIENTS 1024
+#define DEFAULT_MAX_MESSAGE_SIZE (64 * 1024)
+
+// Open connections from one peer address. IPv4 addresses are stored
+// IPv4-mapped so both families share a key format.
+typedef struct {
+    uint8_t addr[16];
+    int count;                 // 0 marks an empty entry
+} PeerEntry;
+
+// A message waiting to be written, shared by every client it was broadcast to
+typedef struct {
+    atomic_int refs;
+    size_t len;
+    char data[];
+} OutboundMessage;
+
+// One lws service thread and the connections lws assigned to it. Everything
+// about those connections that other threads touch is guarded by lock.
+typedef struct {
+    WSServer* server;
+    int index;
+    pthread_t thread;
+    pthread_mutex_t lock;
+    WSClient* clients;         // Open connections, linked through prev/next
+    WSClient* ready;           // Clients with queued output or paused reads to resume
+    uint64_t activity;         // Callbacks seen; touched only by this thread
+    unsigned char* write_buf;  // LWS_PRE headroom plus the message being written
+    size_t write_buf_size;
+} ServiceThread;
 
 struct WSServer {
     struct lws_context* context;
     struct lws_vhost* vhost;
+    struct lws_vhost* metrics_vhost;
     const WSServerConfig* config;
     struct lws_context_creation_info info;
 
@@ -16,31 +53,82 @@ struct WSServer {
     ClientDisconnectCallback disconnect_cb;
     MessageCallback message_cb;
     void* user_data;
+    MetricsPageCallback metrics_page_cb;
+    void* metrics_user_data;
+    ThrottleCallback throttle_cb;
+    void* throttle_user_data;
 
     // Threading
-    pthread_t service_thread;
+    ServiceThread* services;
+    int service_count;
     bool running;
-    pthread_mutex_t lock;
-    unsigned char* broadcast_buf;
-    size_t broadcast_len;
+    atomic_int client_count;
+
+    // Admission. Clients come from a table sized to max_clients, so a
+    // connection storm cannot grow memory, and peers counts open
+    // connections per address in an open-addressed table.
+    int max_clients;
+    WSClient* client_slots;
+    WSClient* free_clients;    // Linked through next
+    char* rx_arena;            // max_message_size bytes per slot for reassembly
+    size_t max_message_size;
+    pthread_mutex_t slots_lock;
+    PeerEntry* peers;
+    unsigned peer_mask;
+    pthread_mutex_t peers_lock;
+    atomic_int queued_messages;  // Sends waiting to be written, across all clients
 };
 
 struct WSClient {
-    struct lws* wsi;
+    struct lws* wsi;           // NULL once the connection has closed
     WSClientInfo info;
     WSServer* server;
+    ServiceThread* service;    // Owning service thread; its lock guards the fields below
+    uint8_t peer[16];
+    bool has_peer;             // False for peers without an IP address
+    TokenBucket bucket;        // Touched only by the owning service thread
+    char* rx_buf;              // This slot's reassembly buffer; kept across reuse
+    size_t rx_len;             // Bytes of a fragmented message gathered so far
+    bool rx_overflow;          // The current message outgrew rx_buf
+    atomic_int refs;
+    WSClient* prev;
+    WSClient* next;
+    WSClient* ready_next;
+    bool ready;
+    bool rx_paused;            // Reads stopped until workers catch up on this client's messages
+    atomic_int in_flight;      // Messages delivered to the message callback and not yet done
+    unsigned outbox_head;
+    unsigned outbox_tail;
+    OutboundMessage* outbox[CLIENT_OUTBOX_SIZE];
 };
 
+// lws per-session data for a trading connection
+typedef struct {
+    WSClient* client;
+} ClientSession;
+
+// The service thread running on this thread, if any
+static __thread ServiceThread* current_service;
+
+// A /metrics response waiting for the connection to become writable
+typedef struct {
+    char* body;
+    size_t len;
+} MetricsRequest;
+
 // Forward declarations
 static void* service_thread(void* arg);
+static void free_server(WSServer* server);
 static int callback_trading(struct lws* wsi, enum lws_callback_reasons reason,
                           void* user, void* in, size_t len);
+static int callback_metrics(struct lws* wsi, enum lws_callback_reasons reason,
+                            void* user, void* in, size_t len);
 
 static struct lws_protocols protocols[] = {
     {
         .name = "trading-protocol",
         .callback = callback_trading,
-        .per_session_data_size = sizeof(WSClient),
+        .per_session_data_size = sizeof(ClientSession),
         .rx_buffer_size = 4096,
         .tx_packet_size = 4096,
         .id = 0,
@@ -57,6 +145,27 @@ static struct lws_protocols protocols[] = {
     }
 };
 
+static struct lws_protocols metrics_protocols[] = {
+    {
+        .name = "http-metrics",
+        .callback = callback_metrics,
+        .per_session_data_size = sizeof(MetricsRequest),
+        .rx_buffer_size = 0,
+        .tx_packet_size = 0,
+        .id = 0,
+        .user = NULL,
+    },
+    {
+        .name = NULL,
+        .callback = NULL,
+        .per_session_data_size = 0,
+        .rx_buffer_size = 0,
+        .tx_packet_size = 0,
+        .id = 0,
+        .user = NULL,
+    }
+};
+
 WSServer* ws_server_create(const WSServerConfig* config) {
     WSServer* server = calloc(1, sizeof(WSServer));
     if (!server) {
@@ -65,26 +174,93 @@ WSServer* ws_server_create(const WSServerConfig* config) {
     }
 
     server->config = config;
-    pthread_mutex_init(&server->lock, NULL);
-    server->broadcast_buf = NULL;
-    server->broadcast_len = 0;
+    server->service_count = config->service_threads > 0 ? config->service_threads : 1;
+#ifdef LWS_MAX_SMP
+    if (server->service_count > LWS_MAX_SMP) {
+        LOG_WARN("libwebsockets was built for at most %d service threads, using %d",
+                 LWS_MAX_SMP, LWS_MAX_SMP);
+        server->service_count = LWS_MAX_SMP;
+    }
+#endif
+
+    server->max_clients = config->max_clients > 0 ? config->max_clients : DEFAULT_MAX_CLIENTS;
+    server->max_message_size = config->max_message_size > 0 ? (size_t)config->max_message_size
+                                                            : DEFAULT_MAX_MESSAGE_SIZE;
+    unsigned peer_capacity = 16;
+    while (peer_capacity < 2u * (unsigned)server->max_clients) {
+        peer_capacity *= 2;  // At most half full, so probes stay short
+    }
+    server->peer_mask = peer_capacity - 1;
+    pthread_mutex_init(&server->slots_lock, NULL);
+    pthread_mutex_init(&server->peers_lock, NULL);
+
+    server->services = calloc((size_t)server->service_count, sizeof(ServiceThread));
+    server->client_slots = calloc((size_t)server->max_clients, sizeof(WSClient));
+    // Untouched pages of a large calloc are not backed until a message
+    // needs them, so only buffers that reassemble something cost memory
+    server->rx_arena = calloc((size_t)server->max_clients, server->max_message_size);
+    server->peers = calloc(peer_capacity, sizeof(PeerEntry));
+    if (!server->services || !server->client_slots || !server->rx_arena || !server->peers) {
+        LOG_ERROR("Failed to allocate tables for %d clients", server->max_clients);
+        free_server(server);
+        return NULL;
+    }
+    for (int i = 0; i < server->service_count; i++) {
+        server->services[i].server = server;
+        server->services[i].index = i;
+        pthread_mutex_init(&server->services[i].lock, NULL);
+    }
+    for (int i = server->max_clients - 1; i >= 0; i--) {
+        server->client_slots[i].rx_buf = server->rx_arena + (size_t)i * server->max_message_size;
+        server->client_slots[i].next = server->free_clients;
+        server->free_clients = &server->client_slots[i];
+    }
 
     memset(&server->info, 0, sizeof(server->info));
     server->info.port = config->port;
     server->info.protocols = protocols;
     server->info.gid = -1;
     server->info.uid = -1;
-    server->info.options = LWS_SERVER_OPTION_VALIDATE_UTF8;
+    server->info.options = LWS_SERVER_OPTION_VALIDATE_UTF8 | LWS_SERVER_OPTION_EXPLICIT_VHOSTS;
     server->info.user = server;  // Store server pointer for callbacks
+    server->info.vhost_name = "trading";
+    server->info.count_threads = (unsigned int)server->service_count;
 
     server->context = lws_create_context(&server->info);
     if (!server->context) {
         LOG_ERROR("Failed to create libwebsockets context");
-        free(server);
+        free_server(server);
+        return NULL;
+    }
+
+    server->vhost = lws_create_vhost(server->context, &server->info);
+    if (!server->vhost) {
+        LOG_ERROR("Failed to listen on port %d", config->port);
+        lws_context_destroy(server->context);
+        free_server(server);
         return NULL;
     }
 
-    LOG_INFO("WebSocket server created on port %d", config->port);
+    // Metrics get their own plain HTTP listener on the same context and service thread
+    if (config->metrics_port > 0) {
+        struct lws_context_creation_info metrics_info;
+        memset(&metrics_info, 0, sizeof(metrics_info));
+        metrics_info.port = config->metrics_port;
+        metrics_info.protocols = metrics_protocols;
+        metrics_info.vhost_name = "metrics";
+
+        server->metrics_vhost = lws_create_vhost(server->context, &metrics_info);
+        if (!server->metrics_vhost) {
+            LOG_ERROR("Failed to listen for metrics on port %d", config->metrics_port);
+            lws_context_destroy(server->context);
+            free_server(server);
+            return NULL;
+        }
+        LOG_INFO("Serving metrics on http://0.0.0.0:%d/metrics", config->metrics_port);
+    }
+
+    LOG_INFO("WebSocket server created on port %d with %d service thread%s",
+             config->port, server->service_count, server->service_count == 1 ? "" : "s");
     return server;
 }
 
@@ -99,8 +275,7 @@ void ws_server_destroy(WSServer* server) {
         lws_context_destroy(server->context);
     }
 
-    pthread_mutex_destroy(&server->lock);
-    free(server);
+    free_server(server);
     LOG_INFO("WebSocket server destroyed");
 }
 
@@ -108,10 +283,19 @@ int ws_server_start(WSServer* server) {
     if (!server) return -1;
 
     server->running = true;
-    if (pthread_create(&server->service_thread, NULL, service_thread, server) != 0) {
-        LOG_ERROR("Failed to create service thread");
-        server->running = false;
-        return -1;
+    for (int i = 0; i < server->service_count; i++) {
+        // A single thread may float over all the service CPUs; several get one each
+        int slot = server->service_count > 1 ? i : -1;
+        if (cpu_thread_create(&server->services[i].thread, &server->config->service_cpus, slot,
+                              service_thread, &server->services[i]) != 0) {
+            LOG_ERROR("Failed to create service thread");
+            server->running = false;
+            lws_cancel_service(server->context);
+            for (int j = 0; j < i; j++) {
+                pthread_join(server->services[j].thread, NULL);
+            }
+            return -1;
+        }
     }
 
     LOG_INFO("WebSocket server started");
@@ -122,36 +306,440 @@ void ws_server_stop(WSServer* server) {
     if (!server || !server->running) return;
 
     server->running = false;
-    pthread_join(server->service_thread, NULL);
+    lws_cancel_service(server->context);
+    for (int i = 0; i < server->service_count; i++) {
+        pthread_join(server->services[i].thread, NULL);
+    }
     LOG_INFO("WebSocket server stopped");
 }
 
 static void* service_thread(void* arg) {
-    WSServer* server = (WSServer*)arg;
-    
+    ServiceThread* service = (ServiceThread*)arg;
+    WSServer* server = service->server;
+    current_service = service;
+    server_metrics_prepare_thread(server->config->metrics);
+
+    if (!server->config->busy_poll) {
+        while (server->running) {
+            lws_service_tsi(server->context, 50, service->index);  // 50ms timeout
+        }
+        return NULL;
+    }
+
+    // A negative timeout makes lws poll without sleeping, so a packet is
+    // picked up as soon as it lands instead of after a scheduler wake-up.
+    // Once idle for busy_poll_idle_us the loop blocks in poll again until
+    // traffic returns.
+    int64_t idle_limit_ns = (int64_t)server->config->busy_poll_idle_us * 1000;
+    int64_t last_active = clock_now_ns();
     while (server->running) {
-        lws_service(server->context, 50);  // 50ms timeout
+        uint64_t before = service->activity;
+        lws_service_tsi(server->context, -1, service->index);
+
+        int64_t now = clock_now_ns();
+        if (service->activity != before) {
+            last_active = now;
+        } else if (idle_limit_ns > 0 && now - last_active >= idle_limit_ns) {
+            lws_service_tsi(server->context, 50, service->index);
+            last_active = clock_now_ns();
+        } else {
+            cpu_relax();
+        }
     }
-    
+
     return NULL;
 }
 
+static void release_message(OutboundMessage* message) {
+    if (atomic_fetch_sub_explicit(&message->refs, 1, memory_order_acq_rel) == 1) {
+        free(message);
+    }
+}
+
+static OutboundMessage* create_message(const char* data, size_t len) {
+    OutboundMessage* message = malloc(sizeof(OutboundMessage) + len);
+    if (!message) {
+        return NULL;
+    }
+    atomic_init(&message->refs, 1);
+    message->len = len;
+    memcpy(message->data, data, len);
+    return message;
+}
+
+static void free_server(WSServer* server) {
+    if (server->services) {
+        for (int i = 0; i < server->service_count; i++) {
+            pthread_mutex_destroy(&server->services[i].lock);
+            free(server->services[i].write_buf);
+        }
+    }
+    pthread_mutex_destroy(&server->slots_lock);
+    pthread_mutex_destroy(&server->peers_lock);
+    free(server->services);
+    free(server->client_slots);
+    free(server->rx_arena);
+    free(server->peers);
+    free(server);
+}
+
+static uint32_t hash_peer(const uint8_t* addr) {
+    uint32_t hash = 2166136261u;  // FNV-1a
+    for (int i = 0; i < 16; i++) {
+        hash = (hash ^ addr[i]) * 16777619u;
+    }
+    return hash;
+}
+
+// Index of addr's entry, or of the empty entry where it would go.
+// Called with peers_lock held.
+static unsigned find_peer(const WSServer* server, const uint8_t* addr) {
+    unsigned i = hash_peer(addr) & server->peer_mask;
+    while (server->peers[i].count > 0 && memcmp(server->peers[i].addr, addr, 16) != 0) {
+        i = (i + 1) & server->peer_mask;
+    }
+    return i;
+}
+
+static int peer_connections(WSServer* server, const uint8_t* addr) {
+    pthread_mutex_lock(&server->peers_lock);
+    int count = server->peers[find_peer(server, addr)].count;
+    pthread_mutex_unlock(&server->peers_lock);
+    return count;
+}
+
+// Counts a connection from addr unless the peer is at its limit
+static bool add_peer_connection(WSServer* server, const uint8_t* addr) {
+    int limit = server->config->max_clients_per_ip;
+    pthread_mutex_lock(&server->peers_lock);
+    PeerEntry* entry = &server->peers[find_peer(server, addr)];
+    bool admitted = limit <= 0 || entry->count < limit;
+    if (admitted) {
+        memcpy(entry->addr, addr, 16);
+        entry->count++;
+    }
+    pthread_mutex_unlock(&server->peers_lock);
+    return admitted;
+}
+
+static void remove_peer_connection(WSServer* server, const uint8_t* addr) {
+    pthread_mutex_lock(&server->peers_lock);
+    unsigned i = find_peer(server, addr);
+    if (server->peers[i].count > 0 && --server->peers[i].count == 0) {
+        // Shift later entries of the probe run back so lookups need no tombstones
+        unsigned j = i;
+        for (;;) {
+            j = (j + 1) & server->peer_mask;
+            if (server->peers[j].count == 0) {
+                break;
+            }
+            unsigned home = hash_peer(server->peers[j].addr) & server->peer_mask;
+            if (((j - home) & server->peer_mask) >= ((j - i) & server->peer_mask)) {
+                server->peers[i] = server->peers[j];
+                i = j;
+            }
+        }
+        server->peers[i].count = 0;
+    }
+    pthread_mutex_unlock(&server->peers_lock);
+}
+
+// The remote address of fd in IPv4-mapped form. False for non-IP sockets.
+static bool peer_address(int fd, uint8_t* addr) {
+    struct sockaddr_storage storage;
+    socklen_t len = sizeof(storage);
+    if (fd < 0 || getpeername(fd, (struct sockaddr*)&storage, &len) != 0) {
+        return false;
+    }
+    if (storage.ss_family == AF_INET) {
+        const struct sockaddr_in* in4 = (const struct sockaddr_in*)&storage;
+        memset(addr, 0, 10);
+        addr[10] = addr[11] = 0xff;
+        memcpy(addr + 12, &in4->sin_addr, 4);
+        return true;
+    }
+    if (storage.ss_family == AF_INET6) {
+        memcpy(addr, &((const struct sockaddr_in6*)&storage)->sin6_addr, 16);
+        return true;
+    }
+    return false;
+}
+
+// Why a connection from addr should be turned away, or NULL to admit it
+static const char* admission_refusal(WSServer* server, const uint8_t* addr) {
+    if (atomic_load(&server->client_count) >= server->max_clients) {
+        return "server full";
+    }
+    int shed_limit = server->config->shed_queued_messages;
+    if (shed_limit > 0 && atomic_load_explicit(&server->queued_messages, memory_order_relaxed) >= shed_limit) {
+        return "outbound queues saturated";
+    }
+    int peer_limit = server->config->max_clients_per_ip;
+    if (addr && peer_limit > 0 && peer_connections(server, addr) >= peer_limit) {
+        return "too many connections from peer";
+    }
+    return NULL;
+}
+
+static void refuse_connection(WSServer* server, const char* reason) {
+    server_metrics_add(server->config->metrics, METRIC_CONNECTIONS_REFUSED, 1);
+    LOG_DEBUG("Refused connection: %s", reason);
+}
+
+static WSClient* acquire_client(WSServer* server) {
+    pthread_mutex_lock(&server->slots_lock);
+    WSClient* client = server->free_clients;
+    if (client) {
+        server->free_clients = client->next;
+    }
+    pthread_mutex_unlock(&server->slots_lock);
+    if (client) {
+        char* rx_buf = client->rx_buf;
+        memset(client, 0, sizeof(*client));
+        client->rx_buf = rx_buf;
+    }
+    return client;
+}
+
+void ws_server_client_retain(WSClient* client) {
+    if (client) {
+        atomic_fetch_add_explicit(&client->refs, 1, memory_order_relaxed);
+    }
+}
+
+void ws_server_client_release(WSClient* client) {
+    if (client && atomic_fetch_sub_explicit(&client->refs, 1, memory_order_acq_rel) == 1) {
+        WSServer* server = client->server;
+        pthread_mutex_lock(&server->slots_lock);
+        client->next = server->free_clients;
+        server->free_clients = client;
+        pthread_mutex_unlock(&server->slots_lock);
+    }
+}
+
+// Hands a client to its service thread, which must touch lws on its behalf.
+// Called with the client's service lock held from any other thread.
+static void park_client(WSClient* client, bool* wake) {
+    if (!client->ready) {
+        ws_server_client_retain(client);
+        client->ready = true;
+        client->ready_next = client->service->ready;
+        client->service->ready = client;
+        *wake = true;
+    }
+}
+
+// Queues message for client and makes sure a writable callback will follow.
+// Called with the client's service lock held; takes a message reference on
+// success. Returns false when the client is gone or its outbox is full.
+static bool queue_message(WSClient* client, OutboundMessage* message, bool* wake) {
+    if (!client->wsi || client->outbox_tail - client->outbox_head == CLIENT_OUTBOX_SIZE) {
+        return false;
+    }
+    atomic_fetch_add_explicit(&message->refs, 1, memory_order_relaxed);
+    client->outbox[client->outbox_tail++ % CLIENT_OUTBOX_SIZE] = message;
+    atomic_fetch_add_explicit(&client->server->queued_messages, 1, memory_order_relaxed);
+
+    if (current_service == client->service) {
+        // Already on the owning thread, so lws can be asked directly
+        lws_callback_on_writable(client->wsi);
+    } else {
+        park_client(client, wake);
+    }
+    return true;
+}
+
+// Runs on the service thread after lws_cancel_service() woke it
+static void service_ready_clients(ServiceThread* service) {
+    int resume_at = service->server->config->max_in_flight / 2;
+    pthread_mutex_lock(&service->lock);
+    WSClient* client = service->ready;
+    service->ready = NULL;
+    while (client) {
+        WSClient* next = client->ready_next;
+        client->ready = false;
+        client->ready_next = NULL;
+        if (client->wsi) {
+            if (client->outbox_head != client->outbox_tail) {
+                lws_callback_on_writable(client->wsi);
+            }
+            if (client->rx_paused && atomic_load(&client->in_flight) <= resume_at) {
+                client->rx_paused = false;
+                lws_rx_flow_control(client->wsi, 1);
+            }
+        }
+        ws_server_client_release(client);
+        client = next;
+    }
+    pthread_mutex_unlock(&service->lock);
+}
+
+void ws_server_message_done(WSClient* client) {
+    if (!client || client->server->config->max_in_flight <= 0) {
+        return;
+    }
+    int remaining = atomic_fetch_sub(&client->in_flight, 1) - 1;
+    if (remaining > client->server->config->max_in_flight / 2) {
+        return;
+    }
+
+    // Pairs with the recheck in pause_reads(): either this sees the pause or
+    // that sees the decrement, so a paused client is always resumed
+    ServiceThread* service = client->service;
+    bool wake = false;
+    pthread_mutex_lock(&service->lock);
+    if (client->rx_paused && client->wsi) {
+        park_client(client, &wake);
+        if (wake) {
+            lws_cancel_service_pt(client->wsi);
+        }
+    }
+    pthread_mutex_unlock(&service->lock);
+}
+
+// Stops reading from a client whose in-flight budget is spent, so the
+// kernel's receive window rather than the worker queue absorbs the excess.
+// Runs on the owning service thread.
+static void pause_reads(WSClient* client) {
+    int max_in_flight = client->server->config->max_in_flight;
+    if (max_in_flight <= 0 || atomic_load(&client->in_flight) < max_in_flight) {
+        return;
+    }
+
+    pthread_mutex_lock(&client->service->lock);
+    bool was_paused = client->rx_paused;
+    client->rx_paused = true;
+    pthread_mutex_unlock(&client->service->lock);
+    if (was_paused) {
+        return;
+    }
+    lws_rx_flow_control(client->wsi, 0);
+
+    // Workers may have finished everything between the check and the pause
+    if (atomic_load(&client->in_flight) <= max_in_flight / 2) {
+        pthread_mutex_lock(&client->service->lock);
+        client->rx_paused = false;
+        pthread_mutex_unlock(&client->service->lock);
+        lws_rx_flow_control(client->wsi, 1);
+    }
+}
+
+// Writes the oldest queued message. lws allows one write per writable callback.
+static int write_next_message(ServiceThread* service, WSClient* client, struct lws* wsi) {
+    pthread_mutex_lock(&service->lock);
+    OutboundMessage* message = NULL;
+    if (client->outbox_head != client->outbox_tail) {
+        message = client->outbox[client->outbox_head++ % CLIENT_OUTBOX_SIZE];
+    }
+    bool more = client->outbox_head != client->outbox_tail;
+    pthread_mutex_unlock(&service->lock);
+
+    if (!message) {
+        return 0;
+    }
+    atomic_fetch_sub_explicit(&service->server->queued_messages, 1, memory_order_relaxed);
+
+    // lws writes the frame header into the headroom, so the shared message
+    // is copied into this thread's own buffer first
+    size_t needed = LWS_PRE + message->len;
+    if (needed > service->write_buf_size) {
+        unsigned char* buf = realloc(service->write_buf, needed);
+        if (!buf) {
+            release_message(message);
+            return -1;
+        }
+        service->write_buf = buf;
+        service->write_buf_size = needed;
+    }
+    memcpy(service->write_buf + LWS_PRE, message->data, message->len);
+    int written = lws_write(wsi, service->write_buf + LWS_PRE, message->len, LWS_WRITE_TEXT);
+    release_message(message);
+    if (written < 0) {
+        LOG_ERROR("Failed to write to client %s", client->info.client_id);
+        return -1;
+    }
+    server_metrics_add(service->server->config->metrics, METRIC_BYTES_OUT, (uint64_t)written);
+
+    if (more) {
+        lws_callback_on_writable(wsi);
+    }
+    return 0;
+}
+
 static int callback_trading(struct lws* wsi, enum lws_callback_reasons reason,
                           void* user, void* in, size_t len) {
-    WSClient* client = (WSClient*)user;
+    ClientSession* session = (ClientSession*)user;
+    WSClient* client = session ? session->client : NULL;
     WSServer* server = (WSServer*)lws_context_user(lws_get_context(wsi));
+    if (current_service) {
+        current_service->activity++;
+    }
 
     switch (reason) {
         case LWS_CALLBACK_PROTOCOL_INIT:
             LOG_DEBUG("Protocol initialized");
             break;
 
+        case LWS_CALLBACK_EVENT_WAIT_CANCELLED:
+            if (current_service) {
+                service_ready_clients(current_service);
+            }
+            break;
+
+        // Raised right after accept(), before any handshake work is spent on
+        // the connection; in holds the new socket
+        case LWS_CALLBACK_FILTER_NETWORK_CONNECTION: {
+            uint8_t addr[16];
+            bool has_addr = peer_address((int)(intptr_t)in, addr);
+            const char* reason = admission_refusal(server, has_addr ? addr : NULL);
+            if (reason) {
+                refuse_connection(server, reason);
+                return -1;
+            }
+            break;
+        }
+
         case LWS_CALLBACK_ESTABLISHED: {
+            // The filter only saw connections already established, so a
+            // burst accepted together is held to the limits here
+            uint8_t addr[16];
+            bool has_addr = peer_address(lws_get_socket_fd(wsi), addr);
+            if (has_addr && !add_peer_connection(server, addr)) {
+                refuse_connection(server, "too many connections from peer");
+                return -1;
+            }
+            client = acquire_client(server);
+            if (!client) {
+                if (has_addr) {
+                    remove_peer_connection(server, addr);
+                }
+                refuse_connection(server, "server full");
+                return -1;
+            }
+            // The connection is serviced by the thread that accepted it
+            ServiceThread* service = current_service ? current_service : &server->services[0];
+            if (has_addr) {
+                memcpy(client->peer, addr, sizeof(addr));
+                client->has_peer = true;
+            }
             client->wsi = wsi;
             client->server = server;
+            client->service = service;
+            atomic_init(&client->refs, 1);  // Held by the connection until it closes
             snprintf(client->info.client_id, sizeof(client->info.client_id),
                     "client-%p", (void*)wsi);
             client->info.connect_time = time(NULL);
+            token_bucket_init(&client->bucket, &server->config->client_limit, clock_now_ns());
+            session->client = client;
+
+            pthread_mutex_lock(&service->lock);
+            client->next = service->clients;
+            if (service->clients) {
+                service->clients->prev = client;
+            }
+            service->clients = client;
+            pthread_mutex_unlock(&service->lock);
+            atomic_fetch_add(&server->client_count, 1);
             
             if (server->connect_cb) {
                 server->connect_cb(client, server->user_data);
@@ -161,19 +749,100 @@ static int callback_trading(struct lws* wsi, enum lws_callback_reasons reason,
         }
 
         case LWS_CALLBACK_CLOSED: {
+            if (!client) {
+                break;
+            }
+            atomic_fetch_sub(&server->client_count, 1);
             if (server->disconnect_cb) {
                 server->disconnect_cb(client, server->user_data);
             }
             LOG_INFO("Client disconnected: %s", client->info.client_id);
+
+            // Threads still holding the client see it closed and stop queueing
+            ServiceThread* service = client->service;
+            pthread_mutex_lock(&service->lock);
+            client->wsi = NULL;
+            if (client->prev) {
+                client->prev->next = client->next;
+            } else {
+                service->clients = client->next;
+            }
+            if (client->next) {
+                client->next->prev = client->prev;
+            }
+            while (client->outbox_head != client->outbox_tail) {
+                release_message(client->outbox[client->outbox_head++ % CLIENT_OUTBOX_SIZE]);
+                atomic_fetch_sub_explicit(&server->queued_messages, 1, memory_order_relaxed);
+            }
+            pthread_mutex_unlock(&service->lock);
+
+            if (client->has_peer) {
+                remove_peer_connection(server, client->peer);
+            }
+
+            session->client = NULL;
+            ws_server_client_release(client);
             break;
         }
 
+        case LWS_CALLBACK_SERVER_WRITEABLE:
+            if (client && current_service) {
+                return write_next_message(current_service, client, wsi);
+            }
+            break;
+
         case LWS_CALLBACK_RECEIVE: {
+            if (!client) {
+                break;
+            }
+            server_metrics_add(server->config->metrics, METRIC_BYTES_IN, len);
+
+            // A message that arrives whole is handed on straight from lws's
+            // buffer. Fragments, and frames larger than rx_buffer_size, are
+            // gathered in the slot's preallocated buffer first.
+            const char* message = (const char*)in;
+            size_t message_len = len;
+            bool complete = lws_is_final_fragment(wsi) && lws_remaining_packet_payload(wsi) == 0;
+            if (!complete || client->rx_len > 0 || client->rx_overflow) {
+                if (client->rx_len + len > server->max_message_size) {
+                    client->rx_overflow = true;
+                } else if (!client->rx_overflow) {
+                    memcpy(client->rx_buf + client->rx_len, in, len);
+                    client->rx_len += len;
+                }
+                if (!complete) {
+                    break;
+                }
+                message = client->rx_buf;
+                message_len = client->rx_overflow ? server->max_message_size + 1 : client->rx_len;
+                client->rx_len = 0;
+                client->rx_overflow = false;
+            }
+            if (message_len > server->max_message_size) {
+                LOG_WARN("Closing %s: message larger than %zu bytes",
+                         client->info.client_id, server->max_message_size);
+                lws_close_reason(wsi, LWS_CLOSE_STATUS_MESSAGE_TOO_LARGE, NULL, 0);
+                return -1;
+            }
             LOG_INFO("Received message from client %s: %.*s", 
-                    client->info.client_id, (int)len, (char*)in);
+                    client->info.client_id, (int)message_len, message);
+
+            // Throttled here, before the message costs a copy or a queue slot
+            if (!token_bucket_take(&client->bucket, &server->config->client_limit,
+                                             clock_now_ns())) {
+                server_metrics_add(server->config->metrics, METRIC_THROTTLED_CONNECTION, 1);
+                if (server->throttle_cb) {
+                    server->throttle_cb(client, server->throttle_user_data);
+                }
+                break;
+            }
 
             if (server->message_cb) {
-                server->message_cb(client, (const char*)in, len, server->user_data);
+                if (server->config->max_in_flight > 0) {
+                    atomic_fetch_add(&client->in_flight, 1);
+                }
+                server->message_cb(client, message, message_len, server->user_data);
+                pause_reads(client);
             }
             break;
         }
@@ -185,40 +854,115 @@ static int callback_trading(struct lws* wsi, enum lws_callback_reasons reason,
     return 0;
 }
 
+static int callback_metrics(struct lws* wsi, enum lws_callback_reasons reason,
+                            void* user, void* in, size_t len) {
+    MetricsRequest* request = (MetricsRequest*)user;
+    WSServer* server = (WSServer*)lws_context_user(lws_get_context(wsi));
+
+    switch (reason) {
+        case LWS_CALLBACK_HTTP: {
+            if (strcmp((const char*)in, "/metrics") != 0 || !server->metrics_page_cb) {
+                lws_return_http_status(wsi, HTTP_STATUS_NOT_FOUND, NULL);
+                return -1;
+            }
+
+            request->body = server->metrics_page_cb(server->metrics_user_data);
+            if (!request->body) {
+                lws_return_http_status(wsi, HTTP_STATUS_INTERNAL_SERVER_ERROR, NULL);
+                return -1;
+            }
+            request->len = strlen(request->body);
+
+            unsigned char headers[LWS_PRE + 256];
+            unsigned char* start = headers + LWS_PRE;
+            unsigned char* p = start;
+            unsigned char* end = headers + sizeof(headers) - 1;
+            if (lws_add_http_common_headers(wsi, HTTP_STATUS_OK, "text/plain; version=0.0.4",
+                                            request->len, &p, end) ||
+                lws_finalize_write_http_header(wsi, start, &p, end)) {
+                return 1;
+            }
+            lws_callback_on_writable(wsi);
+            return 0;
+        }
+
+        case LWS_CALLBACK_HTTP_WRITEABLE: {
+            if (!request->body) {
+                break;
+            }
+            unsigned char* buf = malloc(LWS_PRE + request->len);
+            if (!buf) {
+                return -1;
+            }
+            memcpy(buf + LWS_PRE, request->body, request->len);
+            int written = lws_write(wsi, buf + LWS_PRE, request->len, LWS_WRITE_HTTP_FINAL);
+            free(buf);
+            free(request->body);
+            request->body = NULL;
+            if (written < 0) {
+                return -1;
+            }
+            return lws_http_transaction_completed(wsi) ? -1 : 0;
+        }
+
+        case LWS_CALLBACK_CLOSED_HTTP:
+            free(request->body);
+            request->body = NULL;
+            break;
+
+        default:
+            break;
+    }
+
+    return lws_callback_http_dummy(wsi, reason, user, in, len);
+}
+
 int ws_server_broadcast(WSServer* server, const char* message, size_t len) {
     if (!server || !message) return -1;
 
-    pthread_mutex_lock(&server->lock);
-    
-    // Store message for sending
-    unsigned char* buf = malloc(LWS_PRE + len);
-    if (!buf) {
-        pthread_mutex_unlock(&server->lock);
+    OutboundMessage* shared = create_message(message, len);
+    if (!shared) {
         return -1;
     }
-    memcpy(buf + LWS_PRE, message, len);
-    server->broadcast_buf = buf;
-    server->broadcast_len = len;
-    
-    lws_callback_all_protocol(server->context, &protocols[0], LWS_CALLBACK_SERVER_WRITEABLE);
-    
-    // Cleanup
-    free(buf);
-    server->broadcast_buf = NULL;
-    server->broadcast_len = 0;
-    
-    pthread_mutex_unlock(&server->lock);
+
+    // Every client queues the same copy; each service thread writes its own
+    bool wake = false;
+    for (int i = 0; i < server->service_count; i++) {
+        ServiceThread* service = &server->services[i];
+        pthread_mutex_lock(&service->lock);
+        for (WSClient* client = service->clients; client; client = client->next) {
+            if (!queue_message(client, shared, &wake)) {
+                LOG_DEBUG("Dropped broadcast to %s, outbox full", client->info.client_id);
+            }
+        }
+        pthread_mutex_unlock(&service->lock);
+    }
+    release_message(shared);
+
+    if (wake) {
+        lws_cancel_service(server->context);
+    }
     return 0;
 }
 
 int ws_server_send(WSClient* client, const char* message, size_t len) {
     if (!client || !message) return -1;
-    unsigned char* buf = malloc(LWS_PRE + len);
-    if (!buf) return -1;
-    memcpy(buf + LWS_PRE, message, len);
-    int written = lws_write(client->wsi, buf + LWS_PRE, len, LWS_WRITE_TEXT);
-    free(buf);
-    return (written >=0 && (size_t)written == len) ? 0 : - 1;
+
+    OutboundMessage* queued = create_message(message, len);
+    if (!queued) return -1;
+
+    ServiceThread* service = client->service;
+    bool wake = false;
+    pthread_mutex_lock(&service->lock);
+    bool sent = queue_message(client, queued, &wake);
+    if (wake) {
+        // Wakes only the thread that owns this connection
+        lws_cancel_service_pt(client->wsi);
+    }
+    pthread_mutex_unlock(&service->lock);
+    release_message(queued);
+
+    return sent ? 0 : -1;
 }
 
 void ws_server_set_connect_callback(WSServer* server,
@@ -245,6 +989,27 @@ void ws_server_set_message_callback(WSServer* server,
     server->user_data = user_data;
 }
 
+void ws_server_set_metrics_callback(WSServer* server,
+                                    MetricsPageCallback callback,
+                                    void* user_data) {
+    if (!server) return;
+    server->metrics_page_cb = callback;
+    server->metrics_user_data = user_data;
+}
+
+void ws_server_set_throttle_callback(WSServer* server,
+                                     ThrottleCallback callback,
+                                     void* user_data) {
+    if (!server) return;
+    server->throttle_cb = callback;
+    server->throttle_user_data = user_data;
+}
+
 const WSClientInfo* ws_server_get_client_info(const WSClient* client) {
     return client ? &client->info : NULL;
 }
+
+int ws_server_get_client_count(const WSServer* server) {
+    if (!server) return 0;
+    return atomic_load(&((WSServer*)server)->client_count);
+}
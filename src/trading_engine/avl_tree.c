@@ -4,10 +4,12 @@
 #include <stdlib.h>
 #include <string.h>
 
+_Static_assert(offsetof(AVLNode, left) == 32, "AVLNode hot fields must fill its first 32 bytes");
+
 // Forward declarations of static functions
 static AVLNode* find_min_node(AVLNode* node);
 static AVLNode* find_max_node(AVLNode* node);
-static AVLNode* create_node(double price, int64_t timestamp, struct Order* order);
+static AVLNode* create_node(double price, uint64_t sequence, struct Order* order);
 static AVLNode* right_rotate(AVLNode* y);
 static AVLNode* left_rotate(AVLNode* x);
 static void destroy_node(AVLNode* node);
@@ -50,7 +52,7 @@ static AVLNode* find_max_node(AVLNode* node) {
     return node;
 }
 
-static AVLNode* create_node(double price, int64_t timestamp, struct Order* order) {
+static AVLNode* create_node(double price, uint64_t sequence, struct Order* order) {
     AVLNode* node = (AVLNode*)malloc(sizeof(AVLNode));
     if (!node) {
         LOG_ERROR("Failed to allocate memory for AVL node");
@@ -58,13 +60,21 @@ static AVLNode* create_node(double price, int64_t timestamp, struct Order* order
     }
     
     node->price = price;
-    node->timestamp = timestamp;
+    node->sequence = sequence;
+    node->remaining_quantity = order ? order->remaining_quantity : 0;
+    node->flags = 0;
+    if (order && order->is_canceled) {
+        node->flags |= AVL_NODE_CANCELED;
+    }
+    if (order && order->display_quantity > 0) {
+        node->flags |= AVL_NODE_ICEBERG;
+    }
     node->order = order;
     node->left = NULL;
     node->right = NULL;
     node->height = 1;
     
-    LOG_DEBUG("Created new AVL node: price=%.2f, timestamp=%ld", price, timestamp);
+    LOG_DEBUG("Created new AVL node: price=%.2f, sequence=%lu", price, sequence);
     return node;
 }
 
@@ -98,8 +108,10 @@ static AVLNode* left_rotate(AVLNode* x) {
     return y;
 }
 
-int compare_nodes(double price1, int64_t timestamp1, 
-                        double price2, int64_t timestamp2, 
+// The best order is the maximum of a buy tree and the minimum of a sell
+// tree, so at equal prices the earlier sequence must win on both sides.
+int compare_nodes(double price1, uint64_t sequence1, 
+                        double price2, uint64_t sequence2, 
                         bool is_buy_tree) {
     if (price1 != price2) {
         if (is_buy_tree) {
@@ -108,23 +120,29 @@ int compare_nodes(double price1, int64_t timestamp1,
             return price1 < price2 ? -1 : 1;  // Lower prices first for sell orders
         }
     }
-    return timestamp1 < timestamp2 ? -1 : (timestamp1 > timestamp2 ? 1 : 0);
+    if (sequence1 == sequence2) {
+        return 0;
+    }
+    if (is_buy_tree) {
+        return sequence1 < sequence2 ? 1 : -1;  // Earlier sequence is greater for buy orders
+    }
+    return sequence1 < sequence2 ? -1 : 1;      // Earlier sequence is smaller for sell orders
 }
 
-static AVLNode* insert_node(AVLNode* node, double price, int64_t timestamp, 
+static AVLNode* insert_node(AVLNode* node, double price, uint64_t sequence, 
                           struct Order* order, bool is_buy_tree) {
     if (!node) {
-        return create_node(price, timestamp, order);
+        return create_node(price, sequence, order);
     }
 
-    int cmp = compare_nodes(price, timestamp, node->price, node->timestamp, is_buy_tree);
+    int cmp = compare_nodes(price, sequence, node->price, node->sequence, is_buy_tree);
     if (cmp < 0) {
-        node->left = insert_node(node->left, price, timestamp, order, is_buy_tree);
+        node->left = insert_node(node->left, price, sequence, order, is_buy_tree);
     } else if (cmp > 0) {
-        node->right = insert_node(node->right, price, timestamp, order, is_buy_tree);
+        node->right = insert_node(node->right, price, sequence, order, is_buy_tree);
     } else {
-        LOG_WARN("Duplicate node attempted to be inserted: price=%.2f, timestamp=%ld", 
-                 price, timestamp);
+        LOG_WARN("Duplicate node attempted to be inserted: price=%.2f, sequence=%lu", 
+                 price, sequence);
         return node;
     }
 
@@ -132,27 +150,27 @@ static AVLNode* insert_node(AVLNode* node, double price, int64_t timestamp,
     int balance = get_balance(node);
 
     // Left Left Case
-    if (balance > 1 && compare_nodes(price, timestamp, 
+    if (balance > 1 && compare_nodes(price, sequence, 
                                    node->left->price, 
-                                   node->left->timestamp, 
+                                   node->left->sequence, 
                                    is_buy_tree) < 0) {
         LOG_DEBUG("Performing LL rotation for price=%.2f", price);
         return right_rotate(node);
     }
 
     // Right Right Case
-    if (balance < -1 && compare_nodes(price, timestamp, 
+    if (balance < -1 && compare_nodes(price, sequence, 
                                     node->right->price, 
-                                    node->right->timestamp, 
+                                    node->right->sequence, 
                                     is_buy_tree) > 0) {
         LOG_DEBUG("Performing RR rotation for price=%.2f", price);
         return left_rotate(node);
     }
 
     // Left Right Case
-    if (balance > 1 && compare_nodes(price, timestamp, 
+    if (balance > 1 && compare_nodes(price, sequence, 
                                    node->left->price, 
-                                   node->left->timestamp, 
+                                   node->left->sequence, 
                                    is_buy_tree) > 0) {
         LOG_DEBUG("Performing LR rotation for price=%.2f", price);
         node->left = left_rotate(node->left);
@@ -160,9 +178,9 @@ static AVLNode* insert_node(AVLNode* node, double price, int64_t timestamp,
     }
 
     // Right Left Case
-    if (balance < -1 && compare_nodes(price, timestamp, 
+    if (balance < -1 && compare_nodes(price, sequence, 
                                     node->right->price, 
-                                    node->right->timestamp, 
+                                    node->right->sequence, 
                                     is_buy_tree) < 0) {
         LOG_DEBUG("Performing RL rotation for price=%.2f", price);
         node->right = right_rotate(node->right);
@@ -172,20 +190,20 @@ static AVLNode* insert_node(AVLNode* node, double price, int64_t timestamp,
     return node;
 }
 
-static AVLNode* delete_node(AVLNode* root, double price, int64_t timestamp, bool is_buy_tree) {
+static AVLNode* delete_node(AVLNode* root, double price, uint64_t sequence, bool is_buy_tree) {
     if (!root) {
         return NULL;
     }
 
-    int cmp = compare_nodes(price, timestamp, root->price, root->timestamp, is_buy_tree);
+    int cmp = compare_nodes(price, sequence, root->price, root->sequence, is_buy_tree);
     
     if (cmp < 0) {
-        root->left = delete_node(root->left, price, timestamp, is_buy_tree);
+        root->left = delete_node(root->left, price, sequence, is_buy_tree);
     } else if (cmp > 0) {
-        root->right = delete_node(root->right, price, timestamp, is_buy_tree);
+        root->right = delete_node(root->right, price, sequence, is_buy_tree);
     } else {
         // Node to delete found
-        LOG_DEBUG("Found node to delete: price=%.2f, timestamp=%ld", price, timestamp);
+        LOG_DEBUG("Found node to delete: price=%.2f, sequence=%lu", price, sequence);
         
         // Case 1: No child or one child
         if (!root->left || !root->right) {
@@ -200,7 +218,7 @@ static AVLNode* delete_node(AVLNode* root, double price, int64_t timestamp, bool
                 *root = *temp; // Copy the contents
             }
             
-            LOG_DEBUG("Deleting node with price=%.2f, timestamp=%ld", temp->price, temp->timestamp);
+            LOG_DEBUG("Deleting node with price=%.2f, sequence=%lu", temp->price, temp->sequence);
             free(temp);
         } else {
             // Case 2: Two children
@@ -208,11 +226,13 @@ static AVLNode* delete_node(AVLNode* root, double price, int64_t timestamp, bool
             
             // Copy the successor's data
             root->price = temp->price;
-            root->timestamp = temp->timestamp;
+            root->sequence = temp->sequence;
+            root->remaining_quantity = temp->remaining_quantity;
+            root->flags = temp->flags;
             root->order = temp->order;
 
             // Delete the successor
-            root->right = delete_node(root->right, temp->price, temp->timestamp, is_buy_tree);
+            root->right = delete_node(root->right, temp->price, temp->sequence, is_buy_tree);
         }
     }
 
@@ -260,8 +280,8 @@ static void destroy_node(AVLNode* node) {
     if (node) {
         destroy_node(node->left);
         destroy_node(node->right);
-        LOG_DEBUG("Destroying AVL node: price=%.2f, timestamp=%ld", 
-                 node->price, node->timestamp);
+        LOG_DEBUG("Destroying AVL node: price=%.2f, sequence=%lu", 
+                 node->price, node->sequence);
         free(node);
     }
 }
@@ -293,27 +313,27 @@ void avl_destroy(AVLTree* tree) {
     }
 }
 
-void avl_insert(AVLTree* tree, double price, int64_t timestamp, struct Order* order) {
+void avl_insert(AVLTree* tree, double price, uint64_t sequence, struct Order* order) {
     if (!tree) {
         LOG_ERROR("Attempted to insert into NULL tree");
         return;
     }
     
-    LOG_INFO("Inserting order into %s tree: price=%.2f, timestamp=%ld",
-             tree->is_buy_tree ? "buy" : "sell", price, timestamp);
-    tree->root = insert_node(tree->root, price, timestamp, order, tree->is_buy_tree);
+    LOG_INFO("Inserting order into %s tree: price=%.2f, sequence=%lu",
+             tree->is_buy_tree ? "buy" : "sell", price, sequence);
+    tree->root = insert_node(tree->root, price, sequence, order, tree->is_buy_tree);
 }
 
-void avl_delete_order(AVLTree* tree, double price, int64_t timestamp) {
+void avl_delete_order(AVLTree* tree, double price, uint64_t sequence) {
     if (!tree) {
         LOG_ERROR("Attempted to delete from NULL tree");
         return;
     }
     
-    LOG_INFO("Deleting order from %s tree: price=%.2f, timestamp=%ld",
-             tree->is_buy_tree ? "buy" : "sell", price, timestamp);
+    LOG_INFO("Deleting order from %s tree: price=%.2f, sequence=%lu",
+             tree->is_buy_tree ? "buy" : "sell", price, sequence);
              
-    tree->root = delete_node(tree->root, price, timestamp, tree->is_buy_tree);
+    tree->root = delete_node(tree->root, price, sequence, tree->is_buy_tree);
 }
 
 struct Order* avl_find_min(const AVLTree* tree) {
@@ -324,8 +344,8 @@ struct Order* avl_find_min(const AVLTree* tree) {
     
     AVLNode* min_node = find_min_node(tree->root);
     if (min_node) {
-        LOG_DEBUG("Found min node: price=%.2f, timestamp=%ld",
-                 min_node->price, min_node->timestamp);
+        LOG_DEBUG("Found min node: price=%.2f, sequence=%lu",
+                 min_node->price, min_node->sequence);
         return min_node->order;
     }
     return NULL;
@@ -339,13 +359,45 @@ struct Order* avl_find_max(const AVLTree* tree) {
     
     AVLNode* max_node = find_max_node(tree->root);
     if (max_node) {
-        LOG_DEBUG("Found max node: price=%.2f, timestamp=%ld",
-                 max_node->price, max_node->timestamp);
+        LOG_DEBUG("Found max node: price=%.2f, sequence=%lu",
+                 max_node->price, max_node->sequence);
         return max_node->order;
     }
     return NULL;
 }
 
+AVLNode* avl_best_node(const AVLTree* tree) {
+    if (!tree || !tree->root) {
+        return NULL;
+    }
+    AVLNode* node = tree->root;
+    if (tree->is_buy_tree) {
+        while (node->right) {
+            node = node->right;
+        }
+    } else {
+        while (node->left) {
+            node = node->left;
+        }
+    }
+    return node;
+}
+
+AVLNode* avl_find_node(const AVLTree* tree, double price, uint64_t sequence) {
+    if (!tree) {
+        return NULL;
+    }
+    AVLNode* node = tree->root;
+    while (node) {
+        int cmp = compare_nodes(price, sequence, node->price, node->sequence, tree->is_buy_tree);
+        if (cmp == 0) {
+            return node;
+        }
+        node = cmp < 0 ? node->left : node->right;
+    }
+    return NULL;
+}
+
 static void inorder_traverse_helper(AVLNode* node, TraversalCallback callback, void* user_data) {
     if (node) {
         inorder_traverse_helper(node->left, callback, user_data);
@@ -365,3 +417,160 @@ void avl_inorder_traverse(const AVLTree* tree, TraversalCallback callback, void*
     inorder_traverse_helper(tree->root, callback, user_data);
     LOG_DEBUG("Completed inorder traversal");
 }
+
+static bool visit_best_first(const AVLNode* node, bool from_max, AVLVisitor visit, void* user_data) {
+    if (!node) {
+        return true;
+    }
+    const AVLNode* first = from_max ? node->right : node->left;
+    const AVLNode* second = from_max ? node->left : node->right;
+    return visit_best_first(first, from_max, visit, user_data) &&
+           visit(node, user_data) &&
+           visit_best_first(second, from_max, visit, user_data);
+}
+
+void avl_visit_best_first(const AVLTree* tree, AVLVisitor visit, void* user_data) {
+    if (!tree || !visit) {
+        LOG_ERROR("Invalid parameters for best-first traversal");
+        return;
+    }
+    // The best buy is the tree's maximum, the best sell its minimum
+    visit_best_first(tree->root, tree->is_buy_tree, visit, user_data);
+}
+
+static size_t count_nodes(const AVLNode* node) {
+    return node ? 1 + count_nodes(node->left) + count_nodes(node->right) : 0;
+}
+
+static void flatten_nodes(AVLNode* node, AVLNode** out, size_t* count) {
+    if (node) {
+        flatten_nodes(node->left, out, count);
+        out[(*count)++] = node;
+        flatten_nodes(node->right, out, count);
+    }
+}
+
+// Links nodes[lo, hi) into a perfectly balanced subtree
+static AVLNode* build_balanced(AVLNode** nodes, size_t lo, size_t hi) {
+    if (lo >= hi) {
+        return NULL;
+    }
+    size_t mid = lo + (hi - lo) / 2;
+    AVLNode* node = nodes[mid];
+    node->left = build_balanced(nodes, lo, mid);
+    node->right = build_balanced(nodes, mid + 1, hi);
+    node->height = max(get_height(node->left), get_height(node->right)) + 1;
+    return node;
+}
+
+int avl_insert_sorted(AVLTree* tree, struct Order** orders, size_t n) {
+    if (!tree || (!orders && n > 0)) {
+        LOG_ERROR("Invalid parameters for sorted AVL insert");
+        return -1;
+    }
+    if (n == 0) {
+        return 0;
+    }
+
+    size_t existing = count_nodes(tree->root);
+    AVLNode** old_nodes = malloc((existing + 1) * sizeof(AVLNode*));
+    AVLNode** new_nodes = malloc(n * sizeof(AVLNode*));
+    AVLNode** merged = malloc((existing + n) * sizeof(AVLNode*));
+    size_t* source = malloc(n * sizeof(size_t));      // Input index of each new node
+    Order** rejected = malloc(n * sizeof(Order*));
+    if (!old_nodes || !new_nodes || !merged || !source || !rejected) {
+        LOG_ERROR("Failed to allocate memory for sorted AVL insert");
+        free(old_nodes);
+        free(new_nodes);
+        free(merged);
+        free(source);
+        free(rejected);
+        return -1;
+    }
+
+    // Buy trees keep equal prices in descending sequence, so walk each
+    // equal-price run of the input backwards
+    size_t i = 0;
+    while (i < n) {
+        size_t run_end = i + 1;
+        if (tree->is_buy_tree) {
+            while (run_end < n && orders[run_end]->price == orders[i]->price) {
+                run_end++;
+            }
+        }
+        for (size_t j = i; j < run_end; j++) {
+            source[j] = tree->is_buy_tree ? run_end - 1 - (j - i) : j;
+            Order* order = orders[source[j]];
+            new_nodes[j] = create_node(order->price, order->sequence, order);
+            if (!new_nodes[j]) {
+                for (size_t k = 0; k < j; k++) {
+                    free(new_nodes[k]);
+                }
+                free(old_nodes);
+                free(new_nodes);
+                free(merged);
+                free(source);
+                free(rejected);
+                return -1;
+            }
+        }
+        i = run_end;
+    }
+
+    size_t old_count = 0;
+    flatten_nodes(tree->root, old_nodes, &old_count);
+
+    // Single merge pass over the two in-order sequences. A new node equal
+    // to an existing one, or to one earlier in the batch, is rejected; any
+    // such match is either the next old node or the last node merged.
+    size_t a = 0, b = 0, total = 0, dropped = 0;
+    while (a < old_count || b < n) {
+        if (b == n) {
+            merged[total++] = old_nodes[a++];
+            continue;
+        }
+
+        AVLNode* node = new_nodes[b];
+        int cmp = a < old_count ? compare_nodes(node->price, node->sequence,
+                                                old_nodes[a]->price, old_nodes[a]->sequence,
+                                                tree->is_buy_tree)
+                                : -1;
+        if (cmp > 0) {
+            merged[total++] = old_nodes[a++];
+            continue;
+        }
+
+        const AVLNode* last = total > 0 ? merged[total - 1] : NULL;
+        if (cmp == 0 || (last && last->price == node->price && last->sequence == node->sequence)) {
+            LOG_WARN("Duplicate node attempted to be inserted: price=%.2f, sequence=%lu",
+                     node->price, node->sequence);
+            rejected[dropped++] = node->order;
+            orders[source[b]] = NULL;
+            free(node);
+        } else {
+            merged[total++] = node;
+        }
+        b++;
+    }
+
+    tree->root = build_balanced(merged, 0, total);
+
+    // Inserted orders keep their input order ahead of the rejected ones
+    size_t inserted = 0;
+    for (size_t j = 0; j < n; j++) {
+        if (orders[j]) {
+            orders[inserted++] = orders[j];
+        }
+    }
+    memcpy(orders + inserted, rejected, dropped * sizeof(Order*));
+
+    LOG_INFO("Bulk inserted %zu of %zu orders into %s tree (%zu total)",
+             inserted, n, tree->is_buy_tree ? "buy" : "sell", total);
+
+    free(old_nodes);
+    free(new_nodes);
+    free(merged);
+    free(source);
+    free(rejected);
+    return (int)inserted;
+}
@@ -0,0 +1,360 @@
+#include "trading_engine/book_snapshot.h"
+#include "utils/checksum.h"
+#include "utils/logging.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#define INITIAL_RECORD_CAPACITY 1024
+
+_Static_assert(sizeof(SnapshotHeader) == 64, "SnapshotHeader layout changed");
+_Static_assert(sizeof(SnapshotSection) == 32, "SnapshotSection layout changed");
+_Static_assert(sizeof(SnapshotRecord) == 168, "SnapshotRecord layout changed");
+
+typedef struct {
+    SnapshotSection section;
+    SnapshotRecord* records;
+} ImageSection;
+
+struct SnapshotImage {
+    SnapshotHeader header;
+    ImageSection* sections;
+};
+
+typedef struct {
+    SnapshotRecord* records;
+    size_t count;
+    size_t capacity;
+    bool failed;
+} RecordBuffer;
+
+static void collect_record(Order* order, void* user_data) {
+    RecordBuffer* buffer = (RecordBuffer*)user_data;
+    if (buffer->failed || order->is_canceled || order->remaining_quantity <= 0) {
+        return;
+    }
+
+    if (buffer->count == buffer->capacity) {
+        size_t capacity = buffer->capacity ? buffer->capacity * 2 : INITIAL_RECORD_CAPACITY;
+        SnapshotRecord* grown = realloc(buffer->records, capacity * sizeof(SnapshotRecord));
+        if (!grown) {
+            LOG_ERROR("Failed to grow snapshot record buffer");
+            buffer->failed = true;
+            return;
+        }
+        buffer->records = grown;
+        buffer->capacity = capacity;
+    }
+
+    SnapshotRecord* record = &buffer->records[buffer->count++];
+    memset(record, 0, sizeof(*record));
+    strncpy(record->order_id, order_get_id(order), MAX_ID_LENGTH - 1);
+    strncpy(record->trader_id, order_get_trader_id(order), MAX_ID_LENGTH - 1);
+    record->price = order->price;
+    record->sequence = order->sequence;
+    record->quantity = order->quantity;
+    record->remaining_quantity = order->remaining_quantity;
+    record->flags = order->is_buy_order ? SNAPSHOT_RECORD_BUY : 0;
+    record->display_quantity = order->display_quantity;
+    record->hidden_quantity = order->hidden_quantity;
+}
+
+SnapshotImage* order_book_capture_snapshot(const SnapshotBook* books, size_t count,
+                                           uint64_t journal_lsn) {
+    if (!books && count > 0) {
+        LOG_ERROR("Invalid parameters for capturing snapshot");
+        return NULL;
+    }
+
+    SnapshotImage* image = calloc(1, sizeof(SnapshotImage));
+    if (!image) {
+        LOG_ERROR("Failed to allocate snapshot image");
+        return NULL;
+    }
+
+    memcpy(image->header.magic, SNAPSHOT_MAGIC, sizeof(image->header.magic));
+    image->header.version = SNAPSHOT_VERSION;
+    image->header.next_sequence = order_reserve_sequences(0);  // Reserving zero just reads the counter
+    image->header.created_at = (int64_t)time(NULL);
+    image->header.journal_lsn = journal_lsn;
+
+    image->sections = calloc(count ? count : 1, sizeof(ImageSection));
+    if (!image->sections) {
+        LOG_ERROR("Failed to allocate snapshot sections");
+        free(image);
+        return NULL;
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        if (!books[i].symbol || !books[i].book ||
+            strlen(books[i].symbol) >= MAX_SYMBOL_LENGTH) {
+            LOG_ERROR("Invalid book at snapshot index %zu", i);
+            snapshot_image_destroy(image);
+            return NULL;
+        }
+
+        RecordBuffer buffer = {0};
+        order_book_traverse_buy_orders(books[i].book, collect_record, &buffer);
+        order_book_traverse_sell_orders(books[i].book, collect_record, &buffer);
+
+        // Count the section before checking for failure so destroy frees it
+        ImageSection* section = &image->sections[image->header.section_count++];
+        section->records = buffer.records;
+        if (buffer.failed) {
+            snapshot_image_destroy(image);
+            return NULL;
+        }
+
+        strncpy(section->section.symbol, books[i].symbol, MAX_SYMBOL_LENGTH - 1);
+        section->section.order_count = buffer.count;
+    }
+
+    return image;
+}
+
+void snapshot_image_destroy(SnapshotImage* image) {
+    if (!image) {
+        return;
+    }
+    for (uint32_t i = 0; i < image->header.section_count; i++) {
+        free(image->sections[i].records);
+    }
+    free(image->sections);
+    free(image);
+}
+
+int snapshot_image_write(const SnapshotImage* image, const char* path) {
+    if (!image || !path) {
+        LOG_ERROR("Invalid parameters for saving snapshot");
+        return -1;
+    }
+
+    char tmp_path[4096];
+    if (snprintf(tmp_path, sizeof(tmp_path), "%s.tmp", path) >= (int)sizeof(tmp_path)) {
+        LOG_ERROR("Snapshot path too long: %s", path);
+        return -1;
+    }
+
+    FILE* file = fopen(tmp_path, "wb");
+    if (!file) {
+        LOG_ERROR("Failed to create snapshot %s: %s", tmp_path, strerror(errno));
+        return -1;
+    }
+
+    int result = fwrite(&image->header, sizeof(image->header), 1, file) == 1 ? 0 : -1;
+    for (uint32_t i = 0; i < image->header.section_count && result == 0; i++) {
+        const ImageSection* entry = &image->sections[i];
+        size_t count = entry->section.order_count;
+
+        // Checksums are computed here so the capture itself stays as short as possible
+        SnapshotSection section = entry->section;
+        section.crc32 = crc32_update(0, entry->records, count * sizeof(SnapshotRecord));
+
+        if (fwrite(&section, sizeof(section), 1, file) != 1 ||
+            (count > 0 && fwrite(entry->records, sizeof(SnapshotRecord), count, file) != count)) {
+            result = -1;
+            break;
+        }
+        LOG_INFO("Snapshot section %s: %zu orders", section.symbol, count);
+    }
+
+    if (result == 0 && (fflush(file) != 0 || fsync(fileno(file)) != 0)) {
+        result = -1;
+    }
+    if (fclose(file) != 0) {
+        result = -1;
+    }
+
+    if (result != 0 || rename(tmp_path, path) != 0) {
+        LOG_ERROR("Failed to write snapshot %s: %s", path, strerror(errno));
+        unlink(tmp_path);
+        return -1;
+    }
+
+    LOG_INFO("Saved snapshot of %u books to %s at journal LSN %lu",
+             image->header.section_count, path, image->header.journal_lsn);
+    return 0;
+}
+
+int order_book_save_snapshot(const char* path, const SnapshotBook* books, size_t count,
+                             uint64_t journal_lsn) {
+    if (!path) {
+        LOG_ERROR("Invalid parameters for saving snapshot");
+        return -1;
+    }
+
+    SnapshotImage* image = order_book_capture_snapshot(books, count, journal_lsn);
+    if (!image) {
+        return -1;
+    }
+    int result = snapshot_image_write(image, path);
+    snapshot_image_destroy(image);
+    return result;
+}
+
+static bool record_is_valid(const SnapshotRecord* record) {
+    return memchr(record->order_id, '\0', MAX_ID_LENGTH) && record->order_id[0] &&
+           memchr(record->trader_id, '\0', MAX_ID_LENGTH) && record->trader_id[0] &&
+           record->price > 0.0 && record->remaining_quantity > 0 &&
+           record->display_quantity >= 0 && record->hidden_quantity >= 0 &&
+           (record->hidden_quantity == 0 || record->display_quantity > 0) &&
+           record->remaining_quantity <= record->quantity - record->hidden_quantity;
+}
+
+// Checks every section against the file bounds and its checksum before any book is touched
+static int validate_sections(const char* data, size_t size, uint32_t section_count) {
+    size_t offset = sizeof(SnapshotHeader);
+    for (uint32_t i = 0; i < section_count; i++) {
+        if (size - offset < sizeof(SnapshotSection)) {
+            LOG_ERROR("Snapshot truncated in section %u header", i);
+            return -1;
+        }
+        const SnapshotSection* section = (const SnapshotSection*)(data + offset);
+        offset += sizeof(SnapshotSection);
+
+        if (!memchr(section->symbol, '\0', MAX_SYMBOL_LENGTH) ||
+            section->order_count > (size - offset) / sizeof(SnapshotRecord)) {
+            LOG_ERROR("Snapshot section %u is corrupt or truncated", i);
+            return -1;
+        }
+
+        const SnapshotRecord* records = (const SnapshotRecord*)(data + offset);
+        size_t bytes = section->order_count * sizeof(SnapshotRecord);
+        if (crc32_update(0, records, bytes) != section->crc32) {
+            LOG_ERROR("Snapshot section %s failed its checksum", section->symbol);
+            return -1;
+        }
+        for (uint64_t r = 0; r < section->order_count; r++) {
+            if (!record_is_valid(&records[r])) {
+                LOG_ERROR("Snapshot section %s has an invalid record at %lu", section->symbol, r);
+                return -1;
+            }
+        }
+        offset += bytes;
+    }
+    return 0;
+}
+
+static int restore_section(const SnapshotSection* section, const SnapshotRecord* records,
+                           OrderBook* book, uint64_t* max_sequence) {
+    size_t count = section->order_count;
+    Order** orders = malloc((count ? count : 1) * sizeof(Order*));
+    if (!orders) {
+        LOG_ERROR("Failed to allocate orders for snapshot section %s", section->symbol);
+        return -1;
+    }
+
+    size_t created = 0;
+    for (size_t i = 0; i < count; i++) {
+        const SnapshotRecord* record = &records[i];
+        Order* order = order_create(record->order_id, record->trader_id, section->symbol,
+                                    record->price, record->quantity,
+                                    (record->flags & SNAPSHOT_RECORD_BUY) != 0);
+        if (!order) {
+            continue;
+        }
+        order->remaining_quantity = record->remaining_quantity;
+        order->display_quantity = record->display_quantity;
+        order->hidden_quantity = record->hidden_quantity;
+        order->sequence = record->sequence;
+        if (record->sequence > *max_sequence) {
+            *max_sequence = record->sequence;
+        }
+        orders[created++] = order;
+    }
+
+    // The book frees what it takes; nobody else holds the orders
+    int added = order_book_add_orders_bulk(book, orders, created);
+    for (int i = 0; i < added; i++) {
+        order_book_adopt_order(book, orders[i]);
+    }
+    for (size_t i = added > 0 ? (size_t)added : 0; i < created; i++) {
+        LOG_ERROR("Failed to restore order %s into %s", order_get_id(orders[i]), section->symbol);
+        order_destroy(orders[i]);
+    }
+    free(orders);
+    return added;
+}
+
+int order_book_load_snapshot(const char* path, SnapshotBookResolver resolver, void* user_data,
+                             uint64_t* journal_lsn) {
+    if (!path || !resolver) {
+        LOG_ERROR("Invalid parameters for loading snapshot");
+        return -1;
+    }
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        LOG_ERROR("Failed to open snapshot %s: %s", path, strerror(errno));
+        return -1;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(SnapshotHeader)) {
+        LOG_ERROR("Snapshot %s is missing or too small", path);
+        close(fd);
+        return -1;
+    }
+
+    size_t size = (size_t)st.st_size;
+    const char* data = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) {
+        LOG_ERROR("Failed to map snapshot %s: %s", path, strerror(errno));
+        return -1;
+    }
+    madvise((void*)data, size, MADV_SEQUENTIAL);
+
+    const SnapshotHeader* header = (const SnapshotHeader*)data;
+    if (memcmp(header->magic, SNAPSHOT_MAGIC, sizeof(header->magic)) != 0 ||
+        header->version != SNAPSHOT_VERSION) {
+        LOG_ERROR("Snapshot %s has an unknown format (version %u)", path, header->version);
+        munmap((void*)data, size);
+        return -1;
+    }
+
+    if (validate_sections(data, size, header->section_count) != 0) {
+        munmap((void*)data, size);
+        return -1;
+    }
+
+    int restored = 0;
+    uint64_t max_sequence = 0;
+    size_t offset = sizeof(SnapshotHeader);
+    for (uint32_t i = 0; i < header->section_count; i++) {
+        const SnapshotSection* section = (const SnapshotSection*)(data + offset);
+        const SnapshotRecord* records =
+            (const SnapshotRecord*)(data + offset + sizeof(SnapshotSection));
+        offset += sizeof(SnapshotSection) + section->order_count * sizeof(SnapshotRecord);
+
+        OrderBook* book = resolver(section->symbol, user_data);
+        if (!book) {
+            LOG_WARN("No book for snapshot section %s, skipping %lu orders",
+                     section->symbol, section->order_count);
+            continue;
+        }
+
+        int added = restore_section(section, records, book, &max_sequence);
+        if (added > 0) {
+            restored += added;
+        }
+    }
+
+    // New orders must queue behind everything that was restored
+    order_advance_sequence(header->next_sequence > max_sequence ? header->next_sequence
+                                                                : max_sequence + 1);
+
+    if (journal_lsn) {
+        *journal_lsn = header->journal_lsn;
+    }
+
+    munmap((void*)data, size);
+    LOG_INFO("Restored %d orders from snapshot %s", restored, path);
+    return restored;
+}
@@ -0,0 +1,305 @@
+#include "trading_engine/id_intern.h"
+#include "utils/logging.h"
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define CHUNK_BITS 12
+#define CHUNK_SIZE (1 << CHUNK_BITS)
+#define MAX_CHUNKS (1 << 16)
+#define INITIAL_TABLE_CAPACITY 1024
+
+typedef struct {
+    uint64_t hash;
+    IdHandle handle;
+} TableEntry;
+
+typedef struct {
+    char* str;                // NULL while the handle is on the free list
+    atomic_uint refs;
+    IdHandle next_free;
+} IdEntry;
+
+static pthread_rwlock_t table_lock = PTHREAD_RWLOCK_INITIALIZER;
+
+// Open-addressing hash table: string -> handle
+static TableEntry* table;
+static size_t table_capacity;
+
+// Chunked handle -> entry directory. Chunks never move once allocated,
+// which is what makes id_intern_str() safe without taking the lock.
+static IdEntry* chunks[MAX_CHUNKS];
+static size_t id_count;        // Live IDs
+static size_t used_entries;    // Entries handed out at least once
+static IdHandle free_handles;  // Released handles, linked through next_free
+
+static uint64_t hash_id(const char* id) {
+    // FNV-1a
+    uint64_t hash = 14695981039346656037ULL;
+    for (const unsigned char* p = (const unsigned char*)id; *p; p++) {
+        hash ^= *p;
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+static IdEntry* handle_entry(IdHandle handle) {
+    uint64_t index = handle - 1;
+    return &chunks[index >> CHUNK_BITS][index & (CHUNK_SIZE - 1)];
+}
+
+static const char* handle_str(IdHandle handle) {
+    return handle_entry(handle)->str;
+}
+
+// Returns the slot holding id, or the empty slot where it would go
+static size_t find_slot(uint64_t hash, const char* id) {
+    size_t mask = table_capacity - 1;
+    size_t slot = hash & mask;
+    while (table[slot].handle != ID_HANDLE_INVALID) {
+        if (table[slot].hash == hash && strcmp(handle_str(table[slot].handle), id) == 0) {
+            return slot;
+        }
+        slot = (slot + 1) & mask;
+    }
+    return slot;
+}
+
+static int grow_table(void) {
+    size_t new_capacity = table_capacity ? table_capacity * 2 : INITIAL_TABLE_CAPACITY;
+    TableEntry* new_table = calloc(new_capacity, sizeof(TableEntry));
+    if (!new_table) {
+        LOG_ERROR("Failed to grow ID intern table to %zu entries", new_capacity);
+        return -1;
+    }
+
+    size_t mask = new_capacity - 1;
+    for (size_t i = 0; i < table_capacity; i++) {
+        if (table[i].handle == ID_HANDLE_INVALID) {
+            continue;
+        }
+        size_t slot = table[i].hash & mask;
+        while (new_table[slot].handle != ID_HANDLE_INVALID) {
+            slot = (slot + 1) & mask;
+        }
+        new_table[slot] = table[i];
+    }
+
+    free(table);
+    table = new_table;
+    table_capacity = new_capacity;
+    return 0;
+}
+
+// Empties a table slot, moving later entries of its probe run back so that
+// lookups never need tombstones
+static void remove_slot(size_t slot) {
+    size_t mask = table_capacity - 1;
+    size_t hole = slot;
+    for (size_t next = (slot + 1) & mask; table[next].handle != ID_HANDLE_INVALID;
+         next = (next + 1) & mask) {
+        size_t home = table[next].hash & mask;
+        // An entry whose home lies cyclically in (hole, next] must stay put
+        bool stays = hole <= next ? (home > hole && home <= next)
+                                  : (home > hole || home <= next);
+        if (!stays) {
+            table[hole] = table[next];
+            hole = next;
+        }
+    }
+    table[hole].hash = 0;
+    table[hole].handle = ID_HANDLE_INVALID;
+}
+
+// Takes an unused handle, recycling a released one first. Lock held for writing.
+static IdHandle take_handle(void) {
+    if (free_handles != ID_HANDLE_INVALID) {
+        IdHandle handle = free_handles;
+        free_handles = handle_entry(handle)->next_free;
+        return handle;
+    }
+
+    size_t index = used_entries;
+    if ((index >> CHUNK_BITS) >= MAX_CHUNKS) {
+        LOG_ERROR("ID intern table is full: %zu IDs are live", id_count);
+        return ID_HANDLE_INVALID;
+    }
+
+    IdEntry** chunk = &chunks[index >> CHUNK_BITS];
+    if (!*chunk) {
+        *chunk = calloc(CHUNK_SIZE, sizeof(IdEntry));
+        if (!*chunk) {
+            LOG_ERROR("Failed to allocate ID intern chunk");
+            return ID_HANDLE_INVALID;
+        }
+    }
+    used_entries++;
+    return (IdHandle)(index + 1);
+}
+
+// Returns a handle to the free list. Lock held for writing.
+static void put_handle(IdHandle handle) {
+    handle_entry(handle)->next_free = free_handles;
+    free_handles = handle;
+}
+
+// Returns the handle for id with a new reference, adding it if needed.
+// Lock held for writing.
+static IdHandle intern_locked(uint64_t hash, const char* id) {
+    // Keep the load factor under one half
+    if ((id_count + 1) * 2 > table_capacity && grow_table() != 0) {
+        return ID_HANDLE_INVALID;
+    }
+
+    size_t slot = find_slot(hash, id);
+    IdHandle handle = table[slot].handle;
+    if (handle != ID_HANDLE_INVALID) {
+        atomic_fetch_add_explicit(&handle_entry(handle)->refs, 1, memory_order_relaxed);
+        return handle;
+    }
+
+    char* str = strdup(id);
+    handle = str ? take_handle() : ID_HANDLE_INVALID;
+    if (handle == ID_HANDLE_INVALID) {
+        if (!str) {
+            LOG_ERROR("Failed to copy ID %s", id);
+        }
+        free(str);
+        return ID_HANDLE_INVALID;
+    }
+
+    IdEntry* entry = handle_entry(handle);
+    entry->str = str;
+    atomic_store_explicit(&entry->refs, 1, memory_order_relaxed);
+    id_count++;
+
+    table[slot].hash = hash;
+    table[slot].handle = handle;
+    return handle;
+}
+
+IdHandle id_intern_find(const char* id) {
+    if (!id) {
+        return ID_HANDLE_INVALID;
+    }
+
+    uint64_t hash = hash_id(id);
+    pthread_rwlock_rdlock(&table_lock);
+    IdHandle handle = table_capacity ? table[find_slot(hash, id)].handle : ID_HANDLE_INVALID;
+    pthread_rwlock_unlock(&table_lock);
+    return handle;
+}
+
+IdHandle id_intern(const char* id) {
+    if (!id) {
+        LOG_ERROR("Attempted to intern NULL ID");
+        return ID_HANDLE_INVALID;
+    }
+
+    // The reference is taken under the lock, so a release that dropped the
+    // count to zero cannot remove the entry underneath us
+    uint64_t hash = hash_id(id);
+    pthread_rwlock_rdlock(&table_lock);
+    IdHandle handle = table_capacity ? table[find_slot(hash, id)].handle : ID_HANDLE_INVALID;
+    if (handle != ID_HANDLE_INVALID) {
+        atomic_fetch_add_explicit(&handle_entry(handle)->refs, 1, memory_order_relaxed);
+    }
+    pthread_rwlock_unlock(&table_lock);
+    if (handle != ID_HANDLE_INVALID) {
+        return handle;
+    }
+
+    // Another thread may have interned it between the two locks
+    pthread_rwlock_wrlock(&table_lock);
+    handle = intern_locked(hash, id);
+    pthread_rwlock_unlock(&table_lock);
+    return handle;
+}
+
+int id_intern_many(const char* const* ids, size_t n, IdHandle* handles) {
+    if (!ids || !handles) {
+        LOG_ERROR("Invalid parameters for batch ID intern");
+        return -1;
+    }
+
+    pthread_rwlock_wrlock(&table_lock);
+    size_t i = 0;
+    for (; i < n; i++) {
+        handles[i] = ids[i] ? intern_locked(hash_id(ids[i]), ids[i]) : ID_HANDLE_INVALID;
+        if (handles[i] == ID_HANDLE_INVALID) {
+            break;
+        }
+    }
+    pthread_rwlock_unlock(&table_lock);
+
+    if (i == n) {
+        return 0;
+    }
+    LOG_ERROR("Failed to intern ID %zu of a batch of %zu", i, n);
+    for (size_t j = 0; j < i; j++) {
+        id_intern_release(handles[j]);
+    }
+    return -1;
+}
+
+void id_intern_release(IdHandle handle) {
+    if (handle == ID_HANDLE_INVALID) {
+        return;
+    }
+
+    IdEntry* entry = handle_entry(handle);
+    if (atomic_fetch_sub_explicit(&entry->refs, 1, memory_order_acq_rel) != 1) {
+        return;
+    }
+
+    pthread_rwlock_wrlock(&table_lock);
+    // New references are only taken under the lock, so a count still at zero
+    // here stays there. Another releaser may already have removed the entry.
+    if (entry->str && atomic_load_explicit(&entry->refs, memory_order_relaxed) == 0) {
+        remove_slot(find_slot(hash_id(entry->str), entry->str));
+        free(entry->str);
+        entry->str = NULL;
+        put_handle(handle);
+        id_count--;
+    }
+    pthread_rwlock_unlock(&table_lock);
+}
+
+const char* id_intern_str(IdHandle handle) {
+    // The caller holds a reference, so the entry is published and stays put
+    if (handle == ID_HANDLE_INVALID) {
+        return NULL;
+    }
+    return handle_str(handle);
+}
+
+size_t id_intern_count(void) {
+    pthread_rwlock_rdlock(&table_lock);
+    size_t count = id_count;
+    pthread_rwlock_unlock(&table_lock);
+    return count;
+}
+
+void id_intern_reset(void) {
+    pthread_rwlock_wrlock(&table_lock);
+
+    free(table);
+    table = NULL;
+    table_capacity = 0;
+
+    for (size_t i = 0; i < MAX_CHUNKS && chunks[i]; i++) {
+        for (size_t j = 0; j < CHUNK_SIZE; j++) {
+            free(chunks[i][j].str);
+        }
+        free(chunks[i]);
+        chunks[i] = NULL;
+    }
+    id_count = 0;
+    used_entries = 0;
+    free_handles = ID_HANDLE_INVALID;
+
+    pthread_rwlock_unlock(&table_lock);
+    LOG_INFO("ID intern table reset");
+}
@@ -1,10 +1,34 @@
 #include "trading_engine/order.h"
+#include "utils/clock.h"
 #include "utils/logging.h"
+#include <stdatomic.h>
 #include <stdlib.h>
 #include <string.h>
 #include <time.h>
 #include <stdio.h>
 
+static atomic_uint_fast64_t next_sequence = 1;
+
+uint64_t order_next_sequence(void) {
+    return (uint64_t)atomic_fetch_add_explicit(&next_sequence, 1, memory_order_relaxed);
+}
+
+uint64_t order_reserve_sequences(size_t n) {
+    return (uint64_t)atomic_fetch_add_explicit(&next_sequence, n, memory_order_relaxed);
+}
+
+void order_advance_sequence(uint64_t next) {
+    uint_fast64_t current = atomic_load_explicit(&next_sequence, memory_order_relaxed);
+    while (current < next &&
+           !atomic_compare_exchange_weak_explicit(&next_sequence, &current, next,
+                                                  memory_order_relaxed, memory_order_relaxed)) {
+    }
+}
+
+void order_restart_sequence(uint64_t next) {
+    atomic_store_explicit(&next_sequence, next, memory_order_relaxed);
+}
+
 Order* order_create(const char* order_id,
                    const char* trader_id,
                    const char* symbol,
@@ -12,26 +36,47 @@ Order* order_create(const char* order_id,
                    int quantity,
                    bool is_buy_order) {
     
-    Order* order = (Order*)malloc(sizeof(Order));
-    if (!order) {
-        LOG_ERROR("Failed to allocate memory for order");
-        return NULL;
-    }
-
     if (strlen(order_id) >= MAX_ID_LENGTH || 
         strlen(trader_id) >= MAX_ID_LENGTH || 
         strlen(symbol) >= MAX_SYMBOL_LENGTH) {
         LOG_ERROR("Input string length exceeds maximum allowed length");
-        free(order);
         return NULL;
     }
 
-    strncpy(order->order_id, order_id, MAX_ID_LENGTH - 1);
-    order->order_id[MAX_ID_LENGTH - 1] = '\0';
-    
-    strncpy(order->trader_id, trader_id, MAX_ID_LENGTH - 1);
-    order->trader_id[MAX_ID_LENGTH - 1] = '\0';
-    
+    IdHandle order_handle = id_intern(order_id);
+    IdHandle trader_handle = id_intern(trader_id);
+    if (order_handle == ID_HANDLE_INVALID || trader_handle == ID_HANDLE_INVALID) {
+        LOG_ERROR("Failed to intern order or trader ID");
+        id_intern_release(order_handle);
+        id_intern_release(trader_handle);
+        return NULL;
+    }
+
+    Order* order = order_create_interned(order_handle, trader_handle, symbol,
+                                         price, quantity, is_buy_order);
+    if (order) {
+        LOG_INFO("Created new %s order: ID=%s, Symbol=%s, Price=%.2f, Quantity=%d",
+                 is_buy_order ? "buy" : "sell", order_id, symbol, price, quantity);
+    }
+    return order;
+}
+
+Order* order_create_interned(IdHandle order_handle,
+                             IdHandle trader_handle,
+                             const char* symbol,
+                             double price,
+                             int quantity,
+                             bool is_buy_order) {
+    Order* order = strlen(symbol) < MAX_SYMBOL_LENGTH ? (Order*)malloc(sizeof(Order)) : NULL;
+    if (!order) {
+        LOG_ERROR("Failed to create order for symbol %s", symbol);
+        id_intern_release(order_handle);
+        id_intern_release(trader_handle);
+        return NULL;
+    }
+
+    order->order_handle = order_handle;
+    order->trader_handle = trader_handle;
     strncpy(order->symbol, symbol, MAX_SYMBOL_LENGTH - 1);
     order->symbol[MAX_SYMBOL_LENGTH - 1] = '\0';
 
@@ -39,18 +84,22 @@ Order* order_create(const char* order_id,
     order->quantity = quantity;
     order->remaining_quantity = quantity;
     order->is_buy_order = is_buy_order;
-    order->timestamp = (int64_t)time(NULL);
+    order->sequence = order_next_sequence();
+    order->timestamp = clock_now_ns();
     order->is_canceled = false;
-
-    LOG_INFO("Created new %s order: ID=%s, Symbol=%s, Price=%.2f, Quantity=%d",
-             is_buy_order ? "buy" : "sell", order_id, symbol, price, quantity);
-
+    order->time_in_force = ORDER_TIF_GTC;
+    order->is_market = false;
+    order->owned_by_book = false;
+    order->display_quantity = 0;
+    order->hidden_quantity = 0;
     return order;
 }
 
 void order_destroy(Order* order) {
     if (order) {
-        LOG_DEBUG("Destroying order: ID=%s", order->order_id);
+        LOG_DEBUG("Destroying order: ID=%s", order_get_id(order));
+        id_intern_release(order->order_handle);
+        id_intern_release(order->trader_handle);
         memset(order, 0, sizeof(Order)); //clear potentially sensitive data.
         free(order);
     }
@@ -61,7 +110,7 @@ const char* order_get_id(const Order* order) {
         LOG_ERROR("Attempted to get ID from NULL order");
         return NULL;
     }
-    return order->order_id;
+    return id_intern_str(order->order_handle);
 }
 
 const char* order_get_trader_id(const Order* order) {
@@ -69,7 +118,7 @@ const char* order_get_trader_id(const Order* order) {
         LOG_ERROR("Attempted to get trader ID from NULL order");
         return NULL;
     }
-    return order->trader_id;
+    return id_intern_str(order->trader_handle);
 }
 
 const char* order_get_symbol(const Order* order) {
@@ -104,6 +153,14 @@ int order_get_remaining_quantity(const Order* order) {
     return order->remaining_quantity;
 }
 
+int order_get_open_quantity(const Order* order) {
+    if (!order) {
+        LOG_ERROR("Attempted to get open quantity from NULL order");
+        return 0;
+    }
+    return order->remaining_quantity + order->hidden_quantity;
+}
+
 bool order_is_buy_order(const Order* order) {
     if (!order) {
         LOG_ERROR("Attempted to check buy/sell status of NULL order");
@@ -120,6 +177,14 @@ int64_t order_get_timestamp(const Order* order) {
     return order->timestamp;
 }
 
+uint64_t order_get_sequence(const Order* order) {
+    if (!order) {
+        LOG_ERROR("Attempted to get sequence from NULL order");
+        return 0;
+    }
+    return order->sequence;
+}
+
 bool order_is_canceled(const Order* order) {
     if (!order) {
         LOG_ERROR("Attempted to check canceled status of NULL order");
@@ -128,6 +193,10 @@ bool order_is_canceled(const Order* order) {
     return order->is_canceled;
 }
 
+bool order_can_rest(const Order* order) {
+    return order && order->time_in_force == ORDER_TIF_GTC && !order->is_market;
+}
+
 void order_set_price(Order* order, double new_price) {
     if (!order) {
         LOG_ERROR("Attempted to set price on NULL order");
@@ -135,11 +204,11 @@ void order_set_price(Order* order, double new_price) {
     }
     if (new_price <= 0.0) {
         LOG_ERROR("Attempted to set invalid price (%.2f) on order %s", 
-                 new_price, order->order_id);
+                 new_price, order_get_id(order));
         return;
     }
     LOG_INFO("Updating order %s price: %.2f -> %.2f", 
-             order->order_id, order->price, new_price);
+             order_get_id(order), order->price, new_price);
     order->price = new_price;
 }
 
@@ -150,12 +219,12 @@ int order_set_quantity(Order* order, int new_quantity) {
     }
     if (new_quantity < 0) {
         LOG_ERROR("Attempted to set negative quantity (%d) on order %s", 
-                 new_quantity, order->order_id);
+                 new_quantity, order_get_id(order));
         return -1;
     }
     
     LOG_INFO("Updating order %s quantity: %d -> %d", 
-             order->order_id, order->quantity, new_quantity);
+             order_get_id(order), order->quantity, new_quantity);
     order->quantity = new_quantity;
     order->remaining_quantity = new_quantity;
     return 0;
@@ -168,17 +237,17 @@ int order_reduce_quantity(Order* order, int amount) {
     }
     if (amount < 0) {
         LOG_ERROR("Attempted to reduce quantity by negative amount (%d) on order %s", 
-                 amount, order->order_id);
+                 amount, order_get_id(order));
         return -1;
     }
     if (amount > order->remaining_quantity) {
         LOG_ERROR("Attempted to reduce quantity by %d when only %d remaining for order %s",
-                 amount, order->remaining_quantity, order->order_id);
+                 amount, order->remaining_quantity, order_get_id(order));
         return -1;
     }
 
     LOG_INFO("Reducing order %s remaining quantity: %d - %d = %d",
-             order->order_id, order->remaining_quantity, amount,
+             order_get_id(order), order->remaining_quantity, amount,
              order->remaining_quantity - amount);
     
     order->remaining_quantity -= amount;
@@ -191,23 +260,56 @@ void order_cancel(Order* order) {
         return;
     }
     if (order->is_canceled) {
-        LOG_WARN("Attempted to cancel already canceled order %s", order->order_id);
+        LOG_WARN("Attempted to cancel already canceled order %s", order_get_id(order));
         return;
     }
     
-    LOG_INFO("Canceling order %s", order->order_id);
+    LOG_INFO("Canceling order %s", order_get_id(order));
     order->is_canceled = true;
 }
 
+int order_set_display_quantity(Order* order, int display_quantity) {
+    if (!order) {
+        LOG_ERROR("Attempted to set display quantity on NULL order");
+        return -1;
+    }
+    if (display_quantity < 0) {
+        LOG_ERROR("Attempted to set negative display quantity (%d) on order %s",
+                  display_quantity, order_get_id(order));
+        return -1;
+    }
+
+    int open = order->remaining_quantity + order->hidden_quantity;
+    order->display_quantity = display_quantity;
+    order->remaining_quantity = (display_quantity > 0 && display_quantity < open)
+                                ? display_quantity : open;
+    order->hidden_quantity = open - order->remaining_quantity;
+    return 0;
+}
+
+bool order_replenish(Order* order) {
+    if (!order || order->remaining_quantity > 0 || order->hidden_quantity <= 0) {
+        return false;
+    }
+
+    int slice = order->hidden_quantity < order->display_quantity
+                ? order->hidden_quantity : order->display_quantity;
+    order->remaining_quantity = slice;
+    order->hidden_quantity -= slice;
+    LOG_DEBUG("Replenished order %s: showing %d, %d hidden",
+              order_get_id(order), slice, order->hidden_quantity);
+    return true;
+}
+
 bool order_equals(const Order* order1, const Order* order2) {
     if (!order1 || !order2) {
         LOG_ERROR("Attempted to compare NULL order(s)");
         return false;
     }
     
-    bool equals = strcmp(order1->order_id, order2->order_id) == 0;
+    bool equals = order1->order_handle == order2->order_handle;
     LOG_DEBUG("Comparing orders %s and %s: %s",
-             order1->order_id, order2->order_id,
+             order_get_id(order1), order_get_id(order2),
              equals ? "equal" : "not equal");
     return equals;
 }
@@ -227,13 +329,13 @@ int order_compare(const Order* order1, const Order* order2) {
         }
     }
 
-    // If prices are equal, compare by timestamp
-    if (order1->timestamp != order2->timestamp) {
-        return order1->timestamp < order2->timestamp ? -1 : 1;
+    // If prices are equal, the earlier sequence has priority
+    if (order1->sequence != order2->sequence) {
+        return order1->sequence < order2->sequence ? -1 : 1;
     }
 
     LOG_DEBUG("Comparing orders %s and %s: equal priority",
-             order1->order_id, order2->order_id);
+             order_get_id(order1), order_get_id(order2));
     return 0;
 }
 
@@ -252,8 +354,8 @@ char* order_to_string(const Order* order) {
 
     snprintf(str, 256,
              "Order{id=%s, trader=%s, symbol=%s, price=%.2f, qty=%d, remaining=%d, %s, %s}",
-             order->order_id,
-             order->trader_id,
+             order_get_id(order),
+             order_get_trader_id(order),
              order->symbol,
              order->price,
              order->quantity,
@@ -261,6 +363,6 @@ char* order_to_string(const Order* order) {
              order->is_buy_order ? "BUY" : "SELL",
              order->is_canceled ? "CANCELED" : "ACTIVE");
 
-    LOG_DEBUG("Created string representation for order %s", order->order_id);
+    LOG_DEBUG("Created string representation for order %s", order_get_id(order));
     return str;
 }
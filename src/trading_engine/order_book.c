@@ -1,52 +1,94 @@
 #include "trading_engine/order_book.h"
 #include "trading_engine/order.h"
 #include "trading_engine/avl_tree.h"
+#include "trading_engine/order_index.h"
+#include "trading_engine/price_ladder.h"
 #include "trading_engine/trade_broadcaster.h"
 #include "utils/logging.h"
 #include <stdlib.h>
 #include <string.h>
 
 OrderBook* order_book_create(TradeBroadcaster* broadcaster) {
-    OrderBook* book = (OrderBook*)malloc(sizeof(OrderBook));
-    if (!book) {
-        LOG_ERROR("Failed to allocate memory for order book");
+    OrderBookConfig config = {
+        .backend = ORDER_BOOK_BACKEND_AVL,
+        .trade_broadcaster = broadcaster
+    };
+    return order_book_create_with_config(&config);
+}
+
+OrderBook* order_book_create_with_config(const OrderBookConfig* config) {
+    if (!config) {
+        LOG_ERROR("NULL order book config provided");
         return NULL;
     }
 
-    book->buy_orders = avl_create(true);
-    if (!book->buy_orders) {
-        LOG_ERROR("Failed to create buy orders AVL tree");
-        free(book);
+    OrderBook* book = (OrderBook*)calloc(1, sizeof(OrderBook));
+    if (!book) {
+        LOG_ERROR("Failed to allocate memory for order book");
         return NULL;
     }
 
-    book->sell_orders = avl_create(false);
-    if (!book->sell_orders) {
-        LOG_ERROR("Failed to create sell orders AVL tree");
-        avl_destroy(book->buy_orders);
+    book->backend = config->backend;
+    book->trade_broadcaster = config->trade_broadcaster;
+
+    book->orders_by_id = order_index_create(0);
+    if (!book->orders_by_id) {
+        LOG_ERROR("Failed to create order ID index");
         free(book);
         return NULL;
     }
+    if (!book->trade_broadcaster) {
+        // Headless books (loaders, tests) match without publishing trades
+        LOG_DEBUG("Order book created without trade broadcaster");
+    }
 
-    book->trade_broadcaster = broadcaster;
-    if (!broadcaster) {
-        LOG_ERROR("NULL trade broadcaster provided");
-        avl_destroy(book->sell_orders);
-        avl_destroy(book->buy_orders); 
-        free(book);
-        return NULL;
+    if (book->backend == ORDER_BOOK_BACKEND_DENSE) {
+        book->buy_levels = price_ladder_create(true, config->tick_size, config->num_levels);
+        book->sell_levels = price_ladder_create(false, config->tick_size, config->num_levels);
+        if (!book->buy_levels || !book->sell_levels) {
+            LOG_ERROR("Failed to create price ladders");
+            order_book_destroy(book);
+            return NULL;
+        }
+    } else {
+        book->buy_orders = avl_create(true);
+        book->sell_orders = avl_create(false);
+        if (!book->buy_orders || !book->sell_orders) {
+            LOG_ERROR("Failed to create order AVL trees");
+            order_book_destroy(book);
+            return NULL;
+        }
     }
 
-    LOG_INFO("Created new order book");
+    LOG_INFO("Created new %s order book",
+             book->backend == ORDER_BOOK_BACKEND_DENSE ? "dense" : "AVL");
     return book;
 }
 
+static void destroy_adopted_order(Order* order, void* user_data) {
+    (void)user_data;
+    if (order->owned_by_book) {
+        order_destroy(order);
+    }
+}
+
 void order_book_destroy(OrderBook* book) {
     if (!book) {
         return;
     }
 
     LOG_INFO("Destroying order book");
+    // Canceled orders the matcher has not dropped yet are still visited.
+    // Books that never adopted may hold caller-owned orders already freed.
+    if (book->adopted_orders > 0) {
+        if (book->backend == ORDER_BOOK_BACKEND_DENSE) {
+            price_ladder_traverse(book->buy_levels, destroy_adopted_order, NULL);
+            price_ladder_traverse(book->sell_levels, destroy_adopted_order, NULL);
+        } else {
+            avl_inorder_traverse(book->buy_orders, destroy_adopted_order, NULL);
+            avl_inorder_traverse(book->sell_orders, destroy_adopted_order, NULL);
+        }
+    }
     if (book->buy_orders) {
         avl_destroy(book->buy_orders);
         book->buy_orders = NULL;
@@ -55,9 +97,99 @@ void order_book_destroy(OrderBook* book) {
         avl_destroy(book->sell_orders);
         book->sell_orders = NULL;
     }
+    if (book->buy_levels) {
+        price_ladder_destroy(book->buy_levels);
+        book->buy_levels = NULL;
+    }
+    if (book->sell_levels) {
+        price_ladder_destroy(book->sell_levels);
+        book->sell_levels = NULL;
+    }
+    order_index_destroy(book->orders_by_id);
     free(book);
 }
 
+void order_book_set_trade_callback(OrderBook* book, OrderBookTradeCallback callback, void* user_data) {
+    if (!book) {
+        return;
+    }
+    book->on_trade = callback;
+    book->trade_callback_data = user_data;
+}
+
+static bool is_side_empty(const OrderBook* book, bool is_buy) {
+    if (book->backend == ORDER_BOOK_BACKEND_DENSE) {
+        return price_ladder_is_empty(is_buy ? book->buy_levels : book->sell_levels);
+    }
+    return avl_is_empty(is_buy ? book->buy_orders : book->sell_orders);
+}
+
+// Drops an order from the ID index unless its ID has since been reused by a newer order
+static void unindex_order(OrderBook* book, const Order* order) {
+    if (order_index_find(book->orders_by_id, order->order_handle) == order) {
+        order_index_remove(book->orders_by_id, order->order_handle);
+    }
+}
+
+// Removes the best AVL order for its side, as returned by avl_best_node
+static void remove_best_order(OrderBook* book, Order* order) {
+    unindex_order(book, order);
+    avl_delete_order(order->is_buy_order ? book->buy_orders : book->sell_orders,
+                     order->price, order->sequence);
+    if (order->owned_by_book) {
+        book->adopted_orders--;
+        order_destroy(order);
+    }
+}
+
+static void pop_best_slot(OrderBook* book, OrderSlot* slot) {
+    Order* order = slot->order;  // Discarded slots no longer refer to an order
+    if (order) {
+        unindex_order(book, order);
+    }
+    price_ladder_pop_best((slot->flags & ORDER_SLOT_BUY) ? book->buy_levels : book->sell_levels);
+    if (order && order->owned_by_book) {
+        book->adopted_orders--;
+        order_destroy(order);
+    }
+}
+
+// Called once the displayed quantity of a best AVL order is used up. An
+// iceberg shows its next slice behind the other orders at its price; the
+// tree is keyed on sequence, so that replaces the node. Anything else is done.
+static void settle_best_order(OrderBook* book, Order* order) {
+    if (order_replenish(order)) {
+        AVLTree* tree = order->is_buy_order ? book->buy_orders : book->sell_orders;
+        avl_delete_order(tree, order->price, order->sequence);
+        order->sequence = order_next_sequence();
+        avl_insert(tree, order->price, order->sequence, order);
+        return;
+    }
+    LOG_DEBUG("Removing fully matched %s order %s",
+              order->is_buy_order ? "buy" : "sell", order_get_id(order));
+    remove_best_order(book, order);
+}
+
+// Dense counterpart of settle_best_order. The slot moves to the back of its
+// level queue in O(1) and nothing else in the ladder changes.
+static void settle_best_slot(OrderBook* book, OrderSlot* slot) {
+    Order* order = slot->order;
+    if (order_replenish(order)) {
+        order->sequence = order_next_sequence();
+        if (price_ladder_requeue_best((slot->flags & ORDER_SLOT_BUY) ? book->buy_levels
+                                                                     : book->sell_levels) != 0) {
+            // Out of memory: show the slice where it is rather than lose it
+            LOG_ERROR("Failed to requeue order %s", order_get_id(order));
+            slot->sequence = order->sequence;
+            slot->remaining_quantity = order->remaining_quantity;
+        }
+        return;
+    }
+    LOG_DEBUG("Removing fully matched %s order %s",
+              (slot->flags & ORDER_SLOT_BUY) ? "buy" : "sell", order_get_id(order));
+    pop_best_slot(book, slot);
+}
+
 static bool is_match_possible(const Order* buy_order, const Order* sell_order) {
     if (!buy_order || !sell_order) {
         LOG_ERROR("Attempted to match with NULL order(s)");
@@ -87,11 +219,12 @@ static bool is_match_possible(const Order* buy_order, const Order* sell_order) {
     }
 
     LOG_DEBUG("Match possible between buy order %s and sell order %s",
-             buy_order->order_id, sell_order->order_id);
+             order_get_id(buy_order), order_get_id(sell_order));
     return true;
 }
 
-static void process_match(Order* buy_order, Order* sell_order, TradeBroadcaster* broadcaster) {
+// Fills both orders by the smaller of their remaining quantities at price
+static void process_match(OrderBook* book, Order* buy_order, Order* sell_order, double price) {
    if (!buy_order || !sell_order) {
        LOG_ERROR("Attempted to process match with NULL order(s)");
        return;
@@ -101,19 +234,26 @@ static void process_match(Order* buy_order, Order* sell_order, TradeBroadcaster*
                        buy_order->remaining_quantity : sell_order->remaining_quantity;
 
    LOG_INFO("Processing match: Buy Order=%s, Sell Order=%s, Quantity=%d, Price=%.2f",
-            buy_order->order_id, sell_order->order_id, match_quantity, sell_order->price);
+            order_get_id(buy_order), order_get_id(sell_order), match_quantity, price);
 
    order_reduce_quantity(buy_order, match_quantity);
    order_reduce_quantity(sell_order, match_quantity);
 
+   if (book->on_trade) {
+       book->on_trade(buy_order, sell_order, price, match_quantity,
+                      book->trade_callback_data);
+   }
+
    // Broadcast the trade
-   trade_broadcaster_send_trade(broadcaster, 
-                              buy_order->symbol,
-                              buy_order->order_id,
-                              sell_order->order_id,
-                              sell_order->price,
-                              match_quantity,
-                              time(NULL));
+   if (book->trade_broadcaster) {
+       trade_broadcaster_send_trade(book->trade_broadcaster, 
+                                  buy_order->symbol,
+                                  order_get_id(buy_order),
+                                  order_get_id(sell_order),
+                                  price,
+                                  match_quantity,
+                                  time(NULL));
+   }
 
    LOG_DEBUG("After match: Buy Order remaining=%d, Sell Order remaining=%d",
             buy_order->remaining_quantity, sell_order->remaining_quantity);
@@ -125,20 +265,279 @@ int order_book_add_order(OrderBook* book, Order* order) {
         return -1;
     }
 
+    if (!order_can_rest(order)) {
+        LOG_ERROR("Rejected order %s: it may not rest in the book", order_get_id(order));
+        return -1;
+    }
+
     LOG_INFO("Adding %s order to book: ID=%s, Symbol=%s, Price=%.2f, Quantity=%d",
              order->is_buy_order ? "buy" : "sell",
-             order->order_id, order->symbol,
+             order_get_id(order), order->symbol,
              order->price, order->quantity);
 
+    if (order_index_insert(book->orders_by_id, order->order_handle, order) != 0) {
+        LOG_ERROR("Rejected order %s: ID already live in book", order_get_id(order));
+        return -1;
+    }
+
+    if (book->backend == ORDER_BOOK_BACKEND_DENSE) {
+        if (price_ladder_insert(order->is_buy_order ? book->buy_levels : book->sell_levels,
+                                order) != 0) {
+            order_index_remove(book->orders_by_id, order->order_handle);
+            return -1;
+        }
+        return 0;
+    }
+
     if (order->is_buy_order) {
-        avl_insert(book->buy_orders, order->price, order->timestamp, order);
+        avl_insert(book->buy_orders, order->price, order->sequence, order);
     } else {
-        avl_insert(book->sell_orders, order->price, order->timestamp, order);
+        avl_insert(book->sell_orders, order->price, order->sequence, order);
+    }
+
+    return 0;
+}
+
+void order_book_adopt_order(OrderBook* book, Order* order) {
+    if (!book || !order) {
+        LOG_ERROR("Invalid parameters for order adoption");
+        return;
     }
 
+    // Only live resting orders are indexed, and nothing can cancel an order
+    // between its add and its adoption
+    if (order_index_find(book->orders_by_id, order->order_handle) != order) {
+        order_destroy(order);
+        return;
+    }
+    order->owned_by_book = true;
+    book->adopted_orders++;
+}
+
+// Buys before sells, then ascending price, then ascending sequence
+static int compare_bulk_orders(const void* a, const void* b) {
+    const Order* lhs = *(const Order* const*)a;
+    const Order* rhs = *(const Order* const*)b;
+
+    if (lhs->is_buy_order != rhs->is_buy_order) {
+        return lhs->is_buy_order ? -1 : 1;
+    }
+    if (lhs->price != rhs->price) {
+        return lhs->price < rhs->price ? -1 : 1;
+    }
+    if (lhs->sequence != rhs->sequence) {
+        return lhs->sequence < rhs->sequence ? -1 : 1;
+    }
     return 0;
 }
 
+int order_book_add_orders_bulk(OrderBook* book, Order** orders, size_t n) {
+    if (!book || (!orders && n > 0)) {
+        LOG_ERROR("Invalid parameters for bulk order add");
+        return -1;
+    }
+
+    // Move orders whose IDs are accepted by the index to the front
+    size_t accepted = 0;
+    for (size_t i = 0; i < n; i++) {
+        Order* order = orders[i];
+        if (!order || order_index_insert(book->orders_by_id, order->order_handle, order) != 0) {
+            if (order) {
+                LOG_ERROR("Rejected order %s: ID already live in book", order_get_id(order));
+            }
+            continue;
+        }
+        orders[i] = orders[accepted];
+        orders[accepted++] = order;
+    }
+    if (accepted == 0) {
+        return 0;
+    }
+
+    Order** failed = malloc(accepted * sizeof(Order*));
+    if (!failed) {
+        LOG_ERROR("Failed to allocate memory for bulk order add");
+        for (size_t i = 0; i < accepted; i++) {
+            order_index_remove(book->orders_by_id, orders[i]->order_handle);
+        }
+        return -1;
+    }
+
+    qsort(orders, accepted, sizeof(Order*), compare_bulk_orders);
+
+    size_t buy_count = 0;
+    while (buy_count < accepted && orders[buy_count]->is_buy_order) {
+        buy_count++;
+    }
+
+    size_t failed_count = 0;
+    size_t added = 0;
+    size_t bounds[3] = {0, buy_count, accepted};
+
+    for (int side = 0; side < 2; side++) {
+        bool is_buy = (side == 0);
+        size_t lo = bounds[side], hi = bounds[side + 1];
+        if (lo == hi) {
+            continue;
+        }
+
+        // The tree moves the orders it rejects behind the inserted ones
+        size_t inserted_end = lo;
+        if (book->backend == ORDER_BOOK_BACKEND_AVL) {
+            int inserted = avl_insert_sorted(is_buy ? book->buy_orders : book->sell_orders,
+                                             orders + lo, hi - lo);
+            inserted_end = lo + (inserted > 0 ? (size_t)inserted : 0);
+        }
+
+        for (size_t i = lo; i < hi; i++) {
+            Order* order = orders[i];
+            bool ok = i < inserted_end;
+            if (book->backend == ORDER_BOOK_BACKEND_DENSE) {
+                // Sorted input walks each ladder level by level, appending in sequence order
+                ok = price_ladder_insert(is_buy ? book->buy_levels : book->sell_levels,
+                                         order) == 0;
+            }
+
+            if (ok) {
+                orders[added++] = order;
+                continue;
+            }
+
+            order_index_remove(book->orders_by_id, order->order_handle);
+            failed[failed_count++] = order;
+        }
+    }
+
+    // Rejected orders follow the added ones so the caller can release them
+    memcpy(orders + added, failed, failed_count * sizeof(Order*));
+    free(failed);
+
+    LOG_INFO("Bulk added %zu of %zu orders to book", added, n);
+    return (int)added;
+}
+
+// As in match_dense, crossing is decided from the nodes' hot fields and the
+// Order records are only dereferenced once a fill is certain.
+static int match_avl(OrderBook* book) {
+    int match_count = 0;
+
+    while (true) {
+        AVLNode* buy = avl_best_node(book->buy_orders);
+        AVLNode* sell = avl_best_node(book->sell_orders);
+
+        if (!buy || !sell) {
+            LOG_DEBUG("No matching possible: one or both sides empty");
+            break;
+        }
+
+        // Canceled orders are removed lazily once they reach the top of the book
+        if (buy->flags & AVL_NODE_CANCELED) {
+            remove_best_order(book, buy->order);
+            continue;
+        }
+
+        if (sell->flags & AVL_NODE_CANCELED) {
+            remove_best_order(book, sell->order);
+            continue;
+        }
+
+        if (buy->price < sell->price) {
+            LOG_INFO("No match possible: Buy %.2f vs Sell %.2f", buy->price, sell->price);
+            break;
+        }
+
+        // Orders may also be canceled directly through order_cancel()
+        if (buy->order->is_canceled) {
+            buy->flags |= AVL_NODE_CANCELED;
+            continue;
+        }
+
+        if (sell->order->is_canceled) {
+            sell->flags |= AVL_NODE_CANCELED;
+            continue;
+        }
+
+        Order* best_buy = buy->order;
+        Order* best_sell = sell->order;
+        if (!is_match_possible(best_buy, best_sell)) {
+            break;
+        }
+
+        process_match(book, best_buy, best_sell, best_sell->price);
+        buy->remaining_quantity = best_buy->remaining_quantity;
+        sell->remaining_quantity = best_sell->remaining_quantity;
+        match_count++;
+
+        if (best_buy->remaining_quantity == 0) {
+            settle_best_order(book, best_buy);
+        }
+
+        if (best_sell->remaining_quantity == 0) {
+            settle_best_order(book, best_sell);
+        }
+    }
+
+    return match_count;
+}
+
+// Crossing is decided from the hot slots alone; the Order records are
+// only dereferenced once a fill is certain.
+static int match_dense(OrderBook* book) {
+    int match_count = 0;
+
+    while (true) {
+        OrderSlot* buy = price_ladder_best_slot(book->buy_levels);
+        OrderSlot* sell = price_ladder_best_slot(book->sell_levels);
+
+        if (!buy || !sell) {
+            LOG_DEBUG("No matching possible: one or both sides empty");
+            break;
+        }
+
+        if (buy->flags & ORDER_SLOT_CANCELED) {
+            pop_best_slot(book, buy);
+            continue;
+        }
+
+        if (sell->flags & ORDER_SLOT_CANCELED) {
+            pop_best_slot(book, sell);
+            continue;
+        }
+
+        if (buy->price_tick < sell->price_tick) {
+            LOG_INFO("No match possible: Buy tick %ld vs Sell tick %ld",
+                     buy->price_tick, sell->price_tick);
+            break;
+        }
+
+        // Orders may also be canceled directly through order_cancel()
+        if (buy->order->is_canceled) {
+            buy->flags |= ORDER_SLOT_CANCELED;
+            continue;
+        }
+
+        if (sell->order->is_canceled) {
+            sell->flags |= ORDER_SLOT_CANCELED;
+            continue;
+        }
+
+        process_match(book, buy->order, sell->order, sell->order->price);
+        buy->remaining_quantity = buy->order->remaining_quantity;
+        sell->remaining_quantity = sell->order->remaining_quantity;
+        match_count++;
+
+        if (buy->remaining_quantity == 0) {
+            settle_best_slot(book, buy);
+        }
+
+        if (sell->remaining_quantity == 0) {
+            settle_best_slot(book, sell);
+        }
+    }
+
+    return match_count;
+}
+
 void order_book_match_orders(OrderBook* book) {
     if (!book) {
         LOG_ERROR("Attempted to match orders in NULL book");
@@ -147,68 +546,195 @@ void order_book_match_orders(OrderBook* book) {
 
     LOG_INFO("Starting order matching process");
 
-    // Early exit if either buy or sell order tree is empty
-    if (!book->buy_orders || !book->sell_orders) {
-        LOG_DEBUG("Cannot match orders: order trees not initialized");
-        return;
-    }
-
-    if (avl_is_empty(book->buy_orders)) {
+    // Early exit if either side of the book is empty
+    if (is_side_empty(book, true)) {
         LOG_INFO("No buy orders available for matching");
         return;
     }
 
-    if (avl_is_empty(book->sell_orders)) {
+    if (is_side_empty(book, false)) {
         LOG_INFO("No sell orders available for matching");
         return;
     }
 
-    Order* best_buy = avl_find_max(book->buy_orders);
-    Order* best_sell = avl_find_min(book->sell_orders);
-    
-    LOG_INFO("Best buy order: %s at %.2f", best_buy->order_id, best_buy->price);
-    LOG_INFO("Best sell order: %s at %.2f", best_sell->order_id, best_sell->price);
+    int match_count = (book->backend == ORDER_BOOK_BACKEND_DENSE)
+                      ? match_dense(book) : match_avl(book);
 
-    if (!is_match_possible(best_buy, best_sell)) {
-        LOG_INFO("No match possible: Buy %.2f vs Sell %.2f", 
-                 best_buy->price, best_sell->price);
-        return;
+    LOG_INFO("Completed order matching process: %d matches executed", match_count);
+}
+
+// Whether a taker may trade with a resting order at price
+static bool within_limit(const Order* taker, double price) {
+    if (taker->is_market) {
+        return true;
     }
+    return taker->is_buy_order ? price <= taker->price : price >= taker->price;
+}
 
-    bool matches_found = true;
-    int match_count = 0;
+static void fill_taker(OrderBook* book, Order* taker, Order* resting) {
+    if (taker->is_buy_order) {
+        process_match(book, taker, resting, resting->price);
+    } else {
+        process_match(book, resting, taker, resting->price);
+    }
+}
 
-    while (matches_found) {
-        matches_found = false;
-        best_buy = avl_find_max(book->buy_orders);
-        best_sell = avl_find_min(book->sell_orders);
+typedef struct {
+    const Order* taker;
+    int available;
+} FillCheck;
 
-        if (!best_buy || !best_sell) {
-            LOG_DEBUG("No matching possible: one or both sides empty");
+static bool count_available(const AVLNode* node, void* user_data) {
+    FillCheck* check = (FillCheck*)user_data;
+    if (!within_limit(check->taker, node->price)) {
+        return false;
+    }
+    if (!(node->flags & AVL_NODE_CANCELED)) {
+        check->available += node->remaining_quantity;
+        if (node->flags & AVL_NODE_ICEBERG) {
+            check->available += node->order->hidden_quantity;
+        }
+    }
+    return check->available < check->taker->remaining_quantity;
+}
+
+// The fill-or-kill pre-check; it only reads the book
+static bool can_fill_completely(const OrderBook* book, const Order* taker, int64_t limit_tick) {
+    int wanted = taker->remaining_quantity;
+    if (book->backend == ORDER_BOOK_BACKEND_DENSE) {
+        const PriceLadder* ladder = taker->is_buy_order ? book->sell_levels : book->buy_levels;
+        return price_ladder_available(ladder, !taker->is_market, limit_tick, wanted) >= wanted;
+    }
+
+    FillCheck check = {.taker = taker, .available = 0};
+    avl_visit_best_first(taker->is_buy_order ? book->sell_orders : book->buy_orders,
+                         count_available, &check);
+    return check.available >= wanted;
+}
+
+static void take_avl(OrderBook* book, Order* taker) {
+    AVLTree* tree = taker->is_buy_order ? book->sell_orders : book->buy_orders;
+
+    while (taker->remaining_quantity > 0) {
+        AVLNode* node = avl_best_node(tree);
+        if (!node) {
             break;
         }
+        if (node->flags & AVL_NODE_CANCELED) {
+            remove_best_order(book, node->order);
+            continue;
+        }
+        if (!within_limit(taker, node->price)) {
+            break;
+        }
+        if (node->order->is_canceled) {
+            node->flags |= AVL_NODE_CANCELED;
+            continue;
+        }
 
-        if (is_match_possible(best_buy, best_sell)) {
-            process_match(best_buy, best_sell, book->trade_broadcaster);
-            matches_found = true;
-            match_count++;
+        Order* best = node->order;
+        fill_taker(book, taker, best);
+        node->remaining_quantity = best->remaining_quantity;
+        if (best->remaining_quantity == 0) {
+            settle_best_order(book, best);
+        }
+    }
+}
 
-            // Safely remove fully matched orders
-            if (best_buy->remaining_quantity == 0) {
-                LOG_DEBUG("Removing fully matched buy order %s", best_buy->order_id);
-                avl_delete_order(book->buy_orders, best_buy->price, best_buy->timestamp);
-            }
+static void take_dense(OrderBook* book, Order* taker, int64_t limit_tick) {
+    PriceLadder* ladder = taker->is_buy_order ? book->sell_levels : book->buy_levels;
 
-            if (best_sell->remaining_quantity == 0) {
-                LOG_DEBUG("Removing fully matched sell order %s", best_sell->order_id);
-                avl_delete_order(book->sell_orders, best_sell->price, best_sell->timestamp);
-            }
-        } else {
-            break;  // No more matches possible
+    while (taker->remaining_quantity > 0) {
+        OrderSlot* slot = price_ladder_best_slot(ladder);
+        if (!slot) {
+            break;
+        }
+        if (slot->flags & ORDER_SLOT_CANCELED) {
+            pop_best_slot(book, slot);
+            continue;
+        }
+        if (!taker->is_market &&
+            (taker->is_buy_order ? slot->price_tick > limit_tick : slot->price_tick < limit_tick)) {
+            break;
+        }
+        if (slot->order->is_canceled) {
+            slot->flags |= ORDER_SLOT_CANCELED;
+            continue;
+        }
+
+        fill_taker(book, taker, slot->order);
+        slot->remaining_quantity = slot->order->remaining_quantity;
+        if (slot->remaining_quantity == 0) {
+            settle_best_slot(book, slot);
         }
     }
+}
 
-    LOG_INFO("Completed order matching process: %d matches executed", match_count);
+// Refusals of order_book_execute_order; on success limit_tick is the
+// order's limit on a dense book
+static int check_execute(const OrderBook* book, const Order* order, int64_t* limit_tick) {
+    if (!book || !order || order_can_rest(order) || order->remaining_quantity <= 0 ||
+        order->hidden_quantity > 0) {
+        LOG_ERROR("Invalid parameters for order execution");
+        return -1;
+    }
+
+    // Fills name the order by ID, so it may not share one with a resting order
+    if (order_index_find(book->orders_by_id, order->order_handle)) {
+        LOG_ERROR("Rejected order %s: ID already live in book", order_get_id(order));
+        return -1;
+    }
+
+    *limit_tick = 0;
+    if (book->backend == ORDER_BOOK_BACKEND_DENSE && !order->is_market &&
+        !price_ladder_to_tick(order->is_buy_order ? book->sell_levels : book->buy_levels,
+                              order->price, limit_tick)) {
+        LOG_ERROR("Rejected order %s: price %.6f is not on a tick", order_get_id(order), order->price);
+        return -1;
+    }
+    return 0;
+}
+
+bool order_book_can_execute(const OrderBook* book, const Order* order) {
+    int64_t limit_tick;
+    return check_execute(book, order, &limit_tick) == 0;
+}
+
+int order_book_execute_order(OrderBook* book, Order* order) {
+    int64_t limit_tick;
+    if (check_execute(book, order, &limit_tick) != 0) {
+        return -1;
+    }
+
+    int wanted = order->remaining_quantity;
+    if (order->time_in_force == ORDER_TIF_FOK && !can_fill_completely(book, order, limit_tick)) {
+        LOG_INFO("Killed fill-or-kill order %s: %d not available", order_get_id(order), wanted);
+    } else if (book->backend == ORDER_BOOK_BACKEND_DENSE) {
+        take_dense(book, order, limit_tick);
+    } else {
+        take_avl(book, order);
+    }
+
+    int filled = wanted - order->remaining_quantity;
+    if (order->remaining_quantity > 0) {
+        order_cancel(order);
+    }
+    LOG_INFO("Executed order %s: %d of %d filled", order_get_id(order), filled, wanted);
+    return filled;
+}
+
+// Resolves an ID to a live resting order on the given side, or NULL
+static Order* find_live_order(const OrderBook* book, const char* order_id, bool is_buy_order) {
+    IdHandle handle = id_intern_find(order_id);
+    if (handle == ID_HANDLE_INVALID) {
+        return NULL;
+    }
+
+    Order* order = order_index_find(book->orders_by_id, handle);
+    if (!order || order->is_buy_order != is_buy_order || order->is_canceled) {
+        return NULL;
+    }
+    return order;
 }
 
 int order_book_cancel_order(OrderBook* book, const char* order_id, bool is_buy_order) {
@@ -217,27 +743,144 @@ int order_book_cancel_order(OrderBook* book, const char* order_id, bool is_buy_o
         return -1;
     }
 
-    AVLTree* order_tree = is_buy_order ? book->buy_orders : book->sell_orders;
-    AVLNode* current = order_tree->root;
+    Order* order = find_live_order(book, order_id, is_buy_order);
+    if (!order) {
+        LOG_WARN("Order not found for cancellation: %s", order_id);
+        return -1;
+    }
 
-    while (current) {
-        if (strcmp(current->order->order_id, order_id) == 0) {
-            // Found the order
-            order_cancel(current->order);
-            LOG_INFO("Canceled order: %s", order_id);
-            return 0;
+    if (book->backend == ORDER_BOOK_BACKEND_DENSE) {
+        OrderSlot* slot = price_ladder_find(is_buy_order ? book->buy_levels : book->sell_levels,
+                                            order);
+        if (slot) {
+            slot->flags |= ORDER_SLOT_CANCELED;
+        }
+    } else {
+        AVLNode* node = avl_find_node(is_buy_order ? book->buy_orders : book->sell_orders,
+                                      order->price, order->sequence);
+        if (node) {
+            node->flags |= AVL_NODE_CANCELED;
         }
+    }
 
-        // Traverse the tree based on price comparison
-        int cmp = compare_nodes(current->price, current->timestamp, 
-                                current->order->price, current->order->timestamp, 
-                                is_buy_order);
-        
-        current = (cmp < 0) ? current->left : current->right;
+    // The order stays in its tree or level until the matcher reaches it,
+    // but its ID is free for reuse straight away
+    order_cancel(order);
+    order_index_remove(book->orders_by_id, order->order_handle);
+    LOG_INFO("Canceled order: %s", order_id);
+    return 0;
+}
+
+// Sets the open quantity, keeping what has already been filled. An iceberg
+// that keeps its place keeps its displayed slice, trimmed if need be; a
+// requeued one shows a fresh slice.
+static void set_open_quantity(Order* order, int open_quantity, bool requeued) {
+    order->quantity += open_quantity - order_get_open_quantity(order);
+    int shown = requeued ? order->display_quantity : order->remaining_quantity;
+    if (shown <= 0 || shown > open_quantity) {
+        shown = open_quantity;
     }
+    order->remaining_quantity = shown;
+    order->hidden_quantity = open_quantity - shown;
+}
 
-    LOG_WARN("Order not found for cancellation: %s", order_id);
-    return -1;
+static int modify_dense(OrderBook* book, Order* order, double new_price, int new_quantity,
+                        uint64_t sequence) {
+    PriceLadder* ladder = order->is_buy_order ? book->buy_levels : book->sell_levels;
+    int64_t old_tick, new_tick;
+    if (!price_ladder_to_tick(ladder, order->price, &old_tick) ||
+        !price_ladder_to_tick(ladder, new_price, &new_tick)) {
+        return -1;
+    }
+
+    OrderSlot* slot = price_ladder_find(ladder, order);
+    if (!slot) {
+        return -1;
+    }
+
+    if (new_tick == old_tick && new_quantity <= order_get_open_quantity(order)) {
+        set_open_quantity(order, new_quantity, false);
+        slot->remaining_quantity = order->remaining_quantity;
+        return 0;
+    }
+
+    // The old slot becomes a tombstone the matcher drops later. Queueing the
+    // new one never moves an existing slot when it fails, so the old slot
+    // can then be restored in place.
+    double old_price = order->price;
+    uint64_t old_sequence = order->sequence;
+    int old_quantity = order->quantity;
+    int old_remaining = order->remaining_quantity;
+    int old_hidden = order->hidden_quantity;
+
+    order->price = new_price;
+    order->sequence = sequence;
+    set_open_quantity(order, new_quantity, true);
+    price_ladder_discard(slot);
+    if (price_ladder_insert(ladder, order) != 0) {
+        order->price = old_price;
+        order->sequence = old_sequence;
+        order->quantity = old_quantity;
+        order->remaining_quantity = old_remaining;
+        order->hidden_quantity = old_hidden;
+        slot->order = order;
+        slot->flags &= ~ORDER_SLOT_CANCELED;
+        return -1;
+    }
+    return 0;
+}
+
+static int modify_avl(OrderBook* book, Order* order, double new_price, int new_quantity,
+                      uint64_t sequence) {
+    AVLTree* tree = order->is_buy_order ? book->buy_orders : book->sell_orders;
+    if (new_price == order->price && new_quantity <= order_get_open_quantity(order)) {
+        AVLNode* node = avl_find_node(tree, order->price, order->sequence);
+        if (!node) {
+            return -1;
+        }
+        set_open_quantity(order, new_quantity, false);
+        node->remaining_quantity = order->remaining_quantity;
+        return 0;
+    }
+
+    // The tree is keyed on price and sequence, so the node is replaced
+    avl_delete_order(tree, order->price, order->sequence);
+    order->price = new_price;
+    order->sequence = sequence;
+    set_open_quantity(order, new_quantity, true);
+    avl_insert(tree, order->price, order->sequence, order);
+    return 0;
+}
+
+int order_book_modify_order(OrderBook* book, const char* order_id, bool is_buy_order,
+                            double new_price, int new_quantity, uint64_t sequence) {
+    if (!book || !order_id || new_price <= 0.0 || new_quantity <= 0) {
+        LOG_ERROR("Invalid parameters for order modification");
+        return -1;
+    }
+
+    Order* order = find_live_order(book, order_id, is_buy_order);
+    if (!order) {
+        LOG_WARN("Order not found for modification: %s", order_id);
+        return -1;
+    }
+
+    LOG_INFO("Modifying order %s: %.2f x %d -> %.2f x %d", order_id,
+             order->price, order_get_open_quantity(order), new_price, new_quantity);
+    return book->backend == ORDER_BOOK_BACKEND_DENSE
+           ? modify_dense(book, order, new_price, new_quantity, sequence)
+           : modify_avl(book, order, new_price, new_quantity, sequence);
+}
+
+bool order_book_is_order_canceled(const OrderBook* book, const char* order_id, bool is_buy_order) {
+    if (!book || !order_id) {
+        LOG_ERROR("Invalid parameters for cancellation status check");
+        return false;
+    }
+
+    IdHandle handle = id_intern_find(order_id);
+    Order* order = order_index_find(book->orders_by_id, handle);
+    return !order || order->is_buy_order != is_buy_order || order->is_canceled;
 }
 
 void order_book_traverse_buy_orders(const OrderBook* book, OrderCallback callback, void* user_data) {
@@ -247,7 +890,11 @@ void order_book_traverse_buy_orders(const OrderBook* book, OrderCallback callbac
     }
 
     LOG_DEBUG("Starting buy orders traversal");
-    avl_inorder_traverse(book->buy_orders, callback, user_data);
+    if (book->backend == ORDER_BOOK_BACKEND_DENSE) {
+        price_ladder_traverse(book->buy_levels, callback, user_data);
+    } else {
+        avl_inorder_traverse(book->buy_orders, callback, user_data);
+    }
     LOG_DEBUG("Completed buy orders traversal");
 }
 
@@ -258,7 +905,11 @@ void order_book_traverse_sell_orders(const OrderBook* book, OrderCallback callba
     }
 
     LOG_DEBUG("Starting sell orders traversal");
-    avl_inorder_traverse(book->sell_orders, callback, user_data);
+    if (book->backend == ORDER_BOOK_BACKEND_DENSE) {
+        price_ladder_traverse(book->sell_levels, callback, user_data);
+    } else {
+        avl_inorder_traverse(book->sell_orders, callback, user_data);
+    }
     LOG_DEBUG("Completed sell orders traversal");
 }
 
@@ -289,10 +940,16 @@ int order_book_get_quantity_at_price(const OrderBook* book, double price, bool i
     LOG_DEBUG("Calculating total quantity for %s orders at price %.2f",
              is_buy_order ? "buy" : "sell", price);
 
+    if (book->backend == ORDER_BOOK_BACKEND_DENSE) {
+        const PriceLadder* ladder = is_buy_order ? book->buy_levels : book->sell_levels;
+        int64_t tick;
+        return price_ladder_to_tick(ladder, price, &tick) ? price_ladder_quantity_at(ladder, tick) : 0;
+    }
+
     if (is_buy_order) {
-        avl_inorder_traverse(book->buy_orders, count_quantity_callback, &data);
+        order_book_traverse_buy_orders(book, count_quantity_callback, &data);
     } else {
-        avl_inorder_traverse(book->sell_orders, count_quantity_callback, &data);
+        order_book_traverse_sell_orders(book, count_quantity_callback, &data);
     }
 
     LOG_DEBUG("Total quantity at price %.2f: %d", price, data.total_quantity);
@@ -0,0 +1,145 @@
+#include "trading_engine/order_index.h"
+#include "utils/logging.h"
+#include <stdlib.h>
+
+#define MIN_INDEX_CAPACITY 64
+
+static size_t round_up_pow2(size_t n) {
+    size_t capacity = MIN_INDEX_CAPACITY;
+    while (capacity < n) {
+        capacity <<= 1;
+    }
+    return capacity;
+}
+
+static size_t home_slot(IdHandle handle, size_t capacity) {
+    // Handles are sequential, so spread them before masking
+    return (size_t)((handle * 0x9E3779B97F4A7C15ULL) >> 17) & (capacity - 1);
+}
+
+static int resize(OrderIndex* index, size_t new_capacity) {
+    OrderIndexEntry* entries = calloc(new_capacity, sizeof(OrderIndexEntry));
+    if (!entries) {
+        LOG_ERROR("Failed to resize order index to %zu entries", new_capacity);
+        return -1;
+    }
+
+    for (size_t i = 0; i < index->capacity; i++) {
+        if (index->entries[i].handle == ID_HANDLE_INVALID) {
+            continue;
+        }
+        size_t slot = home_slot(index->entries[i].handle, new_capacity);
+        while (entries[slot].handle != ID_HANDLE_INVALID) {
+            slot = (slot + 1) & (new_capacity - 1);
+        }
+        entries[slot] = index->entries[i];
+    }
+
+    free(index->entries);
+    index->entries = entries;
+    index->capacity = new_capacity;
+    return 0;
+}
+
+OrderIndex* order_index_create(size_t initial_capacity) {
+    OrderIndex* index = malloc(sizeof(OrderIndex));
+    if (!index) {
+        LOG_ERROR("Failed to allocate order index");
+        return NULL;
+    }
+
+    index->capacity = round_up_pow2(initial_capacity);
+    index->count = 0;
+    index->entries = calloc(index->capacity, sizeof(OrderIndexEntry));
+    if (!index->entries) {
+        LOG_ERROR("Failed to allocate order index entries");
+        free(index);
+        return NULL;
+    }
+    return index;
+}
+
+void order_index_destroy(OrderIndex* index) {
+    if (!index) {
+        return;
+    }
+    free(index->entries);
+    free(index);
+}
+
+int order_index_insert(OrderIndex* index, IdHandle handle, struct Order* order) {
+    if (!index || handle == ID_HANDLE_INVALID || !order) {
+        return -1;
+    }
+
+    // Keep the load factor under three quarters
+    if ((index->count + 1) * 4 > index->capacity * 3 &&
+        resize(index, index->capacity * 2) != 0) {
+        return -1;
+    }
+
+    size_t mask = index->capacity - 1;
+    size_t slot = home_slot(handle, index->capacity);
+    while (index->entries[slot].handle != ID_HANDLE_INVALID) {
+        if (index->entries[slot].handle == handle) {
+            return -1;
+        }
+        slot = (slot + 1) & mask;
+    }
+
+    index->entries[slot].handle = handle;
+    index->entries[slot].order = order;
+    index->count++;
+    return 0;
+}
+
+struct Order* order_index_find(const OrderIndex* index, IdHandle handle) {
+    if (!index || handle == ID_HANDLE_INVALID) {
+        return NULL;
+    }
+
+    size_t mask = index->capacity - 1;
+    size_t slot = home_slot(handle, index->capacity);
+    while (index->entries[slot].handle != ID_HANDLE_INVALID) {
+        if (index->entries[slot].handle == handle) {
+            return index->entries[slot].order;
+        }
+        slot = (slot + 1) & mask;
+    }
+    return NULL;
+}
+
+void order_index_remove(OrderIndex* index, IdHandle handle) {
+    if (!index || handle == ID_HANDLE_INVALID) {
+        return;
+    }
+
+    size_t mask = index->capacity - 1;
+    size_t slot = home_slot(handle, index->capacity);
+    while (index->entries[slot].handle != handle) {
+        if (index->entries[slot].handle == ID_HANDLE_INVALID) {
+            return;
+        }
+        slot = (slot + 1) & mask;
+    }
+
+    // Backward-shift deletion keeps probe chains intact without tombstones
+    size_t hole = slot;
+    size_t next = (hole + 1) & mask;
+    while (index->entries[next].handle != ID_HANDLE_INVALID) {
+        size_t home = home_slot(index->entries[next].handle, index->capacity);
+        if (((next - home) & mask) >= ((next - hole) & mask)) {
+            index->entries[hole] = index->entries[next];
+            hole = next;
+        }
+        next = (next + 1) & mask;
+    }
+
+    index->entries[hole].handle = ID_HANDLE_INVALID;
+    index->entries[hole].order = NULL;
+    index->count--;
+}
+
+size_t order_index_count(const OrderIndex* index) {
+    return index ? index->count : 0;
+}
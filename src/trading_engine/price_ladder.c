@@ -0,0 +1,500 @@
+#include "trading_engine/price_ladder.h"
+#include "trading_engine/order.h"
+#include "utils/logging.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define BITS_PER_WORD 64
+#define MAX_LADDER_LEVELS (1 << 20)
+#define INITIAL_LEVEL_CAPACITY 8
+#define TICK_EPSILON 1e-6
+#define MAX_TICK_MAGNITUDE 4611686018427387904.0   // 2^62, well inside int64_t
+
+_Static_assert(sizeof(OrderSlot) == 32, "OrderSlot must stay two slots per cache line");
+
+static int round_up_levels(int num_levels) {
+    if (num_levels < BITS_PER_WORD) {
+        return BITS_PER_WORD;
+    }
+    return (num_levels + BITS_PER_WORD - 1) / BITS_PER_WORD * BITS_PER_WORD;
+}
+
+static int words_for(int bits) {
+    return (bits + BITS_PER_WORD - 1) / BITS_PER_WORD;
+}
+
+static int top_words(int num_levels) {
+    return words_for(words_for(words_for(num_levels)));
+}
+
+// One zeroed block holding the level bitmap followed by its summary and top
+// words, so the three are allocated and freed together
+static uint64_t* alloc_bitmap(int num_levels) {
+    int bitmap_words = words_for(num_levels);
+    int summary_words = words_for(bitmap_words);
+    return calloc(bitmap_words + summary_words + top_words(num_levels), sizeof(uint64_t));
+}
+
+static void attach_bitmap(PriceLadder* ladder, uint64_t* block, int num_levels) {
+    ladder->bitmap = block;
+    ladder->summary = block + words_for(num_levels);
+    ladder->top = ladder->summary + words_for(words_for(num_levels));
+}
+
+static void set_level_bit(PriceLadder* ladder, int index) {
+    int word = index / BITS_PER_WORD;
+    int summary_word = word / BITS_PER_WORD;
+    ladder->bitmap[word] |= (1ULL << (index % BITS_PER_WORD));
+    ladder->summary[summary_word] |= (1ULL << (word % BITS_PER_WORD));
+    ladder->top[summary_word / BITS_PER_WORD] |= (1ULL << (summary_word % BITS_PER_WORD));
+}
+
+static void clear_level_bit(PriceLadder* ladder, int index) {
+    int word = index / BITS_PER_WORD;
+    int summary_word = word / BITS_PER_WORD;
+    ladder->bitmap[word] &= ~(1ULL << (index % BITS_PER_WORD));
+    if (ladder->bitmap[word] == 0) {
+        ladder->summary[summary_word] &= ~(1ULL << (word % BITS_PER_WORD));
+        if (ladder->summary[summary_word] == 0) {
+            ladder->top[summary_word / BITS_PER_WORD] &= ~(1ULL << (summary_word % BITS_PER_WORD));
+        }
+    }
+}
+
+static int lowest_bit(uint64_t word) {
+    return __builtin_ctzll(word);
+}
+
+static int highest_bit(uint64_t word) {
+    return BITS_PER_WORD - 1 - __builtin_clzll(word);
+}
+
+// Lowest non-empty level index, or -1 if the ladder is empty. The top words
+// number at most four, so this is a handful of bit scans at any window size.
+static int first_level(const PriceLadder* ladder) {
+    int words = top_words(ladder->num_levels);
+    for (int t = 0; t < words; t++) {
+        if (ladder->top[t]) {
+            int s = t * BITS_PER_WORD + lowest_bit(ladder->top[t]);
+            int w = s * BITS_PER_WORD + lowest_bit(ladder->summary[s]);
+            return w * BITS_PER_WORD + lowest_bit(ladder->bitmap[w]);
+        }
+    }
+    return -1;
+}
+
+// Highest non-empty level index, or -1 if the ladder is empty
+static int last_level(const PriceLadder* ladder) {
+    int words = top_words(ladder->num_levels);
+    for (int t = words - 1; t >= 0; t--) {
+        if (ladder->top[t]) {
+            int s = t * BITS_PER_WORD + highest_bit(ladder->top[t]);
+            int w = s * BITS_PER_WORD + highest_bit(ladder->summary[s]);
+            return w * BITS_PER_WORD + highest_bit(ladder->bitmap[w]);
+        }
+    }
+    return -1;
+}
+
+static int best_level(const PriceLadder* ladder) {
+    return ladder->is_buy_ladder ? last_level(ladder) : first_level(ladder);
+}
+
+// Move every level to a new window [new_base, new_base + new_num_levels).
+// Callers guarantee all non-empty levels fit in the new window.
+static int rebase(PriceLadder* ladder, int64_t new_base, int new_num_levels) {
+    PriceLevel* levels = calloc(new_num_levels, sizeof(PriceLevel));
+    uint64_t* bitmap = alloc_bitmap(new_num_levels);
+    if (!levels || !bitmap) {
+        LOG_ERROR("Failed to allocate memory for price ladder rebase");
+        free(levels);
+        free(bitmap);
+        return -1;
+    }
+
+    // The old bitmap is not read below, so the new one can be filled in place
+    free(ladder->bitmap);
+    attach_bitmap(ladder, bitmap, new_num_levels);
+
+    for (int i = 0; i < ladder->num_levels; i++) {
+        PriceLevel* level = &ladder->levels[i];
+        if (!level->slots) {
+            continue;
+        }
+
+        int64_t new_index = ladder->base_tick + i - new_base;
+        if (new_index >= 0 && new_index < new_num_levels) {
+            levels[new_index] = *level;
+            if (level->head < level->tail) {
+                set_level_bit(ladder, (int)new_index);
+            }
+        } else {
+            free(level->slots);
+        }
+    }
+
+    free(ladder->levels);
+    ladder->levels = levels;
+    ladder->base_tick = new_base;
+    ladder->num_levels = new_num_levels;
+    return 0;
+}
+
+// Returns the level index for a tick, re-centering or growing the window as needed
+static int ensure_tick(PriceLadder* ladder, int64_t tick) {
+    int64_t index = tick - ladder->base_tick;
+    if (index >= 0 && index < ladder->num_levels) {
+        return (int)index;
+    }
+
+    int lo = first_level(ladder);
+    if (lo < 0) {
+        // Empty ladder: just move the window, existing level buffers are reused in place
+        ladder->base_tick = tick - ladder->num_levels / 2;
+        LOG_DEBUG("Centered empty %s ladder on tick %ld",
+                  ladder->is_buy_ladder ? "buy" : "sell", tick);
+        return (int)(tick - ladder->base_tick);
+    }
+
+    int64_t lo_tick = ladder->base_tick + lo;
+    int64_t hi_tick = ladder->base_tick + last_level(ladder);
+    if (tick < lo_tick) lo_tick = tick;
+    if (tick > hi_tick) hi_tick = tick;
+
+    int64_t span = hi_tick - lo_tick + 1;
+    int64_t new_num_levels = ladder->num_levels;
+    while (span > new_num_levels) {
+        new_num_levels *= 2;
+    }
+    if (new_num_levels > MAX_LADDER_LEVELS) {
+        LOG_ERROR("Tick %ld outside price ladder range (span %ld ticks exceeds %d)",
+                  tick, span, MAX_LADDER_LEVELS);
+        return -1;
+    }
+
+    int64_t new_base = lo_tick - (new_num_levels - span) / 2;
+    LOG_INFO("Re-centering %s ladder: base %ld -> %ld, levels %d -> %ld",
+             ladder->is_buy_ladder ? "buy" : "sell",
+             ladder->base_tick, new_base, ladder->num_levels, new_num_levels);
+
+    if (rebase(ladder, new_base, (int)new_num_levels) != 0) {
+        return -1;
+    }
+    return (int)(tick - ladder->base_tick);
+}
+
+static OrderSlot* push_slot(PriceLevel* level) {
+    if (level->tail == level->capacity) {
+        if (level->head > 0 && level->head >= level->capacity / 2) {
+            // Reclaim space consumed at the front by filled orders. Waiting
+            // until it is half the queue keeps the copy amortized O(1) even
+            // when requeued slots cycle through a full level.
+            memmove(level->slots, level->slots + level->head,
+                    (level->tail - level->head) * sizeof(OrderSlot));
+            level->tail -= level->head;
+            level->shift += (uint32_t)level->head;
+            level->head = 0;
+        } else {
+            int new_capacity = level->capacity ? level->capacity * 2 : INITIAL_LEVEL_CAPACITY;
+            OrderSlot* slots = realloc(level->slots, new_capacity * sizeof(OrderSlot));
+            if (!slots) {
+                LOG_ERROR("Failed to grow price level queue");
+                return NULL;
+            }
+            level->slots = slots;
+            level->capacity = new_capacity;
+        }
+    }
+
+    return &level->slots[level->tail++];
+}
+
+// Public functions
+PriceLadder* price_ladder_create(bool is_buy_ladder, double tick_size, int num_levels) {
+    if (tick_size <= 0.0 || num_levels <= 0 || num_levels > MAX_LADDER_LEVELS) {
+        LOG_ERROR("Invalid price ladder parameters: tick_size=%.6f, levels=%d",
+                  tick_size, num_levels);
+        return NULL;
+    }
+
+    PriceLadder* ladder = (PriceLadder*)malloc(sizeof(PriceLadder));
+    if (!ladder) {
+        LOG_ERROR("Failed to allocate memory for price ladder");
+        return NULL;
+    }
+
+    ladder->num_levels = round_up_levels(num_levels);
+    ladder->levels = calloc(ladder->num_levels, sizeof(PriceLevel));
+    uint64_t* bitmap = alloc_bitmap(ladder->num_levels);
+    if (!ladder->levels || !bitmap) {
+        LOG_ERROR("Failed to allocate memory for price ladder levels");
+        free(ladder->levels);
+        free(bitmap);
+        free(ladder);
+        return NULL;
+    }
+    attach_bitmap(ladder, bitmap, ladder->num_levels);
+
+    ladder->base_tick = 0;
+    ladder->tick_size = tick_size;
+    ladder->is_buy_ladder = is_buy_ladder;
+    ladder->order_count = 0;
+
+    LOG_INFO("Created new price ladder for %s orders: tick_size=%.6f, levels=%d",
+             is_buy_ladder ? "buy" : "sell", tick_size, ladder->num_levels);
+    return ladder;
+}
+
+void price_ladder_destroy(PriceLadder* ladder) {
+    if (!ladder) {
+        return;
+    }
+
+    LOG_INFO("Destroying price ladder for %s orders",
+             ladder->is_buy_ladder ? "buy" : "sell");
+    for (int i = 0; i < ladder->num_levels; i++) {
+        free(ladder->levels[i].slots);
+    }
+    free(ladder->levels);
+    free(ladder->bitmap);
+    free(ladder);
+}
+
+bool price_ladder_to_tick(const PriceLadder* ladder, double price, int64_t* tick) {
+    if (!ladder || !tick) {
+        return false;
+    }
+
+    // Converting NaN, an infinity or anything beyond int64_t is undefined
+    double scaled = price / ladder->tick_size;
+    if (!isfinite(scaled) || fabs(scaled) >= MAX_TICK_MAGNITUDE) {
+        return false;
+    }
+    int64_t rounded = (int64_t)(scaled + (scaled >= 0 ? 0.5 : -0.5));
+    double diff = scaled - (double)rounded;
+    if (diff > TICK_EPSILON || diff < -TICK_EPSILON) {
+        return false;
+    }
+
+    *tick = rounded;
+    return true;
+}
+
+int price_ladder_insert(PriceLadder* ladder, struct Order* order) {
+    if (!ladder || !order) {
+        LOG_ERROR("Attempted to insert NULL order into price ladder");
+        return -1;
+    }
+
+    int64_t tick;
+    if (!price_ladder_to_tick(ladder, order->price, &tick)) {
+        LOG_ERROR("Price %.6f of order %s is not a multiple of tick size %.6f",
+                  order->price, order_get_id(order), ladder->tick_size);
+        return -1;
+    }
+
+    int index = ensure_tick(ladder, tick);
+    if (index < 0) {
+        return -1;
+    }
+
+    PriceLevel* level = &ladder->levels[index];
+    OrderSlot* slot = push_slot(level);
+    if (!slot) {
+        return -1;
+    }
+    order->ladder_ticket = (uint32_t)(level->tail - 1) + level->shift;
+    slot->price_tick = tick;
+    slot->sequence = order->sequence;
+    slot->remaining_quantity = order->remaining_quantity;
+    slot->flags = (order->is_buy_order ? ORDER_SLOT_BUY : 0) |
+                  (order->is_canceled ? ORDER_SLOT_CANCELED : 0) |
+                  (order->display_quantity > 0 ? ORDER_SLOT_ICEBERG : 0);
+    slot->order = order;
+
+    set_level_bit(ladder, index);
+    ladder->order_count++;
+
+    LOG_DEBUG("Inserted order %s into %s ladder at tick %ld",
+              order_get_id(order), ladder->is_buy_ladder ? "buy" : "sell", tick);
+    return 0;
+}
+
+OrderSlot* price_ladder_best_slot(const PriceLadder* ladder) {
+    if (!ladder) {
+        return NULL;
+    }
+
+    int index = best_level(ladder);
+    if (index < 0) {
+        return NULL;
+    }
+
+    const PriceLevel* level = &ladder->levels[index];
+    return &level->slots[level->head];
+}
+
+struct Order* price_ladder_best(const PriceLadder* ladder) {
+    OrderSlot* slot = price_ladder_best_slot(ladder);
+    return slot ? slot->order : NULL;
+}
+
+void price_ladder_pop_best(PriceLadder* ladder) {
+    if (!ladder) {
+        return;
+    }
+
+    int index = best_level(ladder);
+    if (index < 0) {
+        LOG_WARN("Attempted to pop from empty price ladder");
+        return;
+    }
+
+    PriceLevel* level = &ladder->levels[index];
+    level->head++;
+    ladder->order_count--;
+
+    if (level->head == level->tail) {
+        level->head = level->tail = 0;
+        clear_level_bit(ladder, index);
+    }
+}
+
+int price_ladder_requeue_best(PriceLadder* ladder) {
+    if (!ladder) {
+        return -1;
+    }
+
+    int index = best_level(ladder);
+    if (index < 0) {
+        return -1;
+    }
+
+    // Pushing may move the queue, so the slot is copied out first
+    PriceLevel* level = &ladder->levels[index];
+    OrderSlot moved = level->slots[level->head];
+    OrderSlot* slot = push_slot(level);
+    if (!slot) {
+        return -1;
+    }
+    moved.sequence = moved.order->sequence;
+    moved.remaining_quantity = moved.order->remaining_quantity;
+    moved.order->ladder_ticket = (uint32_t)(level->tail - 1) + level->shift;
+    *slot = moved;
+    level->head++;
+    return 0;
+}
+
+OrderSlot* price_ladder_find(const PriceLadder* ladder, const struct Order* order) {
+    if (!ladder || !order) {
+        return NULL;
+    }
+
+    // Only the order's own level can hold its slot
+    int64_t tick;
+    if (!price_ladder_to_tick(ladder, order->price, &tick)) {
+        return NULL;
+    }
+
+    int64_t index = tick - ladder->base_tick;
+    if (index < 0 || index >= ladder->num_levels) {
+        return NULL;
+    }
+
+    // A ticket left behind by a popped slot may point anywhere, so check it
+    const PriceLevel* level = &ladder->levels[index];
+    uint32_t position = order->ladder_ticket - level->shift;
+    if (position < (uint32_t)level->head || position >= (uint32_t)level->tail ||
+        level->slots[position].order != order) {
+        return NULL;
+    }
+    return &level->slots[position];
+}
+
+void price_ladder_discard(OrderSlot* slot) {
+    if (slot) {
+        slot->flags |= ORDER_SLOT_CANCELED;
+        slot->order = NULL;
+    }
+}
+
+bool price_ladder_is_empty(const PriceLadder* ladder) {
+    return !ladder || ladder->order_count == 0;
+}
+
+int price_ladder_quantity_at(const PriceLadder* ladder, int64_t tick) {
+    if (!ladder) {
+        return 0;
+    }
+
+    int64_t index = tick - ladder->base_tick;
+    if (index < 0 || index >= ladder->num_levels) {
+        return 0;
+    }
+
+    const PriceLevel* level = &ladder->levels[index];
+    int total = 0;
+    for (int i = level->head; i < level->tail; i++) {
+        if (!(level->slots[i].flags & ORDER_SLOT_CANCELED)) {
+            total += level->slots[i].remaining_quantity;
+        }
+    }
+    return total;
+}
+
+int price_ladder_available(const PriceLadder* ladder, bool has_limit, int64_t limit_tick, int wanted) {
+    if (!ladder) {
+        return 0;
+    }
+
+    int lo = first_level(ladder);
+    int hi = last_level(ladder);
+    if (lo < 0) {
+        return 0;
+    }
+
+    int step = ladder->is_buy_ladder ? -1 : 1;
+    int total = 0;
+    for (int i = ladder->is_buy_ladder ? hi : lo; i >= lo && i <= hi && total < wanted; i += step) {
+        int64_t tick = ladder->base_tick + i;
+        if (has_limit && (ladder->is_buy_ladder ? tick < limit_tick : tick > limit_tick)) {
+            break;
+        }
+        const PriceLevel* level = &ladder->levels[i];
+        for (int j = level->head; j < level->tail && total < wanted; j++) {
+            const OrderSlot* slot = &level->slots[j];
+            if (slot->flags & ORDER_SLOT_CANCELED) {
+                continue;
+            }
+            total += slot->remaining_quantity;
+            if (slot->flags & ORDER_SLOT_ICEBERG) {
+                total += slot->order->hidden_quantity;
+            }
+        }
+    }
+    return total;
+}
+
+void price_ladder_traverse(const PriceLadder* ladder, LadderCallback callback, void* user_data) {
+    if (!ladder || !callback) {
+        LOG_ERROR("Invalid parameters for price ladder traversal");
+        return;
+    }
+
+    int words = ladder->num_levels / BITS_PER_WORD;
+    for (int w = 0; w < words; w++) {
+        uint64_t bits = ladder->bitmap[w];
+        while (bits) {
+            int index = w * BITS_PER_WORD + __builtin_ctzll(bits);
+            bits &= bits - 1;
+
+            const PriceLevel* level = &ladder->levels[index];
+            for (int i = level->head; i < level->tail; i++) {
+                if (level->slots[i].order) {
+                    callback(level->slots[i].order, user_data);
+                }
+            }
+        }
+    }
+}
@@ -38,12 +38,16 @@ Trade* trade_create(const char* buy_order_id,
         return NULL;
     }
 
-    strncpy(trade->buy_order_id, buy_order_id, MAX_ORDER_ID_LENGTH - 1);
-    trade->buy_order_id[MAX_ORDER_ID_LENGTH - 1] = '\0';
-    
-    strncpy(trade->sell_order_id, sell_order_id, MAX_ORDER_ID_LENGTH - 1);
-    trade->sell_order_id[MAX_ORDER_ID_LENGTH - 1] = '\0';
-    
+    trade->buy_order = id_intern(buy_order_id);
+    trade->sell_order = id_intern(sell_order_id);
+    if (trade->buy_order == ID_HANDLE_INVALID || trade->sell_order == ID_HANDLE_INVALID) {
+        LOG_ERROR("Failed to intern trade order IDs");
+        id_intern_release(trade->buy_order);
+        id_intern_release(trade->sell_order);
+        free(trade);
+        return NULL;
+    }
+
     trade->trade_price = trade_price;
     trade->trade_quantity = trade_quantity;
 
@@ -56,7 +60,9 @@ Trade* trade_create(const char* buy_order_id,
 void trade_destroy(Trade* trade) {
     if (trade) {
         LOG_DEBUG("Destroying trade between buy order %s and sell order %s",
-                 trade->buy_order_id, trade->sell_order_id);
+                 trade_get_buy_order_id(trade), trade_get_sell_order_id(trade));
+        id_intern_release(trade->buy_order);
+        id_intern_release(trade->sell_order);
         free(trade);
     }
 }
@@ -66,7 +72,7 @@ const char* trade_get_buy_order_id(const Trade* trade) {
         LOG_ERROR("Attempted to get buy order ID from NULL trade");
         return NULL;
     }
-    return trade->buy_order_id;
+    return id_intern_str(trade->buy_order);
 }
 
 const char* trade_get_sell_order_id(const Trade* trade) {
@@ -74,7 +80,7 @@ const char* trade_get_sell_order_id(const Trade* trade) {
         LOG_ERROR("Attempted to get sell order ID from NULL trade");
         return NULL;
     }
-    return trade->sell_order_id;
+    return id_intern_str(trade->sell_order);
 }
 
 double trade_get_price(const Trade* trade) {
@@ -102,7 +108,7 @@ int trade_execute(Trade* trade, Trader* buyer, Trader* seller) {
     double total_amount = trade->trade_price * trade->trade_quantity;
 
     LOG_INFO("Executing trade: Buy Order=%s, Sell Order=%s, Price=%.2f, Quantity=%d, Total=%.2f",
-             trade->buy_order_id, trade->sell_order_id,
+             trade_get_buy_order_id(trade), trade_get_sell_order_id(trade),
              trade->trade_price, trade->trade_quantity, total_amount);
 
     // Update seller's balance
@@ -132,13 +138,13 @@ char* trade_to_string(const Trade* trade) {
 
     snprintf(str, 256,
              "Trade{buy_order=%s, sell_order=%s, price=%.2f, quantity=%d}",
-             trade->buy_order_id,
-             trade->sell_order_id,
+             trade_get_buy_order_id(trade),
+             trade_get_sell_order_id(trade),
              trade->trade_price,
              trade->trade_quantity);
 
     LOG_DEBUG("Created string representation for trade between %s and %s",
-             trade->buy_order_id, trade->sell_order_id);
+             trade_get_buy_order_id(trade), trade_get_sell_order_id(trade));
     
     return str;
 }
@@ -1,5 +1,6 @@
 #include "trading_engine/trade_broadcaster.h"
 #include "utils/logging.h"
+#include "protocol/message_types.h"
 #include <stdlib.h>
 #include <string.h>
 #include <cJSON/cJSON.h>
@@ -37,25 +38,20 @@ void trade_broadcaster_send_trade(TradeBroadcaster* broadcaster,
        return;
    }
 
-   char time_str[32];
-   strftime(time_str, sizeof(time_str), "%Y-%m-%d %H:%M:%S",
-            localtime(&timestamp));
-
+   // Same layout as serialize_trade_message, so clients can use parse_trade_message
    cJSON* trade_msg = cJSON_CreateObject();
-   cJSON_AddNumberToObject(trade_msg, "type", 102);  // Trade notification type
-   
-   cJSON* trade_details = cJSON_CreateObject();
-   cJSON_AddStringToObject(trade_details, "symbol", symbol);
-   cJSON_AddStringToObject(trade_details, "buy_order", buy_order_id);
-   cJSON_AddStringToObject(trade_details, "sell_order", sell_order_id);
-   cJSON_AddNumberToObject(trade_details, "price", price);
-   cJSON_AddNumberToObject(trade_details, "quantity", quantity);
-   cJSON_AddStringToObject(trade_details, "time", time_str);
-   
-   cJSON_AddItemToObject(trade_msg, "trade", trade_details);
+   cJSON_AddNumberToObject(trade_msg, "type", MSG_TRADE_EXECUTED);
+   cJSON_AddStringToObject(trade_msg, "symbol", symbol);
+   cJSON_AddStringToObject(trade_msg, "buy_order_id", buy_order_id);
+   cJSON_AddStringToObject(trade_msg, "sell_order_id", sell_order_id);
+   cJSON_AddNumberToObject(trade_msg, "price", price);
+   cJSON_AddNumberToObject(trade_msg, "quantity", quantity);
+   cJSON_AddNumberToObject(trade_msg, "timestamp", (double)timestamp);
 
-   char* json_str = cJSON_Print(trade_msg);
-   ws_server_broadcast(broadcaster->server, json_str, strlen(json_str));
+   char* json_str = cJSON_PrintUnformatted(trade_msg);
+   if (json_str) {
+       ws_server_broadcast(broadcaster->server, json_str, strlen(json_str));
+   }
    
    free(json_str);
    cJSON_Delete(trade_msg);
@@ -31,9 +31,13 @@ Trader* trader_create(const char* trader_id, const char* name, double balance) {
         return NULL;
     }
 
-    strncpy(trader->trader_id, trader_id, MAX_TRADER_ID_LENGTH - 1);
-    trader->trader_id[MAX_TRADER_ID_LENGTH - 1] = '\0';
-    
+    trader->trader_handle = id_intern(trader_id);
+    if (trader->trader_handle == ID_HANDLE_INVALID) {
+        LOG_ERROR("Failed to intern trader ID");
+        free(trader);
+        return NULL;
+    }
+
     strncpy(trader->name, name, MAX_TRADER_NAME_LENGTH - 1);
     trader->name[MAX_TRADER_NAME_LENGTH - 1] = '\0';
     
@@ -46,7 +50,8 @@ Trader* trader_create(const char* trader_id, const char* name, double balance) {
 
 void trader_destroy(Trader* trader) {
     if (trader) {
-        LOG_INFO("Destroying trader: ID=%s", trader->trader_id);
+        LOG_INFO("Destroying trader: ID=%s", trader_get_id(trader));
+        id_intern_release(trader->trader_handle);
         free(trader);
     }
 }
@@ -56,7 +61,7 @@ const char* trader_get_id(const Trader* trader) {
         LOG_ERROR("Attempted to get ID from NULL trader");
         return NULL;
     }
-    return trader->trader_id;
+    return id_intern_str(trader->trader_handle);
 }
 
 const char* trader_get_name(const Trader* trader) {
@@ -86,9 +91,15 @@ void trader_set_id(Trader* trader, const char* trader_id) {
         return;
     }
 
-    LOG_INFO("Updating trader ID: %s -> %s", trader->trader_id, trader_id);
-    strncpy(trader->trader_id, trader_id, MAX_TRADER_ID_LENGTH - 1);
-    trader->trader_id[MAX_TRADER_ID_LENGTH - 1] = '\0';
+    IdHandle handle = id_intern(trader_id);
+    if (handle == ID_HANDLE_INVALID) {
+        LOG_ERROR("Failed to intern new trader ID");
+        return;
+    }
+
+    LOG_INFO("Updating trader ID: %s -> %s", trader_get_id(trader), trader_id);
+    id_intern_release(trader->trader_handle);
+    trader->trader_handle = handle;
 }
 
 void trader_set_name(Trader* trader, const char* name) {
@@ -115,12 +126,12 @@ void trader_set_balance(Trader* trader, double balance) {
 
     if (balance < 0) {
         LOG_ERROR("Attempted to set negative balance (%.2f) for trader %s",
-                 balance, trader->trader_id);
+                 balance, trader_get_id(trader));
         return;
     }
 
     LOG_INFO("Setting balance for trader %s: %.2f -> %.2f",
-             trader->trader_id, trader->balance, balance);
+             trader_get_id(trader), trader->balance, balance);
     trader->balance = balance;
 }
 
@@ -130,9 +141,9 @@ int trader_place_order(Trader* trader, OrderBook* order_book, const Order* order
         return -1;
     }
 
-    if (strcmp(trader->trader_id, order_get_trader_id(order)) != 0) {
+    if (trader->trader_handle != order->trader_handle) {
         LOG_ERROR("Trader ID mismatch: %s attempting to place order for trader %s",
-                 trader->trader_id, order_get_trader_id(order));
+                 trader_get_id(trader), order_get_trader_id(order));
         return -1;
     }
 
@@ -141,18 +152,18 @@ int trader_place_order(Trader* trader, OrderBook* order_book, const Order* order
         double required_funds = order_get_price(order) * order_get_quantity(order);
         if (required_funds > trader->balance) {
             LOG_ERROR("Insufficient funds for trader %s: required=%.2f, available=%.2f",
-                     trader->trader_id, required_funds, trader->balance);
+                     trader_get_id(trader), required_funds, trader->balance);
             return -1;
         }
         
         // Reserve the funds
         LOG_INFO("Reserving %.2f from trader %s balance for buy order",
-                 required_funds, trader->trader_id);
+                 required_funds, trader_get_id(trader));
         trader->balance -= required_funds;
     }
 
     LOG_INFO("Trader %s placing %s order: Symbol=%s, Price=%.2f, Quantity=%d",
-             trader->trader_id,
+             trader_get_id(trader),
              order_is_buy_order(order) ? "buy" : "sell",
              order_get_symbol(order),
              order_get_price(order),
@@ -170,12 +181,12 @@ void trader_update_balance(Trader* trader, double amount) {
     double new_balance = trader->balance + amount;
     if (new_balance < 0) {
         LOG_ERROR("Balance update would result in negative balance for trader %s",
-                 trader->trader_id);
+                 trader_get_id(trader));
         return;
     }
 
     LOG_INFO("Updating balance for trader %s: %.2f %s %.2f = %.2f",
-             trader->trader_id,
+             trader_get_id(trader),
              trader->balance,
              amount >= 0 ? "+" : "-",
              fabs(amount),
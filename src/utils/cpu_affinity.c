@@ -0,0 +1,117 @@
+#define _GNU_SOURCE
+#include "utils/cpu_affinity.h"
+#include "utils/logging.h"
+#include <ctype.h>
+#include <dirent.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+int cpu_list_parse(const char* spec, CpuList* list) {
+    if (!spec || !list) {
+        return -1;
+    }
+
+    list->count = 0;
+    const char* p = spec;
+    while (*p) {
+        if (!isdigit((unsigned char)*p)) {
+            return -1;
+        }
+        char* end;
+        long first = strtol(p, &end, 10);
+        long last = first;
+        p = end;
+        if (*p == '-') {
+            p++;
+            if (!isdigit((unsigned char)*p)) {
+                return -1;
+            }
+            last = strtol(p, &end, 10);
+            p = end;
+        }
+        if (last < first || last >= CPU_SETSIZE) {
+            return -1;
+        }
+
+        for (long cpu = first; cpu <= last; cpu++) {
+            if (list->count >= MAX_CPU_LIST) {
+                return -1;
+            }
+            list->cpus[list->count++] = (int)cpu;
+        }
+
+        if (*p == ',') {
+            p++;
+            if (!*p) {
+                return -1;
+            }
+        } else if (*p) {
+            return -1;
+        }
+    }
+    return list->count > 0 ? 0 : -1;
+}
+
+// NUMA node of cpu, or -1 when the system does not report one
+static int cpu_numa_node(int cpu) {
+    char path[64];
+    snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%d", cpu);
+
+    DIR* dir = opendir(path);
+    if (!dir) {
+        return -1;
+    }
+
+    int node = -1;
+    struct dirent* entry;
+    while ((entry = readdir(dir)) != NULL) {
+        if (strncmp(entry->d_name, "node", 4) == 0 && isdigit((unsigned char)entry->d_name[4])) {
+            node = atoi(entry->d_name + 4);
+            break;
+        }
+    }
+    closedir(dir);
+    return node;
+}
+
+int cpu_thread_create(pthread_t* thread, const CpuList* cpus, int slot,
+                      void* (*start_routine)(void*), void* arg) {
+    if (!cpus || cpus->count == 0) {
+        return pthread_create(thread, NULL, start_routine, arg) == 0 ? 0 : -1;
+    }
+
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (slot >= 0) {
+        CPU_SET(cpus->cpus[slot % cpus->count], &set);
+    } else {
+        for (int i = 0; i < cpus->count; i++) {
+            CPU_SET(cpus->cpus[i], &set);
+        }
+    }
+
+    // Setting affinity in the attributes rather than after the thread starts
+    // means even its stack is first touched on the right node
+    pthread_attr_t attr;
+    if (pthread_attr_init(&attr) != 0) {
+        return -1;
+    }
+    int result = pthread_attr_setaffinity_np(&attr, sizeof(set), &set);
+    if (result == 0) {
+        result = pthread_create(thread, &attr, start_routine, arg);
+    }
+    pthread_attr_destroy(&attr);
+
+    if (result != 0) {
+        LOG_WARN("Could not place thread on the configured CPUs, starting it unpinned");
+        return pthread_create(thread, NULL, start_routine, arg) == 0 ? 0 : -1;
+    }
+
+    if (slot >= 0) {
+        int cpu = cpus->cpus[slot % cpus->count];
+        LOG_INFO("Started thread on CPU %d (NUMA node %d)", cpu, cpu_numa_node(cpu));
+    }
+    return 0;
+}
@@ -0,0 +1,237 @@
+#include "utils/latency_histogram.h"
+#include "utils/logging.h"
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define SUB_BUCKET_BITS 5
+#define SUB_BUCKET_COUNT (1 << SUB_BUCKET_BITS)
+#define MAX_VALUE_BITS 40
+#define BUCKET_COUNT ((MAX_VALUE_BITS - SUB_BUCKET_BITS + 1) * SUB_BUCKET_COUNT)
+#define MAX_VALUE_NS ((INT64_C(1) << MAX_VALUE_BITS) - 1)
+#define MAX_SHARDS 64  // Threads beyond this share the last shard
+
+typedef struct {
+    _Atomic uint64_t counts[BUCKET_COUNT];
+    _Atomic uint64_t total;
+    _Atomic int64_t sum;
+    _Atomic int64_t min;
+    _Atomic int64_t max;
+} HistogramShard;
+
+struct LatencyHistogram {
+    _Atomic(HistogramShard*) shards[MAX_SHARDS];
+};
+
+// Each thread gets one shard index, shared by every histogram it records into
+static _Atomic unsigned next_thread_slot;
+static __thread int thread_slot = -1;
+
+static int current_slot(void) {
+    if (thread_slot < 0) {
+        unsigned slot = atomic_fetch_add_explicit(&next_thread_slot, 1, memory_order_relaxed);
+        thread_slot = slot < MAX_SHARDS ? (int)slot : MAX_SHARDS - 1;
+    }
+    return thread_slot;
+}
+
+static int bucket_index(int64_t value) {
+    if (value < SUB_BUCKET_COUNT) {
+        return value < 0 ? 0 : (int)value;
+    }
+    if (value > MAX_VALUE_NS) {
+        value = MAX_VALUE_NS;
+    }
+
+    int msb = 63 - __builtin_clzll((unsigned long long)value);
+    int shift = msb - SUB_BUCKET_BITS;
+    int mantissa = (int)((value >> shift) & (SUB_BUCKET_COUNT - 1));
+    return (shift + 1) * SUB_BUCKET_COUNT + mantissa;
+}
+
+// Highest value that maps to the bucket
+static int64_t bucket_value(int index) {
+    if (index < SUB_BUCKET_COUNT) {
+        return index;
+    }
+    int shift = index / SUB_BUCKET_COUNT - 1;
+    int64_t lower = (int64_t)(SUB_BUCKET_COUNT + index % SUB_BUCKET_COUNT) << shift;
+    return lower + (INT64_C(1) << shift) - 1;
+}
+
+LatencyHistogram* latency_histogram_create(void) {
+    LatencyHistogram* histogram = calloc(1, sizeof(LatencyHistogram));
+    if (!histogram) {
+        LOG_ERROR("Failed to allocate latency histogram");
+    }
+    return histogram;
+}
+
+void latency_histogram_destroy(LatencyHistogram* histogram) {
+    if (!histogram) {
+        return;
+    }
+    for (int i = 0; i < MAX_SHARDS; i++) {
+        free(atomic_load(&histogram->shards[i]));
+    }
+    free(histogram);
+}
+
+static HistogramShard* get_shard(LatencyHistogram* histogram) {
+    int slot = current_slot();
+    HistogramShard* shard = atomic_load_explicit(&histogram->shards[slot], memory_order_acquire);
+    if (shard) {
+        return shard;
+    }
+
+    HistogramShard* created = calloc(1, sizeof(HistogramShard));
+    if (!created) {
+        return NULL;
+    }
+    atomic_init(&created->min, INT64_MAX);
+
+    // Only shared overflow slots can race here; the loser frees its copy
+    HistogramShard* expected = NULL;
+    if (!atomic_compare_exchange_strong_explicit(&histogram->shards[slot], &expected, created,
+                                                 memory_order_acq_rel, memory_order_acquire)) {
+        free(created);
+        return expected;
+    }
+    return created;
+}
+
+void latency_histogram_prepare_thread(LatencyHistogram* histogram) {
+    if (histogram) {
+        get_shard(histogram);
+    }
+}
+
+void latency_histogram_record(LatencyHistogram* histogram, int64_t value_ns) {
+    if (!histogram) {
+        return;
+    }
+
+    HistogramShard* shard = get_shard(histogram);
+    if (!shard) {
+        return;
+    }
+
+    if (value_ns < 0) {
+        value_ns = 0;
+    }
+
+    atomic_fetch_add_explicit(&shard->counts[bucket_index(value_ns)], 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&shard->total, 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&shard->sum, value_ns, memory_order_relaxed);
+
+    int64_t current = atomic_load_explicit(&shard->max, memory_order_relaxed);
+    while (value_ns > current &&
+           !atomic_compare_exchange_weak_explicit(&shard->max, &current, value_ns,
+                                                  memory_order_relaxed, memory_order_relaxed)) {
+    }
+    current = atomic_load_explicit(&shard->min, memory_order_relaxed);
+    while (value_ns < current &&
+           !atomic_compare_exchange_weak_explicit(&shard->min, &current, value_ns,
+                                                  memory_order_relaxed, memory_order_relaxed)) {
+    }
+}
+
+typedef struct {
+    uint64_t counts[BUCKET_COUNT];
+    uint64_t total;
+    int64_t sum;
+    int64_t min;
+    int64_t max;
+} MergedHistogram;
+
+static void merge_shards(const LatencyHistogram* histogram, MergedHistogram* merged) {
+    memset(merged, 0, sizeof(*merged));
+    merged->min = INT64_MAX;
+
+    for (int i = 0; i < MAX_SHARDS; i++) {
+        HistogramShard* shard = atomic_load_explicit(
+            &((LatencyHistogram*)histogram)->shards[i], memory_order_acquire);
+        if (!shard) {
+            continue;
+        }
+        for (int b = 0; b < BUCKET_COUNT; b++) {
+            merged->counts[b] += atomic_load_explicit(&shard->counts[b], memory_order_relaxed);
+        }
+        merged->total += atomic_load_explicit(&shard->total, memory_order_relaxed);
+        merged->sum += atomic_load_explicit(&shard->sum, memory_order_relaxed);
+
+        int64_t min = atomic_load_explicit(&shard->min, memory_order_relaxed);
+        int64_t max = atomic_load_explicit(&shard->max, memory_order_relaxed);
+        if (min < merged->min) merged->min = min;
+        if (max > merged->max) merged->max = max;
+    }
+}
+
+static int64_t merged_percentile(const MergedHistogram* merged, double fraction) {
+    if (merged->total == 0) {
+        return 0;
+    }
+
+    // Counts may be read mid-update, so rank against their own sum
+    uint64_t total = 0;
+    for (int b = 0; b < BUCKET_COUNT; b++) {
+        total += merged->counts[b];
+    }
+    uint64_t rank = (uint64_t)(fraction * (double)total);
+    if (rank >= total) {
+        rank = total - 1;
+    }
+
+    uint64_t seen = 0;
+    for (int b = 0; b < BUCKET_COUNT; b++) {
+        seen += merged->counts[b];
+        if (seen > rank) {
+            int64_t value = bucket_value(b);
+            return value < merged->max ? value : merged->max;
+        }
+    }
+    return merged->max;
+}
+
+void latency_histogram_summarize(const LatencyHistogram* histogram, LatencySummary* summary) {
+    if (!summary) {
+        return;
+    }
+    memset(summary, 0, sizeof(*summary));
+    if (!histogram) {
+        return;
+    }
+
+    MergedHistogram* merged = malloc(sizeof(MergedHistogram));
+    if (!merged) {
+        return;
+    }
+    merge_shards(histogram, merged);
+
+    if (merged->total > 0) {
+        summary->count = merged->total;
+        summary->min_ns = merged->min;
+        summary->max_ns = merged->max;
+        summary->mean_ns = (double)merged->sum / (double)merged->total;
+        summary->p50_ns = merged_percentile(merged, 0.50);
+        summary->p90_ns = merged_percentile(merged, 0.90);
+        summary->p99_ns = merged_percentile(merged, 0.99);
+        summary->p999_ns = merged_percentile(merged, 0.999);
+    }
+    free(merged);
+}
+
+int64_t latency_histogram_percentile(const LatencyHistogram* histogram, double fraction) {
+    if (!histogram) {
+        return 0;
+    }
+
+    MergedHistogram* merged = malloc(sizeof(MergedHistogram));
+    if (!merged) {
+        return 0;
+    }
+    merge_shards(histogram, merged);
+    int64_t value = merged_percentile(merged, fraction);
+    free(merged);
+    return value;
+}
@@ -4,12 +4,19 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <strings.h>
 #include <errno.h>
-#include <ctype.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 
-#define MAX_LINE_LENGTH 1024
-#define CSV_DELIMITER ","
-#define TXT_DELIMITER " \t"  // Space or tab for txt files
+#define INITIAL_CHUNK_CAPACITY 1024
+#define MIN_CHUNK_BYTES (1 << 20)  // Files smaller than this are parsed on the calling thread
+#define MAX_LOADER_THREADS 32
+#define MAX_SIDE_LENGTH 8
+#define RAW_BATCH_SIZE 1024        // Lines parsed between acquisitions of the ID intern lock
 
 typedef enum {
     FILE_TYPE_CSV,
@@ -17,105 +24,345 @@ typedef enum {
     FILE_TYPE_UNKNOWN
 } FileType;
 
+// One parsed line, kept until its batch's IDs are interned
+typedef struct {
+    char order_id[MAX_ID_LENGTH];
+    char trader_id[MAX_ID_LENGTH];
+    char symbol[MAX_SYMBOL_LENGTH];
+    double price;
+    int quantity;
+    bool is_buy;
+} RawOrder;
+
+// A newline-aligned slice of the mapped file and the orders parsed from it
+typedef struct {
+    const char* start;
+    const char* end;
+    const char* file_base;
+    FileType file_type;
+    Order** orders;
+    size_t count;
+    size_t capacity;
+    bool failed;
+} LoaderChunk;
+
 static FileType determine_file_type(const char* filename) {
     const char* extension = strrchr(filename, '.');
     if (!extension) {
         return FILE_TYPE_UNKNOWN;
     }
-    
+
     extension++; // Skip the dot
     if (strcasecmp(extension, "csv") == 0) {
         return FILE_TYPE_CSV;
     } else if (strcasecmp(extension, "txt") == 0) {
         return FILE_TYPE_TXT;
     }
-    
+
     return FILE_TYPE_UNKNOWN;
 }
 
-static char* trim_whitespace(char* str) {
-    if (!str) return NULL;
-    
-    // Trim leading space
-    while (isspace((unsigned char)*str)) str++;
+static bool is_blank(char c) {
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+// Returns the next field of a line and advances the cursor past it. CSV fields are
+// comma-separated and trimmed; TXT fields are separated by runs of blanks.
+// *cursor becomes NULL once the last CSV field has been consumed.
+static bool next_field(const char** cursor, const char* end, FileType file_type,
+                       const char** field, size_t* len) {
+    const char* p = *cursor;
+    if (!p) {
+        return false;
+    }
 
-    if (*str == 0) return str;  // All spaces
+    while (p < end && is_blank(*p)) p++;
 
-    // Trim trailing space
-    char* end = str + strlen(str) - 1;
-    while (end > str && isspace((unsigned char)*end)) end--;
+    if (file_type == FILE_TYPE_TXT) {
+        if (p == end) {
+            return false;
+        }
+        const char* q = p;
+        while (q < end && !is_blank(*q)) q++;
+        *field = p;
+        *len = (size_t)(q - p);
+        *cursor = q;
+        return true;
+    }
 
-    end[1] = '\0';
-    return str;
+    const char* comma = memchr(p, ',', (size_t)(end - p));
+    const char* q = comma ? comma : end;
+    *cursor = comma ? comma + 1 : NULL;
+    while (q > p && is_blank(q[-1])) q--;
+    *field = p;
+    *len = (size_t)(q - p);
+    return true;
 }
 
-static Order* parse_order_line(char* line, FileType file_type, int line_number) {
-    char order_id[MAX_ID_LENGTH];
-    char trader_id[MAX_ID_LENGTH];
-    char symbol[MAX_SYMBOL_LENGTH];
-    char side[10];
-    double price;
-    int quantity;
-    const char* delimiter = (file_type == FILE_TYPE_CSV) ? CSV_DELIMITER : TXT_DELIMITER;
-    
-    // Parse line based on file type
-    char* token = strtok(line, delimiter);
-    if (!token) return NULL;
-    strncpy(order_id, trim_whitespace(token), MAX_ID_LENGTH - 1);
-    order_id[MAX_ID_LENGTH - 1] = '\0';
-
-    token = strtok(NULL, delimiter);
-    if (!token) {
-        LOG_ERROR("Line %d: Missing trader ID", line_number);
-        return NULL;
+static bool copy_field(char* dst, size_t dst_size, const char* field, size_t len) {
+    if (len == 0 || len >= dst_size) {
+        return false;
     }
-    strncpy(trader_id, trim_whitespace(token), MAX_ID_LENGTH - 1);
-    trader_id[MAX_ID_LENGTH - 1] = '\0';
+    memcpy(dst, field, len);
+    dst[len] = '\0';
+    return true;
+}
 
-    token = strtok(NULL, delimiter);
-    if (!token) {
-        LOG_ERROR("Line %d: Missing symbol", line_number);
-        return NULL;
+// Parses a positive decimal such as "150.25". Digits are accumulated as an
+// integer and scaled once, which rounds correctly for up to 15 significant digits.
+static bool parse_price(const char* field, size_t len, double* price) {
+    static const double powers_of_ten[] = {
+        1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11, 1e12, 1e13, 1e14, 1e15
+    };
+
+    uint64_t mantissa = 0;
+    int digits = 0;
+    int decimals = -1;
+    for (size_t i = 0; i < len; i++) {
+        char c = field[i];
+        if (c == '.' && decimals < 0) {
+            decimals = 0;
+            continue;
+        }
+        if (c < '0' || c > '9' || digits == 15) {
+            return false;
+        }
+        mantissa = mantissa * 10 + (uint64_t)(c - '0');
+        if (mantissa > 0) digits++;
+        if (decimals >= 0 && ++decimals > 15) {
+            return false;
+        }
     }
-    strncpy(symbol, trim_whitespace(token), MAX_SYMBOL_LENGTH - 1);
-    symbol[MAX_SYMBOL_LENGTH - 1] = '\0';
 
-    token = strtok(NULL, delimiter);
-    if (!token) {
-        LOG_ERROR("Line %d: Missing side", line_number);
-        return NULL;
+    if (mantissa == 0) {
+        return false;
     }
-    strncpy(side, trim_whitespace(token), sizeof(side) - 1);
-    side[sizeof(side) - 1] = '\0';
+    *price = (double)mantissa / powers_of_ten[decimals > 0 ? decimals : 0];
+    return true;
+}
 
-    token = strtok(NULL, delimiter);
-    if (!token) {
-        LOG_ERROR("Line %d: Missing price", line_number);
-        return NULL;
+static bool parse_quantity(const char* field, size_t len, int* quantity) {
+    if (len == 0) {
+        return false;
     }
-    price = atof(trim_whitespace(token));
-    if (price <= 0.0) {
-        LOG_ERROR("Line %d: Invalid price %.2f", line_number, price);
-        return NULL;
+
+    long value = 0;
+    for (size_t i = 0; i < len; i++) {
+        if (field[i] < '0' || field[i] > '9') {
+            return false;
+        }
+        value = value * 10 + (field[i] - '0');
+        if (value > INT32_MAX) {
+            return false;
+        }
     }
 
-    token = strtok(NULL, delimiter);
-    if (!token) {
-        LOG_ERROR("Line %d: Missing quantity", line_number);
-        return NULL;
+    *quantity = (int)value;
+    return value > 0;
+}
+
+static bool parse_order_line(const char* line, const char* line_end, FileType file_type,
+                             size_t offset, RawOrder* raw) {
+    char side[MAX_SIDE_LENGTH];
+    const char* cursor = line;
+    const char* field;
+    size_t len;
+
+    if (!next_field(&cursor, line_end, file_type, &field, &len) ||
+        !copy_field(raw->order_id, sizeof(raw->order_id), field, len)) {
+        LOG_ERROR("Offset %zu: Missing or invalid order ID", offset);
+        return false;
+    }
+
+    if (!next_field(&cursor, line_end, file_type, &field, &len) ||
+        !copy_field(raw->trader_id, sizeof(raw->trader_id), field, len)) {
+        LOG_ERROR("Offset %zu: Missing or invalid trader ID", offset);
+        return false;
+    }
+
+    if (!next_field(&cursor, line_end, file_type, &field, &len) ||
+        !copy_field(raw->symbol, sizeof(raw->symbol), field, len)) {
+        LOG_ERROR("Offset %zu: Missing or invalid symbol", offset);
+        return false;
+    }
+
+    if (!next_field(&cursor, line_end, file_type, &field, &len) ||
+        !copy_field(side, sizeof(side), field, len)) {
+        LOG_ERROR("Offset %zu: Missing side", offset);
+        return false;
+    }
+
+    raw->is_buy = (strcasecmp(side, "BUY") == 0);
+    if (!raw->is_buy && strcasecmp(side, "SELL") != 0) {
+        LOG_ERROR("Offset %zu: Invalid side %s", offset, side);
+        return false;
     }
-    quantity = atoi(trim_whitespace(token));
-    if (quantity <= 0) {
-        LOG_ERROR("Line %d: Invalid quantity %d", line_number, quantity);
+
+    if (!next_field(&cursor, line_end, file_type, &field, &len)) {
+        LOG_ERROR("Offset %zu: Missing price", offset);
+        return false;
+    }
+    if (!parse_price(field, len, &raw->price)) {
+        LOG_ERROR("Offset %zu: Invalid price %.*s", offset, (int)len, field);
+        return false;
+    }
+
+    if (!next_field(&cursor, line_end, file_type, &field, &len)) {
+        LOG_ERROR("Offset %zu: Missing quantity", offset);
+        return false;
+    }
+    if (!parse_quantity(field, len, &raw->quantity)) {
+        LOG_ERROR("Offset %zu: Invalid quantity %.*s", offset, (int)len, field);
+        return false;
+    }
+    return true;
+}
+
+// Interns the IDs of a batch of parsed lines under one acquisition of the
+// intern lock and turns the lines into orders
+static bool create_orders(LoaderChunk* chunk, const RawOrder* raws, size_t n) {
+    if (chunk->capacity - chunk->count < n) {
+        size_t capacity = chunk->capacity ? chunk->capacity : INITIAL_CHUNK_CAPACITY;
+        while (capacity - chunk->count < n) {
+            capacity *= 2;
+        }
+        Order** grown = realloc(chunk->orders, capacity * sizeof(Order*));
+        if (!grown) {
+            LOG_ERROR("Failed to grow order buffer for loader chunk");
+            return false;
+        }
+        chunk->orders = grown;
+        chunk->capacity = capacity;
+    }
+
+    // Order IDs first, then trader IDs
+    const char* ids[2 * RAW_BATCH_SIZE];
+    IdHandle handles[2 * RAW_BATCH_SIZE];
+    for (size_t i = 0; i < n; i++) {
+        ids[i] = raws[i].order_id;
+        ids[n + i] = raws[i].trader_id;
+    }
+    if (id_intern_many(ids, 2 * n, handles) != 0) {
+        return false;
+    }
+
+    bool ok = true;
+    for (size_t i = 0; i < n; i++) {
+        Order* order = order_create_interned(handles[i], handles[n + i], raws[i].symbol,
+                                             raws[i].price, raws[i].quantity, raws[i].is_buy);
+        if (order) {
+            chunk->orders[chunk->count++] = order;
+        } else {
+            ok = false;
+        }
+    }
+    return ok;
+}
+
+static void* parse_chunk(void* arg) {
+    LoaderChunk* chunk = (LoaderChunk*)arg;
+    const char* line = chunk->start;
+
+    RawOrder* raws = malloc(RAW_BATCH_SIZE * sizeof(RawOrder));
+    size_t pending = 0;
+    if (!raws) {
+        LOG_ERROR("Failed to allocate parse buffer for loader chunk");
+        chunk->failed = true;
         return NULL;
     }
 
-    // Create order
-    bool is_buy = (strcasecmp(side, "BUY") == 0);
-    return order_create(order_id, trader_id, symbol, price, quantity, is_buy);
+    while (line < chunk->end) {
+        const char* newline = memchr(line, '\n', (size_t)(chunk->end - line));
+        const char* line_end = newline ? newline : chunk->end;
+        const char* next = newline ? newline + 1 : chunk->end;
+
+        // Skip empty lines and comments
+        const char* p = line;
+        while (p < line_end && is_blank(*p)) p++;
+        if (p == line_end || *p == '#') {
+            line = next;
+            continue;
+        }
+
+        if (parse_order_line(line, line_end, chunk->file_type,
+                             (size_t)(line - chunk->file_base), &raws[pending])) {
+            pending++;
+        }
+        line = next;
+
+        if (pending == RAW_BATCH_SIZE) {
+            if (!create_orders(chunk, raws, pending)) {
+                chunk->failed = true;
+                break;
+            }
+            pending = 0;
+        }
+    }
+
+    if (!chunk->failed && pending > 0 && !create_orders(chunk, raws, pending)) {
+        chunk->failed = true;
+    }
+    free(raws);
+    return NULL;
+}
+
+static int choose_thread_count(size_t bytes, int max_threads) {
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    size_t threads = bytes / MIN_CHUNK_BYTES;
+    if (threads < 1) threads = 1;
+    if (cpus > 0 && threads > (size_t)cpus) threads = (size_t)cpus;
+    if (max_threads > 0 && threads > (size_t)max_threads) threads = (size_t)max_threads;
+    if (threads > MAX_LOADER_THREADS) threads = MAX_LOADER_THREADS;
+    return (int)threads;
+}
+
+// Parses [body, end) on up to MAX_LOADER_THREADS threads, each starting and
+// ending on a line boundary. Chunks are kept in file order.
+static int parse_parallel(const char* base, const char* body, const char* end,
+                          FileType file_type, int max_threads, LoaderChunk* chunks) {
+    int num_chunks = choose_thread_count((size_t)(end - body), max_threads);
+    size_t target = (size_t)(end - body) / (size_t)num_chunks;
+
+    const char* start = body;
+    for (int i = 0; i < num_chunks; i++) {
+        const char* stop = end;
+        if (i < num_chunks - 1 && (size_t)(end - start) > target) {
+            const char* newline = memchr(start + target, '\n', (size_t)(end - start - target));
+            stop = newline ? newline + 1 : end;
+        }
+        chunks[i] = (LoaderChunk){
+            .start = start,
+            .end = stop,
+            .file_base = base,
+            .file_type = file_type
+        };
+        start = stop;
+    }
+
+    pthread_t threads[MAX_LOADER_THREADS];
+    bool started[MAX_LOADER_THREADS] = {false};
+    for (int i = 1; i < num_chunks; i++) {
+        started[i] = pthread_create(&threads[i], NULL, parse_chunk, &chunks[i]) == 0;
+    }
+
+    // The calling thread takes the first chunk, and any chunk whose thread failed to start
+    parse_chunk(&chunks[0]);
+    for (int i = 1; i < num_chunks; i++) {
+        if (started[i]) {
+            pthread_join(threads[i], NULL);
+        } else {
+            parse_chunk(&chunks[i]);
+        }
+    }
+
+    return num_chunks;
 }
 
 int load_orders_from_file(const char* filename, OrderBook* book) {
+    return load_orders_from_file_threads(filename, book, 0);
+}
+
+int load_orders_from_file_threads(const char* filename, OrderBook* book, int max_threads) {
     if (!filename || !book) {
         LOG_ERROR("Invalid parameters for loading orders");
         return -1;
@@ -127,61 +374,96 @@ int load_orders_from_file(const char* filename, OrderBook* book) {
         return -1;
     }
 
-    FILE* file = fopen(filename, "r");
-    if (!file) {
+    int fd = open(filename, O_RDONLY);
+    if (fd < 0) {
         LOG_ERROR("Failed to open file %s: %s", filename, strerror(errno));
         return -1;
     }
 
-    LOG_INFO("Loading orders from %s file: %s", 
-             (file_type == FILE_TYPE_CSV) ? "CSV" : "TXT", 
-             filename);
-
-    char line[MAX_LINE_LENGTH];
-    int orders_loaded = 0;
-    int line_number = 0;
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        LOG_ERROR("Failed to stat file %s: %s", filename, strerror(errno));
+        close(fd);
+        return -1;
+    }
 
-    // Skip header for CSV files only
-    if (file_type == FILE_TYPE_CSV) {
-        if (fgets(line, sizeof(line), file) == NULL) {
+    if (st.st_size == 0) {
+        close(fd);
+        if (file_type == FILE_TYPE_CSV) {
             LOG_ERROR("File %s is empty", filename);
-            fclose(file);
             return -1;
         }
-        line_number++;
+        return 0;
     }
 
-    // Process each line
-    while (fgets(line, sizeof(line), file)) {
-        line_number++;
-        
-        // Remove newline
-        char* newline = strchr(line, '\n');
-        if (newline) *newline = '\0';
+    size_t size = (size_t)st.st_size;
+    char* data = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) {
+        LOG_ERROR("Failed to map file %s: %s", filename, strerror(errno));
+        return -1;
+    }
+    madvise(data, size, MADV_SEQUENTIAL);
 
-        // Skip empty lines and comments
-        char* trimmed_line = trim_whitespace(line);
-        if (strlen(trimmed_line) == 0 || trimmed_line[0] == '#') {
-            continue;
-        }
+    LOG_INFO("Loading orders from %s file: %s (%zu bytes)",
+             (file_type == FILE_TYPE_CSV) ? "CSV" : "TXT", filename, size);
 
-        // Parse and create order
-        Order* order = parse_order_line(line, file_type, line_number);
-        if (!order) {
-            continue;
+    const char* end = data + size;
+    const char* body = data;
+
+    // Skip header for CSV files only
+    if (file_type == FILE_TYPE_CSV) {
+        const char* newline = memchr(data, '\n', size);
+        body = newline ? newline + 1 : end;
+    }
+
+    LoaderChunk chunks[MAX_LOADER_THREADS];
+    int num_chunks = parse_parallel(data, body, end, file_type, max_threads, chunks);
+    munmap(data, size);
+
+    size_t total = 0;
+    bool failed = false;
+    for (int i = 0; i < num_chunks; i++) {
+        total += chunks[i].count;
+        failed |= chunks[i].failed;
+    }
+
+    Order** batch = failed ? NULL : malloc((total ? total : 1) * sizeof(Order*));
+    if (!batch) {
+        LOG_ERROR("Failed to collect parsed orders from %s", filename);
+        for (int i = 0; i < num_chunks; i++) {
+            for (size_t j = 0; j < chunks[i].count; j++) {
+                order_destroy(chunks[i].orders[j]);
+            }
+            free(chunks[i].orders);
         }
+        return -1;
+    }
 
-        // Add order to book
-        if (order_book_add_order(book, order) == 0) {
-            orders_loaded++;
-            LOG_INFO("Loaded order: %s", order_to_string(order));
-        } else {
-            LOG_ERROR("Line %d: Failed to add order to book", line_number);
-            order_destroy(order);
+    // Orders were created concurrently, so re-issue time priority in file order
+    uint64_t sequence = order_reserve_sequences(total);
+    size_t count = 0;
+    for (int i = 0; i < num_chunks; i++) {
+        for (size_t j = 0; j < chunks[i].count; j++) {
+            chunks[i].orders[j]->sequence = sequence++;
+            batch[count++] = chunks[i].orders[j];
         }
+        free(chunks[i].orders);
+    }
+
+    int orders_loaded = order_book_add_orders_bulk(book, batch, count);
+    size_t first_rejected = orders_loaded > 0 ? (size_t)orders_loaded : 0;
+    for (size_t i = first_rejected; i < count; i++) {
+        LOG_ERROR("Failed to add order %s to book", order_get_id(batch[i]));
+        order_destroy(batch[i]);
+    }
+    free(batch);
+
+    if (orders_loaded < 0) {
+        return -1;
     }
 
-    LOG_INFO("Successfully loaded %d orders from %s", orders_loaded, filename);
-    fclose(file);
+    LOG_INFO("Successfully loaded %d orders from %s using %d thread%s",
+             orders_loaded, filename, num_chunks, num_chunks == 1 ? "" : "s");
     return orders_loaded;
 }
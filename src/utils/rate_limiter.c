@@ -0,0 +1,200 @@
+#include "utils/rate_limiter.h"
+#include "utils/logging.h"
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define CACHE_LINE_SIZE 64
+#define RATE_LIMITER_STRIPES 16
+
+typedef struct {
+    char key[RATE_LIMITER_MAX_KEY];  // Empty marks an unused entry
+    uint32_t hash;
+    TokenBucket bucket;
+} RateLimiterEntry;
+
+// Each stripe is an open-addressed table of its own, on its own cache line
+typedef struct {
+    _Alignas(CACHE_LINE_SIZE) pthread_mutex_t lock;
+    RateLimiterEntry* entries;
+    int capacity;
+    int used;
+} RateLimiterStripe;
+
+struct RateLimiter {
+    RateLimit limit;
+    RateLimiterStripe stripes[RATE_LIMITER_STRIPES];
+};
+
+static int bucket_burst(const RateLimit* limit) {
+    return limit->burst > 0 ? limit->burst : 1;
+}
+
+void token_bucket_init(TokenBucket* bucket, const RateLimit* limit, int64_t now_ns) {
+    bucket->tokens = bucket_burst(limit);
+    bucket->last_ns = now_ns;
+}
+
+bool token_bucket_take(TokenBucket* bucket, const RateLimit* limit, int64_t now_ns) {
+    if (limit->rate <= 0) {
+        return true;
+    }
+
+    if (now_ns > bucket->last_ns) {
+        bucket->tokens += limit->rate * (double)(now_ns - bucket->last_ns) / 1e9;
+        if (bucket->tokens > bucket_burst(limit)) {
+            bucket->tokens = bucket_burst(limit);
+        }
+        bucket->last_ns = now_ns;
+    }
+
+    if (bucket->tokens < 1.0) {
+        return false;
+    }
+    bucket->tokens -= 1.0;
+    return true;
+}
+
+RateLimiter* rate_limiter_create(const RateLimit* limit, int capacity) {
+    if (!limit || capacity <= 0) {
+        return NULL;
+    }
+
+    RateLimiter* limiter = aligned_alloc(CACHE_LINE_SIZE, sizeof(RateLimiter));
+    if (!limiter) {
+        LOG_ERROR("Failed to allocate rate limiter");
+        return NULL;
+    }
+    memset(limiter, 0, sizeof(*limiter));
+    limiter->limit = *limit;
+
+    // Twice the share of keys per stripe keeps probe runs short
+    int per_stripe = 2 * ((capacity + RATE_LIMITER_STRIPES - 1) / RATE_LIMITER_STRIPES);
+    for (int i = 0; i < RATE_LIMITER_STRIPES; i++) {
+        RateLimiterStripe* stripe = &limiter->stripes[i];
+        pthread_mutex_init(&stripe->lock, NULL);
+        stripe->capacity = per_stripe;
+        stripe->entries = calloc((size_t)per_stripe, sizeof(RateLimiterEntry));
+        if (!stripe->entries) {
+            LOG_ERROR("Failed to allocate rate limiter table");
+            rate_limiter_destroy(limiter);
+            return NULL;
+        }
+    }
+    return limiter;
+}
+
+void rate_limiter_destroy(RateLimiter* limiter) {
+    if (!limiter) {
+        return;
+    }
+    for (int i = 0; i < RATE_LIMITER_STRIPES; i++) {
+        pthread_mutex_destroy(&limiter->stripes[i].lock);
+        free(limiter->stripes[i].entries);
+    }
+    free(limiter);
+}
+
+static uint32_t hash_key(const char* key) {
+    uint32_t hash = 2166136261u;  // FNV-1a
+    for (const char* p = key; *p; p++) {
+        hash = (hash ^ (uint8_t)*p) * 16777619u;
+    }
+    return hash;
+}
+
+// A bucket that has refilled completely acts exactly like a new one
+static bool bucket_is_idle(const TokenBucket* bucket, const RateLimit* limit, int64_t now_ns) {
+    double elapsed = now_ns > bucket->last_ns ? (double)(now_ns - bucket->last_ns) / 1e9 : 0.0;
+    return bucket->tokens + limit->rate * elapsed >= bucket_burst(limit);
+}
+
+static int home_slot(const RateLimiterStripe* stripe, uint32_t hash) {
+    return (int)((hash / RATE_LIMITER_STRIPES) % (uint32_t)stripe->capacity);
+}
+
+// Empties a slot, moving later entries of its probe run back so lookups
+// still find them
+static void remove_entry(RateLimiterStripe* stripe, int slot) {
+    int hole = slot;
+    for (int next = (slot + 1) % stripe->capacity; stripe->entries[next].key[0];
+         next = (next + 1) % stripe->capacity) {
+        int home = home_slot(stripe, stripe->entries[next].hash);
+        // An entry whose home lies cyclically in (hole, next] must stay put
+        bool stays = hole <= next ? (home > hole && home <= next)
+                                  : (home > hole || home <= next);
+        if (!stays) {
+            stripe->entries[hole] = stripe->entries[next];
+            hole = next;
+        }
+    }
+    memset(&stripe->entries[hole], 0, sizeof(RateLimiterEntry));
+    stripe->used--;
+}
+
+// Frees room in a full stripe: every idle entry goes, or if none is idle
+// the least recently used one
+static void reclaim_entries(RateLimiterStripe* stripe, const RateLimit* limit, int64_t now_ns) {
+    int before = stripe->used;
+    int oldest = -1;
+    for (int i = 0; i < stripe->capacity; i++) {
+        RateLimiterEntry* entry = &stripe->entries[i];
+        // Removal may shift a later entry into this slot, so look again
+        while (entry->key[0] && bucket_is_idle(&entry->bucket, limit, now_ns)) {
+            remove_entry(stripe, i);
+        }
+        if (entry->key[0] &&
+            (oldest < 0 || entry->bucket.last_ns < stripe->entries[oldest].bucket.last_ns)) {
+            oldest = i;
+        }
+    }
+    if (stripe->used == before && oldest >= 0) {
+        remove_entry(stripe, oldest);
+    }
+}
+
+bool rate_limiter_allow(RateLimiter* limiter, const char* key, size_t key_len, int64_t now_ns) {
+    if (!limiter || !key || limiter->limit.rate <= 0) {
+        return true;
+    }
+
+    char name[RATE_LIMITER_MAX_KEY];
+    if (key_len >= sizeof(name)) {
+        key_len = sizeof(name) - 1;
+    }
+    memcpy(name, key, key_len);
+    name[key_len] = '\0';
+    if (!name[0]) {
+        return true;
+    }
+
+    uint32_t hash = hash_key(name);
+    RateLimiterStripe* stripe = &limiter->stripes[hash % RATE_LIMITER_STRIPES];
+    bool allowed = true;
+
+    pthread_mutex_lock(&stripe->lock);
+    int i = home_slot(stripe, hash);
+    while (stripe->entries[i].key[0] && strcmp(stripe->entries[i].key, name) != 0) {
+        i = (i + 1) % stripe->capacity;
+    }
+
+    if (!stripe->entries[i].key[0] && stripe->used >= stripe->capacity / 2) {
+        // Keep the stripe at most half full so probe runs stay short
+        reclaim_entries(stripe, &limiter->limit, now_ns);
+        i = home_slot(stripe, hash);
+        while (stripe->entries[i].key[0]) {
+            i = (i + 1) % stripe->capacity;
+        }
+    }
+
+    RateLimiterEntry* entry = &stripe->entries[i];
+    if (!entry->key[0]) {
+        memcpy(entry->key, name, key_len + 1);
+        entry->hash = hash;
+        token_bucket_init(&entry->bucket, &limiter->limit, now_ns);
+        stripe->used++;
+    }
+    allowed = token_bucket_take(&entry->bucket, &limiter->limit, now_ns);
+    pthread_mutex_unlock(&stripe->lock);
+    return allowed;
+}
@@ -0,0 +1,173 @@
+#include "unity.h"
+#include "protocol/json_protocol.h"
+#include <stdlib.h>
+#include <string.h>
+
+void setUp(void) {}
+void tearDown(void) {}
+
+void test_parse_order_types(void) {
+    OrderMessage order;
+    TEST_ASSERT_TRUE(parse_order_message(
+        "{\"order_id\": \"O1\", \"trader_id\": \"T1\", \"symbol\": \"AAPL\", \"price\": 10,"
+        " \"quantity\": 5, \"is_buy\": true}", &order));
+    TEST_ASSERT_EQUAL_INT(TIME_IN_FORCE_GTC, order.time_in_force);
+    TEST_ASSERT_FALSE(order.is_market);
+
+    TEST_ASSERT_TRUE(parse_order_message(
+        "{\"order_id\": \"O2\", \"trader_id\": \"T1\", \"symbol\": \"AAPL\", \"price\": 10,"
+        " \"quantity\": 5, \"is_buy\": true, \"time_in_force\": \"FOK\"}", &order));
+    TEST_ASSERT_EQUAL_INT(TIME_IN_FORCE_FOK, order.time_in_force);
+
+    // Market orders need no price
+    TEST_ASSERT_TRUE(parse_order_message(
+        "{\"order_id\": \"O3\", \"trader_id\": \"T1\", \"symbol\": \"AAPL\","
+        " \"quantity\": 5, \"is_buy\": false, \"order_type\": \"MARKET\", \"time_in_force\": \"IOC\"}",
+        &order));
+    TEST_ASSERT_TRUE(order.is_market);
+    TEST_ASSERT_EQUAL_INT(TIME_IN_FORCE_IOC, order.time_in_force);
+    TEST_ASSERT_EQUAL_DOUBLE(0.0, order.price);
+
+    TEST_ASSERT_FALSE(parse_order_message(
+        "{\"order_id\": \"O4\", \"trader_id\": \"T1\", \"symbol\": \"AAPL\", \"price\": 10,"
+        " \"quantity\": 5, \"is_buy\": true, \"time_in_force\": \"DAY\"}", &order));
+    TEST_ASSERT_FALSE(parse_order_message(
+        "{\"order_id\": \"O5\", \"trader_id\": \"T1\", \"symbol\": \"AAPL\","
+        " \"quantity\": 5, \"is_buy\": true}", &order));
+
+    // Only resting limit orders may hide quantity
+    TEST_ASSERT_TRUE(parse_order_message(
+        "{\"order_id\": \"O6\", \"trader_id\": \"T1\", \"symbol\": \"AAPL\", \"price\": 10,"
+        " \"quantity\": 500, \"is_buy\": true, \"display_quantity\": 100}", &order));
+    TEST_ASSERT_EQUAL_INT(100, order.display_quantity);
+    TEST_ASSERT_FALSE(parse_order_message(
+        "{\"order_id\": \"O7\", \"trader_id\": \"T1\", \"symbol\": \"AAPL\", \"price\": 10,"
+        " \"quantity\": 500, \"is_buy\": true, \"display_quantity\": 100, \"time_in_force\": \"IOC\"}",
+        &order));
+    TEST_ASSERT_FALSE(parse_order_message(
+        "{\"order_id\": \"O8\", \"trader_id\": \"T1\", \"symbol\": \"AAPL\", \"price\": 10,"
+        " \"quantity\": 500, \"is_buy\": true, \"display_quantity\": 0}", &order));
+}
+
+void test_parse_order_batch(void) {
+    cJSON* root = cJSON_Parse(
+        "{\"type\": 7, \"symbol\": \"AAPL\", \"orders\": ["
+        "{\"order_id\": \"B1\", \"trader_id\": \"T1\", \"price\": 101.5, \"quantity\": 10, \"is_buy\": true},"
+        "{\"order_id\": \"B2\", \"trader_id\": \"T1\", \"price\": 102, \"quantity\": 5, \"is_buy\": false}]}");
+    TEST_ASSERT_NOT_NULL(root);
+
+    OrderMessage orders[MAX_BATCH_ORDERS];
+    TEST_ASSERT_EQUAL_INT(2, parse_order_batch(root, orders));
+    TEST_ASSERT_EQUAL_STRING("B1", orders[0].order_id);
+    TEST_ASSERT_EQUAL_STRING("AAPL", orders[0].symbol);
+    TEST_ASSERT_TRUE(orders[0].is_buy);
+    TEST_ASSERT_EQUAL_DOUBLE(101.5, orders[0].price);
+    TEST_ASSERT_EQUAL_STRING("AAPL", orders[1].symbol);
+    TEST_ASSERT_EQUAL_INT(5, orders[1].quantity);
+    TEST_ASSERT_FALSE(orders[1].is_buy);
+    cJSON_Delete(root);
+}
+
+void test_parse_order_batch_rejects_malformed(void) {
+    OrderMessage orders[MAX_BATCH_ORDERS];
+    const char* bad[] = {
+        "{\"orders\": [{\"order_id\": \"B1\", \"trader_id\": \"T1\", \"price\": 1, \"quantity\": 1, \"is_buy\": true}]}",
+        "{\"symbol\": \"AAPL\", \"orders\": []}",
+        "{\"symbol\": \"AAPL\", \"orders\": [{\"order_id\": \"B1\", \"price\": 1, \"quantity\": 1, \"is_buy\": true}]}",
+        "{\"symbol\": \"AAPL\", \"orders\": [{\"order_id\": \"B1\", \"trader_id\": \"T1\", \"price\": \"1\", \"quantity\": 1, \"is_buy\": true}]}",
+        "{\"symbol\": \"A_SYMBOL_FAR_TOO_LONG\", \"orders\": [{\"order_id\": \"B1\", \"trader_id\": \"T1\", \"price\": 1, \"quantity\": 1, \"is_buy\": true}]}"
+    };
+    for (size_t i = 0; i < sizeof(bad) / sizeof(bad[0]); i++) {
+        cJSON* root = cJSON_Parse(bad[i]);
+        TEST_ASSERT_NOT_NULL(root);
+        TEST_ASSERT_EQUAL_INT(-1, parse_order_batch(root, orders));
+        cJSON_Delete(root);
+    }
+}
+
+static cJSON* create_order_batch(int count) {
+    cJSON* root = cJSON_CreateObject();
+    cJSON_AddStringToObject(root, "symbol", "AAPL");
+    cJSON* entries = cJSON_AddArrayToObject(root, "orders");
+    for (int i = 0; i < count; i++) {
+        cJSON* entry = cJSON_CreateObject();
+        cJSON_AddStringToObject(entry, "order_id", "B");
+        cJSON_AddStringToObject(entry, "trader_id", "T1");
+        cJSON_AddNumberToObject(entry, "price", 100);
+        cJSON_AddNumberToObject(entry, "quantity", 1);
+        cJSON_AddBoolToObject(entry, "is_buy", true);
+        cJSON_AddItemToArray(entries, entry);
+    }
+    return root;
+}
+
+void test_parse_order_batch_limit(void) {
+    OrderMessage orders[MAX_BATCH_ORDERS];
+
+    cJSON* root = create_order_batch(MAX_BATCH_ORDERS);
+    TEST_ASSERT_EQUAL_INT(MAX_BATCH_ORDERS, parse_order_batch(root, orders));
+    cJSON_Delete(root);
+
+    root = create_order_batch(MAX_BATCH_ORDERS + 1);
+    TEST_ASSERT_EQUAL_INT(-1, parse_order_batch(root, orders));
+    cJSON_Delete(root);
+}
+
+void test_parse_cancel_batch(void) {
+    cJSON* root = cJSON_Parse(
+        "{\"type\": 8, \"symbol\": \"MSFT\", \"orders\": ["
+        "{\"order_id\": \"C1\", \"is_buy\": 1}, {\"order_id\": \"C2\", \"is_buy\": false}]}");
+    TEST_ASSERT_NOT_NULL(root);
+
+    char symbol[16];
+    CancelMessage cancels[MAX_BATCH_ORDERS];
+    TEST_ASSERT_EQUAL_INT(2, parse_cancel_batch(root, symbol, sizeof(symbol), cancels));
+    TEST_ASSERT_EQUAL_STRING("MSFT", symbol);
+    TEST_ASSERT_EQUAL_STRING("C1", cancels[0].order_id);
+    TEST_ASSERT_TRUE(cancels[0].is_buy);
+    TEST_ASSERT_FALSE(cancels[1].is_buy);
+    cJSON_Delete(root);
+}
+
+void test_serialize_batch_ack(void) {
+    BatchAck ack = {.request_type = MSG_PLACE_ORDER_BATCH, .symbol = "AAPL", .count = 2};
+    strcpy(ack.results[0].order_id, "B1");
+    ack.results[0].accepted = true;
+    strcpy(ack.results[1].order_id, "B2");
+    strcpy(ack.results[1].reason, "Failed to place order");
+
+    char* json = serialize_batch_ack(&ack);
+    TEST_ASSERT_NOT_NULL(json);
+    cJSON* root = cJSON_Parse(json);
+    TEST_ASSERT_NOT_NULL(root);
+
+    TEST_ASSERT_EQUAL_INT(MSG_BATCH_ACK, cJSON_GetObjectItem(root, "type")->valueint);
+    TEST_ASSERT_EQUAL_INT(1, cJSON_GetObjectItem(root, "accepted")->valueint);
+    TEST_ASSERT_EQUAL_INT(1, cJSON_GetObjectItem(root, "rejected")->valueint);
+
+    cJSON* results = cJSON_GetObjectItem(root, "results");
+    TEST_ASSERT_EQUAL_INT(2, cJSON_GetArraySize(results));
+    cJSON* first = cJSON_GetArrayItem(results, 0);
+    cJSON* second = cJSON_GetArrayItem(results, 1);
+    TEST_ASSERT_EQUAL_STRING("accepted", cJSON_GetObjectItem(first, "status")->valuestring);
+    TEST_ASSERT_NULL(cJSON_GetObjectItem(first, "reason"));
+    TEST_ASSERT_EQUAL_STRING("B2", cJSON_GetObjectItem(second, "order_id")->valuestring);
+    TEST_ASSERT_EQUAL_STRING("Failed to place order",
+                             cJSON_GetObjectItem(second, "reason")->valuestring);
+
+    cJSON_Delete(root);
+    free(json);
+}
+
+int main(void) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_parse_order_types);
+    RUN_TEST(test_parse_order_batch);
+    RUN_TEST(test_parse_order_batch_rejects_malformed);
+    RUN_TEST(test_parse_order_batch_limit);
+    RUN_TEST(test_parse_cancel_batch);
+    RUN_TEST(test_serialize_batch_ack);
+
+    return UNITY_END();
+}
@@ -0,0 +1,82 @@
+#include "unity.h"
+#include "server/server_metrics.h"
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+
+ServerMetrics* metrics;
+
+void setUp(void) {
+    metrics = server_metrics_create();
+}
+
+void tearDown(void) {
+    server_metrics_destroy(metrics);
+}
+
+void test_counts_and_names(void) {
+    server_metrics_add(metrics, METRIC_ORDERS_IN, 1);
+    server_metrics_add(metrics, METRIC_ORDERS_IN, 1);
+    server_metrics_add(metrics, METRIC_BYTES_IN, 512);
+    server_metrics_add(NULL, METRIC_ORDERS_IN, 1);
+
+    TEST_ASSERT_EQUAL_UINT64(2, server_metrics_read(metrics, METRIC_ORDERS_IN));
+    TEST_ASSERT_EQUAL_UINT64(512, server_metrics_read(metrics, METRIC_BYTES_IN));
+    TEST_ASSERT_EQUAL_UINT64(0, server_metrics_read(metrics, METRIC_TRADES));
+
+    StatusCounter counters[MAX_STATUS_COUNTERS];
+    int count = server_metrics_summarize(metrics, counters, MAX_STATUS_COUNTERS);
+    TEST_ASSERT_EQUAL_INT(METRIC_COUNT, count);
+    TEST_ASSERT_EQUAL_STRING("orders_in", counters[METRIC_ORDERS_IN].name);
+    TEST_ASSERT_EQUAL_UINT64(2, counters[METRIC_ORDERS_IN].value);
+    TEST_ASSERT_EQUAL_STRING("queue_full_drops", counters[METRIC_QUEUE_FULL_DROPS].name);
+}
+
+static void* count_from_thread(void* arg) {
+    (void)arg;
+    for (int i = 0; i < 100000; i++) {
+        server_metrics_add(metrics, METRIC_ACKS_OUT, 1);
+    }
+    return NULL;
+}
+
+// Per-thread shards are summed when read
+void test_sums_threads(void) {
+    pthread_t threads[4];
+    for (int i = 0; i < 4; i++) {
+        pthread_create(&threads[i], NULL, count_from_thread, NULL);
+    }
+    for (int i = 0; i < 4; i++) {
+        pthread_join(threads[i], NULL);
+    }
+
+    TEST_ASSERT_EQUAL_UINT64(400000, server_metrics_read(metrics, METRIC_ACKS_OUT));
+}
+
+void test_format_text(void) {
+    server_metrics_add(metrics, METRIC_TRADES, 3);
+
+    ServerStatus status = {0};
+    status.num_connected_clients = 2;
+    status.num_counters = server_metrics_summarize(metrics, status.counters, MAX_STATUS_COUNTERS);
+    status.num_symbols = 1;
+    strcpy(status.symbols[0].symbol, "AAPL");
+    status.symbols[0].active_orders = 7;
+
+    char* text = server_metrics_format_text(&status);
+    TEST_ASSERT_NOT_NULL(text);
+    TEST_ASSERT_NOT_NULL(strstr(text, "quant_trades_total 3\n"));
+    TEST_ASSERT_NOT_NULL(strstr(text, "quant_connected_clients 2\n"));
+    TEST_ASSERT_NOT_NULL(strstr(text, "quant_active_orders{symbol=\"AAPL\"} 7\n"));
+    free(text);
+}
+
+int main(void) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_counts_and_names);
+    RUN_TEST(test_sums_threads);
+    RUN_TEST(test_format_text);
+
+    return UNITY_END();
+}
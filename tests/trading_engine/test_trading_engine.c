@@ -4,8 +4,12 @@
 #include "trading_engine/order.h"
 #include "trading_engine/trade.h"
 #include "trading_engine/trade_broadcaster.h"
+#include "trading_engine/book_snapshot.h"
 #include "utils/logging.h"
-#include <unistd.h>
+#include <math.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
 
 // Test fixtures
 OrderBook* book;
@@ -89,7 +93,6 @@ void test_time_priority(void) {
     
     // Create multiple sell orders at same price
     Order* sell1 = order_create("SELL1", "TRADER2", "AAPL", 150.0, 100, false);
-    sleep(1); // Ensure different timestamps
     Order* sell2 = order_create("SELL2", "TRADER2", "AAPL", 150.0, 100, false);
     
     // Add orders
@@ -201,6 +204,776 @@ void test_multiple_matches(void) {
     order_destroy(sell1);
 }
 
+// Dense backend: best level found through the bitmap
+void test_dense_book_price_priority(void) {
+    OrderBookConfig config = {
+        .backend = ORDER_BOOK_BACKEND_DENSE,
+        .tick_size = 0.01,
+        .num_levels = 128,
+        .trade_broadcaster = NULL
+    };
+    OrderBook* dense = order_book_create_with_config(&config);
+    TEST_ASSERT_NOT_NULL(dense);
+
+    Order* sell1 = order_create("SELL1", "TRADER2", "AAPL", 150.02, 100, false);
+    Order* sell2 = order_create("SELL2", "TRADER2", "AAPL", 150.01, 100, false);
+    Order* buy = order_create("BUY1", "TRADER1", "AAPL", 150.02, 150, true);
+
+    TEST_ASSERT_EQUAL_INT(0, order_book_add_order(dense, sell1));
+    TEST_ASSERT_EQUAL_INT(0, order_book_add_order(dense, sell2));
+    TEST_ASSERT_EQUAL_INT(0, order_book_add_order(dense, buy));
+
+    order_book_match_orders(dense);
+
+    TEST_ASSERT_EQUAL_INT(0, order_get_remaining_quantity(sell2));   // 150.01 matched first
+    TEST_ASSERT_EQUAL_INT(50, order_get_remaining_quantity(sell1));
+    TEST_ASSERT_EQUAL_INT(0, order_get_remaining_quantity(buy));
+    TEST_ASSERT_EQUAL_INT(50, order_book_get_quantity_at_price(dense, 150.02, false));
+
+    order_book_destroy(dense);
+    order_destroy(sell1);
+    order_destroy(sell2);
+    order_destroy(buy);
+}
+
+// Dense backend: prices outside the initial window re-center the ladder
+void test_dense_book_recenter(void) {
+    OrderBookConfig config = {
+        .backend = ORDER_BOOK_BACKEND_DENSE,
+        .tick_size = 0.01,
+        .num_levels = 64,
+        .trade_broadcaster = NULL
+    };
+    OrderBook* dense = order_book_create_with_config(&config);
+
+    Order* buy1 = order_create("BUY1", "TRADER1", "AAPL", 100.00, 10, true);
+    Order* buy2 = order_create("BUY2", "TRADER1", "AAPL", 100.50, 10, true);
+    Order* buy3 = order_create("BUY3", "TRADER1", "AAPL", 110.00, 10, true);
+    Order* off_tick = order_create("BUY4", "TRADER1", "AAPL", 100.005, 10, true);
+
+    TEST_ASSERT_EQUAL_INT(0, order_book_add_order(dense, buy1));
+    TEST_ASSERT_EQUAL_INT(0, order_book_add_order(dense, buy2));
+    TEST_ASSERT_EQUAL_INT(0, order_book_add_order(dense, buy3));
+    TEST_ASSERT_EQUAL_INT(-1, order_book_add_order(dense, off_tick));
+
+    // Prices with no tick index are refused rather than converted
+    const double unrepresentable[] = {1e300, -1e300, INFINITY, NAN};
+    for (size_t i = 0; i < sizeof(unrepresentable) / sizeof(unrepresentable[0]); i++) {
+        Order* huge = order_create("BUY5", "TRADER1", "AAPL", unrepresentable[i], 10, true);
+        TEST_ASSERT_EQUAL_INT(-1, order_book_add_order(dense, huge));
+        order_destroy(huge);
+    }
+
+    TEST_ASSERT_EQUAL_INT(10, order_book_get_quantity_at_price(dense, 100.00, true));
+    TEST_ASSERT_EQUAL_INT(10, order_book_get_quantity_at_price(dense, 100.50, true));
+    TEST_ASSERT_EQUAL_INT(10, order_book_get_quantity_at_price(dense, 110.00, true));
+
+    Order* sell = order_create("SELL1", "TRADER2", "AAPL", 100.50, 20, false);
+    order_book_add_order(dense, sell);
+    order_book_match_orders(dense);
+
+    TEST_ASSERT_EQUAL_INT(0, order_get_remaining_quantity(buy3));
+    TEST_ASSERT_EQUAL_INT(0, order_get_remaining_quantity(buy2));
+    TEST_ASSERT_EQUAL_INT(10, order_get_remaining_quantity(buy1));
+
+    order_book_destroy(dense);
+    order_destroy(buy1);
+    order_destroy(buy2);
+    order_destroy(buy3);
+    order_destroy(off_tick);
+    order_destroy(sell);
+}
+
+// Best levels far apart in a wide window are still found from either end
+void test_dense_book_wide_window(void) {
+    OrderBookConfig config = {
+        .backend = ORDER_BOOK_BACKEND_DENSE,
+        .tick_size = 0.01,
+        .num_levels = 64,
+        .trade_broadcaster = NULL
+    };
+    OrderBook* dense = order_book_create_with_config(&config);
+
+    Order* low = order_create("BUY1", "TRADER1", "AAPL", 1.00, 10, true);
+    Order* high = order_create("BUY2", "TRADER1", "AAPL", 90.00, 10, true);
+    TEST_ASSERT_EQUAL_INT(0, order_book_add_order(dense, low));
+    TEST_ASSERT_EQUAL_INT(0, order_book_add_order(dense, high));
+
+    Order* sell1 = order_create("SELL1", "TRADER2", "AAPL", 1.00, 10, false);
+    order_book_add_order(dense, sell1);
+    order_book_match_orders(dense);
+    TEST_ASSERT_EQUAL_INT(0, order_get_remaining_quantity(high));
+    TEST_ASSERT_EQUAL_INT(10, order_get_remaining_quantity(low));
+
+    Order* sell2 = order_create("SELL2", "TRADER2", "AAPL", 1.00, 10, false);
+    order_book_add_order(dense, sell2);
+    order_book_match_orders(dense);
+    TEST_ASSERT_EQUAL_INT(0, order_get_remaining_quantity(low));
+
+    order_book_destroy(dense);
+    order_destroy(low);
+    order_destroy(high);
+    order_destroy(sell1);
+    order_destroy(sell2);
+}
+
+// Dense backend: canceled orders are skipped by the matcher
+void test_dense_book_cancellation(void) {
+    OrderBookConfig config = {
+        .backend = ORDER_BOOK_BACKEND_DENSE,
+        .tick_size = 0.01,
+        .num_levels = 64,
+        .trade_broadcaster = NULL
+    };
+    OrderBook* dense = order_book_create_with_config(&config);
+
+    Order* sell1 = order_create("SELL1", "TRADER2", "AAPL", 150.00, 100, false);
+    Order* sell2 = order_create("SELL2", "TRADER2", "AAPL", 150.00, 100, false);
+    Order* buy = order_create("BUY1", "TRADER1", "AAPL", 150.00, 100, true);
+
+    order_book_add_order(dense, sell1);
+    order_book_add_order(dense, sell2);
+    TEST_ASSERT_EQUAL_INT(0, order_book_cancel_order(dense, "SELL1", false));
+    TEST_ASSERT_EQUAL_INT(-1, order_book_cancel_order(dense, "SELL1", false));
+
+    order_book_add_order(dense, buy);
+    order_book_match_orders(dense);
+
+    TEST_ASSERT_EQUAL_INT(100, order_get_remaining_quantity(sell1));
+    TEST_ASSERT_EQUAL_INT(0, order_get_remaining_quantity(sell2));
+    TEST_ASSERT_EQUAL_INT(0, order_get_remaining_quantity(buy));
+
+    order_book_destroy(dense);
+    order_destroy(sell1);
+    order_destroy(sell2);
+    order_destroy(buy);
+}
+
+// Same-price buys created back to back all rest and fill in arrival order
+// Cancels find their slot directly even after the level queue has been compacted
+void test_dense_book_cancel_after_compaction(void) {
+    OrderBookConfig config = {
+        .backend = ORDER_BOOK_BACKEND_DENSE,
+        .tick_size = 0.01,
+        .num_levels = 64,
+        .trade_broadcaster = NULL
+    };
+    OrderBook* dense = order_book_create_with_config(&config);
+
+    enum { COUNT = 24 };
+    Order* sells[COUNT];
+    char id[16];
+    for (int i = 0; i < COUNT; i++) {
+        snprintf(id, sizeof(id), "SELL%d", i);
+        sells[i] = order_create(id, "TRADER2", "AAPL", 150.00, 10, false);
+        order_book_add_order(dense, sells[i]);
+        if (i == 11) {
+            // Fill the first ten so later inserts move the queue down
+            Order* buy = order_create("BUY1", "TRADER1", "AAPL", 150.00, 100, true);
+            order_book_add_order(dense, buy);
+            order_book_match_orders(dense);
+            order_destroy(buy);
+        }
+    }
+
+    TEST_ASSERT_EQUAL_INT(140, order_book_get_quantity_at_price(dense, 150.00, false));
+    TEST_ASSERT_EQUAL_INT(-1, order_book_cancel_order(dense, "SELL3", false));
+    TEST_ASSERT_EQUAL_INT(0, order_book_cancel_order(dense, "SELL11", false));
+    TEST_ASSERT_EQUAL_INT(0, order_book_cancel_order(dense, "SELL23", false));
+    TEST_ASSERT_EQUAL_INT(120, order_book_get_quantity_at_price(dense, 150.00, false));
+
+    order_book_destroy(dense);
+    for (int i = 0; i < COUNT; i++) {
+        order_destroy(sells[i]);
+    }
+}
+
+void test_buy_time_priority_same_instant(void) {
+    Order* buy1 = order_create("BUY1", "TRADER1", "AAPL", 150.0, 100, true);
+    Order* buy2 = order_create("BUY2", "TRADER1", "AAPL", 150.0, 100, true);
+    Order* buy3 = order_create("BUY3", "TRADER1", "AAPL", 150.0, 100, true);
+    TEST_ASSERT_TRUE(order_get_sequence(buy1) < order_get_sequence(buy2));
+    TEST_ASSERT_TRUE(order_get_timestamp(buy1) <= order_get_timestamp(buy2));
+
+    order_book_add_order(book, buy1);
+    order_book_add_order(book, buy2);
+    order_book_add_order(book, buy3);
+    TEST_ASSERT_EQUAL_INT(300, order_book_get_quantity_at_price(book, 150.0, true));
+
+    Order* sell = order_create("SELL1", "TRADER2", "AAPL", 150.0, 150, false);
+    order_book_add_order(book, sell);
+    order_book_match_orders(book);
+
+    TEST_ASSERT_EQUAL_INT(0, order_get_remaining_quantity(buy1));
+    TEST_ASSERT_EQUAL_INT(50, order_get_remaining_quantity(buy2));
+    TEST_ASSERT_EQUAL_INT(100, order_get_remaining_quantity(buy3));
+
+    order_destroy(buy1);
+    order_destroy(buy2);
+    order_destroy(buy3);
+    order_destroy(sell);
+}
+
+// IDs are interned once and shared by every structure that carries them
+void test_interned_ids(void) {
+    Order* first = order_create("ORD-7", "TRADER1", "AAPL", 150.0, 10, true);
+    Order* second = order_create("ORD-7", "TRADER1", "AAPL", 151.0, 20, true);
+
+    TEST_ASSERT_EQUAL_UINT64(first->order_handle, second->order_handle);
+    TEST_ASSERT_EQUAL_UINT64(test_buyer->trader_handle, first->trader_handle);
+    TEST_ASSERT_TRUE(order_equals(first, second));
+    TEST_ASSERT_EQUAL_STRING("ORD-7", order_get_id(second));
+    TEST_ASSERT_EQUAL_UINT64(ID_HANDLE_INVALID, id_intern_find("NEVER-SEEN"));
+
+    order_destroy(first);
+    order_destroy(second);
+}
+
+// Released IDs leave the table and their handles are reused
+void test_intern_release(void) {
+    size_t base = id_intern_count();
+    IdHandle handle = id_intern("REL-1");
+    TEST_ASSERT_EQUAL_UINT64(handle, id_intern("REL-1"));
+    TEST_ASSERT_EQUAL_size_t(base + 1, id_intern_count());
+
+    id_intern_release(handle);
+    TEST_ASSERT_EQUAL_UINT64(handle, id_intern_find("REL-1"));
+    id_intern_release(handle);
+    TEST_ASSERT_EQUAL_UINT64(ID_HANDLE_INVALID, id_intern_find("REL-1"));
+    TEST_ASSERT_EQUAL_size_t(base, id_intern_count());
+
+    IdHandle reused = id_intern("REL-2");
+    TEST_ASSERT_EQUAL_UINT64(handle, reused);
+    TEST_ASSERT_EQUAL_STRING("REL-2", id_intern_str(reused));
+    id_intern_release(reused);
+
+    // Enough IDs to grow the table, then release every other one so that
+    // removals land in the middle of probe runs
+    enum { COUNT = 5000 };
+    static IdHandle handles[COUNT];
+    char id[32];
+    for (int i = 0; i < COUNT; i++) {
+        snprintf(id, sizeof(id), "BULK-%d", i);
+        handles[i] = id_intern(id);
+        TEST_ASSERT_NOT_EQUAL(ID_HANDLE_INVALID, handles[i]);
+    }
+    for (int i = 0; i < COUNT; i += 2) {
+        id_intern_release(handles[i]);
+    }
+    TEST_ASSERT_EQUAL_size_t(base + COUNT / 2, id_intern_count());
+    for (int i = 0; i < COUNT; i++) {
+        snprintf(id, sizeof(id), "BULK-%d", i);
+        TEST_ASSERT_EQUAL_UINT64(i % 2 ? handles[i] : ID_HANDLE_INVALID, id_intern_find(id));
+    }
+    for (int i = 0; i < COUNT; i += 2) {
+        snprintf(id, sizeof(id), "BULK-%d", i);
+        handles[i] = id_intern(id);
+    }
+    for (int i = 0; i < COUNT; i++) {
+        snprintf(id, sizeof(id), "BULK-%d", i);
+        TEST_ASSERT_EQUAL_UINT64(handles[i], id_intern_find(id));
+        id_intern_release(handles[i]);
+    }
+    TEST_ASSERT_EQUAL_size_t(base, id_intern_count());
+}
+
+// An adopted order is freed by the book when it leaves, so its ID goes too
+void test_adopted_orders(void) {
+    Order* filled = order_create("ADOPT-1", "TRADER2", "AAPL", 150.0, 100, false);
+    Order* crossing = order_create("ADOPT-2", "TRADER1", "AAPL", 151.0, 40, true);
+    Order* resting = order_create("ADOPT-3", "TRADER2", "AAPL", 152.0, 100, false);
+    Order* canceled = order_create("ADOPT-4", "TRADER2", "AAPL", 153.0, 100, false);
+
+    TEST_ASSERT_EQUAL_INT(0, order_book_add_order(book, filled));
+    order_book_adopt_order(book, filled);
+    TEST_ASSERT_EQUAL_INT(0, order_book_add_order(book, resting));
+    order_book_adopt_order(book, resting);
+    TEST_ASSERT_EQUAL_INT(0, order_book_add_order(book, canceled));
+    order_book_adopt_order(book, canceled);
+    TEST_ASSERT_EQUAL_INT(0, order_book_cancel_order(book, "ADOPT-4", false));
+
+    // The taker is filled and gone by the time it is adopted
+    TEST_ASSERT_EQUAL_INT(0, order_book_add_order(book, crossing));
+    order_book_match_orders(book);
+    order_book_adopt_order(book, crossing);
+    TEST_ASSERT_EQUAL_UINT64(ID_HANDLE_INVALID, id_intern_find("ADOPT-2"));
+    TEST_ASSERT_EQUAL_INT(60, order_get_remaining_quantity(filled));
+
+    Order* taker = order_create("ADOPT-5", "TRADER1", "AAPL", 150.0, 60, true);
+    taker->time_in_force = ORDER_TIF_IOC;
+    TEST_ASSERT_EQUAL_INT(60, order_book_execute_order(book, taker));
+    order_destroy(taker);
+    TEST_ASSERT_EQUAL_UINT64(ID_HANDLE_INVALID, id_intern_find("ADOPT-1"));
+
+    // The resting and the canceled order go with the book in tearDown
+    TEST_ASSERT_NOT_EQUAL(ID_HANDLE_INVALID, id_intern_find("ADOPT-3"));
+    TEST_ASSERT_NOT_EQUAL(ID_HANDLE_INVALID, id_intern_find("ADOPT-4"));
+}
+
+// AVL cancel goes through the ID index; live IDs cannot be reused until canceled
+void test_cancel_by_id(void) {
+    Order* sell1 = order_create("SELL1", "TRADER2", "AAPL", 150.0, 100, false);
+    Order* sell2 = order_create("SELL2", "TRADER2", "AAPL", 151.0, 100, false);
+    Order* reused = order_create("SELL1", "TRADER2", "AAPL", 152.0, 100, false);
+
+    TEST_ASSERT_EQUAL_INT(0, order_book_add_order(book, sell1));
+    TEST_ASSERT_EQUAL_INT(0, order_book_add_order(book, sell2));
+    TEST_ASSERT_EQUAL_INT(-1, order_book_add_order(book, reused));
+
+    TEST_ASSERT_EQUAL_INT(-1, order_book_cancel_order(book, "SELL2", true));
+    TEST_ASSERT_EQUAL_INT(0, order_book_cancel_order(book, "SELL2", false));
+    TEST_ASSERT_TRUE(order_is_canceled(sell2));
+    TEST_ASSERT_FALSE(order_book_is_order_canceled(book, "SELL1", false));
+    TEST_ASSERT_TRUE(order_book_is_order_canceled(book, "SELL2", false));
+
+    TEST_ASSERT_EQUAL_INT(0, order_book_cancel_order(book, "SELL1", false));
+    TEST_ASSERT_EQUAL_INT(0, order_book_add_order(book, reused));
+
+    order_destroy(sell1);
+    order_destroy(sell2);
+    order_destroy(reused);
+}
+
+// Lowering quantity keeps queue priority; repricing or raising it requeues
+static void check_modify_priority(OrderBook* target) {
+    Order* sell1 = order_create("SELL1", "TRADER2", "AAPL", 150.00, 100, false);
+    Order* sell2 = order_create("SELL2", "TRADER2", "AAPL", 150.00, 100, false);
+    Order* sell3 = order_create("SELL3", "TRADER2", "AAPL", 151.00, 100, false);
+    Order* buy = order_create("BUY1", "TRADER1", "AAPL", 150.00, 60, true);
+
+    order_book_add_order(target, sell1);
+    order_book_add_order(target, sell2);
+    order_book_add_order(target, sell3);
+
+    TEST_ASSERT_EQUAL_INT(-1, order_book_modify_order(target, "SELL1", true, 150.00, 50,
+                                                      order_next_sequence()));
+    TEST_ASSERT_EQUAL_INT(-1, order_book_modify_order(target, "SELL1", false, 150.00, 0,
+                                                      order_next_sequence()));
+    TEST_ASSERT_EQUAL_INT(0, order_book_modify_order(target, "SELL1", false, 150.00, 50,
+                                                     order_next_sequence()));
+    TEST_ASSERT_EQUAL_INT(150, order_book_get_quantity_at_price(target, 150.00, false));
+
+    // SELL3 moves to 150 behind SELL2, then SELL2 grows and drops behind SELL3
+    TEST_ASSERT_EQUAL_INT(0, order_book_modify_order(target, "SELL3", false, 150.00, 100,
+                                                     order_next_sequence()));
+    TEST_ASSERT_EQUAL_INT(0, order_book_modify_order(target, "SELL2", false, 150.00, 120,
+                                                     order_next_sequence()));
+    TEST_ASSERT_EQUAL_INT(0, order_book_get_quantity_at_price(target, 151.00, false));
+    TEST_ASSERT_EQUAL_INT(270, order_book_get_quantity_at_price(target, 150.00, false));
+
+    // A fill-or-kill sizes the level from the modified quantities
+    Order* fok = order_create("FOK1", "TRADER1", "AAPL", 150.00, 280, true);
+    fok->time_in_force = ORDER_TIF_FOK;
+    TEST_ASSERT_EQUAL_INT(0, order_book_execute_order(target, fok));
+    order_destroy(fok);
+
+    order_book_add_order(target, buy);
+    order_book_match_orders(target);
+
+    TEST_ASSERT_EQUAL_INT(0, order_get_remaining_quantity(sell1));
+    TEST_ASSERT_EQUAL_INT(90, order_get_remaining_quantity(sell3));
+    TEST_ASSERT_EQUAL_INT(120, order_get_remaining_quantity(sell2));
+    TEST_ASSERT_EQUAL_INT(50, order_get_quantity(sell1));
+    TEST_ASSERT_EQUAL_INT(-1, order_book_modify_order(target, "SELL1", false, 150.00, 10,
+                                                      order_next_sequence()));
+
+    order_destroy(sell1);
+    order_destroy(sell2);
+    order_destroy(sell3);
+    order_destroy(buy);
+}
+
+void test_modify_order(void) {
+    check_modify_priority(book);
+}
+
+void test_dense_book_modify(void) {
+    OrderBookConfig config = {
+        .backend = ORDER_BOOK_BACKEND_DENSE,
+        .tick_size = 0.01,
+        .num_levels = 64,
+        .trade_broadcaster = NULL
+    };
+    OrderBook* dense = order_book_create_with_config(&config);
+
+    check_modify_priority(dense);
+
+    // An off-tick price is refused without touching the order
+    Order* buy = order_create("BUY2", "TRADER1", "AAPL", 149.00, 100, true);
+    order_book_add_order(dense, buy);
+    TEST_ASSERT_EQUAL_INT(-1, order_book_modify_order(dense, "BUY2", true, 149.005, 100,
+                                                      order_next_sequence()));
+    TEST_ASSERT_EQUAL_INT(100, order_book_get_quantity_at_price(dense, 149.00, true));
+
+    order_book_destroy(dense);
+    order_destroy(buy);
+}
+
+static Order* create_taker(const char* id, double price, int quantity, bool is_buy,
+                           OrderTimeInForce time_in_force, bool is_market) {
+    Order* order = order_create(id, "TRADER1", "AAPL", price, quantity, is_buy);
+    order->time_in_force = time_in_force;
+    order->is_market = is_market;
+    return order;
+}
+
+// IOC, FOK and market orders trade against one side and never rest
+static void check_non_resting_orders(OrderBook* target) {
+    Order* sell1 = order_create("SELL1", "TRADER2", "AAPL", 150.00, 100, false);
+    Order* sell2 = order_create("SELL2", "TRADER2", "AAPL", 151.00, 100, false);
+    Order* sell3 = order_create("SELL3", "TRADER2", "AAPL", 152.00, 100, false);
+    order_book_add_order(target, sell1);
+    order_book_add_order(target, sell2);
+    order_book_add_order(target, sell3);
+
+    // FOK wants more than rests within its limit, so nothing trades
+    Order* fok = create_taker("FOK1", 151.00, 250, true, ORDER_TIF_FOK, false);
+    TEST_ASSERT_EQUAL_INT(-1, order_book_add_order(target, fok));
+    TEST_ASSERT_TRUE(order_book_can_execute(target, fok));
+    TEST_ASSERT_EQUAL_INT(0, order_book_execute_order(target, fok));
+    TEST_ASSERT_TRUE(order_is_canceled(fok));
+    TEST_ASSERT_EQUAL_INT(100, order_get_remaining_quantity(sell1));
+    TEST_ASSERT_EQUAL_INT(100, order_get_remaining_quantity(sell2));
+
+    // IOC fills up to its limit and drops the rest
+    Order* ioc = create_taker("IOC1", 151.00, 250, true, ORDER_TIF_IOC, false);
+    TEST_ASSERT_EQUAL_INT(200, order_book_execute_order(target, ioc));
+    TEST_ASSERT_EQUAL_INT(50, order_get_remaining_quantity(ioc));
+    TEST_ASSERT_TRUE(order_is_canceled(ioc));
+    TEST_ASSERT_EQUAL_INT(0, order_book_get_quantity_at_price(target, 151.00, true));
+
+    // A resting ID cannot be reused by a taker
+    Order* reused = create_taker("SELL3", 0.0, 10, true, ORDER_TIF_IOC, true);
+    TEST_ASSERT_FALSE(order_book_can_execute(target, reused));
+    TEST_ASSERT_EQUAL_INT(-1, order_book_execute_order(target, reused));
+
+    // FOK that fits, then a market order that sweeps what is left
+    Order* fok_fill = create_taker("FOK2", 152.00, 40, true, ORDER_TIF_FOK, false);
+    TEST_ASSERT_EQUAL_INT(40, order_book_execute_order(target, fok_fill));
+    TEST_ASSERT_FALSE(order_is_canceled(fok_fill));
+
+    Order* market = create_taker("MKT1", 0.0, 100, true, ORDER_TIF_IOC, true);
+    TEST_ASSERT_EQUAL_INT(60, order_book_execute_order(target, market));
+    TEST_ASSERT_EQUAL_INT(0, order_get_remaining_quantity(sell3));
+
+    // Nothing the takers left over rests on the buy side
+    Order* sell4 = order_create("SELL4", "TRADER2", "AAPL", 100.00, 10, false);
+    order_book_add_order(target, sell4);
+    order_book_match_orders(target);
+    TEST_ASSERT_EQUAL_INT(10, order_get_remaining_quantity(sell4));
+
+    Order* orders[] = {sell1, sell2, sell3, sell4, fok, ioc, reused, fok_fill, market};
+    for (size_t i = 0; i < sizeof(orders) / sizeof(orders[0]); i++) {
+        order_destroy(orders[i]);
+    }
+}
+
+void test_non_resting_orders(void) {
+    check_non_resting_orders(book);
+}
+
+void test_dense_book_non_resting_orders(void) {
+    OrderBookConfig config = {
+        .backend = ORDER_BOOK_BACKEND_DENSE,
+        .tick_size = 0.01,
+        .num_levels = 64,
+        .trade_broadcaster = NULL
+    };
+    OrderBook* dense = order_book_create_with_config(&config);
+    check_non_resting_orders(dense);
+    order_book_destroy(dense);
+}
+
+static Order* create_iceberg(const char* id, double price, int quantity, int display_quantity) {
+    Order* order = order_create(id, "TRADER2", "AAPL", price, quantity, false);
+    order_set_display_quantity(order, display_quantity);
+    return order;
+}
+
+// An iceberg shows one slice at a time and each new slice queues at the back
+static void check_iceberg_orders(OrderBook* target) {
+    Order* iceberg = create_iceberg("ICE1", 150.00, 300, 100);
+    Order* sell2 = order_create("SELL2", "TRADER2", "AAPL", 150.00, 100, false);
+    order_book_add_order(target, iceberg);
+    order_book_add_order(target, sell2);
+    TEST_ASSERT_EQUAL_INT(200, order_book_get_quantity_at_price(target, 150.00, false));
+    TEST_ASSERT_EQUAL_INT(300, order_get_open_quantity(iceberg));
+
+    // The first slice fills and the next one queues behind SELL2
+    Order* buy1 = order_create("BUY1", "TRADER1", "AAPL", 150.00, 100, true);
+    order_book_add_order(target, buy1);
+    order_book_match_orders(target);
+    TEST_ASSERT_EQUAL_INT(100, order_get_remaining_quantity(iceberg));
+    TEST_ASSERT_EQUAL_INT(100, order_get_remaining_quantity(sell2));
+    TEST_ASSERT_TRUE(order_get_sequence(iceberg) > order_get_sequence(buy1));
+    TEST_ASSERT_EQUAL_INT(200, order_book_get_quantity_at_price(target, 150.00, false));
+
+    Order* buy2 = order_create("BUY2", "TRADER1", "AAPL", 150.00, 150, true);
+    order_book_add_order(target, buy2);
+    order_book_match_orders(target);
+    TEST_ASSERT_EQUAL_INT(0, order_get_remaining_quantity(sell2));
+    TEST_ASSERT_EQUAL_INT(50, order_get_remaining_quantity(iceberg));
+    TEST_ASSERT_EQUAL_INT(150, order_get_open_quantity(iceberg));
+    TEST_ASSERT_EQUAL_INT(50, order_book_get_quantity_at_price(target, 150.00, false));
+
+    // Icebergs cannot take, but the hidden reserve counts for a fill-or-kill
+    Order* hidden_taker = create_taker("IOC0", 150.00, 100, true, ORDER_TIF_IOC, false);
+    order_set_display_quantity(hidden_taker, 10);
+    TEST_ASSERT_FALSE(order_book_can_execute(target, hidden_taker));
+    TEST_ASSERT_EQUAL_INT(-1, order_book_execute_order(target, hidden_taker));
+    Order* fok = create_taker("FOK1", 150.00, 150, true, ORDER_TIF_FOK, false);
+    TEST_ASSERT_EQUAL_INT(150, order_book_execute_order(target, fok));
+    TEST_ASSERT_EQUAL_INT(0, order_get_open_quantity(iceberg));
+    TEST_ASSERT_TRUE(order_book_is_order_canceled(target, "ICE1", false));
+
+    // Cycling many slices through a level keeps the queue intact
+    Order* iceberg2 = create_iceberg("ICE2", 151.00, 1000, 10);
+    Order* sell3 = order_create("SELL3", "TRADER2", "AAPL", 151.00, 500, false);
+    order_book_add_order(target, iceberg2);
+    order_book_add_order(target, sell3);
+    Order* ioc = create_taker("IOC1", 151.00, 2000, true, ORDER_TIF_IOC, false);
+    TEST_ASSERT_EQUAL_INT(1500, order_book_execute_order(target, ioc));
+    TEST_ASSERT_EQUAL_INT(0, order_book_get_quantity_at_price(target, 151.00, false));
+
+    Order* orders[] = {iceberg, sell2, buy1, buy2, hidden_taker, fok, iceberg2, sell3, ioc};
+    for (size_t i = 0; i < sizeof(orders) / sizeof(orders[0]); i++) {
+        order_destroy(orders[i]);
+    }
+}
+
+void test_iceberg_orders(void) {
+    check_iceberg_orders(book);
+}
+
+void test_dense_book_iceberg_orders(void) {
+    OrderBookConfig config = {
+        .backend = ORDER_BOOK_BACKEND_DENSE,
+        .tick_size = 0.01,
+        .num_levels = 64,
+        .trade_broadcaster = NULL
+    };
+    OrderBook* dense = order_book_create_with_config(&config);
+    check_iceberg_orders(dense);
+    order_book_destroy(dense);
+}
+
+// Bulk insert merges with resting orders and keeps price-time priority
+void test_bulk_add_orders(void) {
+    Order* resting = order_create("SELL0", "TRADER2", "AAPL", 151.0, 100, false);
+    order_book_add_order(book, resting);
+
+    Order* batch[] = {
+        order_create("SELL1", "TRADER2", "AAPL", 152.0, 100, false),
+        order_create("BUY1", "TRADER1", "AAPL", 149.0, 100, true),
+        order_create("SELL2", "TRADER2", "AAPL", 150.0, 100, false),
+        order_create("BUY2", "TRADER1", "AAPL", 149.0, 100, true),
+        order_create("SELL0", "TRADER2", "AAPL", 150.0, 100, false),  // Duplicate live ID
+        order_create("SELL3", "TRADER2", "AAPL", 150.0, 100, false)
+    };
+    size_t n = sizeof(batch) / sizeof(batch[0]);
+
+    TEST_ASSERT_EQUAL_INT(5, order_book_add_orders_bulk(book, batch, n));
+    TEST_ASSERT_EQUAL_STRING("SELL0", order_get_id(batch[5]));
+    TEST_ASSERT_EQUAL_INT(200, order_book_get_quantity_at_price(book, 149.0, true));
+    TEST_ASSERT_EQUAL_INT(200, order_book_get_quantity_at_price(book, 150.0, false));
+
+    // Sweeps the 150 level in arrival order, then the resting 151 order
+    Order* buy = order_create("BUY3", "TRADER1", "AAPL", 151.0, 250, true);
+    order_book_add_order(book, buy);
+    order_book_match_orders(book);
+
+    TEST_ASSERT_EQUAL_INT(0, order_get_remaining_quantity(buy));
+    TEST_ASSERT_EQUAL_INT(50, order_get_remaining_quantity(resting));
+    TEST_ASSERT_EQUAL_INT(100, order_book_get_quantity_at_price(book, 152.0, false));
+
+    // The earlier of the two equal-price bids fills first
+    Order* sell = order_create("SELL4", "TRADER2", "AAPL", 149.0, 100, false);
+    order_book_add_order(book, sell);
+    order_book_match_orders(book);
+    TEST_ASSERT_EQUAL_STRING("BUY1", order_get_id(batch[0]));
+    TEST_ASSERT_EQUAL_INT(0, order_get_remaining_quantity(batch[0]));
+    TEST_ASSERT_EQUAL_INT(100, order_get_remaining_quantity(batch[1]));
+
+    for (size_t i = 0; i < n; i++) {
+        order_destroy(batch[i]);
+    }
+    order_destroy(resting);
+    order_destroy(buy);
+    order_destroy(sell);
+}
+
+// Orders repeating the price and sequence of a resting order, or of one
+// earlier in the batch, are rejected rather than dropped
+void test_bulk_add_duplicate_keys(void) {
+    Order* resting = order_create("SELL0", "TRADER2", "AAPL", 151.0, 100, false);
+    order_book_add_order(book, resting);
+
+    Order* clash = order_create("SELL1", "TRADER2", "AAPL", 151.0, 100, false);
+    Order* first = order_create("BUY1", "TRADER1", "AAPL", 149.0, 100, true);
+    Order* repeat = order_create("BUY2", "TRADER1", "AAPL", 149.0, 100, true);
+    Order* other = order_create("BUY3", "TRADER1", "AAPL", 149.0, 100, true);
+    clash->sequence = resting->sequence;
+    repeat->sequence = first->sequence;
+
+    // Which of the two equal keys wins is up to the sort
+    Order* batch[] = {clash, first, repeat, other};
+    TEST_ASSERT_EQUAL_INT(2, order_book_add_orders_bulk(book, batch, 4));
+    TEST_ASSERT_TRUE(batch[0] == first || batch[0] == repeat);
+    TEST_ASSERT_EQUAL_STRING("BUY3", order_get_id(batch[1]));
+    TEST_ASSERT_TRUE(batch[2] == clash || batch[3] == clash);
+
+    TEST_ASSERT_TRUE(order_book_is_order_canceled(book, "SELL1", false));
+    TEST_ASSERT_NOT_EQUAL(order_book_is_order_canceled(book, "BUY1", true),
+                          order_book_is_order_canceled(book, "BUY2", true));
+    TEST_ASSERT_FALSE(order_book_is_order_canceled(book, "BUY3", true));
+    TEST_ASSERT_EQUAL_INT(200, order_book_get_quantity_at_price(book, 149.0, true));
+    TEST_ASSERT_EQUAL_INT(100, order_book_get_quantity_at_price(book, 151.0, false));
+
+    order_destroy(resting);
+    for (size_t i = 0; i < 4; i++) {
+        order_destroy(batch[i]);
+    }
+}
+
+typedef struct {
+    int fills;
+    int quantity;
+    double last_price;
+} TradeCapture;
+
+static void capture_trade(const Order* buy_order, const Order* sell_order,
+                          double price, int quantity, void* user_data) {
+    TradeCapture* capture = (TradeCapture*)user_data;
+    TEST_ASSERT_EQUAL_STRING("BUY1", order_get_id(buy_order));
+    TEST_ASSERT_FALSE(order_is_buy_order(sell_order));
+    capture->fills++;
+    capture->quantity += quantity;
+    capture->last_price = price;
+}
+
+void test_trade_callback(void) {
+    TradeCapture capture = {0};
+    order_book_set_trade_callback(book, capture_trade, &capture);
+
+    Order* sell1 = order_create("SELL1", "TRADER2", "AAPL", 150.0, 40, false);
+    Order* sell2 = order_create("SELL2", "TRADER2", "AAPL", 151.0, 40, false);
+    Order* buy = order_create("BUY1", "TRADER1", "AAPL", 151.0, 100, true);
+
+    order_book_add_order(book, sell1);
+    order_book_add_order(book, sell2);
+    order_book_add_order(book, buy);
+    order_book_match_orders(book);
+
+    TEST_ASSERT_EQUAL_INT(2, capture.fills);
+    TEST_ASSERT_EQUAL_INT(80, capture.quantity);
+    TEST_ASSERT_EQUAL_DOUBLE(151.0, capture.last_price);
+
+    order_destroy(sell1);
+    order_destroy(sell2);
+    order_destroy(buy);
+}
+
+static OrderBook* resolve_test_book(const char* symbol, void* user_data) {
+    return strcmp(symbol, "AAPL") == 0 ? (OrderBook*)user_data : NULL;
+}
+
+// Snapshots round-trip live orders with their priority and reject corrupt files
+void test_snapshot_round_trip(void) {
+    const char* path = "test_books.snap";
+    Order* sell1 = order_create("SELL1", "TRADER2", "AAPL", 150.0, 100, false);
+    Order* sell2 = order_create("SELL2", "TRADER2", "AAPL", 150.0, 100, false);
+    Order* sell3 = order_create("SELL3", "TRADER2", "AAPL", 151.0, 100, false);
+    Order* buy = order_create("BUY1", "TRADER1", "AAPL", 149.0, 100, true);
+    order_book_add_order(book, sell1);
+    order_book_add_order(book, sell2);
+    order_book_add_order(book, sell3);
+    order_book_add_order(book, buy);
+    order_reduce_quantity(sell1, 40);
+    order_book_cancel_order(book, "SELL3", false);
+
+    SnapshotBook entry = {.symbol = "AAPL", .book = book};
+    TEST_ASSERT_EQUAL_INT(0, order_book_save_snapshot(path, &entry, 1, 42));
+
+    OrderBook* restored = order_book_create(NULL);
+    uint64_t journal_lsn = 0;
+    TEST_ASSERT_EQUAL_INT(3, order_book_load_snapshot(path, resolve_test_book, restored, &journal_lsn));
+    TEST_ASSERT_EQUAL_UINT64(42, journal_lsn);
+    TEST_ASSERT_EQUAL_INT(160, order_book_get_quantity_at_price(restored, 150.0, false));
+    TEST_ASSERT_EQUAL_INT(0, order_book_get_quantity_at_price(restored, 151.0, false));
+    TEST_ASSERT_EQUAL_INT(100, order_book_get_quantity_at_price(restored, 149.0, true));
+
+    // Restored SELL1 keeps priority over SELL2, and new orders queue behind both
+    Order* taker = order_create("BUY2", "TRADER1", "AAPL", 150.0, 60, true);
+    TEST_ASSERT_TRUE(order_get_sequence(taker) > order_get_sequence(sell2));
+    order_book_add_order(restored, taker);
+    order_book_match_orders(restored);
+    TEST_ASSERT_EQUAL_INT(100, order_book_get_quantity_at_price(restored, 150.0, false));
+    TEST_ASSERT_TRUE(order_book_is_order_canceled(restored, "SELL1", false));
+    TEST_ASSERT_FALSE(order_book_is_order_canceled(restored, "SELL2", false));
+
+    // Any other format version is refused
+    uint32_t version = SNAPSHOT_VERSION + 1;
+    FILE* file = fopen(path, "r+b");
+    TEST_ASSERT_NOT_NULL(file);
+    fseek(file, (long)offsetof(SnapshotHeader, version), SEEK_SET);
+    fwrite(&version, sizeof(version), 1, file);
+    fclose(file);
+
+    OrderBook* untouched = order_book_create(NULL);
+    TEST_ASSERT_EQUAL_INT(-1, order_book_load_snapshot(path, resolve_test_book, untouched, NULL));
+
+    // Flip a byte inside the first record
+    version = SNAPSHOT_VERSION;
+    file = fopen(path, "r+b");
+    TEST_ASSERT_NOT_NULL(file);
+    fseek(file, (long)offsetof(SnapshotHeader, version), SEEK_SET);
+    fwrite(&version, sizeof(version), 1, file);
+    fseek(file, (long)(sizeof(SnapshotHeader) + sizeof(SnapshotSection) + 4), SEEK_SET);
+    fputc('X', file);
+    fclose(file);
+
+    TEST_ASSERT_EQUAL_INT(-1, order_book_load_snapshot(path, resolve_test_book, untouched, NULL));
+    TEST_ASSERT_EQUAL_INT(0, order_book_get_quantity_at_price(untouched, 150.0, false));
+    remove(path);
+
+    order_book_destroy(untouched);
+    order_book_destroy(restored);
+    order_destroy(sell1);
+    order_destroy(sell2);
+    order_destroy(sell3);
+    order_destroy(buy);
+    order_destroy(taker);
+}
+
+// A restored iceberg keeps its displayed slice and hidden reserve
+void test_snapshot_iceberg(void) {
+    const char* path = "test_iceberg.snap";
+    Order* iceberg = create_iceberg("ICE1", 150.0, 300, 100);
+    Order* buy = order_create("BUY1", "TRADER1", "AAPL", 150.0, 40, true);
+    order_book_add_order(book, iceberg);
+    order_book_add_order(book, buy);
+    order_book_match_orders(book);
+
+    SnapshotBook entry = {.symbol = "AAPL", .book = book};
+    TEST_ASSERT_EQUAL_INT(0, order_book_save_snapshot(path, &entry, 1, 0));
+
+    OrderBook* restored = order_book_create(NULL);
+    TEST_ASSERT_EQUAL_INT(1, order_book_load_snapshot(path, resolve_test_book, restored, NULL));
+    TEST_ASSERT_EQUAL_INT(60, order_book_get_quantity_at_price(restored, 150.0, false));
+
+    Order* taker = order_create("BUY2", "TRADER1", "AAPL", 150.0, 260, true);
+    order_book_add_order(restored, taker);
+    order_book_match_orders(restored);
+    TEST_ASSERT_EQUAL_INT(0, order_get_remaining_quantity(taker));
+    TEST_ASSERT_TRUE(order_book_is_order_canceled(restored, "ICE1", false));
+    remove(path);
+
+    order_book_destroy(restored);
+    order_destroy(iceberg);
+    order_destroy(buy);
+    order_destroy(taker);
+}
+
 int main(void) {
     set_log_level(LOG_INFO);
     LOG_INFO("Starting trading system tests");
@@ -214,6 +987,27 @@ int main(void) {
     RUN_TEST(test_partial_fills);
     RUN_TEST(test_balance_updates);
     RUN_TEST(test_multiple_matches);
+    RUN_TEST(test_dense_book_price_priority);
+    RUN_TEST(test_dense_book_recenter);
+    RUN_TEST(test_dense_book_wide_window);
+    RUN_TEST(test_dense_book_cancellation);
+    RUN_TEST(test_dense_book_cancel_after_compaction);
+    RUN_TEST(test_buy_time_priority_same_instant);
+    RUN_TEST(test_interned_ids);
+    RUN_TEST(test_intern_release);
+    RUN_TEST(test_adopted_orders);
+    RUN_TEST(test_cancel_by_id);
+    RUN_TEST(test_modify_order);
+    RUN_TEST(test_dense_book_modify);
+    RUN_TEST(test_non_resting_orders);
+    RUN_TEST(test_dense_book_non_resting_orders);
+    RUN_TEST(test_iceberg_orders);
+    RUN_TEST(test_dense_book_iceberg_orders);
+    RUN_TEST(test_bulk_add_orders);
+    RUN_TEST(test_bulk_add_duplicate_keys);
+    RUN_TEST(test_snapshot_round_trip);
+    RUN_TEST(test_snapshot_iceberg);
+    RUN_TEST(test_trade_callback);
     
     LOG_INFO("All tests completed");
     return UNITY_END();
@@ -0,0 +1,57 @@
+#define _GNU_SOURCE
+#include "unity.h"
+#include "utils/cpu_affinity.h"
+#include <sched.h>
+
+void setUp(void) {}
+
+void tearDown(void) {}
+
+void test_parse_lists_and_ranges(void) {
+    CpuList list;
+    TEST_ASSERT_EQUAL_INT(0, cpu_list_parse("2,4-6,9", &list));
+    TEST_ASSERT_EQUAL_INT(5, list.count);
+    int expected[] = {2, 4, 5, 6, 9};
+    TEST_ASSERT_EQUAL_INT_ARRAY(expected, list.cpus, 5);
+
+    TEST_ASSERT_EQUAL_INT(0, cpu_list_parse("0", &list));
+    TEST_ASSERT_EQUAL_INT(1, list.count);
+    TEST_ASSERT_EQUAL_INT(0, list.cpus[0]);
+}
+
+void test_parse_rejects_malformed(void) {
+    CpuList list;
+    TEST_ASSERT_EQUAL_INT(-1, cpu_list_parse("", &list));
+    TEST_ASSERT_EQUAL_INT(-1, cpu_list_parse("1,", &list));
+    TEST_ASSERT_EQUAL_INT(-1, cpu_list_parse("3-1", &list));
+    TEST_ASSERT_EQUAL_INT(-1, cpu_list_parse("a", &list));
+    TEST_ASSERT_EQUAL_INT(-1, cpu_list_parse("1-", &list));
+    TEST_ASSERT_EQUAL_INT(-1, cpu_list_parse("0-100", &list));
+}
+
+static void* report_cpu(void* arg) {
+    *(int*)arg = sched_getcpu();
+    return NULL;
+}
+
+// Every machine has CPU 0, so a thread pinned there must run there
+void test_thread_runs_on_pinned_cpu(void) {
+    CpuList list;
+    TEST_ASSERT_EQUAL_INT(0, cpu_list_parse("0", &list));
+
+    pthread_t thread;
+    int cpu = -1;
+    TEST_ASSERT_EQUAL_INT(0, cpu_thread_create(&thread, &list, 0, report_cpu, &cpu));
+    pthread_join(thread, NULL);
+    TEST_ASSERT_EQUAL_INT(0, cpu);
+}
+
+int main(void) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_parse_lists_and_ranges);
+    RUN_TEST(test_parse_rejects_malformed);
+    RUN_TEST(test_thread_runs_on_pinned_cpu);
+
+    return UNITY_END();
+}
@@ -0,0 +1,78 @@
+#include "unity.h"
+#include "utils/latency_histogram.h"
+#include <pthread.h>
+#include <stdlib.h>
+
+LatencyHistogram* histogram;
+
+void setUp(void) {
+    histogram = latency_histogram_create();
+}
+
+void tearDown(void) {
+    latency_histogram_destroy(histogram);
+}
+
+// Percentiles land within the histogram's ~3% bucket resolution
+void test_percentiles_uniform(void) {
+    for (int64_t v = 1; v <= 100000; v++) {
+        latency_histogram_record(histogram, v * 1000);
+    }
+
+    LatencySummary summary;
+    latency_histogram_summarize(histogram, &summary);
+    TEST_ASSERT_EQUAL_UINT64(100000, summary.count);
+    TEST_ASSERT_EQUAL_INT64(1000, summary.min_ns);
+    TEST_ASSERT_EQUAL_INT64(100000000, summary.max_ns);
+    TEST_ASSERT_INT64_WITHIN(50000000 / 32, 50000000, summary.p50_ns);
+    TEST_ASSERT_INT64_WITHIN(99000000 / 32, 99000000, summary.p99_ns);
+    TEST_ASSERT_INT64_WITHIN(99900000 / 32, 99900000, summary.p999_ns);
+    TEST_ASSERT_TRUE(summary.p999_ns <= summary.max_ns);
+}
+
+void test_small_values_are_exact(void) {
+    latency_histogram_record(histogram, 0);
+    latency_histogram_record(histogram, 7);
+    latency_histogram_record(histogram, 31);
+    latency_histogram_record(histogram, -5);
+
+    TEST_ASSERT_EQUAL_INT64(0, latency_histogram_percentile(histogram, 0.0));
+    TEST_ASSERT_EQUAL_INT64(7, latency_histogram_percentile(histogram, 0.5));
+    TEST_ASSERT_EQUAL_INT64(31, latency_histogram_percentile(histogram, 1.0));
+}
+
+static void* record_from_thread(void* arg) {
+    int64_t value = (int64_t)(intptr_t)arg;
+    for (int i = 0; i < 10000; i++) {
+        latency_histogram_record(histogram, value);
+    }
+    return NULL;
+}
+
+// Per-thread shards are merged when read
+void test_merges_threads(void) {
+    pthread_t threads[4];
+    for (int i = 0; i < 4; i++) {
+        pthread_create(&threads[i], NULL, record_from_thread, (void*)(intptr_t)((i + 1) * 1000));
+    }
+    for (int i = 0; i < 4; i++) {
+        pthread_join(threads[i], NULL);
+    }
+
+    LatencySummary summary;
+    latency_histogram_summarize(histogram, &summary);
+    TEST_ASSERT_EQUAL_UINT64(40000, summary.count);
+    TEST_ASSERT_EQUAL_INT64(1000, summary.min_ns);
+    TEST_ASSERT_EQUAL_INT64(4000, summary.max_ns);
+    TEST_ASSERT_EQUAL_DOUBLE(2500.0, summary.mean_ns);
+}
+
+int main(void) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_percentiles_uniform);
+    RUN_TEST(test_small_values_are_exact);
+    RUN_TEST(test_merges_threads);
+
+    return UNITY_END();
+}
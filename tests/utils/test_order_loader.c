@@ -38,7 +38,7 @@ static size_t count_orders(const OrderBook* book, bool is_buy_order) {
 
 void test_load_orders_from_csv(void) {
     // Load orders from CSV file
-    int loaded = load_orders_from_file("tests/data/test_orders.csv", book);
+    int loaded = load_orders_from_file("data/test_orders.csv", book);
     TEST_ASSERT_GREATER_THAN(0, loaded);
     
     // Count orders in the book
@@ -95,6 +95,50 @@ void test_load_orders_null_params(void) {
 void test_load_orders_malformed_lines(void) {
     int loaded = load_orders_from_file("data/test_orders_malformed.txt", book);
     TEST_ASSERT_GREATER_OR_EQUAL_INT(0, loaded);  // Should skip malformed lines but continue processing
+    TEST_ASSERT_EQUAL_INT(2, loaded);
+}
+
+// Collects resting orders in traversal order
+struct OrderList {
+    Order* orders[8];
+    size_t count;
+};
+
+static void collect_callback(Order* order, void* data) {
+    struct OrderList* list = (struct OrderList*)data;
+    if (list->count < 8) {
+        list->orders[list->count] = order;
+    }
+    list->count++;
+}
+
+void test_load_orders_large_file(void) {
+    // Large enough to be split across several parser threads
+    const char* path = "data/test_orders_large.csv";
+    const int num_orders = 100000;
+    FILE* file = fopen(path, "w");
+    TEST_ASSERT_NOT_NULL(file);
+    fprintf(file, "order_id,trader_id,symbol,side,price,quantity\n");
+    for (int i = 0; i < num_orders; i++) {
+        // Every order rests at one of two prices, so priority within a level is file order
+        fprintf(file, "L%d,TRD%03d,AAPL,%s,%s,%d\n", i, i % 100,
+                (i % 2) ? "SELL" : "BUY", (i % 2) ? "101.25" : "99.75", 1 + i % 50);
+    }
+    fclose(file);
+
+    int loaded = load_orders_from_file(path, book);
+    remove(path);
+    TEST_ASSERT_EQUAL_INT(num_orders, loaded);
+    TEST_ASSERT_EQUAL_INT(num_orders / 2, count_orders(book, true));
+    TEST_ASSERT_EQUAL_INT(num_orders / 2, count_orders(book, false));
+
+    // Sequences follow file order even though chunks were parsed concurrently
+    struct OrderList sells = {0};
+    order_book_traverse_sell_orders(book, collect_callback, &sells);
+    TEST_ASSERT_EQUAL_STRING("L1", order_get_id(sells.orders[0]));
+    TEST_ASSERT_EQUAL_STRING("L3", order_get_id(sells.orders[1]));
+    TEST_ASSERT_TRUE(order_get_sequence(sells.orders[0]) < order_get_sequence(sells.orders[1]));
+    TEST_ASSERT_EQUAL_DOUBLE(101.25, order_get_price(sells.orders[0]));
 }
 
 int main(void) {
@@ -105,6 +149,7 @@ int main(void) {
     RUN_TEST(test_load_orders_invalid_file);
     RUN_TEST(test_load_orders_null_params);
     RUN_TEST(test_load_orders_malformed_lines);
+    RUN_TEST(test_load_orders_large_file);
     
     return UNITY_END();
 }
@@ -0,0 +1,148 @@
+#include "unity.h"
+#include "utils/rate_limiter.h"
+#include "trading_engine/order.h"
+#include <stdio.h>
+#include <string.h>
+
+#define NS_PER_SEC 1000000000LL
+
+void setUp(void) {}
+void tearDown(void) {}
+
+void test_bucket_burst_then_refill(void) {
+    RateLimit limit = {.rate = 10.0, .burst = 3};
+    TokenBucket bucket;
+    token_bucket_init(&bucket, &limit, 0);
+
+    TEST_ASSERT_TRUE(token_bucket_take(&bucket, &limit, 0));
+    TEST_ASSERT_TRUE(token_bucket_take(&bucket, &limit, 0));
+    TEST_ASSERT_TRUE(token_bucket_take(&bucket, &limit, 0));
+    TEST_ASSERT_FALSE(token_bucket_take(&bucket, &limit, 0));
+
+    // One token every 100ms, never more than the burst
+    TEST_ASSERT_FALSE(token_bucket_take(&bucket, &limit, NS_PER_SEC / 20));
+    TEST_ASSERT_TRUE(token_bucket_take(&bucket, &limit, NS_PER_SEC / 10));
+    TEST_ASSERT_FALSE(token_bucket_take(&bucket, &limit, NS_PER_SEC / 10));
+
+    int allowed = 0;
+    while (token_bucket_take(&bucket, &limit, 10 * NS_PER_SEC)) {
+        allowed++;
+    }
+    TEST_ASSERT_EQUAL_INT(3, allowed);
+}
+
+void test_zero_rate_is_unlimited(void) {
+    RateLimit limit = {.rate = 0, .burst = 1};
+    TokenBucket bucket;
+    token_bucket_init(&bucket, &limit, 0);
+    for (int i = 0; i < 1000; i++) {
+        TEST_ASSERT_TRUE(token_bucket_take(&bucket, &limit, 0));
+    }
+}
+
+// Each key has its own bucket
+void test_limiter_keys_are_independent(void) {
+    RateLimit limit = {.rate = 1.0, .burst = 2};
+    RateLimiter* limiter = rate_limiter_create(&limit, 64);
+    TEST_ASSERT_NOT_NULL(limiter);
+
+    const char* flood = "TRADER1";
+    TEST_ASSERT_TRUE(rate_limiter_allow(limiter, flood, strlen(flood), 0));
+    TEST_ASSERT_TRUE(rate_limiter_allow(limiter, flood, strlen(flood), 0));
+    TEST_ASSERT_FALSE(rate_limiter_allow(limiter, flood, strlen(flood), 0));
+
+    // A key given by length, as it is when sliced from a raw message
+    const char* message = "TRADER2\",\"symbol\"";
+    TEST_ASSERT_TRUE(rate_limiter_allow(limiter, message, 7, 0));
+    TEST_ASSERT_TRUE(rate_limiter_allow(limiter, "TRADER2", 7, 0));
+    TEST_ASSERT_FALSE(rate_limiter_allow(limiter, "TRADER2", 7, 0));
+
+    TEST_ASSERT_TRUE(rate_limiter_allow(limiter, flood, strlen(flood), NS_PER_SEC));
+    rate_limiter_destroy(limiter);
+}
+
+// Keys far beyond capacity are still limited; each displaces an older one
+void test_limiter_full_table(void) {
+    RateLimit limit = {.rate = 1.0, .burst = 1};
+    RateLimiter* limiter = rate_limiter_create(&limit, 16);
+    TEST_ASSERT_NOT_NULL(limiter);
+
+    char key[16];
+    int limited = 0;
+    for (int i = 0; i < 1000; i++) {
+        snprintf(key, sizeof(key), "T%d", i);
+        rate_limiter_allow(limiter, key, strlen(key), 0);
+        if (!rate_limiter_allow(limiter, key, strlen(key), 0)) {
+            limited++;
+        }
+    }
+    TEST_ASSERT_EQUAL_INT(1000, limited);
+    rate_limiter_destroy(limiter);
+}
+
+// Refilled buckets make way for new keys before a busy one is evicted
+void test_limiter_reclaims_idle_keys(void) {
+    RateLimit limit = {.rate = 1.0, .burst = 5};
+    RateLimiter* limiter = rate_limiter_create(&limit, 1024);
+    TEST_ASSERT_NOT_NULL(limiter);
+
+    const char* hot = "HOT";
+    for (int i = 0; i < 5; i++) {
+        TEST_ASSERT_TRUE(rate_limiter_allow(limiter, hot, strlen(hot), 0));
+    }
+    TEST_ASSERT_FALSE(rate_limiter_allow(limiter, hot, strlen(hot), 0));
+
+    // Together more keys than the table holds. The first wave has refilled
+    // by the time the second arrives, while HOT, the least recently used,
+    // has not.
+    char key[16];
+    for (int i = 0; i < 600; i++) {
+        snprintf(key, sizeof(key), "A%d", i);
+        TEST_ASSERT_TRUE(rate_limiter_allow(limiter, key, strlen(key), NS_PER_SEC / 10));
+    }
+    for (int i = 0; i < 600; i++) {
+        snprintf(key, sizeof(key), "B%d", i);
+        for (int j = 0; j < 5; j++) {
+            TEST_ASSERT_TRUE(rate_limiter_allow(limiter, key, strlen(key), 2 * NS_PER_SEC));
+        }
+        TEST_ASSERT_FALSE(rate_limiter_allow(limiter, key, strlen(key), 2 * NS_PER_SEC));
+    }
+
+    // HOT kept its bucket: two tokens back after two seconds, not a fresh five
+    TEST_ASSERT_TRUE(rate_limiter_allow(limiter, hot, strlen(hot), 2 * NS_PER_SEC));
+    TEST_ASSERT_TRUE(rate_limiter_allow(limiter, hot, strlen(hot), 2 * NS_PER_SEC));
+    TEST_ASSERT_FALSE(rate_limiter_allow(limiter, hot, strlen(hot), 2 * NS_PER_SEC));
+    rate_limiter_destroy(limiter);
+}
+
+// Keys are compared in full up to an ID's maximum length
+void test_limiter_long_keys(void) {
+    RateLimit limit = {.rate = 1.0, .burst = 1};
+    RateLimiter* limiter = rate_limiter_create(&limit, 64);
+    TEST_ASSERT_NOT_NULL(limiter);
+
+    char first[MAX_ID_LENGTH];
+    char second[MAX_ID_LENGTH];
+    memset(first, 'T', sizeof(first) - 1);
+    first[sizeof(first) - 1] = '\0';
+    memcpy(second, first, sizeof(second));
+    second[sizeof(second) - 2] = 'U';
+
+    TEST_ASSERT_TRUE(rate_limiter_allow(limiter, first, strlen(first), 0));
+    TEST_ASSERT_FALSE(rate_limiter_allow(limiter, first, strlen(first), 0));
+    TEST_ASSERT_TRUE(rate_limiter_allow(limiter, second, strlen(second), 0));
+    rate_limiter_destroy(limiter);
+}
+
+int main(void) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_bucket_burst_then_refill);
+    RUN_TEST(test_zero_rate_is_unlimited);
+    RUN_TEST(test_limiter_keys_are_independent);
+    RUN_TEST(test_limiter_full_table);
+    RUN_TEST(test_limiter_reclaims_idle_keys);
+    RUN_TEST(test_limiter_long_keys);
+
+    return UNITY_END();
+}